@@ -0,0 +1,140 @@
+package sqlitevec
+
+import (
+	"database/sql"
+	"fmt"
+	"log/slog"
+	"time"
+
+	"github.com/spetr/mcp-codewizard/pkg/types"
+)
+
+// Memory access statistics (access_count, accessed_at) are recorded on the
+// read path of recall. Instead of an UPDATE per recalled memory, accesses
+// are buffered and written by a background flush as one transaction, so
+// recall never waits for the WAL write lock.
+
+// accessFlushInterval is how long access events are buffered before being
+// written. Accesses within the window share one transaction.
+var accessFlushInterval = 5 * time.Second
+
+// memoryAccess is the buffered access delta of one memory.
+type memoryAccess struct {
+	count    int
+	accessed int64 // Unix seconds of the latest access
+}
+
+// touchMemory records an access of a memory. The write is deferred to the
+// next flush.
+func (s *Store) touchMemory(id string) {
+	s.accessMu.Lock()
+	defer s.accessMu.Unlock()
+
+	if s.accessPending == nil {
+		s.accessPending = make(map[string]memoryAccess)
+	}
+	a := s.accessPending[id]
+	a.count++
+	a.accessed = time.Now().Unix()
+	s.accessPending[id] = a
+
+	if s.accessTimer == nil {
+		s.accessTimer = time.AfterFunc(accessFlushInterval, func() {
+			s.accessMu.Lock()
+			s.accessTimer = nil
+			s.accessMu.Unlock()
+
+			if err := s.FlushMemoryAccess(); err != nil {
+				slog.Warn("failed to flush memory access stats", "error", err)
+			}
+		})
+	}
+}
+
+// FlushMemoryAccess writes all buffered access events in one transaction.
+// Events are kept for the next flush if the write fails.
+func (s *Store) FlushMemoryAccess() error {
+	s.accessFlushMu.Lock()
+	defer s.accessFlushMu.Unlock()
+
+	s.accessMu.Lock()
+	pending := s.accessPending
+	s.accessPending = nil
+	s.accessMu.Unlock()
+
+	if len(pending) == 0 {
+		return nil
+	}
+
+	if err := s.writeMemoryAccess(pending); err != nil {
+		s.accessMu.Lock()
+		if s.accessPending == nil {
+			s.accessPending = pending
+		} else {
+			for id, a := range pending {
+				s.accessPending[id] = mergeAccess(s.accessPending[id], a)
+			}
+		}
+		s.accessMu.Unlock()
+		return err
+	}
+
+	return nil
+}
+
+func (s *Store) writeMemoryAccess(pending map[string]memoryAccess) error {
+	return s.writeTo(subsysMemory, writeBulk, func(tx *sql.Tx) error {
+		stmt, err := tx.Prepare(`
+			UPDATE memories
+			SET access_count = access_count + ?, accessed_at = MAX(accessed_at, ?)
+			WHERE id = ?
+		`)
+		if err != nil {
+			return fmt.Errorf("failed to prepare statement: %w", err)
+		}
+		defer stmt.Close()
+
+		for id, a := range pending {
+			if _, err := stmt.Exec(a.count, a.accessed, id); err != nil {
+				return fmt.Errorf("failed to update access stats for %s: %w", id, err)
+			}
+		}
+		return nil
+	})
+}
+
+// applyPendingAccess overlays buffered access events on a memory read from
+// the database, so reads see their own recalls before the flush.
+func (s *Store) applyPendingAccess(m *types.MemoryEntry) {
+	if m == nil {
+		return
+	}
+
+	s.accessMu.Lock()
+	a, ok := s.accessPending[m.ID]
+	s.accessMu.Unlock()
+
+	if ok {
+		m.AccessCount += a.count
+		if at := time.Unix(a.accessed, 0); at.After(m.AccessedAt) {
+			m.AccessedAt = at
+		}
+	}
+}
+
+// stopAccessFlush cancels a pending background flush.
+func (s *Store) stopAccessFlush() {
+	s.accessMu.Lock()
+	defer s.accessMu.Unlock()
+
+	if s.accessTimer != nil {
+		s.accessTimer.Stop()
+		s.accessTimer = nil
+	}
+}
+
+func mergeAccess(a, b memoryAccess) memoryAccess {
+	a.count += b.count
+	a.accessed = max(a.accessed, b.accessed)
+	return a
+}
@@ -0,0 +1,393 @@
+package sqlitevec
+
+import (
+	"database/sql"
+	"encoding/json"
+	"fmt"
+	"log/slog"
+	"strings"
+	"time"
+
+	"github.com/spetr/mcp-codewizard/pkg/types"
+)
+
+// BulkLoad writes a whole index in three steps instead of maintaining every
+// index and the FTS table row by row:
+//
+//  1. The secondary indexes and triggers of chunks, symbols and refs are
+//     dropped and the tables cleared, together with the file hashes, so an
+//     interrupted load leaves every file to be indexed again. The
+//     statements that recreate the indexes and triggers are saved in the
+//     metadata table, so if the process dies before step 3, the next Init
+//     finishes the load (finishBulkLoad).
+//  2. Rows are inserted with multi-row statements, bulkLoadTxRows rows per
+//     transaction. Chunk rowids are assigned here, so embeddings need no
+//     RETURNING round trip.
+//  3. The indexes and triggers are recreated, chunks_fts is filled with one
+//     statement and the index counters are recounted.
+//
+// Readers see the cleared index from step 1 until the load transactions
+// commit, and search without full text until step 3.
+
+const (
+	// bulkLoadKey is the metadata key of the index objects dropped by a
+	// bulk load in progress.
+	bulkLoadKey = "bulk_load"
+
+	// bulkInsertRows is the number of rows per INSERT statement; 64 rows of
+	// the widest table stay below SQLite's historic 999 variable limit.
+	bulkInsertRows = 64
+
+	// bulkLoadTxRows is the number of rows per load transaction.
+	bulkLoadTxRows = 16384
+)
+
+// BulkLoad replaces the chunks, symbols and references of the index and
+// clears the file hashes. It is meant for initial and forced indexing, where
+// it is much faster than StoreChunks, StoreSymbols and StoreReferences.
+func (s *Store) BulkLoad(chunks []*types.ChunkWithEmbedding, symbols []*types.Symbol, refs []*types.Reference) error {
+	start := time.Now()
+	chunks = uniqueChunks(chunks)
+
+	dimensions := 0
+	if len(chunks) > 0 {
+		dimensions = len(chunks[0].Embedding)
+	}
+
+	var deferred []string
+	var fileIDs map[string]int64
+	err := s.write(writeBulk, func(tx *sql.Tx) error {
+		var err error
+		if deferred, err = dropIndexObjects(tx); err != nil {
+			return err
+		}
+		_, err = tx.Exec("INSERT OR REPLACE INTO metadata (key, value) VALUES (?, ?)", bulkLoadKey, jsonArray(deferred))
+		if err != nil {
+			return err
+		}
+
+		stmts := []string{
+			"DELETE FROM chunks",
+			"DELETE FROM symbols",
+			"DELETE FROM refs",
+			"DELETE FROM file_cache",
+			"DROP TABLE IF EXISTS chunk_embeddings",
+		}
+		if s.enableFTS {
+			stmts = append(stmts, "INSERT INTO chunks_fts(chunks_fts) VALUES('delete-all')")
+		}
+		for _, stmt := range stmts {
+			if _, err := tx.Exec(stmt); err != nil {
+				return err
+			}
+		}
+		if dimensions > 0 {
+			if err := createChunkEmbeddingsTable(tx, dimensions); err != nil {
+				return err
+			}
+		}
+
+		fileIDs, err = resolveFileIDs(tx, chunks, symbols, refs)
+		return err
+	})
+	if err != nil {
+		return fmt.Errorf("failed to prepare bulk load: %w", err)
+	}
+	s.dimensions = dimensions
+
+	loadErr := s.loadRows(chunks, symbols, refs, fileIDs)
+
+	// The indexes and triggers are restored even if loading failed
+	err = s.write(writeBulk, func(tx *sql.Tx) error {
+		return s.restoreIndexObjects(tx, deferred)
+	})
+	if err != nil {
+		return fmt.Errorf("failed to finish bulk load: %w", err)
+	}
+	if loadErr != nil {
+		return fmt.Errorf("failed to bulk load: %w", loadErr)
+	}
+
+	slog.Debug("bulk loaded index",
+		"chunks", len(chunks), "symbols", len(symbols), "refs", len(refs),
+		"duration", time.Since(start).Round(time.Millisecond))
+	return nil
+}
+
+// restoreIndexObjects runs the last step of a bulk load: it recreates the
+// dropped indexes and triggers, refills chunks_fts and the index counters,
+// and clears the bulk load marker.
+func (s *Store) restoreIndexObjects(tx *sql.Tx, deferred []string) error {
+	for _, stmt := range deferred {
+		if _, err := tx.Exec(stmt); err != nil {
+			return err
+		}
+	}
+	if s.enableFTS {
+		if _, err := tx.Exec("INSERT INTO chunks_fts(chunks_fts) VALUES('delete-all')"); err != nil {
+			return err
+		}
+		if err := fillChunksFTS(tx); err != nil {
+			return err
+		}
+	}
+	if err := recountStats(tx, indexCounters); err != nil {
+		return err
+	}
+	_, err := tx.Exec("DELETE FROM metadata WHERE key = ?", bulkLoadKey)
+	return err
+}
+
+// finishBulkLoad completes a bulk load that was interrupted after its
+// first step, when Init finds the marker the load left in the metadata
+// table.
+func (s *Store) finishBulkLoad() error {
+	var saved string
+	err := s.db.QueryRow("SELECT value FROM metadata WHERE key = ?", bulkLoadKey).Scan(&saved)
+	if err == sql.ErrNoRows {
+		return nil
+	}
+	if err != nil {
+		return err
+	}
+
+	var deferred []string
+	if err := json.Unmarshal([]byte(saved), &deferred); err != nil {
+		return fmt.Errorf("invalid bulk load marker: %w", err)
+	}
+	slog.Warn("finishing an interrupted bulk load", "path", s.path)
+	return s.write(writeBulk, func(tx *sql.Tx) error {
+		return s.restoreIndexObjects(tx, deferred)
+	})
+}
+
+// loadRows inserts the rows of a bulk load.
+func (s *Store) loadRows(chunks []*types.ChunkWithEmbedding, symbols []*types.Symbol, refs []*types.Reference, fileIDs map[string]int64) error {
+	for start := 0; start < len(chunks); start += bulkLoadTxRows {
+		batch := chunks[start:min(start+bulkLoadTxRows, len(chunks))]
+		err := s.write(writeBulk, func(tx *sql.Tx) error {
+			// Writes from outside the load may have taken rowids meanwhile
+			var base int64
+			if err := tx.QueryRow("SELECT COALESCE(MAX(id), 0) FROM chunks").Scan(&base); err != nil {
+				return err
+			}
+
+			chunkRows := make([][]any, 0, len(batch))
+			var embeddingRows [][]any
+			for i, cwe := range batch {
+				c := cwe.Chunk
+				content, contentBlob, err := s.encodeContent(c.Content)
+				if err != nil {
+					return fmt.Errorf("failed to compress chunk %s: %w", c.ID, err)
+				}
+				id := base + int64(i) + 1
+				chunkRows = append(chunkRows, []any{
+					id, c.ID, fileIDs[c.FilePath], c.Language, content, contentBlob,
+					string(c.ChunkType), c.Name, c.ParentName, c.StartLine, c.EndLine, c.Hash,
+				})
+				if len(cwe.Embedding) > 0 {
+					embeddingRows = append(embeddingRows, []any{id, floatsToBytes(cwe.Embedding)})
+				}
+			}
+
+			if err := insertRows(tx, `INSERT INTO chunks
+				(id, key, file_id, language, content, content_blob, chunk_type, name, parent_name, start_line, end_line, hash)`,
+				chunkRows); err != nil {
+				return fmt.Errorf("failed to store chunks: %w", err)
+			}
+			if err := insertRows(tx, "INSERT INTO chunk_embeddings (rowid, embedding)", embeddingRows); err != nil {
+				return fmt.Errorf("failed to store embeddings: %w", err)
+			}
+			return nil
+		})
+		if err != nil {
+			return err
+		}
+	}
+
+	// Symbols and references replace duplicates by key, like StoreSymbols
+	// and StoreReferences
+	for start := 0; start < len(symbols); start += bulkLoadTxRows {
+		batch := symbols[start:min(start+bulkLoadTxRows, len(symbols))]
+		rows := make([][]any, 0, len(batch))
+		for _, sym := range batch {
+			lineCount := sym.LineCount
+			if lineCount == 0 {
+				lineCount = sym.ComputeLineCount()
+			}
+			rows = append(rows, []any{
+				sym.ID, sym.Name, string(sym.Kind), fileIDs[sym.FilePath],
+				sym.StartLine, sym.EndLine, lineCount, sym.Signature, sym.Visibility, sym.DocComment,
+			})
+		}
+		err := s.write(writeBulk, func(tx *sql.Tx) error {
+			return insertRows(tx, `INSERT OR REPLACE INTO symbols
+				(key, name, kind, file_id, start_line, end_line, line_count, signature, visibility, doc_comment)`, rows)
+		})
+		if err != nil {
+			return fmt.Errorf("failed to store symbols: %w", err)
+		}
+	}
+
+	for start := 0; start < len(refs); start += bulkLoadTxRows {
+		batch := refs[start:min(start+bulkLoadTxRows, len(refs))]
+		rows := make([][]any, 0, len(batch))
+		for _, ref := range batch {
+			rows = append(rows, []any{
+				ref.ID, ref.FromSymbol, ref.ToSymbol, string(ref.Kind),
+				fileIDs[ref.FilePath], ref.Line, ref.IsExternal,
+			})
+		}
+		err := s.write(writeBulk, func(tx *sql.Tx) error {
+			return insertRows(tx, `INSERT OR REPLACE INTO refs
+				(key, from_symbol, to_symbol, kind, file_id, line, is_external)`, rows)
+		})
+		if err != nil {
+			return fmt.Errorf("failed to store references: %w", err)
+		}
+	}
+	return nil
+}
+
+// dropIndexObjects drops the secondary indexes and triggers of the chunk,
+// symbol and reference tables and returns the statements that recreate
+// them, indexes first. The statements are idempotent, so an interrupted
+// restore can run them again. Indexes backing UNIQUE constraints have no
+// SQL and stay.
+func dropIndexObjects(tx *sql.Tx) ([]string, error) {
+	rows, err := tx.Query(`
+		SELECT type, name, sql FROM sqlite_master
+		WHERE type IN ('index', 'trigger') AND tbl_name IN ('chunks', 'symbols', 'refs') AND sql IS NOT NULL
+		ORDER BY type = 'trigger', name
+	`)
+	if err != nil {
+		return nil, err
+	}
+	var drops, creates []string
+	for rows.Next() {
+		var kind, name, ddl string
+		if err := rows.Scan(&kind, &name, &ddl); err != nil {
+			rows.Close()
+			return nil, err
+		}
+		drops = append(drops, fmt.Sprintf("DROP %s %s", strings.ToUpper(kind), name))
+		creates = append(creates, ifNotExists(ddl))
+	}
+	rows.Close()
+	if err := rows.Err(); err != nil {
+		return nil, err
+	}
+
+	for _, stmt := range drops {
+		if _, err := tx.Exec(stmt); err != nil {
+			return nil, err
+		}
+	}
+	return creates, nil
+}
+
+// ifNotExists adds IF NOT EXISTS to a CREATE INDEX or CREATE TRIGGER
+// statement from sqlite_master. SQLite stores them normalized: upper case
+// leading keywords separated by single spaces, without IF NOT EXISTS.
+func ifNotExists(ddl string) string {
+	for _, prefix := range []string{"CREATE INDEX ", "CREATE UNIQUE INDEX ", "CREATE TRIGGER "} {
+		if strings.HasPrefix(ddl, prefix) {
+			return prefix + "IF NOT EXISTS " + ddl[len(prefix):]
+		}
+	}
+	return ddl
+}
+
+// resolveFileIDs adds the paths of all rows to the files dictionary.
+func resolveFileIDs(tx *sql.Tx, chunks []*types.ChunkWithEmbedding, symbols []*types.Symbol, refs []*types.Reference) (map[string]int64, error) {
+	files := newFileIDs(tx)
+	add := func(path string) error {
+		_, err := files.get(path)
+		return err
+	}
+	for _, c := range chunks {
+		if err := add(c.Chunk.FilePath); err != nil {
+			return nil, err
+		}
+	}
+	for _, sym := range symbols {
+		if err := add(sym.FilePath); err != nil {
+			return nil, err
+		}
+	}
+	for _, ref := range refs {
+		if err := add(ref.FilePath); err != nil {
+			return nil, err
+		}
+	}
+	return files.ids, nil
+}
+
+// uniqueChunks drops all but the last of chunks with the same ID, which
+// StoreChunks would have stored over each other.
+func uniqueChunks(chunks []*types.ChunkWithEmbedding) []*types.ChunkWithEmbedding {
+	last := make(map[string]int, len(chunks))
+	for i, c := range chunks {
+		last[c.Chunk.ID] = i
+	}
+	if len(last) == len(chunks) {
+		return chunks
+	}
+	unique := make([]*types.ChunkWithEmbedding, 0, len(last))
+	for i, c := range chunks {
+		if last[c.Chunk.ID] == i {
+			unique = append(unique, c)
+		}
+	}
+	return unique
+}
+
+// insertRows inserts rows with statements of up to bulkInsertRows rows each.
+// head is the INSERT statement up to VALUES; all rows have the same number
+// of columns.
+func insertRows(tx *sql.Tx, head string, rows [][]any) error {
+	if len(rows) == 0 {
+		return nil
+	}
+	columns := len(rows[0])
+
+	var full *sql.Stmt
+	defer func() {
+		if full != nil {
+			full.Close()
+		}
+	}()
+
+	args := make([]any, 0, bulkInsertRows*columns)
+	for start := 0; start < len(rows); start += bulkInsertRows {
+		batch := rows[start:min(start+bulkInsertRows, len(rows))]
+		args = args[:0]
+		for _, row := range batch {
+			args = append(args, row...)
+		}
+
+		query := head + " VALUES " + valuesList(len(batch), columns)
+		if len(batch) < bulkInsertRows {
+			if _, err := tx.Exec(query, args...); err != nil {
+				return err
+			}
+			continue
+		}
+		if full == nil {
+			var err error
+			if full, err = tx.Prepare(query); err != nil {
+				return err
+			}
+		}
+		if _, err := full.Exec(args...); err != nil {
+			return err
+		}
+	}
+	return nil
+}
+
+// valuesList returns rows groups of "(?, ?, ...)" with columns placeholders.
+func valuesList(rows, columns int) string {
+	group := "(" + strings.Repeat("?, ", columns-1) + "?)"
+	return strings.Repeat(group+", ", rows-1) + group
+}
@@ -0,0 +1,244 @@
+package sqlitevec
+
+import (
+	"context"
+	"database/sql"
+	"fmt"
+	"os"
+	"testing"
+
+	"github.com/spetr/mcp-codewizard/pkg/types"
+)
+
+// bulkTestIndex returns n chunks spread over files, with one symbol and one
+// reference per chunk.
+func bulkTestIndex(n int) ([]*types.ChunkWithEmbedding, []*types.Symbol, []*types.Reference) {
+	chunks := make([]*types.ChunkWithEmbedding, n)
+	symbols := make([]*types.Symbol, n)
+	refs := make([]*types.Reference, n)
+	for i := range chunks {
+		file := fmt.Sprintf("pkg/file%d.go", i%100)
+		name := fmt.Sprintf("Handler%d", i)
+		chunks[i] = &types.ChunkWithEmbedding{
+			Chunk: &types.Chunk{
+				ID: fmt.Sprintf("%s:%d:h", file, i), FilePath: file, Language: "go",
+				Content: fmt.Sprintf("func %s() error { return validate%d() }", name, i), ChunkType: types.ChunkTypeFunction,
+				Name: name, StartLine: i, EndLine: i + 3, Hash: "h",
+			},
+			Embedding: []float32{0.1, 0.2, 0.3, float32(i%10) / 10},
+		}
+		symbols[i] = &types.Symbol{
+			ID: fmt.Sprintf("%s:%s:%d", file, name, i), Name: name,
+			Kind: types.SymbolKindFunction, FilePath: file, StartLine: i, EndLine: i + 3,
+		}
+		refs[i] = &types.Reference{
+			ID: fmt.Sprintf("%s:%d:call:validate%d", file, i+1, i), FromSymbol: name, ToSymbol: fmt.Sprintf("validate%d", i),
+			Kind: types.RefKindCall, FilePath: file, Line: i + 1,
+		}
+	}
+	return chunks, symbols, refs
+}
+
+func TestBulkLoad(t *testing.T) {
+	store := newWriterTestStore(t)
+
+	// Rows of an earlier index are replaced
+	stale := &types.ChunkWithEmbedding{
+		Chunk: &types.Chunk{ID: "old.go:1:h", FilePath: "old.go", Language: "go", Content: "func Stale()",
+			ChunkType: types.ChunkTypeFunction, StartLine: 1, EndLine: 1, Hash: "h"},
+		Embedding: []float32{1, 0, 0, 0},
+	}
+	if err := store.StoreChunks([]*types.ChunkWithEmbedding{stale}); err != nil {
+		t.Fatal(err)
+	}
+	if err := store.SetFileHash("old.go", "h", "config"); err != nil {
+		t.Fatal(err)
+	}
+
+	chunks, symbols, refs := bulkTestIndex(500)
+	chunks = append(chunks, chunks[0]) // Duplicates are stored once
+	if err := store.BulkLoad(chunks, symbols, refs); err != nil {
+		t.Fatal(err)
+	}
+
+	stats, err := store.GetStats()
+	if err != nil {
+		t.Fatal(err)
+	}
+	if stats.TotalChunks != 500 || stats.TotalSymbols != 500 || stats.TotalReferences != 500 {
+		t.Errorf("stats after bulk load = %+v", stats)
+	}
+	var embeddings int
+	store.db.QueryRow("SELECT COUNT(*) FROM chunk_embeddings").Scan(&embeddings)
+	if embeddings != 500 {
+		t.Errorf("%d embeddings, want 500", embeddings)
+	}
+
+	var objects int
+	store.db.QueryRow(`SELECT COUNT(*) FROM sqlite_master WHERE name IN
+		('idx_chunks_file', 'idx_symbols_name', 'idx_refs_to', 'chunks_ai', 'chunks_ad', 'chunks_au')`).Scan(&objects)
+	if objects != 6 {
+		t.Errorf("%d of 6 indexes and triggers restored", objects)
+	}
+	var revision int
+	store.db.QueryRow("PRAGMA user_version").Scan(&revision)
+	if revision != schemaRevision {
+		t.Errorf("user_version = %d, want %d", revision, schemaRevision)
+	}
+	if err := store.CheckFTSHealth(); err != nil {
+		t.Errorf("FTS after bulk load: %v", err)
+	}
+
+	results, err := store.Search(context.Background(), &types.SearchRequest{
+		Query: "Handler42", QueryVec: []float32{0.1, 0.2, 0.3, 0.2}, Limit: 5, Mode: types.SearchModeHybrid,
+	})
+	if err != nil {
+		t.Fatal(err)
+	}
+	if len(results) == 0 || results[0].Chunk.Name != "Handler42" {
+		t.Errorf("search after bulk load = %+v", results)
+	}
+	if got, _ := store.GetChunk(stale.Chunk.ID); got != nil {
+		t.Error("chunk of the previous index survived")
+	}
+	// The caller caches the hashes of the loaded files afterwards
+	if hashes, _ := store.GetAllFileHashes(); len(hashes) != 0 {
+		t.Errorf("file hashes of the previous index survived: %v", hashes)
+	}
+	if callers, _ := store.GetCallers("validate7", 10); len(callers) != 1 {
+		t.Errorf("callers of validate7 = %+v", callers)
+	}
+
+	// Triggers work again for incremental writes
+	if err := store.DeleteChunksByFile("pkg/file3.go"); err != nil {
+		t.Fatal(err)
+	}
+	if err := store.CheckFTSHealth(); err != nil {
+		t.Errorf("FTS after incremental delete: %v", err)
+	}
+}
+
+func TestBulkLoadInterrupted(t *testing.T) {
+	tmpDir, err := os.MkdirTemp("", "bulkloadtest")
+	if err != nil {
+		t.Fatal(err)
+	}
+	defer os.RemoveAll(tmpDir)
+	path := tmpDir + "/index.db"
+
+	store := New()
+	if err := store.Init(path); err != nil {
+		if containsString(err.Error(), "fts5") || containsString(err.Error(), "FTS5") {
+			t.Skip("FTS5 not available in this environment")
+		}
+		t.Fatal(err)
+	}
+	chunks, symbols, refs := bulkTestIndex(50)
+	if err := store.BulkLoad(chunks, symbols, refs); err != nil {
+		t.Fatal(err)
+	}
+
+	// A load that dies after its first step, with one object already
+	// restored
+	err = store.write(writeBulk, func(tx *sql.Tx) error {
+		deferred, err := dropIndexObjects(tx)
+		if err != nil {
+			return err
+		}
+		if _, err := tx.Exec("INSERT INTO metadata (key, value) VALUES (?, ?)", bulkLoadKey, jsonArray(deferred)); err != nil {
+			return err
+		}
+		if _, err := tx.Exec(deferred[0]); err != nil {
+			return err
+		}
+		_, err = tx.Exec("INSERT INTO chunks_fts(chunks_fts) VALUES('delete-all')")
+		return err
+	})
+	if err != nil {
+		t.Fatal(err)
+	}
+	store.Close()
+
+	store = New()
+	if err := store.Init(path); err != nil {
+		t.Fatalf("Init after an interrupted bulk load: %v", err)
+	}
+	defer store.Close()
+
+	var objects, markers, revision int
+	store.db.QueryRow(`SELECT COUNT(*) FROM sqlite_master WHERE name IN
+		('idx_chunks_file', 'idx_symbols_name', 'idx_refs_to', 'chunks_ai', 'chunks_ad', 'chunks_au')`).Scan(&objects)
+	if objects != 6 {
+		t.Errorf("%d of 6 indexes and triggers restored", objects)
+	}
+	store.db.QueryRow("SELECT COUNT(*) FROM metadata WHERE key = ?", bulkLoadKey).Scan(&markers)
+	if markers != 0 {
+		t.Error("bulk load marker left behind")
+	}
+	store.db.QueryRow("PRAGMA user_version").Scan(&revision)
+	if revision != schemaRevision {
+		t.Errorf("user_version = %d, want %d", revision, schemaRevision)
+	}
+	if err := store.CheckFTSHealth(); err != nil {
+		t.Errorf("FTS after finishing the load: %v", err)
+	}
+	results, err := store.Search(context.Background(), &types.SearchRequest{
+		Query: "Handler42", Limit: 5, Mode: types.SearchModeBM25,
+	})
+	if err != nil || len(results) == 0 || results[0].Chunk.Name != "Handler42" {
+		t.Errorf("search after finishing the load = %+v, %v", results, err)
+	}
+}
+
+// BenchmarkStoreIndex compares loading an index through StoreChunks,
+// StoreSymbols and StoreReferences with BulkLoad, in chunk rows per second.
+func BenchmarkStoreIndex(b *testing.B) {
+	const n = 20000
+	chunks, symbols, refs := bulkTestIndex(n)
+
+	loads := []struct {
+		name string
+		load func(s *Store) error
+	}{
+		{"Incremental", func(s *Store) error {
+			if err := s.StoreChunks(chunks); err != nil {
+				return err
+			}
+			if err := s.StoreSymbols(symbols); err != nil {
+				return err
+			}
+			return s.StoreReferences(refs)
+		}},
+		{"Bulk", func(s *Store) error {
+			return s.BulkLoad(chunks, symbols, refs)
+		}},
+	}
+
+	for _, l := range loads {
+		b.Run(l.name, func(b *testing.B) {
+			for i := 0; i < b.N; i++ {
+				b.StopTimer()
+				tmpDir, err := os.MkdirTemp("", "bulkbench")
+				if err != nil {
+					b.Fatal(err)
+				}
+				store := New()
+				if err := store.Init(tmpDir + "/bench.db"); err != nil {
+					os.RemoveAll(tmpDir)
+					b.Skipf("store not available: %v", err)
+				}
+				b.StartTimer()
+
+				if err := l.load(store); err != nil {
+					b.Fatal(err)
+				}
+
+				b.StopTimer()
+				store.Close()
+				os.RemoveAll(tmpDir)
+				b.StartTimer()
+			}
+			b.ReportMetric(float64(n*b.N)/b.Elapsed().Seconds(), "rows/s")
+		})
+	}
+}
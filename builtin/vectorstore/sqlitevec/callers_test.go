@@ -1,6 +1,8 @@
 package sqlitevec
 
 import (
+	"context"
+	"errors"
 	"os"
 	"testing"
 
@@ -83,6 +85,32 @@ func TestGetCallersWithSymbolID(t *testing.T) {
 	}
 }
 
+func TestGraphQueriesStopOnCancel(t *testing.T) {
+	store := newWriterTestStore(t)
+	chunks, symbols, refs := bulkTestIndex(100)
+	if err := store.BulkLoad(chunks, symbols, refs); err != nil {
+		t.Fatal(err)
+	}
+
+	// A cancelled tool call must not get a silently partial graph
+	ctx, cancel := context.WithCancel(context.Background())
+	cancel()
+	if _, err := store.FindSymbols(ctx, "", "", 100000); !errors.Is(err, context.Canceled) {
+		t.Errorf("FindSymbols after cancel: %v", err)
+	}
+	if _, err := store.GetAllReferences(ctx, 1000000); !errors.Is(err, context.Canceled) {
+		t.Errorf("GetAllReferences after cancel: %v", err)
+	}
+	if _, err := store.FindReferencesByKind(ctx, types.RefKindCall, 1000); !errors.Is(err, context.Canceled) {
+		t.Errorf("FindReferencesByKind after cancel: %v", err)
+	}
+
+	all, err := store.GetAllReferences(context.Background(), 1000000)
+	if err != nil || len(all) != 100 {
+		t.Errorf("GetAllReferences = %d, %v; want 100", len(all), err)
+	}
+}
+
 func TestExtractSymbolName(t *testing.T) {
 	tests := []struct {
 		input string
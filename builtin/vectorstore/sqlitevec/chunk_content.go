@@ -0,0 +1,128 @@
+package sqlitevec
+
+import (
+	"container/list"
+	"fmt"
+	"sync"
+)
+
+// With Config.CompressChunks, chunk bodies of at least minCompressedContent
+// bytes are stored compressed in chunks.content_blob with the diff codec,
+// leaving chunks.content empty. Rows stored uncompressed stay readable and
+// are compressed the next time they are stored.
+//
+// Reads inflate bodies through contentCache, so chunks returned by repeated
+// searches are decompressed once. The FTS triggers get the text through the
+// chunk_text SQL function registered on every connection.
+
+const (
+	// minCompressedContent is the smallest body worth compressing.
+	minCompressedContent = 256
+
+	// defaultContentCacheMB sizes the decompressed content cache.
+	defaultContentCacheMB = 32
+)
+
+// encodeContent returns the values of the content and content_blob columns
+// for a chunk body.
+func (s *Store) encodeContent(content string) (string, []byte, error) {
+	if !s.config.CompressChunks || len(content) < minCompressedContent {
+		return content, nil, nil
+	}
+	blob, err := compressDiff([]byte(content))
+	if err != nil {
+		return "", nil, err
+	}
+	if len(blob) >= len(content) {
+		return content, nil, nil
+	}
+	return "", blob, nil
+}
+
+// chunkContent returns the body of a chunk read with its content columns.
+func (s *Store) chunkContent(id int64, hash, content string, blob []byte) (string, error) {
+	if len(blob) == 0 {
+		return content, nil
+	}
+
+	// The hash changes with the body, so cached bodies of rows updated in
+	// place are never returned
+	key := contentKey{id: id, hash: hash}
+	if text, ok := s.contents.get(key); ok {
+		return text, nil
+	}
+	data, err := decompressDiff(blob)
+	if err != nil {
+		return "", fmt.Errorf("failed to decompress chunk content: %w", err)
+	}
+	text := string(data)
+	s.contents.add(key, text)
+	return text, nil
+}
+
+// chunkText implements chunk_text(content, content_blob).
+func chunkText(content string, blob any) (string, error) {
+	b, _ := blob.([]byte)
+	if len(b) == 0 {
+		return content, nil
+	}
+	data, err := decompressDiff(b)
+	if err != nil {
+		return "", err
+	}
+	return string(data), nil
+}
+
+type contentKey struct {
+	id   int64
+	hash string
+}
+
+type contentEntry struct {
+	key  contentKey
+	text string
+}
+
+// contentCache is an LRU of decompressed chunk bodies bounded by their
+// total size.
+type contentCache struct {
+	mu       sync.Mutex
+	maxBytes int
+	bytes    int
+	order    *list.List // Front is most recently used
+	entries  map[contentKey]*list.Element
+}
+
+func (c *contentCache) get(key contentKey) (string, bool) {
+	c.mu.Lock()
+	defer c.mu.Unlock()
+	e, ok := c.entries[key]
+	if !ok {
+		return "", false
+	}
+	c.order.MoveToFront(e)
+	return e.Value.(*contentEntry).text, true
+}
+
+func (c *contentCache) add(key contentKey, text string) {
+	c.mu.Lock()
+	defer c.mu.Unlock()
+	if len(text) > c.maxBytes/8 {
+		return // A single huge chunk would flush everything else
+	}
+	if c.entries == nil {
+		c.entries = make(map[contentKey]*list.Element)
+		c.order = list.New()
+	}
+	if _, ok := c.entries[key]; ok {
+		return
+	}
+	c.entries[key] = c.order.PushFront(&contentEntry{key: key, text: text})
+	c.bytes += len(text)
+	for c.bytes > c.maxBytes {
+		oldest := c.order.Back()
+		entry := c.order.Remove(oldest).(*contentEntry)
+		delete(c.entries, entry.key)
+		c.bytes -= len(entry.text)
+	}
+}
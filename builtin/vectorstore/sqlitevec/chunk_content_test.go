@@ -0,0 +1,118 @@
+package sqlitevec
+
+import (
+	"context"
+	"fmt"
+	"os"
+	"strings"
+	"testing"
+
+	"github.com/spetr/mcp-codewizard/pkg/types"
+)
+
+func TestContentCacheEviction(t *testing.T) {
+	c := contentCache{maxBytes: 800}
+	for i := 0; i < 10; i++ {
+		c.add(contentKey{id: int64(i), hash: "h"}, strings.Repeat("x", 100))
+	}
+	if c.bytes > c.maxBytes {
+		t.Errorf("cache holds %d bytes, limit %d", c.bytes, c.maxBytes)
+	}
+	if _, ok := c.get(contentKey{id: 0, hash: "h"}); ok {
+		t.Error("oldest entry was not evicted")
+	}
+	if _, ok := c.get(contentKey{id: 9, hash: "h"}); !ok {
+		t.Error("newest entry was evicted")
+	}
+	if _, ok := c.get(contentKey{id: 9, hash: "other"}); ok {
+		t.Error("entry returned for a different hash")
+	}
+
+	c.add(contentKey{id: 99, hash: "h"}, strings.Repeat("x", 200))
+	if _, ok := c.get(contentKey{id: 99, hash: "h"}); ok {
+		t.Error("entry larger than an eighth of the cache was kept")
+	}
+}
+
+func TestCompressedChunks(t *testing.T) {
+	tmpDir, err := os.MkdirTemp("", "compresstest")
+	if err != nil {
+		t.Fatal(err)
+	}
+	defer os.RemoveAll(tmpDir)
+
+	store := NewWithConfig(Config{CompressChunks: true})
+	if err := store.Init(tmpDir + "/test.db"); err != nil {
+		if containsString(err.Error(), "fts5") || containsString(err.Error(), "FTS5") {
+			t.Skip("FTS5 not available in this environment")
+		}
+		t.Fatal(err)
+	}
+	defer store.Close()
+
+	var body strings.Builder
+	body.WriteString("func reconcileWatcher(ctx context.Context) error {\n")
+	for i := 0; i < 40; i++ {
+		fmt.Fprintf(&body, "\tif err := step%d(ctx); err != nil {\n\t\treturn err\n\t}\n", i)
+	}
+	body.WriteString("}\n")
+	content := body.String()
+
+	chunks := []*types.ChunkWithEmbedding{
+		{Chunk: &types.Chunk{ID: "w.go:1:a", FilePath: "w.go", Language: "go", Content: content,
+			ChunkType: types.ChunkTypeFunction, Name: "reconcileWatcher", StartLine: 1, EndLine: 100, Hash: "a"},
+			Embedding: []float32{1, 0, 0, 0}},
+		{Chunk: &types.Chunk{ID: "w.go:200:b", FilePath: "w.go", Language: "go", Content: "var small = 1",
+			ChunkType: types.ChunkTypeBlock, StartLine: 200, EndLine: 200, Hash: "b"},
+			Embedding: []float32{0, 1, 0, 0}},
+	}
+	if err := store.StoreChunks(chunks); err != nil {
+		t.Fatal(err)
+	}
+
+	var stored string
+	var blobLen int
+	store.db.QueryRow("SELECT content, length(content_blob) FROM chunks WHERE key = 'w.go:1:a'").Scan(&stored, &blobLen)
+	if stored != "" || blobLen == 0 || blobLen >= len(content) {
+		t.Errorf("large chunk stored as %d text bytes and %d compressed bytes of %d", len(stored), blobLen, len(content))
+	}
+	store.db.QueryRow("SELECT content FROM chunks WHERE key = 'w.go:200:b'").Scan(&stored)
+	if stored != "var small = 1" {
+		t.Errorf("small chunk stored as %q", stored)
+	}
+
+	for i := 0; i < 2; i++ { // The second read is served from the cache
+		got, err := store.GetChunk("w.go:1:a")
+		if err != nil || got == nil || got.Content != content {
+			t.Fatalf("GetChunk = %v, %v", got, err)
+		}
+	}
+
+	search := func() []*types.SearchResult {
+		t.Helper()
+		results, err := store.Search(context.Background(), &types.SearchRequest{
+			Query: "step17", Limit: 10, Mode: types.SearchModeBM25,
+		})
+		if err != nil {
+			t.Fatal(err)
+		}
+		return results
+	}
+	if results := search(); len(results) != 1 || results[0].Chunk.Content != content {
+		t.Fatalf("BM25 search over compressed content = %+v", results)
+	}
+
+	if err := store.RebuildFTS(); err != nil {
+		t.Fatal(err)
+	}
+	if results := search(); len(results) != 1 {
+		t.Errorf("after rebuild: %d results", len(results))
+	}
+
+	if err := store.DeleteChunksByFile("w.go"); err != nil {
+		t.Fatal(err)
+	}
+	if results := search(); len(results) != 0 {
+		t.Errorf("deleted chunk still found: %+v", results)
+	}
+}
@@ -0,0 +1,404 @@
+package sqlitevec
+
+import (
+	"container/heap"
+	"context"
+	"database/sql"
+	"fmt"
+
+	"github.com/spetr/mcp-codewizard/pkg/types"
+)
+
+// graphWindow is the number of generations whose parent edges are loaded per
+// query while walking the commit graph.
+const graphWindow = 1024
+
+// commitParents returns all parents of a commit, falling back to ParentHash
+// for callers that only know the first parent.
+func commitParents(c *types.Commit) []string {
+	if len(c.ParentHashes) > 0 {
+		return c.ParentHashes
+	}
+	if c.ParentHash != "" {
+		return []string{c.ParentHash}
+	}
+	return nil
+}
+
+// computeGenerations assigns generation numbers (1 + max parent generation)
+// to a batch of commits. Parents outside the batch are looked up in the store;
+// parents that were never indexed count as generation 0.
+//
+// Generations of already stored descendants are not revisited, so indexing
+// older history after newer history can leave them too low; a forced reindex
+// recomputes the whole graph.
+func computeGenerations(tx *sql.Tx, commits []*types.Commit) (map[string]int, error) {
+	byHash := make(map[string]*types.Commit, len(commits))
+	for _, c := range commits {
+		byHash[c.Hash] = c
+	}
+
+	var external []string
+	for _, c := range commits {
+		for _, p := range commitParents(c) {
+			if _, ok := byHash[p]; !ok {
+				external = append(external, p)
+			}
+		}
+	}
+
+	generations := make(map[string]int, len(commits)+len(external))
+	if len(external) > 0 {
+		rows, err := tx.Query(`
+			SELECT hash, generation FROM commits
+			WHERE hash IN (SELECT value FROM json_each(?))
+		`, jsonArray(external))
+		if err != nil {
+			return nil, err
+		}
+		for rows.Next() {
+			var hash string
+			var gen int
+			if err := rows.Scan(&hash, &gen); err != nil {
+				rows.Close()
+				return nil, err
+			}
+			generations[hash] = gen
+		}
+		rows.Close()
+		if err := rows.Err(); err != nil {
+			return nil, err
+		}
+	}
+
+	var visit func(c *types.Commit) int
+	visit = func(c *types.Commit) int {
+		if gen, ok := generations[c.Hash]; ok {
+			return gen
+		}
+		generations[c.Hash] = 0 // guards against malformed cyclic input
+
+		gen := 0
+		for _, p := range commitParents(c) {
+			pg := generations[p]
+			if pc, ok := byHash[p]; ok {
+				pg = visit(pc)
+			}
+			if pg > gen {
+				gen = pg
+			}
+		}
+		generations[c.Hash] = gen + 1
+		return gen + 1
+	}
+	for _, c := range commits {
+		visit(c)
+	}
+
+	return generations, nil
+}
+
+// commitGraphVersion is stored in git_index_meta once commit_parents and
+// the generation numbers of commits stored before them have been backfilled.
+const commitGraphVersion = "1"
+
+// backfillCommitGraph fills commit_parents from commits.parent_hash and
+// recomputes all generation numbers, for databases whose commits were
+// stored before the commit graph was tracked. Runs once per database.
+func (s *Store) backfillCommitGraph() error {
+	var version string
+	err := s.db.QueryRow("SELECT value FROM git_index_meta WHERE key = 'commit_graph_version'").Scan(&version)
+	if err != nil && err != sql.ErrNoRows {
+		return err
+	}
+	if version == commitGraphVersion {
+		return nil
+	}
+
+	tx, err := s.db.Begin()
+	if err != nil {
+		return err
+	}
+	defer tx.Rollback()
+
+	// Older databases only kept the first parent
+	_, err = tx.Exec(`
+		INSERT OR IGNORE INTO commit_parents (commit_hash, parent_hash, ordinal)
+		SELECT hash, parent_hash, 0 FROM commits
+		WHERE parent_hash IS NOT NULL AND parent_hash != ''
+	`)
+	if err != nil {
+		return fmt.Errorf("failed to backfill commit parents: %w", err)
+	}
+
+	generations, err := graphGenerations(tx)
+	if err != nil {
+		return fmt.Errorf("failed to compute commit generations: %w", err)
+	}
+	stmt, err := tx.Prepare("UPDATE commits SET generation = ? WHERE hash = ? AND generation != ?")
+	if err != nil {
+		return err
+	}
+	defer stmt.Close()
+	for hash, gen := range generations {
+		if _, err := stmt.Exec(gen, hash, gen); err != nil {
+			return fmt.Errorf("failed to update generation of %s: %w", hash, err)
+		}
+	}
+
+	_, err = tx.Exec(`
+		INSERT OR REPLACE INTO git_index_meta (key, value)
+		VALUES ('commit_graph_version', ?)
+	`, commitGraphVersion)
+	if err != nil {
+		return err
+	}
+
+	return tx.Commit()
+}
+
+// graphGenerations computes the generation numbers of all stored commits in
+// topological order, parents first, with the same rule as
+// computeGenerations. Commits on malformed cycles are left out.
+func graphGenerations(tx *sql.Tx) (map[string]int, error) {
+	rows, err := tx.Query(`
+		SELECT c.hash, cp.parent_hash
+		FROM commits c LEFT JOIN commit_parents cp ON cp.commit_hash = c.hash
+	`)
+	if err != nil {
+		return nil, err
+	}
+	parents := make(map[string][]string)
+	for rows.Next() {
+		var hash string
+		var parent sql.NullString
+		if err := rows.Scan(&hash, &parent); err != nil {
+			rows.Close()
+			return nil, err
+		}
+		if _, ok := parents[hash]; !ok {
+			parents[hash] = nil
+		}
+		if parent.Valid {
+			parents[hash] = append(parents[hash], parent.String)
+		}
+	}
+	rows.Close()
+	if err := rows.Err(); err != nil {
+		return nil, err
+	}
+
+	// Only edges to indexed parents order the walk
+	children := make(map[string][]string)
+	pending := make(map[string]int, len(parents))
+	var ready []string
+	for hash, ps := range parents {
+		for _, p := range ps {
+			if _, ok := parents[p]; ok {
+				children[p] = append(children[p], hash)
+				pending[hash]++
+			}
+		}
+		if pending[hash] == 0 {
+			ready = append(ready, hash)
+		}
+	}
+
+	generations := make(map[string]int, len(parents))
+	for len(ready) > 0 {
+		hash := ready[len(ready)-1]
+		ready = ready[:len(ready)-1]
+
+		gen := 0
+		for _, p := range parents[hash] {
+			gen = max(gen, generations[p])
+		}
+		generations[hash] = gen + 1
+
+		for _, child := range children[hash] {
+			if pending[child]--; pending[child] == 0 {
+				ready = append(ready, child)
+			}
+		}
+	}
+
+	return generations, nil
+}
+
+// resolveIndexedRef resolves a full or short hash to an indexed commit and its
+// generation. An empty ref or "HEAD" resolves to the newest indexed commit.
+// Returns an empty hash if the commit is not indexed.
+func (s *Store) resolveIndexedRef(ctx context.Context, ref string) (string, int, error) {
+	var row *sql.Row
+	if ref == "" || ref == "HEAD" {
+		row = s.db.QueryRowContext(ctx, `
+			SELECT hash, generation FROM commits
+			ORDER BY generation DESC, date DESC
+			LIMIT 1
+		`)
+	} else {
+		row = s.db.QueryRowContext(ctx, `
+			SELECT hash, generation FROM commits
+			WHERE hash = ? OR short_hash = ?
+			LIMIT 1
+		`, ref, ref)
+	}
+
+	var hash string
+	var gen int
+	err := row.Scan(&hash, &gen)
+	if err == sql.ErrNoRows {
+		return "", 0, nil
+	}
+	return hash, gen, err
+}
+
+// Walk flags for resolveCommitRange.
+const (
+	reachableFromBad  uint8 = 1
+	reachableFromGood uint8 = 2
+)
+
+// resolveCommitRange returns the hashes of indexed commits reachable from bad
+// but not from good (git's good..bad), in walk order (highest generation first).
+//
+// Commits are visited highest generation first, so a commit's reachability is
+// final when it is popped and the walk stops as soon as every queued commit is
+// reachable from good. Parent edges are loaded in generation windows rather
+// than per commit.
+func (s *Store) resolveCommitRange(ctx context.Context, good, bad string) ([]string, error) {
+	badHash, badGen, err := s.resolveIndexedRef(ctx, bad)
+	if err != nil || badHash == "" {
+		return nil, err
+	}
+
+	var goodHash string
+	var goodGen int
+	if good != "" {
+		goodHash, goodGen, err = s.resolveIndexedRef(ctx, good)
+		if err != nil {
+			return nil, err
+		}
+	}
+
+	flags := make(map[string]uint8)
+	queued := make(map[string]bool)
+	visited := make(map[string]bool)
+	queue := &generationHeap{}
+	pendingBad := 0 // queued commits reachable from bad only
+
+	push := func(hash string, gen int, flag uint8) {
+		if visited[hash] {
+			return
+		}
+		old := flags[hash]
+		updated := old | flag
+		flags[hash] = updated
+		if queued[hash] {
+			if old == reachableFromBad && updated != reachableFromBad {
+				pendingBad--
+			}
+			return
+		}
+		queued[hash] = true
+		heap.Push(queue, generationItem{hash: hash, generation: gen})
+		if updated == reachableFromBad {
+			pendingBad++
+		}
+	}
+
+	push(badHash, badGen, reachableFromBad)
+	if goodHash != "" {
+		push(goodHash, goodGen, reachableFromGood)
+	}
+
+	parents := make(map[string][]generationItem)
+	loadedFrom := queue.items[0].generation + 1 // lowest generation with loaded edges
+
+	var result []string
+	for queue.Len() > 0 && pendingBad > 0 {
+		item := heap.Pop(queue).(generationItem)
+		delete(queued, item.hash)
+		visited[item.hash] = true
+
+		flag := flags[item.hash]
+		if flag == reachableFromBad {
+			pendingBad--
+			result = append(result, item.hash)
+		}
+
+		for item.generation < loadedFrom && loadedFrom > 0 {
+			hi := loadedFrom - 1
+			lo := hi - graphWindow + 1
+			if lo < 0 {
+				lo = 0
+			}
+			if err := s.loadParentEdges(ctx, lo, hi, parents); err != nil {
+				return nil, err
+			}
+			loadedFrom = lo
+		}
+
+		for _, p := range parents[item.hash] {
+			push(p.hash, p.generation, flag)
+		}
+	}
+
+	return result, nil
+}
+
+// loadParentEdges loads parent edges of all commits with generation in
+// [lo, hi]. Parents that are not indexed are skipped.
+func (s *Store) loadParentEdges(ctx context.Context, lo, hi int, into map[string][]generationItem) error {
+	rows, err := s.queryContext(ctx, `
+		SELECT cp.commit_hash, cp.parent_hash, pc.generation
+		FROM commit_parents cp
+		JOIN commits c ON c.hash = cp.commit_hash
+		JOIN commits pc ON pc.hash = cp.parent_hash
+		WHERE c.generation BETWEEN ? AND ?
+		ORDER BY cp.commit_hash, cp.ordinal
+	`, lo, hi)
+	if err != nil {
+		return err
+	}
+	defer rows.Close()
+
+	for rows.Next() {
+		var child string
+		var parent generationItem
+		if err := rows.Scan(&child, &parent.hash, &parent.generation); err != nil {
+			return err
+		}
+		into[child] = append(into[child], parent)
+	}
+
+	return rows.Err()
+}
+
+// generationItem is a commit queued for the graph walk.
+type generationItem struct {
+	hash       string
+	generation int
+}
+
+// generationHeap is a max-heap of commits ordered by generation.
+type generationHeap struct {
+	items []generationItem
+}
+
+func (h *generationHeap) Len() int { return len(h.items) }
+
+func (h *generationHeap) Less(i, j int) bool {
+	return h.items[i].generation > h.items[j].generation
+}
+
+func (h *generationHeap) Swap(i, j int) { h.items[i], h.items[j] = h.items[j], h.items[i] }
+
+func (h *generationHeap) Push(x any) { h.items = append(h.items, x.(generationItem)) }
+
+func (h *generationHeap) Pop() any {
+	n := len(h.items)
+	item := h.items[n-1]
+	h.items = h.items[:n-1]
+	return item
+}
@@ -0,0 +1,227 @@
+package sqlitevec
+
+import (
+	"database/sql"
+	"fmt"
+	"math"
+	"strings"
+	"time"
+)
+
+// Memory confidence decays lazily. memories.confidence holds the base
+// confidence as of confidence_at, and the effective confidence at time t is
+//
+//	confidence * 2^(-(t - confidence_at) / half_life)
+//
+// computed when a memory is read. Nothing is rewritten as time passes.
+//
+// confidence_key = confidence_at + half_life * log2(confidence) is the time
+// at which the decayed confidence would be 1, so a minimum confidence filter
+// becomes a range scan: confidence_key >= now + half_life * log2(min). Keys
+// only have to be rewritten when the half-life changes.
+
+// confidenceHalfLifeKey is the metadata key of the half-life in seconds.
+// Without it confidence does not decay.
+const confidenceHalfLifeKey = "memory_confidence_half_life"
+
+// minBaseConfidence keeps log2 finite for zero confidence.
+const minBaseConfidence = 1e-6
+
+// createConfidenceSchema adds the decay columns and loads the half-life.
+func (s *Store) createConfidenceSchema() error {
+	if err := s.addColumnIfMissing("memories", "confidence_at", "INTEGER"); err != nil {
+		return err
+	}
+	if err := s.addColumnIfMissing("memories", "confidence_key", "REAL"); err != nil {
+		return err
+	}
+	if _, err := s.db.Exec("CREATE INDEX IF NOT EXISTS idx_memories_confidence_key ON memories(confidence_key)"); err != nil {
+		return err
+	}
+	if err := s.loadConfidenceHalfLife(); err != nil {
+		return err
+	}
+
+	// Rows written before lazy decay decayed from their creation time
+	var missing int
+	if err := s.db.QueryRow("SELECT COUNT(*) FROM memories WHERE confidence_at IS NULL").Scan(&missing); err != nil {
+		return err
+	}
+	if missing == 0 {
+		return nil
+	}
+
+	tx, err := s.db.Begin()
+	if err != nil {
+		return err
+	}
+	defer tx.Rollback()
+
+	if _, err := tx.Exec("UPDATE memories SET confidence_at = created_at WHERE confidence_at IS NULL"); err != nil {
+		return fmt.Errorf("failed to backfill confidence_at: %w", err)
+	}
+	if err := s.rebuildConfidenceKeys(tx, s.confidenceHalfLife.Load()); err != nil {
+		return err
+	}
+
+	return tx.Commit()
+}
+
+// loadConfidenceHalfLife reads the half-life from the metadata table.
+func (s *Store) loadConfidenceHalfLife() error {
+	var value string
+	err := s.db.QueryRow("SELECT value FROM metadata WHERE key = ?", confidenceHalfLifeKey).Scan(&value)
+	if err == sql.ErrNoRows {
+		return nil
+	}
+	if err != nil {
+		return fmt.Errorf("failed to read confidence half-life: %w", err)
+	}
+
+	var halfLife int64
+	if _, err := fmt.Sscan(value, &halfLife); err == nil {
+		s.confidenceHalfLife.Store(halfLife)
+	}
+	return nil
+}
+
+// confidenceKey returns the confidence_key column value, NULL when
+// confidence does not decay.
+func confidenceKey(base float32, at, halfLife int64) sql.NullFloat64 {
+	if halfLife <= 0 {
+		return sql.NullFloat64{}
+	}
+	b := math.Max(float64(base), minBaseConfidence)
+	return sql.NullFloat64{Float64: float64(at) + float64(halfLife)*math.Log2(b), Valid: true}
+}
+
+// decayedConfidence returns the effective confidence of a base confidence
+// set at time at.
+func (s *Store) decayedConfidence(base float32, at int64) float32 {
+	halfLife := s.confidenceHalfLife.Load()
+	if halfLife <= 0 || at <= 0 {
+		return base
+	}
+	age := time.Now().Unix() - at
+	if age <= 0 {
+		return base
+	}
+	return base * float32(math.Exp2(-float64(age)/float64(halfLife)))
+}
+
+// minConfidenceFilter returns the filter clause for an effective confidence
+// of at least min.
+func (s *Store) minConfidenceFilter(min float32) (string, any) {
+	halfLife := s.confidenceHalfLife.Load()
+	if halfLife <= 0 {
+		return " AND m.confidence >= ?", min
+	}
+	threshold := float64(time.Now().Unix()) + float64(halfLife)*math.Log2(float64(min))
+	return " AND m.confidence_key >= ?", threshold
+}
+
+// rebuildConfidenceKeys recomputes confidence_key for every memory.
+func (s *Store) rebuildConfidenceKeys(tx *sql.Tx, halfLife int64) error {
+	if halfLife <= 0 {
+		_, err := tx.Exec("UPDATE memories SET confidence_key = NULL WHERE confidence_key IS NOT NULL")
+		return err
+	}
+
+	rows, err := tx.Query("SELECT rowid, confidence, confidence_at FROM memories")
+	if err != nil {
+		return fmt.Errorf("failed to read confidence: %w", err)
+	}
+	type keyRow struct {
+		rowid int64
+		key   sql.NullFloat64
+	}
+	var keys []keyRow
+	for rows.Next() {
+		var rowid, at int64
+		var base float32
+		if err := rows.Scan(&rowid, &base, &at); err != nil {
+			rows.Close()
+			return err
+		}
+		keys = append(keys, keyRow{rowid, confidenceKey(base, at, halfLife)})
+	}
+	rows.Close()
+	if err := rows.Err(); err != nil {
+		return err
+	}
+
+	stmt, err := tx.Prepare("UPDATE memories SET confidence_key = ? WHERE rowid = ?")
+	if err != nil {
+		return err
+	}
+	defer stmt.Close()
+
+	for _, k := range keys {
+		if _, err := stmt.Exec(k.key, k.rowid); err != nil {
+			return fmt.Errorf("failed to update confidence key: %w", err)
+		}
+	}
+	return nil
+}
+
+// DecayConfidence sets the half-life of memory confidence. Decay is applied
+// when memories are read, measured from when their confidence was last set;
+// calling this again with the same half-life is a no-op.
+func (s *Store) DecayConfidence(halfLifeDays int) error {
+	if halfLifeDays <= 0 {
+		halfLifeDays = 30
+	}
+	halfLife := int64(halfLifeDays) * 24 * 60 * 60
+
+	if halfLife == s.confidenceHalfLife.Load() {
+		return nil
+	}
+
+	// The keys live with the memories, the half-life in the index metadata,
+	// which may be separate files. It is saved last, so a failed rebuild is
+	// redone by the next call.
+	err := s.writeTo(subsysMemory, writeInteractive, func(tx *sql.Tx) error {
+		return s.rebuildConfidenceKeys(tx, halfLife)
+	})
+	if err != nil {
+		return err
+	}
+	err = s.write(writeInteractive, func(tx *sql.Tx) error {
+		_, err := tx.Exec("INSERT OR REPLACE INTO metadata (key, value) VALUES (?, ?)",
+			confidenceHalfLifeKey, fmt.Sprint(halfLife))
+		return err
+	})
+	if err != nil {
+		return fmt.Errorf("failed to save confidence half-life: %w", err)
+	}
+
+	s.confidenceHalfLife.Store(halfLife)
+	return nil
+}
+
+// updateMemoriesFTSTrigger limits the memories FTS update trigger to the
+// indexed columns, so bookkeeping updates (access stats, confidence keys)
+// do not rewrite the FTS index. Older databases have an unrestricted one.
+func (s *Store) updateMemoriesFTSTrigger() error {
+	var triggerSQL string
+	err := s.db.QueryRow("SELECT sql FROM sqlite_master WHERE type = 'trigger' AND name = 'memories_au'").Scan(&triggerSQL)
+	if err == nil && strings.Contains(triggerSQL, "UPDATE OF") {
+		return nil
+	}
+	if err != nil && err != sql.ErrNoRows {
+		return err
+	}
+
+	if _, err := s.db.Exec("DROP TRIGGER IF EXISTS memories_au"); err != nil {
+		return err
+	}
+	_, err = s.db.Exec(`
+		CREATE TRIGGER memories_au AFTER UPDATE OF id, content, summary ON memories BEGIN
+			INSERT INTO memories_fts(memories_fts, rowid, id, content, summary)
+			VALUES('delete', old.rowid, old.id, old.content, old.summary);
+			INSERT INTO memories_fts(rowid, id, content, summary)
+			VALUES (new.rowid, new.id, new.content, new.summary);
+		END
+	`)
+	return err
+}
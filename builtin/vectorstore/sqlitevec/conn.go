@@ -0,0 +1,310 @@
+package sqlitevec
+
+import (
+	"container/list"
+	"context"
+	"database/sql"
+	"database/sql/driver"
+	"fmt"
+	"runtime"
+	"sync"
+	"sync/atomic"
+
+	sqlite3 "github.com/mattn/go-sqlite3"
+)
+
+// Config tunes the SQLite connections and storage of a store. Zero
+// connection settings are sized from the database size and available memory
+// when the store is opened.
+type Config struct {
+	CacheSizeMB int    // Page cache per connection
+	MmapSizeMB  int    // Memory-mapped reads; negative disables
+	TempStore   string // "memory" (default) or "file"
+	MaxConns    int    // Open connections, the writer's included
+
+	CompressChunks bool // Store chunk bodies compressed (chunk_content.go)
+	ContentCacheMB int  // Decompressed chunk body cache; 0 = default
+
+	MaintenanceBudgetMB int // Writes per idle maintenance pass (maintenance.go); 0 = default, negative disables
+
+	SplitDatabases bool // Git history and memories in files of their own (databases.go)
+}
+
+const mb = 1 << 20
+
+// connSettings are the resolved per-connection settings.
+type connSettings struct {
+	cacheKB   int
+	mmapBytes int64
+	tempStore string
+	maxConns  int
+}
+
+// resolveSettings fills in the zero values of cfg. availMem is the
+// available system memory in bytes, 0 if unknown.
+func resolveSettings(cfg Config, dbSize, availMem int64) connSettings {
+	st := connSettings{
+		tempStore: "MEMORY",
+		maxConns:  cfg.MaxConns,
+	}
+	if cfg.TempStore == "file" {
+		st.tempStore = "FILE"
+	}
+	if st.maxConns <= 0 {
+		st.maxConns = min(max(runtime.NumCPU(), 4), 16)
+	}
+
+	// Map the whole database with room to grow, within a quarter of the
+	// free memory; mapped pages are shared by all connections
+	switch {
+	case cfg.MmapSizeMB < 0:
+		st.mmapBytes = 0
+	case cfg.MmapSizeMB > 0:
+		st.mmapBytes = int64(cfg.MmapSizeMB) * mb
+	default:
+		limit := int64(256 * mb)
+		if availMem > 0 {
+			limit = min(availMem/4, 1024*mb)
+		}
+		st.mmapBytes = min(max(dbSize*2, 64*mb), limit)
+	}
+
+	// The page cache is per connection; together they get at most an
+	// eighth of the free memory
+	if cfg.CacheSizeMB > 0 {
+		st.cacheKB = cfg.CacheSizeMB * 1024
+	} else {
+		cache := min(max(dbSize/4, 8*mb), 64*mb)
+		if availMem > 0 {
+			cache = min(cache, availMem/8/int64(st.maxConns))
+		}
+		st.cacheKB = int(max(cache, 2*mb) / 1024)
+	}
+
+	return st
+}
+
+// pragmas returns the statements run on every new connection.
+func (st connSettings) pragmas() []string {
+	return []string{
+		fmt.Sprintf("PRAGMA cache_size = -%d", st.cacheKB),
+		fmt.Sprintf("PRAGMA mmap_size = %d", st.mmapBytes),
+		"PRAGMA temp_store = " + st.tempStore,
+		// INSERT OR REPLACE fires the delete triggers of replaced rows, which
+		// keep the FTS tables and stat_counts in step
+		"PRAGMA recursive_triggers = ON",
+	}
+}
+
+// attachedPragmas returns the statements run for an attached database file.
+// The DSN sets journal mode, synchronous and auto_vacuum of the main one.
+func (st connSettings) attachedPragmas(schema string) []string {
+	return []string{
+		fmt.Sprintf("PRAGMA %s.auto_vacuum = INCREMENTAL", schema),
+		fmt.Sprintf("PRAGMA %s.journal_mode = WAL", schema),
+		fmt.Sprintf("PRAGMA %s.synchronous = NORMAL", schema),
+		fmt.Sprintf("PRAGMA %s.cache_size = -%d", schema, st.cacheKB),
+		fmt.Sprintf("PRAGMA %s.mmap_size = %d", schema, st.mmapBytes),
+	}
+}
+
+// dsnOptions returns the DSN options of the store's connections. WAL mode
+// for concurrent reads. Writes of this process are serialized by the
+// writers; busy_timeout waits out other processes. Write transactions take
+// the write lock up front instead of failing to upgrade a read lock when
+// another process wrote in between: with one database file through
+// immediate transactions, with split files, where that would lock every
+// attached file, through the writer's first statement (writeLockStatement).
+// New databases keep free pages for idle maintenance to release
+// (maintenance.go).
+func dsnOptions(immediate bool) string {
+	opts := "_journal_mode=WAL&_synchronous=NORMAL&_busy_timeout=5000&_auto_vacuum=incremental"
+	if immediate {
+		opts += "&_txlock=immediate"
+	}
+	return opts
+}
+
+// attachment is a database file attached to every connection.
+type attachment struct {
+	schema string
+	path   string
+}
+
+// connector opens connections initialized with the store's settings.
+type connector struct {
+	dsn    string
+	driver *sqlite3.SQLiteDriver
+}
+
+func newConnector(dsn string, st connSettings, attached []attachment) *connector {
+	pragmas := st.pragmas()
+	return &connector{
+		dsn: dsn,
+		driver: &sqlite3.SQLiteDriver{
+			ConnectHook: func(conn *sqlite3.SQLiteConn) error {
+				for _, p := range pragmas {
+					if _, err := conn.Exec(p, nil); err != nil {
+						return fmt.Errorf("failed to run %q: %w", p, err)
+					}
+				}
+				for _, a := range attached {
+					if _, err := conn.Exec("ATTACH DATABASE ? AS "+a.schema, []driver.Value{a.path}); err != nil {
+						return fmt.Errorf("failed to attach %s: %w", a.path, err)
+					}
+					for _, p := range st.attachedPragmas(a.schema) {
+						if _, err := conn.Exec(p, nil); err != nil {
+							return fmt.Errorf("failed to run %q: %w", p, err)
+						}
+					}
+				}
+				// Used by the FTS triggers to index compressed chunk bodies
+				if err := conn.RegisterFunc("chunk_text", chunkText, true); err != nil {
+					return fmt.Errorf("failed to register chunk_text: %w", err)
+				}
+				return nil
+			},
+		},
+	}
+}
+
+func (c *connector) Connect(context.Context) (driver.Conn, error) {
+	return c.driver.Open(c.dsn)
+}
+
+func (c *connector) Driver() driver.Driver {
+	return c.driver
+}
+
+// maxCachedStmts bounds the statement cache. The least recently used
+// statement is closed to make room for a new one.
+const maxCachedStmts = 512
+
+// stmtCache holds prepared statements keyed by their SQL text. database/sql
+// prepares a statement on each connection the first time it runs there and
+// keeps it, so repeated lookups skip parsing and planning. Queries whose SQL
+// varies with their arguments bind lists with json_each instead, so they
+// map to one entry.
+type stmtCache struct {
+	mu       sync.Mutex
+	stmts    map[string]*cachedStmt
+	lru      list.List // *cachedStmt, most recently used first
+	disabled bool      // Benchmarks compare against unprepared queries
+}
+
+// cachedStmt is a cache entry. An evicted statement stays open until the
+// queries that took it have started. refs and evicted are atomic so that
+// release does not wait for the cache lock while its query holds a
+// connection; closing a statement twice is harmless.
+type cachedStmt struct {
+	query   string
+	stmt    *sql.Stmt
+	elem    *list.Element
+	refs    atomic.Int32
+	evicted atomic.Bool
+}
+
+// get returns the prepared statement for query and a function to call once
+// the statement has been run, or nil if it cannot be prepared; callers then
+// run the query unprepared.
+func (c *stmtCache) get(db *sql.DB, query string) (*sql.Stmt, func()) {
+	c.mu.Lock()
+	if c.disabled {
+		c.mu.Unlock()
+		return nil, nil
+	}
+	if entry := c.take(query); entry != nil {
+		c.mu.Unlock()
+		return entry.stmt, entry.release
+	}
+	c.mu.Unlock()
+
+	// Preparing waits for a connection, which queries holding the lock
+	// would never give back. A failed prepare (e.g. a table not created
+	// yet) is not cached; the unprepared query reports the error
+	stmt, err := db.Prepare(query)
+	if err != nil {
+		return nil, nil
+	}
+
+	c.mu.Lock()
+	defer c.mu.Unlock()
+	if entry := c.take(query); entry != nil {
+		// Another caller prepared it meanwhile
+		stmt.Close()
+		return entry.stmt, entry.release
+	}
+	if c.stmts == nil {
+		c.stmts = make(map[string]*cachedStmt)
+	}
+	if len(c.stmts) >= maxCachedStmts {
+		c.evict(c.lru.Back().Value.(*cachedStmt))
+	}
+	entry := &cachedStmt{query: query, stmt: stmt}
+	entry.elem = c.lru.PushFront(entry)
+	c.stmts[query] = entry
+	entry.refs.Add(1)
+	return entry.stmt, entry.release
+}
+
+// take returns the cached entry for query, if any, and counts its new user.
+// Called with c.mu held.
+func (c *stmtCache) take(query string) *cachedStmt {
+	entry := c.stmts[query]
+	if entry != nil {
+		c.lru.MoveToFront(entry.elem)
+		entry.refs.Add(1)
+	}
+	return entry
+}
+
+// evict removes an entry; it is closed now or by its last user. Called with
+// c.mu held.
+func (c *stmtCache) evict(entry *cachedStmt) {
+	c.lru.Remove(entry.elem)
+	delete(c.stmts, entry.query)
+	entry.evicted.Store(true)
+	if entry.refs.Load() == 0 {
+		entry.stmt.Close()
+	}
+}
+
+func (e *cachedStmt) release() {
+	if e.refs.Add(-1) == 0 && e.evicted.Load() {
+		e.stmt.Close()
+	}
+}
+
+func (c *stmtCache) close() {
+	c.mu.Lock()
+	defer c.mu.Unlock()
+	for _, entry := range c.stmts {
+		entry.stmt.Close()
+	}
+	c.stmts = nil
+	c.lru.Init()
+}
+
+// queryContext runs a read query through the statement cache.
+func (s *Store) queryContext(ctx context.Context, query string, args ...any) (*sql.Rows, error) {
+	if stmt, release := s.stmts.get(s.db, query); stmt != nil {
+		// Open rows keep their connection's statement alive after release
+		defer release()
+		return stmt.QueryContext(ctx, args...)
+	}
+	return s.db.QueryContext(ctx, query, args...)
+}
+
+// query runs a read query through the statement cache.
+func (s *Store) query(query string, args ...any) (*sql.Rows, error) {
+	return s.queryContext(context.Background(), query, args...)
+}
+
+// queryRow runs a single-row query through the statement cache.
+func (s *Store) queryRow(query string, args ...any) *sql.Row {
+	if stmt, release := s.stmts.get(s.db, query); stmt != nil {
+		defer release()
+		return stmt.QueryRow(args...)
+	}
+	return s.db.QueryRow(query, args...)
+}
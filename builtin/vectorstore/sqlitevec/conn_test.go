@@ -0,0 +1,266 @@
+package sqlitevec
+
+import (
+	"database/sql"
+	"fmt"
+	"os"
+	"testing"
+	"time"
+
+	"github.com/spetr/mcp-codewizard/pkg/types"
+)
+
+func TestResolveSettings(t *testing.T) {
+	const gb = 1024 * mb
+
+	t.Run("Explicit", func(t *testing.T) {
+		st := resolveSettings(Config{CacheSizeMB: 16, MmapSizeMB: 128, TempStore: "file", MaxConns: 3}, 0, 0)
+		if st.cacheKB != 16*1024 || st.mmapBytes != 128*mb || st.tempStore != "FILE" || st.maxConns != 3 {
+			t.Errorf("got %+v", st)
+		}
+	})
+
+	t.Run("MmapDisabled", func(t *testing.T) {
+		if st := resolveSettings(Config{MmapSizeMB: -1}, gb, 16*gb); st.mmapBytes != 0 {
+			t.Errorf("mmap = %d, want 0", st.mmapBytes)
+		}
+	})
+
+	t.Run("SmallDatabase", func(t *testing.T) {
+		st := resolveSettings(Config{MaxConns: 4}, 10*mb, 16*gb)
+		if st.mmapBytes != 64*mb {
+			t.Errorf("mmap = %d, want the 64 MiB minimum", st.mmapBytes)
+		}
+		if st.cacheKB != 8*1024 {
+			t.Errorf("cache = %d KiB, want the 8 MiB minimum", st.cacheKB)
+		}
+		if st.tempStore != "MEMORY" {
+			t.Errorf("temp_store = %s", st.tempStore)
+		}
+	})
+
+	t.Run("LargeDatabase", func(t *testing.T) {
+		st := resolveSettings(Config{MaxConns: 4}, 2*gb, 16*gb)
+		if st.mmapBytes != gb {
+			t.Errorf("mmap = %d, want the 1 GiB cap", st.mmapBytes)
+		}
+		if st.cacheKB != 64*1024 {
+			t.Errorf("cache = %d KiB, want the 64 MiB cap", st.cacheKB)
+		}
+	})
+
+	t.Run("LowMemory", func(t *testing.T) {
+		st := resolveSettings(Config{MaxConns: 8}, gb, 256*mb)
+		if st.mmapBytes != 64*mb {
+			t.Errorf("mmap = %d, want a quarter of free memory", st.mmapBytes)
+		}
+		if st.cacheKB != 4*1024 {
+			t.Errorf("cache = %d KiB, want an eighth of free memory per connection", st.cacheKB)
+		}
+	})
+
+	t.Run("UnknownMemory", func(t *testing.T) {
+		if st := resolveSettings(Config{}, 4*gb, 0); st.mmapBytes != 256*mb {
+			t.Errorf("mmap = %d, want the 256 MiB conservative cap", st.mmapBytes)
+		}
+	})
+}
+
+func TestStmtCacheEviction(t *testing.T) {
+	db, err := sql.Open("sqlite3", ":memory:")
+	if err != nil {
+		t.Fatal(err)
+	}
+	defer db.Close()
+
+	var cache stmtCache
+	defer cache.close()
+	query := func(i int) string { return fmt.Sprintf("SELECT %d", i) }
+	get := func(i int) (*sql.Stmt, func()) {
+		t.Helper()
+		stmt, release := cache.get(db, query(i))
+		if stmt == nil {
+			t.Fatalf("%q not prepared", query(i))
+		}
+		return stmt, release
+	}
+
+	for i := 0; i < maxCachedStmts; i++ {
+		_, release := get(i)
+		release()
+	}
+	// Statement 2 is in use while it is evicted
+	held, releaseHeld := get(2)
+	for _, i := range []int{0, 2} {
+		_, release := get(i)
+		release()
+	}
+
+	// Statements 1 and 3 are the least recently used
+	for i := maxCachedStmts; i < maxCachedStmts+2; i++ {
+		_, release := get(i)
+		release()
+	}
+	if len(cache.stmts) != maxCachedStmts {
+		t.Errorf("%d statements cached, want %d", len(cache.stmts), maxCachedStmts)
+	}
+	for i, want := range map[int]bool{0: true, 1: false, 2: true, 3: false, 4: true, maxCachedStmts + 1: true} {
+		if got := cache.stmts[query(i)] != nil; got != want {
+			t.Errorf("%q cached = %v, want %v", query(i), got, want)
+		}
+	}
+
+	// Evicting a statement in use defers closing it to its last user
+	for i := maxCachedStmts + 2; i < 2*maxCachedStmts+2; i++ {
+		_, release := get(i)
+		release()
+	}
+	if cache.stmts[query(2)] != nil {
+		t.Fatal("statement 2 not evicted")
+	}
+	var n int
+	if err := held.QueryRow().Scan(&n); err != nil || n != 2 {
+		t.Errorf("evicted statement in use = %d, %v", n, err)
+	}
+	releaseHeld()
+	if err := held.QueryRow().Scan(&n); err == nil {
+		t.Error("evicted statement still open after its last release")
+	}
+}
+
+func TestStmtCacheFullPool(t *testing.T) {
+	db, err := sql.Open("sqlite3", ":memory:")
+	if err != nil {
+		t.Fatal(err)
+	}
+	defer db.Close()
+	db.SetMaxOpenConns(1)
+
+	var cache stmtCache
+	defer cache.close()
+	held, releaseHeld := cache.get(db, "SELECT 1")
+	if held == nil {
+		t.Fatal("statement not prepared")
+	}
+
+	// Open rows hold the only connection while another caller prepares a
+	// new statement, which waits for it
+	rows, err := held.Query()
+	if err != nil {
+		t.Fatal(err)
+	}
+	prepared := make(chan *sql.Stmt)
+	go func() {
+		stmt, release := cache.get(db, "SELECT 2")
+		if release != nil {
+			release()
+		}
+		prepared <- stmt
+	}()
+	time.Sleep(50 * time.Millisecond)
+
+	// Cached statements stay available meanwhile
+	done := make(chan struct{})
+	go func() {
+		_, release := cache.get(db, "SELECT 1")
+		release()
+		releaseHeld()
+		close(done)
+	}()
+	select {
+	case <-done:
+	case <-time.After(5 * time.Second):
+		t.Fatal("cached statement blocked by a prepare waiting for a connection")
+	}
+
+	rows.Close()
+	if stmt := <-prepared; stmt == nil {
+		t.Error("statement not prepared after the connection was freed")
+	}
+}
+
+// BenchmarkLookups measures point lookups with and without the statement
+// cache.
+func BenchmarkLookups(b *testing.B) {
+	tmpDir, err := os.MkdirTemp("", "lookupbench")
+	if err != nil {
+		b.Fatal(err)
+	}
+	defer os.RemoveAll(tmpDir)
+
+	store := New()
+	if err := store.Init(tmpDir + "/bench.db"); err != nil {
+		b.Skipf("store not available: %v", err)
+	}
+	defer store.Close()
+
+	const n = 2000
+	chunks := make([]*types.ChunkWithEmbedding, n)
+	symbols := make([]*types.Symbol, n)
+	for i := range chunks {
+		file := fmt.Sprintf("pkg/file%d.go", i%100)
+		chunks[i] = &types.ChunkWithEmbedding{
+			Chunk: &types.Chunk{
+				ID: fmt.Sprintf("chunk%d", i), FilePath: file, Language: "go",
+				Content: fmt.Sprintf("func Handler%d() error { return nil }", i), ChunkType: types.ChunkTypeFunction,
+				Name: fmt.Sprintf("Handler%d", i), StartLine: i, EndLine: i + 3, Hash: "h",
+			},
+			Embedding: []float32{0.1, 0.2, 0.3, 0.4},
+		}
+		symbols[i] = &types.Symbol{
+			ID: fmt.Sprintf("%s:Handler%d:%d", file, i, i), Name: fmt.Sprintf("Handler%d", i),
+			Kind: types.SymbolKindFunction, FilePath: file, StartLine: i, EndLine: i + 3,
+		}
+		if err := store.SetFileHash(file, "hash", "config"); err != nil {
+			b.Fatal(err)
+		}
+	}
+	if err := store.StoreChunks(chunks); err != nil {
+		b.Fatal(err)
+	}
+	if err := store.StoreSymbols(symbols); err != nil {
+		b.Fatal(err)
+	}
+
+	lookups := map[string]func(i int) error{
+		"GetChunk": func(i int) error {
+			_, err := store.GetChunk(fmt.Sprintf("chunk%d", i%n))
+			return err
+		},
+		"GetSymbol": func(i int) error {
+			_, err := store.GetSymbol(symbols[i%n].ID)
+			return err
+		},
+		"GetFileHash": func(i int) error {
+			_, err := store.GetFileHash(fmt.Sprintf("pkg/file%d.go", i%100))
+			return err
+		},
+		"FindSymbolsAdvanced": func(i int) error {
+			_, err := store.FindSymbolsAdvanced(fmt.Sprintf("Handler%d", i%n), types.SymbolKindFunction, 0, "", 10)
+			return err
+		},
+	}
+
+	for name, lookup := range lookups {
+		for _, prepared := range []bool{false, true} {
+			mode := "unprepared"
+			if prepared {
+				mode = "prepared"
+			}
+			b.Run(name+"/"+mode, func(b *testing.B) {
+				store.stmts.mu.Lock()
+				store.stmts.disabled = !prepared
+				store.stmts.mu.Unlock()
+
+				b.ReportAllocs()
+				b.ResetTimer()
+				for i := 0; i < b.N; i++ {
+					if err := lookup(i); err != nil {
+						b.Fatal(err)
+					}
+				}
+				b.ReportMetric(float64(b.N)/b.Elapsed().Seconds(), "lookups/s")
+			})
+		}
+	}
+}
@@ -0,0 +1,402 @@
+package sqlitevec
+
+import (
+	"database/sql"
+	"fmt"
+	"sort"
+	"strings"
+
+	"github.com/spetr/mcp-codewizard/pkg/types"
+)
+
+// contributorStatsVersion is stored in git_index_meta once the junction
+// tables and contributor aggregates have been backfilled from changes.
+const contributorStatsVersion = "1"
+
+// createContributorSchema creates the junction tables linking changes to
+// symbols and chunks, and the incremental per-(path prefix, author)
+// aggregates used by GetContributorInsights.
+func (s *Store) createContributorSchema() error {
+	_, err := s.db.Exec(`
+		CREATE TABLE IF NOT EXISTS change_symbols (
+			change_id TEXT NOT NULL,
+			commit_hash TEXT NOT NULL,
+			symbol TEXT NOT NULL,
+			symbol_lower TEXT NOT NULL,
+			PRIMARY KEY (change_id, symbol)
+		)
+	`)
+	if err != nil {
+		return fmt.Errorf("failed to create change_symbols table: %w", err)
+	}
+	_, err = s.db.Exec(`CREATE INDEX IF NOT EXISTS idx_change_symbols_symbol ON change_symbols(symbol_lower)`)
+	if err != nil {
+		return err
+	}
+
+	_, err = s.db.Exec(`
+		CREATE TABLE IF NOT EXISTS change_chunks (
+			change_id TEXT NOT NULL,
+			chunk_id TEXT NOT NULL,
+			PRIMARY KEY (change_id, chunk_id)
+		)
+	`)
+	if err != nil {
+		return fmt.Errorf("failed to create change_chunks table: %w", err)
+	}
+	_, err = s.db.Exec(`CREATE INDEX IF NOT EXISTS idx_change_chunks_chunk ON change_chunks(chunk_id)`)
+	if err != nil {
+		return err
+	}
+
+	// Lines changed per commit under each path prefix ("" is the repo root).
+	// Lets re-stored changes adjust the aggregates instead of double counting.
+	_, err = s.db.Exec(`
+		CREATE TABLE IF NOT EXISTS commit_path_touches (
+			commit_hash TEXT NOT NULL,
+			path_prefix TEXT NOT NULL,
+			lines INTEGER NOT NULL DEFAULT 0,
+			PRIMARY KEY (commit_hash, path_prefix)
+		)
+	`)
+	if err != nil {
+		return fmt.Errorf("failed to create commit_path_touches table: %w", err)
+	}
+	_, err = s.db.Exec(`CREATE INDEX IF NOT EXISTS idx_commit_path_touches_prefix ON commit_path_touches(path_prefix)`)
+	if err != nil {
+		return err
+	}
+
+	_, err = s.db.Exec(`
+		CREATE TABLE IF NOT EXISTS contributor_path_stats (
+			path_prefix TEXT NOT NULL,
+			author_email TEXT NOT NULL,
+			author TEXT NOT NULL,
+			commits INTEGER NOT NULL DEFAULT 0,
+			lines INTEGER NOT NULL DEFAULT 0,
+			last_active INTEGER NOT NULL DEFAULT 0,
+			PRIMARY KEY (path_prefix, author_email)
+		)
+	`)
+	if err != nil {
+		return fmt.Errorf("failed to create contributor_path_stats table: %w", err)
+	}
+
+	return s.backfillContributorStats()
+}
+
+// backfillContributorStats populates the junction tables and aggregates from
+// changes stored before they existed. Runs once per database.
+func (s *Store) backfillContributorStats() error {
+	var version string
+	err := s.db.QueryRow("SELECT value FROM git_index_meta WHERE key = 'contributor_stats_version'").Scan(&version)
+	if err != nil && err != sql.ErrNoRows {
+		return err
+	}
+	if version == contributorStatsVersion {
+		return nil
+	}
+
+	tx, err := s.db.Begin()
+	if err != nil {
+		return err
+	}
+	defer tx.Rollback()
+
+	// Diff bodies and hunks are not needed here
+	rows, err := tx.Query(`
+		SELECT c.id, c.commit_hash, f.path, c.change_type, c.old_path, '',
+		       c.additions, c.deletions, c.affected_functions, c.affected_chunk_ids, '',
+		       NULL, NULL
+		FROM changes c JOIN files f ON f.id = c.file_id
+	`)
+	if err != nil {
+		return err
+	}
+	changes, err := scanChanges(rows)
+	rows.Close()
+	if err != nil {
+		return err
+	}
+
+	if len(changes) > 0 {
+		if err := updateChangeLinks(tx, changes); err != nil {
+			return fmt.Errorf("failed to backfill change links: %w", err)
+		}
+		if err := updateContributorStats(tx, changeCommitHashes(changes)); err != nil {
+			return fmt.Errorf("failed to backfill contributor stats: %w", err)
+		}
+	}
+
+	_, err = tx.Exec(`
+		INSERT OR REPLACE INTO git_index_meta (key, value)
+		VALUES ('contributor_stats_version', ?)
+	`, contributorStatsVersion)
+	if err != nil {
+		return err
+	}
+
+	return tx.Commit()
+}
+
+// updateChangeLinks replaces the change_symbols and change_chunks rows of
+// the given changes.
+func updateChangeLinks(tx *sql.Tx, changes []*types.Change) error {
+	delSymbols, err := tx.Prepare("DELETE FROM change_symbols WHERE change_id = ?")
+	if err != nil {
+		return err
+	}
+	defer delSymbols.Close()
+
+	delChunks, err := tx.Prepare("DELETE FROM change_chunks WHERE change_id = ?")
+	if err != nil {
+		return err
+	}
+	defer delChunks.Close()
+
+	symbolStmt, err := tx.Prepare(`
+		INSERT OR IGNORE INTO change_symbols (change_id, commit_hash, symbol, symbol_lower)
+		VALUES (?, ?, ?, ?)
+	`)
+	if err != nil {
+		return err
+	}
+	defer symbolStmt.Close()
+
+	chunkStmt, err := tx.Prepare(`
+		INSERT OR IGNORE INTO change_chunks (change_id, chunk_id)
+		VALUES (?, ?)
+	`)
+	if err != nil {
+		return err
+	}
+	defer chunkStmt.Close()
+
+	for _, c := range changes {
+		if _, err := delSymbols.Exec(c.ID); err != nil {
+			return err
+		}
+		if _, err := delChunks.Exec(c.ID); err != nil {
+			return err
+		}
+
+		for _, fn := range c.AffectedFunctions {
+			if _, err := symbolStmt.Exec(c.ID, c.CommitHash, fn, strings.ToLower(fn)); err != nil {
+				return err
+			}
+		}
+		for _, chunkID := range c.AffectedChunkIDs {
+			if _, err := chunkStmt.Exec(c.ID, chunkID); err != nil {
+				return err
+			}
+		}
+	}
+
+	return nil
+}
+
+// commitAuthor is the author information of a commit used for aggregates.
+type commitAuthor struct {
+	name  string
+	email string
+	date  int64
+}
+
+// updateContributorStats recomputes the per-prefix line counts of the given
+// commits from their stored changes and applies the difference to
+// contributor_path_stats. A commit counts once per prefix no matter how often
+// its changes are stored. Commits that are not stored yet are skipped.
+func updateContributorStats(tx *sql.Tx, commitHashes []string) error {
+	if len(commitHashes) == 0 {
+		return nil
+	}
+	hashesJSON := jsonArray(commitHashes)
+
+	rows, err := tx.Query(`
+		SELECT c.commit_hash, f.path, c.additions + c.deletions,
+		       cm.author, cm.author_email, cm.date
+		FROM changes c
+		JOIN files f ON f.id = c.file_id
+		JOIN commits cm ON cm.hash = c.commit_hash
+		WHERE c.commit_hash IN (SELECT value FROM json_each(?))
+	`, hashesJSON)
+	if err != nil {
+		return err
+	}
+
+	touches := make(map[string]map[string]int)
+	authors := make(map[string]commitAuthor)
+	for rows.Next() {
+		var hash, filePath string
+		var lines int
+		var a commitAuthor
+		if err := rows.Scan(&hash, &filePath, &lines, &a.name, &a.email, &a.date); err != nil {
+			rows.Close()
+			return err
+		}
+		authors[hash] = a
+		if touches[hash] == nil {
+			touches[hash] = make(map[string]int)
+		}
+		for _, prefix := range pathPrefixesOf(filePath) {
+			touches[hash][prefix] += lines
+		}
+	}
+	rows.Close()
+	if err := rows.Err(); err != nil {
+		return err
+	}
+
+	rows, err = tx.Query(`
+		SELECT commit_hash, path_prefix, lines
+		FROM commit_path_touches
+		WHERE commit_hash IN (SELECT value FROM json_each(?))
+	`, hashesJSON)
+	if err != nil {
+		return err
+	}
+
+	existing := make(map[string]map[string]int)
+	for rows.Next() {
+		var hash, prefix string
+		var lines int
+		if err := rows.Scan(&hash, &prefix, &lines); err != nil {
+			rows.Close()
+			return err
+		}
+		if existing[hash] == nil {
+			existing[hash] = make(map[string]int)
+		}
+		existing[hash][prefix] = lines
+	}
+	rows.Close()
+	if err := rows.Err(); err != nil {
+		return err
+	}
+
+	touchStmt, err := tx.Prepare(`
+		INSERT OR REPLACE INTO commit_path_touches (commit_hash, path_prefix, lines)
+		VALUES (?, ?, ?)
+	`)
+	if err != nil {
+		return err
+	}
+	defer touchStmt.Close()
+
+	statsStmt, err := tx.Prepare(`
+		INSERT INTO contributor_path_stats (path_prefix, author_email, author, commits, lines, last_active)
+		VALUES (?, ?, ?, ?, ?, ?)
+		ON CONFLICT(path_prefix, author_email) DO UPDATE SET
+			author = excluded.author,
+			commits = commits + excluded.commits,
+			lines = lines + excluded.lines,
+			last_active = MAX(last_active, excluded.last_active)
+	`)
+	if err != nil {
+		return err
+	}
+	defer statsStmt.Close()
+
+	for _, hash := range commitHashes {
+		a, ok := authors[hash]
+		if !ok {
+			continue
+		}
+
+		for prefix, lines := range touches[hash] {
+			oldLines, seen := existing[hash][prefix]
+			commitDelta := 1
+			if seen {
+				commitDelta = 0
+			}
+
+			if _, err := statsStmt.Exec(prefix, a.email, a.name, commitDelta, lines-oldLines, a.date); err != nil {
+				return err
+			}
+			if _, err := touchStmt.Exec(hash, prefix, lines); err != nil {
+				return err
+			}
+		}
+
+		// Prefixes no longer touched by the stored changes of this commit
+		for prefix, oldLines := range existing[hash] {
+			if _, ok := touches[hash][prefix]; ok {
+				continue
+			}
+			if _, err := statsStmt.Exec(prefix, a.email, a.name, -1, -oldLines, a.date); err != nil {
+				return err
+			}
+			if _, err := tx.Exec("DELETE FROM commit_path_touches WHERE commit_hash = ? AND path_prefix = ?", hash, prefix); err != nil {
+				return err
+			}
+		}
+	}
+
+	return nil
+}
+
+// pathPrefixesOf returns the aggregate keys for a file: the repo root (""),
+// every parent directory and the file itself.
+func pathPrefixesOf(filePath string) []string {
+	filePath = normalizeHistoryPath(filePath)
+	prefixes := []string{""}
+	for i := 0; i < len(filePath); i++ {
+		if filePath[i] == '/' {
+			prefixes = append(prefixes, filePath[:i])
+		}
+	}
+	if filePath != "" {
+		prefixes = append(prefixes, filePath)
+	}
+	return prefixes
+}
+
+// pathPrefixes converts contributor path patterns to aggregate keys.
+// Directory globs ("internal/mcp/**", "internal/mcp/*", "internal/mcp/")
+// map to their directory; plain paths map to themselves. Returns false if a
+// pattern has wildcards elsewhere and needs a scan. Prefixes covered by
+// another prefix are dropped so the remaining ones are disjoint.
+func pathPrefixes(patterns []string) ([]string, bool) {
+	var prefixes []string
+	for _, p := range patterns {
+		p = normalizeHistoryPath(p)
+		for {
+			trimmed := strings.TrimSuffix(strings.TrimSuffix(p, "/**"), "/*")
+			if trimmed == p {
+				break
+			}
+			p = trimmed
+		}
+		if p == "*" || p == "**" {
+			p = ""
+		}
+		if strings.ContainsAny(p, "*?[") {
+			return nil, false
+		}
+		prefixes = append(prefixes, p)
+	}
+
+	sort.Strings(prefixes)
+	var disjoint []string
+	for _, p := range prefixes {
+		covered := false
+		for _, q := range disjoint {
+			if q == "" || p == q || strings.HasPrefix(p, q+"/") {
+				covered = true
+				break
+			}
+		}
+		if !covered {
+			disjoint = append(disjoint, p)
+		}
+	}
+
+	return disjoint, true
+}
+
+// normalizeHistoryPath normalizes a repo-relative path as stored in changes.
+func normalizeHistoryPath(p string) string {
+	p = strings.ReplaceAll(strings.TrimSpace(p), "\\", "/")
+	p = strings.TrimPrefix(p, "./")
+	return strings.TrimSuffix(p, "/")
+}
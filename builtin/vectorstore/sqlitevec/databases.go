@@ -0,0 +1,299 @@
+package sqlitevec
+
+import (
+	"database/sql"
+	"fmt"
+	"log/slog"
+	"os"
+	"path/filepath"
+	"strings"
+	"sync"
+	"sync/atomic"
+	"time"
+)
+
+// By default all tables live in one database file. With
+// Config.SplitDatabases, git history and memories/todos get files of their
+// own next to the index, attached to every connection under their schema
+// name. Table names are unique across the files, so queries, joins included,
+// do not qualify them. Each file has its own WAL and writer, so a long git
+// history write no longer holds up memory or index writes, and each is
+// maintained on its own idle schedule.
+//
+// Writes stay within the file of their subsystem: transactions are
+// deferred and lock their own file first (writeLockStatement), so they only
+// lock the files they write. Git history refers to
+// the index's files dictionary; StoreChanges adds new paths through the
+// index writer first.
+//
+// An index that was split stays split: the subsystem files are attached
+// whenever they exist. When they are created for an existing index, the
+// subsystem's tables are moved into them.
+
+// subsystem is a group of tables that can live in a database file of its
+// own.
+type subsystem int
+
+const (
+	subsysIndex   subsystem = iota // Chunks, symbols, references, files, metadata
+	subsysHistory                  // Commits, changes and their links
+	subsysMemory                   // Memories, sessions, checkpoints, todos
+	numSubsystems
+)
+
+// subsystemSchemas are the schema names of the subsystem files.
+var subsystemSchemas = [numSubsystems]string{"main", "history", "memory"}
+
+// subsystemTables are the tables a subsystem file takes over from the index
+// file. Index tables always stay in the main file.
+var subsystemTables = [numSubsystems][]string{
+	subsysHistory: {
+		"commits", "commit_parents", "commits_fts", "commit_features", "chunk_history", "git_index_meta",
+		"changes", "commit_embeddings", "change_embeddings", "commit_diff_embeddings",
+		"change_symbols", "change_chunks", "commit_path_touches", "contributor_path_stats",
+	},
+	subsysMemory: {
+		"memories", "memories_fts", "memory_sessions", "memory_checkpoints", "memory_embeddings",
+		"todos", "todos_fts", "todo_embeddings",
+	},
+}
+
+// movedSchema is the schema name of the index file on the connections that
+// set up a subsystem file.
+const movedSchema = "index_db"
+
+// schemaObject is a table, index or trigger read from sqlite_master.
+type schemaObject struct{ kind, name, ddl string }
+
+// database is one database file and the writer of its tables.
+type database struct {
+	schema string // Schema name on the store's connections
+	path   string
+	writer *writer
+
+	// Idle-time maintenance (maintenance.go)
+	lastWrite       atomic.Int64 // UnixNano of the last submitted write
+	lastMaintenance atomic.Int64 // Unix time of the last completed pass
+	maintMu         sync.Mutex
+	maintTimer      *time.Timer
+	maintStopped    atomic.Bool
+	maintPassMu     sync.Mutex
+	convertSkipped  atomic.Bool // Logged that VACUUM exceeds the budget
+}
+
+// subsystemPath returns the file of sub next to the index at path, e.g.
+// index-history.db for index.db.
+func subsystemPath(path string, sub subsystem) string {
+	if sub == subsysIndex {
+		return path
+	}
+	ext := filepath.Ext(path)
+	return strings.TrimSuffix(path, ext) + "-" + subsystemSchemas[sub] + ext
+}
+
+// splitExists reports whether subsystem files exist next to the index.
+func splitExists(path string) bool {
+	for sub := subsysHistory; sub < numSubsystems; sub++ {
+		if _, err := os.Stat(subsystemPath(path, sub)); err == nil {
+			return true
+		}
+	}
+	return false
+}
+
+// newDatabases returns the databases of the store's subsystems. Without
+// split files, all subsystems share one.
+func newDatabases(path string, split bool) [numSubsystems]*database {
+	var dbs [numSubsystems]*database
+	dbs[subsysIndex] = &database{schema: "main", path: path}
+	for sub := subsysHistory; sub < numSubsystems; sub++ {
+		if split {
+			dbs[sub] = &database{schema: subsystemSchemas[sub], path: subsystemPath(path, sub)}
+		} else {
+			dbs[sub] = dbs[subsysIndex]
+		}
+	}
+	return dbs
+}
+
+// databases returns the distinct databases of the store.
+func (s *Store) databases() []*database {
+	all := []*database{s.dbs[subsysIndex]}
+	for sub := subsysHistory; sub < numSubsystems; sub++ {
+		if d := s.dbs[sub]; d != nil && d != all[0] {
+			all = append(all, d)
+		}
+	}
+	return all
+}
+
+// split reports whether the subsystems have files of their own.
+func (s *Store) split() bool {
+	return s.dbs[subsysMemory] != s.dbs[subsysIndex]
+}
+
+// schema returns the schema name of sub's tables, for statements that
+// create tables or read sqlite_master.
+func (s *Store) schema(sub subsystem) string {
+	return s.dbs[sub].schema
+}
+
+// attachments returns the subsystem files attached to the connections.
+func (s *Store) attachments() []attachment {
+	var attached []attachment
+	for _, d := range s.databases()[1:] {
+		attached = append(attached, attachment{schema: d.schema, path: d.path})
+	}
+	return attached
+}
+
+// writeLockStatement returns the statement that starts the transactions of
+// d's writer. With split files the connections begin deferred transactions,
+// so a transaction that read before its first write would have to upgrade
+// its lock, and fail at once if another process wrote the file meanwhile.
+// A write to d's file that changes nothing takes its write lock first,
+// waiting out other writers with busy_timeout, and leaves the other files
+// unlocked.
+func (s *Store) writeLockStatement(d *database) string {
+	if !s.split() {
+		return "" // Transactions are immediate
+	}
+	return "DELETE FROM " + d.schema + ".stat_counts WHERE 0"
+}
+
+// setupSubsystem brings the file of sub to schemaRevision. It runs on
+// connections of its own, with the subsystem file as main schema so the
+// schema creators create their tables in it, and the index file attached
+// for the files dictionary and metadata. Moving tables writes both files,
+// so its transactions are immediate.
+func (s *Store) setupSubsystem(sub subsystem, settings connSettings, creators []schemaCreator) error {
+	d := s.dbs[sub]
+	db := sql.OpenDB(newConnector(d.path+"?"+dsnOptions(true), settings,
+		[]attachment{{schema: movedSchema, path: s.path}}))
+	setup := &Store{db: db, path: d.path, enableFTS: s.enableFTS, config: s.config}
+	defer func() {
+		setup.stmts.close()
+		db.Close()
+	}()
+
+	if err := moveSubsystemTables(db, sub); err != nil {
+		return fmt.Errorf("failed to move %s tables: %w", d.schema, err)
+	}
+	return setup.runCreators(creators)
+}
+
+// moveSubsystemTables moves the tables of sub from the index file into the
+// subsystem file, which is the main schema of db. The copy is one
+// transaction on the subsystem file and the tables are dropped from the
+// index file afterwards, so a move interrupted in between is finished by
+// dropping them.
+func moveSubsystemTables(db *sql.DB, sub subsystem) error {
+	tables := jsonArray(subsystemTables[sub])
+
+	// Counter triggers are recreated with the counters of the new file
+	rows, err := db.Query(`
+		SELECT type, name, sql FROM `+movedSchema+`.sqlite_master
+		WHERE tbl_name IN (SELECT value FROM json_each(?)) AND sql IS NOT NULL AND name NOT LIKE 'stat\_%' ESCAPE '\'
+		ORDER BY CASE type WHEN 'table' THEN 0 WHEN 'trigger' THEN 1 ELSE 2 END
+	`, tables)
+	if err != nil {
+		return err
+	}
+	var objects []schemaObject
+	for rows.Next() {
+		var o schemaObject
+		if err := rows.Scan(&o.kind, &o.name, &o.ddl); err != nil {
+			rows.Close()
+			return err
+		}
+		objects = append(objects, o)
+	}
+	rows.Close()
+	if err := rows.Err(); err != nil {
+		return err
+	}
+	if len(objects) == 0 {
+		return nil
+	}
+
+	var copied int
+	err = db.QueryRow("SELECT COUNT(*) FROM main.sqlite_master WHERE name IN (SELECT value FROM json_each(?))", tables).Scan(&copied)
+	if err != nil {
+		return err
+	}
+	if copied == 0 {
+		start := time.Now()
+		if err := copySubsystemTables(db, objects); err != nil {
+			return err
+		}
+		slog.Info("moved tables into their own database file", "tables", subsystemTables[sub],
+			"duration", time.Since(start).Round(time.Millisecond))
+	}
+
+	tx, err := db.Begin()
+	if err != nil {
+		return err
+	}
+	defer tx.Rollback()
+	for _, o := range objects {
+		if o.kind != "table" {
+			continue // Dropped with their table
+		}
+		if _, err := tx.Exec("DROP TABLE IF EXISTS " + movedSchema + "." + o.name); err != nil {
+			return fmt.Errorf("failed to drop moved table %s: %w", o.name, err)
+		}
+	}
+
+	// Their counters now live in the subsystem file
+	var counted bool
+	err = tx.QueryRow("SELECT EXISTS (SELECT 1 FROM " + movedSchema + ".sqlite_master WHERE name = 'stat_counts')").Scan(&counted)
+	if err != nil {
+		return err
+	}
+	if counted {
+		_, err := tx.Exec("DELETE FROM "+movedSchema+".stat_counts WHERE counter IN (SELECT value FROM json_each(?))",
+			jsonArray(countersOf(subsystemTables[sub])))
+		if err != nil {
+			return err
+		}
+	}
+	return tx.Commit()
+}
+
+// copySubsystemTables recreates objects in the main schema of db and copies
+// the rows of their tables. Full-text tables are filled by their triggers,
+// which are created before the rows are copied.
+func copySubsystemTables(db *sql.DB, objects []schemaObject) error {
+	tx, err := db.Begin()
+	if err != nil {
+		return err
+	}
+	defer tx.Rollback()
+
+	for _, o := range objects {
+		if o.kind == "index" {
+			continue
+		}
+		if _, err := tx.Exec(o.ddl); err != nil {
+			return fmt.Errorf("failed to create %s: %w", o.name, err)
+		}
+	}
+	for _, o := range objects {
+		if o.kind != "table" || strings.Contains(strings.ToLower(o.ddl), "using fts5") {
+			continue
+		}
+		if _, err := tx.Exec(fmt.Sprintf("INSERT INTO main.%[1]s SELECT * FROM %[2]s.%[1]s", o.name, movedSchema)); err != nil {
+			return fmt.Errorf("failed to copy %s: %w", o.name, err)
+		}
+	}
+	for _, o := range objects {
+		if o.kind != "index" {
+			continue
+		}
+		if _, err := tx.Exec(o.ddl); err != nil {
+			return fmt.Errorf("failed to create %s: %w", o.name, err)
+		}
+	}
+
+	return tx.Commit()
+}
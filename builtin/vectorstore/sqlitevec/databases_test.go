@@ -0,0 +1,194 @@
+package sqlitevec
+
+import (
+	"database/sql"
+	"fmt"
+	"os"
+	"sync"
+	"testing"
+	"time"
+
+	"github.com/spetr/mcp-codewizard/pkg/types"
+)
+
+func TestSplitDatabases(t *testing.T) {
+	tmpDir, err := os.MkdirTemp("", "splittest")
+	if err != nil {
+		t.Fatal(err)
+	}
+	defer os.RemoveAll(tmpDir)
+	dbPath := tmpDir + "/index.db"
+	now := time.Now()
+
+	// An index written as a single file
+	store := New()
+	if err := store.Init(dbPath); err != nil {
+		if containsString(err.Error(), "fts5") || containsString(err.Error(), "FTS5") {
+			t.Skip("FTS5 not available in this environment")
+		}
+		t.Fatal(err)
+	}
+	storeMemory := func(s *Store, id string) {
+		t.Helper()
+		err := s.StoreMemory(&types.MemoryEntry{
+			ID: id, Content: "split memory", Category: types.MemoryCategoryFact,
+			Channel: "main", CreatedAt: now, UpdatedAt: now,
+		})
+		if err != nil {
+			t.Fatal(err)
+		}
+	}
+	storeMemory(store, "mem_0")
+	if err := store.StoreTodo(&types.TodoItem{
+		ID: "todo_0", Title: "split todo", Status: types.TodoStatusPending, Priority: types.TodoPriorityHigh,
+		Channel: "main", CreatedAt: now, UpdatedAt: now,
+	}); err != nil {
+		t.Fatal(err)
+	}
+	commit := &types.Commit{Hash: "1111111111111111111111111111111111111111", ShortHash: "1111111",
+		Author: "Alice", AuthorEmail: "alice@test.com", Date: now, Message: "Fix parser"}
+	if err := store.StoreCommits([]*types.Commit{commit}); err != nil {
+		t.Fatal(err)
+	}
+	store.Close()
+
+	// Splitting moves the existing tables
+	store = NewWithConfig(Config{SplitDatabases: true})
+	if err := store.Init(dbPath); err != nil {
+		t.Fatal(err)
+	}
+	for _, sub := range []subsystem{subsysHistory, subsysMemory} {
+		if _, err := os.Stat(subsystemPath(dbPath, sub)); err != nil {
+			t.Errorf("no %s database: %v", subsystemSchemas[sub], err)
+		}
+	}
+	tableSchema := func(table string) string {
+		t.Helper()
+		var schemas []string
+		for _, schema := range []string{"main", "history", "memory"} {
+			var n int
+			store.db.QueryRow(fmt.Sprintf("SELECT COUNT(*) FROM %s.sqlite_master WHERE name = ?", schema), table).Scan(&n)
+			if n > 0 {
+				schemas = append(schemas, schema)
+			}
+		}
+		return fmt.Sprint(schemas)
+	}
+	for table, want := range map[string]string{"chunks": "[main]", "commits": "[history]", "memories": "[memory]", "todos_fts": "[memory]"} {
+		if got := tableSchema(table); got != want {
+			t.Errorf("%s in %s, want %s", table, got, want)
+		}
+	}
+	if m, err := store.GetMemory("mem_0"); err != nil || m == nil {
+		t.Errorf("memory lost in the move: %v", err)
+	}
+	if todo, err := store.GetTodo("todo_0"); err != nil || todo == nil {
+		t.Errorf("todo lost in the move: %v", err)
+	}
+
+	// Writes go to their files; changes refer to the index's files
+	storeMemory(store, "mem_1")
+	if err := store.StoreChanges([]*types.Change{{
+		ID: "1111111:parser.go", CommitHash: commit.Hash, FilePath: "parser.go",
+		ChangeType: types.ChangeTypeModified, DiffContent: "-a\n+b",
+	}}); err != nil {
+		t.Fatal(err)
+	}
+	var path string
+	err = store.db.QueryRow("SELECT f.path FROM changes c JOIN files f ON f.id = c.file_id").Scan(&path)
+	if err != nil || path != "parser.go" {
+		t.Errorf("change path = %q, %v", path, err)
+	}
+
+	memStats, err := store.GetMemoryStats("main")
+	if err != nil {
+		t.Fatal(err)
+	}
+	gitStats, err := store.GetGitHistoryStats()
+	if err != nil {
+		t.Fatal(err)
+	}
+	if memStats.TotalMemories != 2 || gitStats.TotalCommits != 1 || gitStats.TotalChanges != 1 {
+		t.Errorf("%d memories, %d commits, %d changes; want 2, 1, 1",
+			memStats.TotalMemories, gitStats.TotalCommits, gitStats.TotalChanges)
+	}
+	if err := store.Maintain(); err != nil {
+		t.Fatal(err)
+	}
+	store.Close()
+
+	// A split index stays split
+	store = New()
+	if err := store.Init(dbPath); err != nil {
+		t.Fatal(err)
+	}
+	defer store.Close()
+	if !store.split() {
+		t.Fatal("split index opened as a single file")
+	}
+	if m, err := store.GetMemory("mem_1"); err != nil || m == nil {
+		t.Errorf("memory lost after reopening: %v", err)
+	}
+}
+
+func TestSplitDatabasesWriteContention(t *testing.T) {
+	tmpDir, err := os.MkdirTemp("", "splittest")
+	if err != nil {
+		t.Fatal(err)
+	}
+	defer os.RemoveAll(tmpDir)
+	dbPath := tmpDir + "/index.db"
+
+	// Two stores on the same files stand in for two processes
+	var stores [2]*Store
+	for i := range stores {
+		stores[i] = NewWithConfig(Config{SplitDatabases: true})
+		if err := stores[i].Init(dbPath); err != nil {
+			if containsString(err.Error(), "fts5") || containsString(err.Error(), "FTS5") {
+				t.Skip("FTS5 not available in this environment")
+			}
+			t.Fatal(err)
+		}
+		defer stores[i].Close()
+	}
+
+	// Each write reads before it writes, which fails at once if another
+	// connection committed in between and the transaction has to upgrade
+	// its read lock
+	increment := func(tx *sql.Tx) error {
+		var n int
+		err := tx.QueryRow("SELECT COALESCE(MAX(n), 0) FROM memory.stat_counts WHERE counter = 'contention'").Scan(&n)
+		if err != nil {
+			return err
+		}
+		time.Sleep(time.Millisecond)
+		_, err = tx.Exec("INSERT OR REPLACE INTO memory.stat_counts (counter, n) VALUES ('contention', ?)", n+1)
+		return err
+	}
+
+	const writes = 50
+	var wg sync.WaitGroup
+	errs := make(chan error, len(stores)*writes)
+	for _, s := range stores {
+		wg.Add(1)
+		go func(s *Store) {
+			defer wg.Done()
+			for i := 0; i < writes; i++ {
+				if err := s.writeTo(subsysMemory, writeInteractive, increment); err != nil {
+					errs <- err
+				}
+			}
+		}(s)
+	}
+	wg.Wait()
+	close(errs)
+	for err := range errs {
+		t.Fatalf("concurrent write failed: %v", err)
+	}
+
+	var n int
+	stores[0].db.QueryRow("SELECT n FROM memory.stat_counts WHERE counter = 'contention'").Scan(&n)
+	if n != len(stores)*writes {
+		t.Errorf("counter = %d, want %d", n, len(stores)*writes)
+	}
+}
@@ -0,0 +1,132 @@
+package sqlitevec
+
+import (
+	"bytes"
+	"compress/flate"
+	"fmt"
+	"io"
+	"sync"
+)
+
+// diffCodecFlateDict marks a blob as raw DEFLATE primed with diffDictionary.
+// The codec byte is stored first so the dictionary can be retrained later
+// without rewriting existing rows.
+const diffCodecFlateDict byte = 1
+
+// diffDictionary primes the compressor with strings that recur in unified
+// diffs and hunk JSON (the escaped \n and \t forms match JSON-encoded hunk
+// content). DEFLATE favours matches near the end of the window, so the most
+// frequent fragments come last.
+var diffDictionary = []byte(`
+#include <stdio.h>
+import (
+package main
+public static void
+private final
+def __init__(self
+self.assertEqual(
+console.log(
+function (
+const { } = require(
+export default
+} else if (
+} else {
+return nil, err
+if err != nil {
+	return err
+}
+:= range
+fmt.Errorf("failed to %w", err)
+ctx context.Context
+func (s *
+"old_start":"old_lines":"new_start":"new_lines":"content":
+{"old_start":
+,"old_lines":
+,"new_start":
+,"new_lines":
+,"content":"@@ -
+\n-\t\t
+\n+\t\t
+\n \t\t
+\n-\t
+\n+\t
+\n \t
+\n-
+\n+
+\n 
+--- a/
++++ b/
+diff --git a/
+index 
+new file mode 100644
+deleted file mode 100644
+\ No newline at end of file
+@@ -1,0 +1,
+ @@ func 
+@@ -
+-	
++	
+ 	
+-		
++		
+ 		
+`)
+
+var (
+	flateWriterPool = sync.Pool{
+		New: func() any {
+			w, err := flate.NewWriterDict(io.Discard, flate.DefaultCompression, diffDictionary)
+			if err != nil {
+				panic(err)
+			}
+			return w
+		},
+	}
+	flateReaderPool sync.Pool
+)
+
+// compressDiff compresses diff text or hunk JSON for storage. Empty input
+// returns nil so the column stays NULL.
+func compressDiff(data []byte) ([]byte, error) {
+	if len(data) == 0 {
+		return nil, nil
+	}
+
+	var buf bytes.Buffer
+	buf.Grow(len(data)/3 + 16)
+	buf.WriteByte(diffCodecFlateDict)
+
+	w := flateWriterPool.Get().(*flate.Writer)
+	defer flateWriterPool.Put(w)
+	w.Reset(&buf)
+
+	if _, err := w.Write(data); err != nil {
+		return nil, err
+	}
+	if err := w.Close(); err != nil {
+		return nil, err
+	}
+
+	return buf.Bytes(), nil
+}
+
+// decompressDiff reverses compressDiff.
+func decompressDiff(blob []byte) ([]byte, error) {
+	if len(blob) == 0 {
+		return nil, nil
+	}
+	if blob[0] != diffCodecFlateDict {
+		return nil, fmt.Errorf("unknown diff codec %d", blob[0])
+	}
+
+	src := bytes.NewReader(blob[1:])
+	r, _ := flateReaderPool.Get().(io.ReadCloser)
+	if r == nil {
+		r = flate.NewReaderDict(src, diffDictionary)
+	} else if err := r.(flate.Resetter).Reset(src, diffDictionary); err != nil {
+		return nil, err
+	}
+	defer flateReaderPool.Put(r)
+
+	return io.ReadAll(r)
+}
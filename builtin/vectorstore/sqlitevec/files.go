@@ -0,0 +1,187 @@
+package sqlitevec
+
+import (
+	"database/sql"
+	"fmt"
+)
+
+// File paths are stored once in the files table. chunks, symbols, refs,
+// file_cache and changes refer to them by integer id, which keeps their rows
+// and indexes small; queries join files to return paths.
+
+// rowQuerier is implemented by *sql.DB and *sql.Tx.
+type rowQuerier interface {
+	QueryRow(query string, args ...any) *sql.Row
+}
+
+// fileIDs resolves paths to file ids within a write transaction, adding
+// paths that are not in the dictionary yet.
+type fileIDs struct {
+	tx  *sql.Tx
+	ids map[string]int64
+}
+
+func newFileIDs(tx *sql.Tx) *fileIDs {
+	return &fileIDs{tx: tx, ids: make(map[string]int64)}
+}
+
+// get returns the id of path, adding it to the dictionary if needed.
+func (f *fileIDs) get(path string) (int64, error) {
+	if id, ok := f.ids[path]; ok {
+		return id, nil
+	}
+	if _, err := f.tx.Exec("INSERT OR IGNORE INTO files (path) VALUES (?)", path); err != nil {
+		return 0, fmt.Errorf("failed to add file %s: %w", path, err)
+	}
+	var id int64
+	if err := f.tx.QueryRow("SELECT id FROM files WHERE path = ?", path).Scan(&id); err != nil {
+		return 0, fmt.Errorf("failed to look up file %s: %w", path, err)
+	}
+	f.ids[path] = id
+	return id, nil
+}
+
+// addFiles adds paths to the dictionary through the index writer and
+// returns their ids, for writes of other subsystems that refer to files
+// (databases.go).
+func (s *Store) addFiles(paths []string) (map[string]int64, error) {
+	var ids map[string]int64
+	err := s.write(writeBulk, func(tx *sql.Tx) error {
+		files := newFileIDs(tx)
+		for _, path := range paths {
+			if _, err := files.get(path); err != nil {
+				return err
+			}
+		}
+		ids = files.ids
+		return nil
+	})
+	return ids, err
+}
+
+// lookupFileID returns the id of path, or false if the path is not in the
+// dictionary and so has no rows anywhere.
+func lookupFileID(q rowQuerier, path string) (int64, bool, error) {
+	var id int64
+	err := q.QueryRow("SELECT id FROM files WHERE path = ?", path).Scan(&id)
+	if err == sql.ErrNoRows {
+		return 0, false, nil
+	}
+	if err != nil {
+		return 0, false, err
+	}
+	return id, true, nil
+}
+
+// legacyIndexTables are the index tables of databases from before the files
+// dictionary, when they were keyed by their string IDs.
+var legacyIndexTables = []string{"chunks", "symbols", "refs", "file_cache"}
+
+// renameLegacyIndexTables moves the string-keyed index tables aside as
+// legacy_<table>, dropping the FTS table, triggers and indexes whose names
+// the new tables reuse.
+func renameLegacyIndexTables(tx *sql.Tx) error {
+	for _, stmt := range []string{
+		"DROP TRIGGER IF EXISTS chunks_ai",
+		"DROP TRIGGER IF EXISTS chunks_ad",
+		"DROP TRIGGER IF EXISTS chunks_au",
+		"DROP TABLE IF EXISTS chunks_fts",
+		"DROP INDEX IF EXISTS idx_chunks_file_path",
+		"DROP INDEX IF EXISTS idx_symbols_name",
+		"DROP INDEX IF EXISTS idx_symbols_kind",
+		"DROP INDEX IF EXISTS idx_symbols_file_path",
+		"DROP INDEX IF EXISTS idx_symbols_line_count",
+		"DROP INDEX IF EXISTS idx_refs_from",
+		"DROP INDEX IF EXISTS idx_refs_to",
+	} {
+		if _, err := tx.Exec(stmt); err != nil {
+			return err
+		}
+	}
+	for _, table := range legacyIndexTables {
+		if _, err := tx.Exec(fmt.Sprintf("ALTER TABLE %s RENAME TO legacy_%s", table, table)); err != nil {
+			return fmt.Errorf("failed to rename %s: %w", table, err)
+		}
+	}
+	return nil
+}
+
+// copyLegacyIndexTables copies the legacy index tables into the new ones
+// and re-keys the chunk embeddings by chunk rowid, so existing indexes need
+// no re-embedding. The chunk insert trigger fills the FTS table.
+func copyLegacyIndexTables(tx *sql.Tx) error {
+	_, err := tx.Exec(`
+		INSERT OR IGNORE INTO files (path)
+		SELECT file_path FROM legacy_chunks
+		UNION SELECT file_path FROM legacy_symbols
+		UNION SELECT file_path FROM legacy_refs
+		UNION SELECT file_path FROM legacy_file_cache
+	`)
+	if err != nil {
+		return fmt.Errorf("failed to fill files: %w", err)
+	}
+
+	for _, stmt := range []string{`
+		INSERT INTO chunks
+		(key, file_id, language, content, chunk_type, name, parent_name, start_line, end_line, hash, created_at)
+		SELECT l.id, f.id, l.language, l.content, l.chunk_type, l.name, l.parent_name,
+		       l.start_line, l.end_line, l.hash, l.created_at
+		FROM legacy_chunks l JOIN files f ON f.path = l.file_path
+	`, `
+		INSERT INTO symbols
+		(key, name, kind, file_id, start_line, end_line, line_count, signature, visibility, doc_comment)
+		SELECT l.id, l.name, l.kind, f.id, l.start_line, l.end_line, l.line_count,
+		       l.signature, l.visibility, l.doc_comment
+		FROM legacy_symbols l JOIN files f ON f.path = l.file_path
+	`, `
+		INSERT INTO refs
+		(key, from_symbol, to_symbol, kind, file_id, line, is_external)
+		SELECT l.id, l.from_symbol, l.to_symbol, l.kind, f.id, l.line, l.is_external
+		FROM legacy_refs l JOIN files f ON f.path = l.file_path
+	`, `
+		INSERT INTO file_cache (file_id, file_hash, config_hash, indexed_at)
+		SELECT f.id, l.file_hash, l.config_hash, l.indexed_at
+		FROM legacy_file_cache l JOIN files f ON f.path = l.file_path
+	`} {
+		if _, err := tx.Exec(stmt); err != nil {
+			return err
+		}
+	}
+
+	// The legacy vector table is keyed by chunk ID; vec0 tables cannot be
+	// altered, so the vectors go through a temporary table
+	dimensions, err := vectorTableDimensions(tx, "chunk_embeddings")
+	if err != nil {
+		return err
+	}
+	if dimensions > 0 {
+		for _, stmt := range []string{
+			`CREATE TEMP TABLE legacy_embeddings AS
+			 SELECT c.id AS chunk_rowid, e.embedding AS embedding
+			 FROM chunk_embeddings e JOIN chunks c ON c.key = e.chunk_id`,
+			"DROP TABLE chunk_embeddings",
+		} {
+			if _, err := tx.Exec(stmt); err != nil {
+				return fmt.Errorf("failed to migrate embeddings: %w", err)
+			}
+		}
+		if err := createChunkEmbeddingsTable(tx, dimensions); err != nil {
+			return fmt.Errorf("failed to migrate embeddings: %w", err)
+		}
+		for _, stmt := range []string{
+			"INSERT INTO chunk_embeddings (rowid, embedding) SELECT chunk_rowid, embedding FROM temp.legacy_embeddings",
+			"DROP TABLE temp.legacy_embeddings",
+		} {
+			if _, err := tx.Exec(stmt); err != nil {
+				return fmt.Errorf("failed to migrate embeddings: %w", err)
+			}
+		}
+	}
+
+	for _, table := range legacyIndexTables {
+		if _, err := tx.Exec("DROP TABLE legacy_" + table); err != nil {
+			return err
+		}
+	}
+	return nil
+}
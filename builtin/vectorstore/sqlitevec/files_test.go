@@ -0,0 +1,228 @@
+package sqlitevec
+
+import (
+	"context"
+	"database/sql"
+	"fmt"
+	"os"
+	"testing"
+
+	"github.com/spetr/mcp-codewizard/pkg/types"
+
+	sqlite_vec "github.com/asg017/sqlite-vec-go-bindings/cgo"
+)
+
+func TestFileDictionary(t *testing.T) {
+	store := newWriterTestStore(t)
+
+	const file = "internal/index/indexer.go"
+	chunk := &types.ChunkWithEmbedding{
+		Chunk: &types.Chunk{
+			ID: file + ":10:abc", FilePath: file, Language: "go", Content: "func Index() error",
+			ChunkType: types.ChunkTypeFunction, Name: "Index", StartLine: 10, EndLine: 20, Hash: "abc",
+		},
+		Embedding: []float32{1, 0, 0, 0},
+	}
+	if err := store.StoreChunks([]*types.ChunkWithEmbedding{chunk}); err != nil {
+		t.Fatal(err)
+	}
+	if err := store.StoreSymbols([]*types.Symbol{{
+		ID: file + ":Index:10", Name: "Index", Kind: types.SymbolKindFunction, FilePath: file, StartLine: 10, EndLine: 20,
+	}}); err != nil {
+		t.Fatal(err)
+	}
+	if err := store.StoreReferences([]*types.Reference{{
+		ID: file + ":12:call:walk", FromSymbol: "Index", ToSymbol: "walk", Kind: types.RefKindCall, FilePath: file, Line: 12,
+	}}); err != nil {
+		t.Fatal(err)
+	}
+	if err := store.SetFileHash(file, "hash", "config"); err != nil {
+		t.Fatal(err)
+	}
+
+	var files int
+	store.db.QueryRow("SELECT COUNT(*) FROM files").Scan(&files)
+	if files != 1 {
+		t.Errorf("files has %d rows, want 1", files)
+	}
+
+	got, err := store.GetChunk(chunk.Chunk.ID)
+	if err != nil || got == nil || got.FilePath != file {
+		t.Fatalf("GetChunk = %+v, %v", got, err)
+	}
+	sym, err := store.GetSymbol(file + ":Index:10")
+	if err != nil || sym == nil || sym.FilePath != file {
+		t.Fatalf("GetSymbol = %+v, %v", sym, err)
+	}
+	if hash, _ := store.GetFileHash(file); hash != "hash" {
+		t.Errorf("GetFileHash = %q", hash)
+	}
+
+	// Storing a chunk again updates it in place; FTS and vectors follow
+	chunk.Chunk.Content = "func Reindex() error"
+	if err := store.StoreChunks([]*types.ChunkWithEmbedding{chunk}); err != nil {
+		t.Fatal(err)
+	}
+	results, err := store.Search(context.Background(), &types.SearchRequest{
+		Query: "Reindex", QueryVec: []float32{1, 0, 0, 0}, Limit: 10, Mode: types.SearchModeHybrid,
+	})
+	if err != nil {
+		t.Fatal(err)
+	}
+	if len(results) != 1 || results[0].Chunk.ID != chunk.Chunk.ID || results[0].BM25Score == 0 || results[0].VectorScore == 0 {
+		t.Errorf("search after update = %+v", results)
+	}
+
+	if err := store.DeleteChunksByFile(file); err != nil {
+		t.Fatal(err)
+	}
+	if got, _ := store.GetChunk(chunk.Chunk.ID); got != nil {
+		t.Error("chunk not deleted")
+	}
+	if callees, _ := store.GetCallees(file+":Index:10", 10); len(callees) != 0 {
+		t.Errorf("references not deleted: %d left", len(callees))
+	}
+}
+
+func TestMigrateStringKeyedIndex(t *testing.T) {
+	tmpDir, err := os.MkdirTemp("", "migratetest")
+	if err != nil {
+		t.Fatal(err)
+	}
+	defer os.RemoveAll(tmpDir)
+	path := tmpDir + "/index.db"
+
+	// An index written before the files dictionary
+	vecAutoOnce.Do(func() {
+		sqlite_vec.Auto()
+	})
+	db, err := sql.Open("sqlite3", path)
+	if err != nil {
+		t.Fatal(err)
+	}
+	for _, stmt := range []string{
+		`CREATE TABLE chunks (id TEXT PRIMARY KEY, file_path TEXT NOT NULL, language TEXT NOT NULL,
+			content TEXT NOT NULL, chunk_type TEXT NOT NULL, name TEXT, parent_name TEXT,
+			start_line INTEGER NOT NULL, end_line INTEGER NOT NULL, hash TEXT NOT NULL,
+			created_at DATETIME DEFAULT CURRENT_TIMESTAMP)`,
+		`CREATE INDEX idx_chunks_file_path ON chunks(file_path)`,
+		`CREATE VIRTUAL TABLE chunks_fts USING fts5(id, content, name, content='chunks', content_rowid='rowid')`,
+		`CREATE TRIGGER chunks_ai AFTER INSERT ON chunks BEGIN
+			INSERT INTO chunks_fts(rowid, id, content, name) VALUES (new.rowid, new.id, new.content, new.name);
+		END`,
+		`CREATE TABLE symbols (id TEXT PRIMARY KEY, name TEXT NOT NULL, kind TEXT NOT NULL, file_path TEXT NOT NULL,
+			start_line INTEGER NOT NULL, end_line INTEGER NOT NULL, line_count INTEGER NOT NULL DEFAULT 1,
+			signature TEXT, visibility TEXT, doc_comment TEXT)`,
+		`CREATE INDEX idx_symbols_name ON symbols(name)`,
+		`CREATE TABLE refs (id TEXT PRIMARY KEY, from_symbol TEXT NOT NULL, to_symbol TEXT NOT NULL, kind TEXT NOT NULL,
+			file_path TEXT NOT NULL, line INTEGER NOT NULL, is_external BOOLEAN NOT NULL DEFAULT FALSE)`,
+		`CREATE TABLE file_cache (file_path TEXT PRIMARY KEY, file_hash TEXT NOT NULL, config_hash TEXT NOT NULL,
+			indexed_at DATETIME DEFAULT CURRENT_TIMESTAMP)`,
+		`CREATE VIRTUAL TABLE chunk_embeddings USING vec0(chunk_id TEXT PRIMARY KEY, embedding float[4])`,
+		`INSERT INTO chunks (id, file_path, language, content, chunk_type, name, start_line, end_line, hash)
+			VALUES ('a.go:1:h', 'a.go', 'go', 'func Legacy()', 'function', 'Legacy', 1, 3, 'h')`,
+		`INSERT INTO symbols (id, name, kind, file_path, start_line, end_line) VALUES ('a.go:Legacy:1', 'Legacy', 'function', 'a.go', 1, 3)`,
+		`INSERT INTO refs (id, from_symbol, to_symbol, kind, file_path, line) VALUES ('a.go:2:call:x', 'Legacy', 'x', 'call', 'a.go', 2)`,
+		`INSERT INTO file_cache (file_path, file_hash, config_hash) VALUES ('a.go', 'hash', 'config')`,
+		`INSERT INTO chunk_embeddings (chunk_id, embedding) VALUES ('a.go:1:h', '[0,1,0,0]')`,
+		`PRAGMA user_version = 1`,
+	} {
+		if _, err := db.Exec(stmt); err != nil {
+			db.Close()
+			t.Skipf("cannot build legacy index: %v", err)
+		}
+	}
+	db.Close()
+
+	store := New()
+	if err := store.Init(path); err != nil {
+		t.Fatal(err)
+	}
+	defer store.Close()
+
+	if store.dimensions != 4 {
+		t.Errorf("dimensions = %d, want 4", store.dimensions)
+	}
+	if hash, _ := store.GetFileHash("a.go"); hash != "hash" {
+		t.Errorf("file hash = %q", hash)
+	}
+	if sym, _ := store.GetSymbol("a.go:Legacy:1"); sym == nil || sym.FilePath != "a.go" {
+		t.Errorf("symbol = %+v", sym)
+	}
+	if refs, _ := store.GetCallees("a.go:Legacy:1", 10); len(refs) != 1 || refs[0].FilePath != "a.go" {
+		t.Errorf("callees = %+v", refs)
+	}
+
+	results, err := store.Search(context.Background(), &types.SearchRequest{
+		Query: "Legacy", QueryVec: []float32{0, 1, 0, 0}, Limit: 10, Mode: types.SearchModeHybrid,
+	})
+	if err != nil {
+		t.Fatal(err)
+	}
+	if len(results) != 1 || results[0].Chunk.FilePath != "a.go" || results[0].BM25Score == 0 || results[0].VectorScore < 0.99 {
+		t.Errorf("search after migration = %+v", results)
+	}
+
+	var legacyTables int
+	store.db.QueryRow("SELECT COUNT(*) FROM sqlite_master WHERE name LIKE 'legacy_%'").Scan(&legacyTables)
+	if legacyTables != 0 {
+		t.Errorf("%d legacy tables left", legacyTables)
+	}
+}
+
+func TestDeleteChunksByFiles(t *testing.T) {
+	store := newWriterTestStore(t)
+
+	var chunks []*types.ChunkWithEmbedding
+	var symbols []*types.Symbol
+	for _, file := range []string{"a.go", "b.go", "c.go"} {
+		for line := 1; line <= 3; line++ {
+			chunks = append(chunks, &types.ChunkWithEmbedding{
+				Chunk: &types.Chunk{
+					ID: fmt.Sprintf("%s:%d:h", file, line), FilePath: file, Language: "go", Content: "func bulk()",
+					ChunkType: types.ChunkTypeFunction, StartLine: line, EndLine: line, Hash: "h",
+				},
+				Embedding: []float32{1, 0, 0, 0},
+			})
+		}
+		symbols = append(symbols, &types.Symbol{
+			ID: file + ":bulk:1", Name: "bulk", Kind: types.SymbolKindFunction, FilePath: file, StartLine: 1, EndLine: 3,
+		})
+	}
+	if err := store.StoreChunks(chunks); err != nil {
+		t.Fatal(err)
+	}
+	if err := store.StoreSymbols(symbols); err != nil {
+		t.Fatal(err)
+	}
+
+	if err := store.DeleteChunksByFiles([]string{"a.go", "c.go", "missing.go"}); err != nil {
+		t.Fatal(err)
+	}
+	if err := store.DeleteChunksByFiles(nil); err != nil {
+		t.Fatal(err)
+	}
+
+	count := func(query string) int {
+		var n int
+		if err := store.db.QueryRow(query).Scan(&n); err != nil {
+			t.Fatal(err)
+		}
+		return n
+	}
+	if n := count("SELECT COUNT(*) FROM chunks"); n != 3 {
+		t.Errorf("%d chunks left, want 3", n)
+	}
+	if n := count("SELECT COUNT(*) FROM chunk_embeddings"); n != 3 {
+		t.Errorf("%d embeddings left, want 3", n)
+	}
+	if n := count("SELECT COUNT(*) FROM symbols"); n != 1 {
+		t.Errorf("%d symbols left, want 1", n)
+	}
+	if got, _ := store.GetChunk("b.go:2:h"); got == nil {
+		t.Error("chunk of a kept file was deleted")
+	}
+	if err := store.CheckFTSHealth(); err != nil {
+		t.Errorf("FTS after bulk delete: %v", err)
+	}
+}
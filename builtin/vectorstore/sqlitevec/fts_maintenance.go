@@ -0,0 +1,186 @@
+package sqlitevec
+
+import (
+	"database/sql"
+	"errors"
+	"fmt"
+	"log/slog"
+	"time"
+)
+
+// The FTS triggers keep chunks_fts consistent with chunks, so indexing does
+// not rebuild it. Every write transaction adds an FTS5 segment, and FTS5's
+// automerge only partly keeps up. Once chunk writes have settled, a
+// background pass checks the segment count and, above ftsMaxSegments, merges
+// the segments in steps of ftsMergePages pages. Each step is its own bulk
+// write, so interactive writes are not held up.
+
+var (
+	// ftsMaintenanceDelay is how long after the last chunk write the
+	// maintenance pass runs.
+	ftsMaintenanceDelay = 10 * time.Second
+
+	// ftsMaxSegments is the segment count above which a pass merges.
+	ftsMaxSegments = 8
+)
+
+const (
+	// ftsMergePages bounds the pages written by one merge step.
+	ftsMergePages = 256
+
+	// ftsMaxMergeSteps bounds one maintenance pass.
+	ftsMaxMergeSteps = 10000
+)
+
+// scheduleFTSMaintenance (re)starts the maintenance timer after a chunk
+// write.
+func (s *Store) scheduleFTSMaintenance() {
+	if !s.enableFTS {
+		return
+	}
+
+	s.ftsMu.Lock()
+	defer s.ftsMu.Unlock()
+
+	if s.ftsTimer != nil {
+		s.ftsTimer.Reset(ftsMaintenanceDelay)
+		return
+	}
+	s.ftsTimer = time.AfterFunc(ftsMaintenanceDelay, func() {
+		s.ftsMu.Lock()
+		s.ftsTimer = nil
+		s.ftsMu.Unlock()
+
+		if err := s.MaintainFTS(); err != nil && !errors.Is(err, errStoreClosed) {
+			slog.Warn("FTS maintenance failed", "error", err)
+		}
+	})
+}
+
+// stopFTSMaintenance cancels a scheduled maintenance pass.
+func (s *Store) stopFTSMaintenance() {
+	s.ftsMu.Lock()
+	defer s.ftsMu.Unlock()
+
+	if s.ftsTimer != nil {
+		s.ftsTimer.Stop()
+		s.ftsTimer = nil
+	}
+}
+
+// MaintainFTS merges the FTS index segments if there are more than
+// ftsMaxSegments. Concurrent calls return immediately.
+func (s *Store) MaintainFTS() error {
+	if !s.ftsPassMu.TryLock() {
+		return nil
+	}
+	defer s.ftsPassMu.Unlock()
+
+	segments, err := s.ftsSegmentCount()
+	if err != nil || segments <= ftsMaxSegments {
+		return err
+	}
+
+	start, before := time.Now(), segments
+	for step := 0; step < ftsMaxMergeSteps && segments > 1; step++ {
+		var worked bool
+		err := s.write(writeBulk, func(tx *sql.Tx) error {
+			// A negative page count merges across levels, so the index
+			// converges to a single segment like 'optimize', in steps.
+			// Merges that write nothing change total_changes() by less than 2.
+			var changesBefore, changesAfter int64
+			if err := tx.QueryRow("SELECT total_changes()").Scan(&changesBefore); err != nil {
+				return err
+			}
+			if _, err := tx.Exec("INSERT INTO chunks_fts(chunks_fts, rank) VALUES('merge', ?)", -ftsMergePages); err != nil {
+				return err
+			}
+			if err := tx.QueryRow("SELECT total_changes()").Scan(&changesAfter); err != nil {
+				return err
+			}
+			worked = changesAfter-changesBefore >= 2
+			return nil
+		})
+		if err != nil {
+			return fmt.Errorf("failed to merge FTS segments: %w", err)
+		}
+		if !worked {
+			break
+		}
+		if segments, err = s.ftsSegmentCount(); err != nil {
+			return err
+		}
+	}
+
+	slog.Debug("merged FTS segments", "before", before, "after", segments, "duration", time.Since(start).Round(time.Millisecond))
+	return nil
+}
+
+// FTS5 keeps its index structure and statistics in records of the
+// chunks_fts_data shadow table.
+const (
+	ftsAveragesRowID  = 1  // Total row count and per-column token counts
+	ftsStructureRowID = 10 // Levels and segments of the index
+)
+
+// ftsStructureV2 follows the cookie in structure records written by FTS5
+// versions with contentless_delete support.
+var ftsStructureV2 = []byte{0xff, 0x00, 0x00, 0x01}
+
+// ftsSegmentCount returns the number of segments of the FTS index, 0 if it
+// is empty.
+func (s *Store) ftsSegmentCount() (int, error) {
+	record, err := s.ftsRecord(ftsStructureRowID)
+	if err != nil || record == nil {
+		return 0, err
+	}
+
+	// 4 byte cookie, optional V2 marker, varint level count, varint
+	// segment count
+	if len(record) < 4 {
+		return 0, errors.New("FTS structure record too short")
+	}
+	record = record[4:]
+	if len(record) >= 4 && string(record[:4]) == string(ftsStructureV2) {
+		record = record[4:]
+	}
+	_, n := getVarint(record)
+	if n == 0 {
+		return 0, errors.New("malformed FTS structure record")
+	}
+	segments, m := getVarint(record[n:])
+	if m == 0 {
+		return 0, errors.New("malformed FTS structure record")
+	}
+	return int(segments), nil
+}
+
+// ftsRecord reads a record of chunks_fts_data, nil if it does not exist.
+func (s *Store) ftsRecord(id int64) ([]byte, error) {
+	var record []byte
+	err := s.db.QueryRow("SELECT block FROM chunks_fts_data WHERE id = ?", id).Scan(&record)
+	if err == sql.ErrNoRows {
+		return nil, nil
+	}
+	if err != nil {
+		return nil, fmt.Errorf("failed to read FTS record %d: %w", id, err)
+	}
+	return record, nil
+}
+
+// getVarint decodes an SQLite varint: up to eight bytes of 7 bits, high bit
+// set on all but the last, and a ninth byte of 8 bits. It returns the value
+// and the number of bytes read, 0 if b is truncated.
+func getVarint(b []byte) (uint64, int) {
+	var v uint64
+	for i := 0; i < 9 && i < len(b); i++ {
+		if i == 8 {
+			return v<<8 | uint64(b[i]), 9
+		}
+		v = v<<7 | uint64(b[i]&0x7f)
+		if b[i]&0x80 == 0 {
+			return v, i + 1
+		}
+	}
+	return 0, 0
+}
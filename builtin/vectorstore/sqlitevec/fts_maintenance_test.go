@@ -0,0 +1,87 @@
+package sqlitevec
+
+import (
+	"fmt"
+	"testing"
+
+	"github.com/spetr/mcp-codewizard/pkg/types"
+)
+
+func TestGetVarint(t *testing.T) {
+	tests := []struct {
+		in   []byte
+		want uint64
+		n    int
+	}{
+		{[]byte{0x05}, 5, 1},
+		{[]byte{0x81, 0x00}, 128, 2},
+		{[]byte{0xff, 0x7f, 0x01}, 16383, 2},
+		{[]byte{0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff}, 1<<64 - 1, 9},
+		{[]byte{0x81}, 0, 0},
+		{nil, 0, 0},
+	}
+	for _, tt := range tests {
+		got, n := getVarint(tt.in)
+		if got != tt.want || n != tt.n {
+			t.Errorf("getVarint(%x) = %d, %d; want %d, %d", tt.in, got, n, tt.want, tt.n)
+		}
+	}
+}
+
+func TestMaintainFTS(t *testing.T) {
+	store := newWriterTestStore(t)
+
+	// Each StoreChunks commits separately and adds a segment
+	for i := 0; i < 24; i++ {
+		chunk := &types.ChunkWithEmbedding{Chunk: &types.Chunk{
+			ID: fmt.Sprintf("m.go:%d:h", i), FilePath: "m.go", Language: "go", Content: fmt.Sprintf("func merged%d()", i),
+			ChunkType: types.ChunkTypeFunction, StartLine: i, EndLine: i, Hash: "h",
+		}}
+		if err := store.StoreChunks([]*types.ChunkWithEmbedding{chunk}); err != nil {
+			t.Fatal(err)
+		}
+	}
+	store.stopFTSMaintenance()
+
+	before, err := store.ftsSegmentCount()
+	if err != nil {
+		t.Fatal(err)
+	}
+	if before <= ftsMaxSegments {
+		t.Skipf("automerge left only %d segments", before)
+	}
+	if err := store.MaintainFTS(); err != nil {
+		t.Fatal(err)
+	}
+	after, err := store.ftsSegmentCount()
+	if err != nil {
+		t.Fatal(err)
+	}
+	if after >= before || after > ftsMaxSegments {
+		t.Errorf("segments: %d before, %d after maintenance", before, after)
+	}
+
+	if err := store.CheckFTSHealth(); err != nil {
+		t.Errorf("healthy index reported as %v", err)
+	}
+	if err := store.DeleteChunksByFile("m.go"); err != nil {
+		t.Fatal(err)
+	}
+	if err := store.CheckFTSHealth(); err != nil {
+		t.Errorf("index after delete reported as %v", err)
+	}
+
+	// An FTS row without a chunk is what the health check must catch
+	if _, err := store.db.Exec("INSERT INTO chunks_fts(rowid, key, content, name) VALUES (999, 'x', 'orphan', '')"); err != nil {
+		t.Fatal(err)
+	}
+	if err := store.CheckFTSHealth(); err == nil {
+		t.Error("orphaned FTS row not detected")
+	}
+	if err := store.RebuildFTS(); err != nil {
+		t.Fatal(err)
+	}
+	if err := store.CheckFTSHealth(); err != nil {
+		t.Errorf("rebuilt index reported as %v", err)
+	}
+}
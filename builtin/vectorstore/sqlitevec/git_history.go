@@ -11,6 +11,7 @@ import (
 	"strings"
 	"time"
 
+	"github.com/spetr/mcp-codewizard/pkg/provider"
 	"github.com/spetr/mcp-codewizard/pkg/types"
 )
 
@@ -32,13 +33,19 @@ func (s *Store) createGitHistorySchema() error {
 			is_merge BOOLEAN DEFAULT FALSE,
 			is_tagged BOOLEAN DEFAULT FALSE,
 			tags TEXT,
-			branch TEXT
+			branch TEXT,
+			generation INTEGER NOT NULL DEFAULT 0
 		)
 	`)
 	if err != nil {
 		return fmt.Errorf("failed to create commits table: %w", err)
 	}
 
+	// Databases created before generation numbers were tracked
+	if err := s.addColumnIfMissing("commits", "generation", "INTEGER NOT NULL DEFAULT 0"); err != nil {
+		return err
+	}
+
 	// Indexes for commits
 	_, err = s.db.Exec(`CREATE INDEX IF NOT EXISTS idx_commits_date ON commits(date)`)
 	if err != nil {
@@ -52,6 +59,23 @@ func (s *Store) createGitHistorySchema() error {
 	if err != nil {
 		return err
 	}
+	_, err = s.db.Exec(`CREATE INDEX IF NOT EXISTS idx_commits_generation ON commits(generation)`)
+	if err != nil {
+		return err
+	}
+
+	// Commit graph edges (commits.parent_hash only keeps the first parent)
+	_, err = s.db.Exec(`
+		CREATE TABLE IF NOT EXISTS commit_parents (
+			commit_hash TEXT NOT NULL,
+			parent_hash TEXT NOT NULL,
+			ordinal INTEGER NOT NULL,
+			PRIMARY KEY (commit_hash, ordinal)
+		)
+	`)
+	if err != nil {
+		return fmt.Errorf("failed to create commit_parents table: %w", err)
+	}
 
 	// FTS5 for commit message search
 	_, err = s.db.Exec(`
@@ -89,23 +113,7 @@ func (s *Store) createGitHistorySchema() error {
 	}
 
 	// Changes table (file changes within commits)
-	_, err = s.db.Exec(`
-		CREATE TABLE IF NOT EXISTS changes (
-			id TEXT PRIMARY KEY,
-			commit_hash TEXT NOT NULL,
-			file_path TEXT NOT NULL,
-			change_type TEXT NOT NULL,
-			old_path TEXT,
-			diff_content TEXT,
-			additions INTEGER DEFAULT 0,
-			deletions INTEGER DEFAULT 0,
-			affected_functions TEXT,
-			affected_chunk_ids TEXT,
-			hunks TEXT,
-			FOREIGN KEY (commit_hash) REFERENCES commits(hash)
-		)
-	`)
-	if err != nil {
+	if err := s.createChangesTable(); err != nil {
 		return fmt.Errorf("failed to create changes table: %w", err)
 	}
 
@@ -114,7 +122,7 @@ func (s *Store) createGitHistorySchema() error {
 	if err != nil {
 		return err
 	}
-	_, err = s.db.Exec(`CREATE INDEX IF NOT EXISTS idx_changes_file ON changes(file_path)`)
+	_, err = s.db.Exec(`CREATE INDEX IF NOT EXISTS idx_changes_file ON changes(file_id)`)
 	if err != nil {
 		return err
 	}
@@ -123,6 +131,19 @@ func (s *Store) createGitHistorySchema() error {
 		return err
 	}
 
+	// Per-commit search features, precomputed when changes are stored.
+	// paths and symbols are lowercased and newline separated.
+	_, err = s.db.Exec(`
+		CREATE TABLE IF NOT EXISTS commit_features (
+			commit_hash TEXT PRIMARY KEY,
+			paths TEXT NOT NULL DEFAULT '',
+			symbols TEXT NOT NULL DEFAULT ''
+		)
+	`)
+	if err != nil {
+		return fmt.Errorf("failed to create commit_features table: %w", err)
+	}
+
 	// Chunk history table (links chunks to their commit history)
 	_, err = s.db.Exec(`
 		CREATE TABLE IF NOT EXISTS chunk_history (
@@ -161,17 +182,109 @@ func (s *Store) createGitHistorySchema() error {
 		return fmt.Errorf("failed to create git_index_meta table: %w", err)
 	}
 
+	if err := s.backfillCommitGraph(); err != nil {
+		return fmt.Errorf("failed to backfill commit graph: %w", err)
+	}
+
+	if err := s.createContributorSchema(); err != nil {
+		return err
+	}
+
 	return nil
 }
 
+// createChangesTable creates the changes table. Tables of databases from
+// before the files dictionary, which store file paths, are converted to
+// file ids.
+func (s *Store) createChangesTable() error {
+	legacy, err := columnExists(s.db, "changes", "file_path")
+	if err != nil {
+		return err
+	}
+	if legacy {
+		// Diffs and hunks are stored compressed in diff_blob/hunks_blob;
+		// rows written before that keep their text in diff_content/hunks.
+		for _, col := range []struct{ name, decl string }{
+			{"diff_blob", "BLOB"},
+			{"hunks_blob", "BLOB"},
+			{"raw_size", "INTEGER NOT NULL DEFAULT 0"},
+		} {
+			if err := s.addColumnIfMissing("changes", col.name, col.decl); err != nil {
+				return err
+			}
+		}
+	}
+
+	tx, err := s.db.Begin()
+	if err != nil {
+		return err
+	}
+	defer tx.Rollback()
+
+	if legacy {
+		for _, stmt := range []string{
+			"DROP INDEX IF EXISTS idx_changes_commit",
+			"DROP INDEX IF EXISTS idx_changes_file",
+			"DROP INDEX IF EXISTS idx_changes_type",
+			"ALTER TABLE changes RENAME TO legacy_changes",
+		} {
+			if _, err := tx.Exec(stmt); err != nil {
+				return err
+			}
+		}
+	}
+
+	_, err = tx.Exec(`
+		CREATE TABLE IF NOT EXISTS changes (
+			id TEXT PRIMARY KEY,
+			commit_hash TEXT NOT NULL,
+			file_id INTEGER NOT NULL REFERENCES files(id),
+			change_type TEXT NOT NULL,
+			old_path TEXT,
+			diff_content TEXT,
+			additions INTEGER DEFAULT 0,
+			deletions INTEGER DEFAULT 0,
+			affected_functions TEXT,
+			affected_chunk_ids TEXT,
+			hunks TEXT,
+			diff_blob BLOB,
+			hunks_blob BLOB,
+			raw_size INTEGER NOT NULL DEFAULT 0,
+			FOREIGN KEY (commit_hash) REFERENCES commits(hash)
+		)
+	`)
+	if err != nil {
+		return err
+	}
+
+	if legacy {
+		for _, stmt := range []string{
+			"INSERT OR IGNORE INTO files (path) SELECT DISTINCT file_path FROM legacy_changes",
+			`INSERT INTO changes
+			 (id, commit_hash, file_id, change_type, old_path, diff_content, additions, deletions,
+			  affected_functions, affected_chunk_ids, hunks, diff_blob, hunks_blob, raw_size)
+			 SELECT l.id, l.commit_hash, f.id, l.change_type, l.old_path, l.diff_content, l.additions, l.deletions,
+			        l.affected_functions, l.affected_chunk_ids, l.hunks, l.diff_blob, l.hunks_blob, l.raw_size
+			 FROM legacy_changes l JOIN files f ON f.path = l.file_path`,
+			"DROP TABLE legacy_changes",
+		} {
+			if _, err := tx.Exec(stmt); err != nil {
+				return err
+			}
+		}
+	}
+
+	return tx.Commit()
+}
+
 // createCommitEmbeddingsTable creates vector table for commit message embeddings.
-func (s *Store) createCommitEmbeddingsTable(dimensions int) error {
-	_, err := s.db.Exec(fmt.Sprintf(`
-		CREATE VIRTUAL TABLE IF NOT EXISTS commit_embeddings USING vec0(
+func createCommitEmbeddingsTable(tx *sql.Tx, schema string, dimensions int) error {
+	_, err := tx.Exec(fmt.Sprintf(`
+		CREATE VIRTUAL TABLE IF NOT EXISTS %s.commit_embeddings USING vec0(
 			commit_hash TEXT PRIMARY KEY,
 			embedding float[%d]
 		)
-	`, dimensions))
+	`, schema, dimensions))
 	if err != nil {
 		return fmt.Errorf("failed to create commit_embeddings table: %w", err)
 	}
@@ -179,132 +292,158 @@ func (s *Store) createCommitEmbeddingsTable(dimensions int) error {
 }
 
 // createChangeEmbeddingsTable creates vector table for diff embeddings.
-func (s *Store) createChangeEmbeddingsTable(dimensions int) error {
-	_, err := s.db.Exec(fmt.Sprintf(`
-		CREATE VIRTUAL TABLE IF NOT EXISTS change_embeddings USING vec0(
+func createChangeEmbeddingsTable(tx *sql.Tx, schema string, dimensions int) error {
+	_, err := tx.Exec(fmt.Sprintf(`
+		CREATE VIRTUAL TABLE IF NOT EXISTS %s.change_embeddings USING vec0(
 			change_id TEXT PRIMARY KEY,
 			embedding float[%d]
 		)
-	`, dimensions))
+	`, schema, dimensions))
 	if err != nil {
 		return fmt.Errorf("failed to create change_embeddings table: %w", err)
 	}
 	return nil
 }
 
+// createCommitDiffEmbeddingsTable creates vector table for per-commit diff
+// embeddings (the normalized mean of the commit's change embeddings).
+func createCommitDiffEmbeddingsTable(tx *sql.Tx, schema string, dimensions int) error {
+	_, err := tx.Exec(fmt.Sprintf(`
+		CREATE VIRTUAL TABLE IF NOT EXISTS %s.commit_diff_embeddings USING vec0(
+			commit_hash TEXT PRIMARY KEY,
+			embedding float[%d]
+		)
+	`, schema, dimensions))
+	if err != nil {
+		return fmt.Errorf("failed to create commit_diff_embeddings table: %w", err)
+	}
+	return nil
+}
+
 // StoreCommits stores commits with optional embeddings.
+// Commit graph edges and generation numbers are maintained alongside.
 func (s *Store) StoreCommits(commits []*types.Commit) error {
 	if len(commits) == 0 {
 		return nil
 	}
 
-	// Create embedding table if we have embeddings
-	for _, c := range commits {
-		if len(c.MessageEmbedding) > 0 {
-			if err := s.createCommitEmbeddingsTable(len(c.MessageEmbedding)); err != nil {
-				return err
+	return s.writeTo(subsysHistory, writeBulk, func(tx *sql.Tx) error {
+		// Create embedding table if we have embeddings
+		for _, c := range commits {
+			if len(c.MessageEmbedding) > 0 {
+				if err := createCommitEmbeddingsTable(tx, s.schema(subsysHistory), len(c.MessageEmbedding)); err != nil {
+					return err
+				}
+				break
 			}
-			break
 		}
-	}
-
-	tx, err := s.db.Begin()
-	if err != nil {
-		return err
-	}
-	defer tx.Rollback()
 
-	commitStmt, err := tx.Prepare(`
-		INSERT OR REPLACE INTO commits
-		(hash, short_hash, author, author_email, date, message, parent_hash,
-		 files_changed, insertions, deletions, is_merge, is_tagged, tags, branch)
-		VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?)
-	`)
-	if err != nil {
-		return err
-	}
-	defer commitStmt.Close()
+		generations, err := computeGenerations(tx, commits)
+		if err != nil {
+			return fmt.Errorf("failed to compute commit generations: %w", err)
+		}
 
-	embStmt, err := tx.Prepare(`
-		INSERT OR REPLACE INTO commit_embeddings (commit_hash, embedding)
-		VALUES (?, ?)
-	`)
-	if err != nil {
-		// Embedding table might not exist yet
-		embStmt = nil
-	} else {
-		defer embStmt.Close()
-	}
+		commitStmt, err := tx.Prepare(`
+			INSERT OR REPLACE INTO commits
+			(hash, short_hash, author, author_email, date, message, parent_hash,
+			 files_changed, insertions, deletions, is_merge, is_tagged, tags, branch, generation)
+			VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?)
+		`)
+		if err != nil {
+			return err
+		}
+		defer commitStmt.Close()
 
-	for _, c := range commits {
-		var tagsJSON string
-		if len(c.Tags) > 0 {
-			b, _ := json.Marshal(c.Tags)
-			tagsJSON = string(b)
+		parentStmt, err := tx.Prepare(`
+			INSERT OR REPLACE INTO commit_parents (commit_hash, parent_hash, ordinal)
+			VALUES (?, ?, ?)
+		`)
+		if err != nil {
+			return err
 		}
+		defer parentStmt.Close()
 
-		_, err := commitStmt.Exec(
-			c.Hash, c.ShortHash, c.Author, c.AuthorEmail,
-			c.Date.Unix(), c.Message, c.ParentHash,
-			c.FilesChanged, c.Insertions, c.Deletions,
-			c.IsMerge, c.IsTagged, tagsJSON, c.Branch,
-		)
+		embStmt, err := tx.Prepare(`
+			INSERT OR REPLACE INTO commit_embeddings (commit_hash, embedding)
+			VALUES (?, ?)
+		`)
 		if err != nil {
-			return fmt.Errorf("failed to store commit %s: %w", c.Hash, err)
+			// Embedding table might not exist yet
+			embStmt = nil
+		} else {
+			defer embStmt.Close()
 		}
 
-		// Store embedding if present
-		if embStmt != nil && len(c.MessageEmbedding) > 0 {
-			embBytes := floatsToBytes(c.MessageEmbedding)
-			_, err := embStmt.Exec(c.Hash, embBytes)
+		for _, c := range commits {
+			var tagsJSON string
+			if len(c.Tags) > 0 {
+				b, _ := json.Marshal(c.Tags)
+				tagsJSON = string(b)
+			}
+
+			_, err := commitStmt.Exec(
+				c.Hash, c.ShortHash, c.Author, c.AuthorEmail,
+				c.Date.Unix(), c.Message, c.ParentHash,
+				c.FilesChanged, c.Insertions, c.Deletions,
+				c.IsMerge, c.IsTagged, tagsJSON, c.Branch, generations[c.Hash],
+			)
 			if err != nil {
-				return fmt.Errorf("failed to store embedding for commit %s: %w", c.Hash, err)
+				return fmt.Errorf("failed to store commit %s: %w", c.Hash, err)
+			}
+			c.Generation = generations[c.Hash]
+
+			for i, parent := range commitParents(c) {
+				if _, err := parentStmt.Exec(c.Hash, parent, i); err != nil {
+					return fmt.Errorf("failed to store parents of commit %s: %w", c.Hash, err)
+				}
+			}
+
+			// Store embedding if present
+			if embStmt != nil && len(c.MessageEmbedding) > 0 {
+				embBytes := floatsToBytes(c.MessageEmbedding)
+				_, err := embStmt.Exec(c.Hash, embBytes)
+				if err != nil {
+					return fmt.Errorf("failed to store embedding for commit %s: %w", c.Hash, err)
+				}
 			}
 		}
-	}
 
-	return tx.Commit()
+		return nil
+	})
 }
 
 // GetCommit retrieves a commit by hash.
 func (s *Store) GetCommit(hash string) (*types.Commit, error) {
 	row := s.db.QueryRow(`
 		SELECT hash, short_hash, author, author_email, date, message, parent_hash,
-		       files_changed, insertions, deletions, is_merge, is_tagged, tags, branch
+		       files_changed, insertions, deletions, is_merge, is_tagged, tags, branch, generation
 		FROM commits WHERE hash = ? OR short_hash = ?
 	`, hash, hash)
 
 	return scanCommit(row)
 }
 
-// GetCommitRange returns commits between two hashes.
+// GetCommitRange returns commits reachable from toHash but not from fromHash
+// (git's fromHash..toHash), newest first. An empty or "HEAD" toHash means the
+// newest indexed commit; an empty fromHash means no lower bound.
 func (s *Store) GetCommitRange(fromHash, toHash string) ([]*types.Commit, error) {
-	// Get the date range from the commits
-	var fromDate, toDate int64
+	ctx := context.Background()
 
-	if fromHash != "" {
-		row := s.db.QueryRow("SELECT date FROM commits WHERE hash = ? OR short_hash = ?", fromHash, fromHash)
-		if err := row.Scan(&fromDate); err != nil && err != sql.ErrNoRows {
-			return nil, err
-		}
+	hashes, err := s.resolveCommitRange(ctx, fromHash, toHash)
+	if err != nil {
+		return nil, err
 	}
-
-	if toHash != "" {
-		row := s.db.QueryRow("SELECT date FROM commits WHERE hash = ? OR short_hash = ?", toHash, toHash)
-		if err := row.Scan(&toDate); err != nil && err != sql.ErrNoRows {
-			return nil, err
-		}
-	} else {
-		toDate = time.Now().Unix()
+	if len(hashes) == 0 {
+		return nil, nil
 	}
 
-	rows, err := s.db.Query(`
+	rows, err := s.queryContext(ctx, `
 		SELECT hash, short_hash, author, author_email, date, message, parent_hash,
-		       files_changed, insertions, deletions, is_merge, is_tagged, tags, branch
+		       files_changed, insertions, deletions, is_merge, is_tagged, tags, branch, generation
 		FROM commits
-		WHERE date >= ? AND date <= ?
+		WHERE hash IN (SELECT value FROM json_each(?))
 		ORDER BY date DESC
-	`, fromDate, toDate)
+	`, jsonArray(hashes))
 	if err != nil {
 		return nil, err
 	}
@@ -328,7 +467,7 @@ func (s *Store) GetCommitsByTimeRange(from, to *time.Time, limit int) ([]*types.
 
 	rows, err := s.db.Query(`
 		SELECT hash, short_hash, author, author_email, date, message, parent_hash,
-		       files_changed, insertions, deletions, is_merge, is_tagged, tags, branch
+		       files_changed, insertions, deletions, is_merge, is_tagged, tags, branch, generation
 		FROM commits
 		WHERE date >= ? AND date <= ?
 		ORDER BY date DESC
@@ -355,11 +494,13 @@ func (s *Store) GetLastIndexedCommit() (string, error) {
 
 // SetLastIndexedCommit sets the hash of the last indexed commit.
 func (s *Store) SetLastIndexedCommit(hash string) error {
-	_, err := s.db.Exec(`
-		INSERT OR REPLACE INTO git_index_meta (key, value)
-		VALUES ('last_indexed_commit', ?)
-	`, hash)
-	return err
+	return s.writeTo(subsysHistory, writeBulk, func(tx *sql.Tx) error {
+		_, err := tx.Exec(`
+			INSERT OR REPLACE INTO git_index_meta (key, value)
+			VALUES ('last_indexed_commit', ?)
+		`, hash)
+		return err
+	})
 }
 
 // StoreChanges stores file changes with optional embeddings.
@@ -368,87 +509,268 @@ func (s *Store) StoreChanges(changes []*types.Change) error {
 		return nil
 	}
 
-	// Create embedding table if we have embeddings
-	for _, c := range changes {
-		if len(c.DiffEmbedding) > 0 {
-			if err := s.createChangeEmbeddingsTable(len(c.DiffEmbedding)); err != nil {
-				return err
+	// The files dictionary belongs to the index
+	paths := make([]string, len(changes))
+	for i, c := range changes {
+		paths[i] = c.FilePath
+	}
+	fileIDs, err := s.addFiles(paths)
+	if err != nil {
+		return err
+	}
+
+	return s.writeTo(subsysHistory, writeBulk, func(tx *sql.Tx) error {
+		// Create embedding tables if we have embeddings
+		for _, c := range changes {
+			if len(c.DiffEmbedding) > 0 {
+				if err := createChangeEmbeddingsTable(tx, s.schema(subsysHistory), len(c.DiffEmbedding)); err != nil {
+					return err
+				}
+				if err := createCommitDiffEmbeddingsTable(tx, s.schema(subsysHistory), len(c.DiffEmbedding)); err != nil {
+					return err
+				}
+				break
 			}
-			break
 		}
-	}
 
-	tx, err := s.db.Begin()
+		changeStmt, err := tx.Prepare(`
+			INSERT OR REPLACE INTO changes
+			(id, commit_hash, file_id, change_type, old_path, diff_content,
+			 additions, deletions, affected_functions, affected_chunk_ids, hunks,
+			 diff_blob, hunks_blob, raw_size)
+			VALUES (?, ?, ?, ?, ?, NULL, ?, ?, ?, ?, NULL, ?, ?, ?)
+		`)
+		if err != nil {
+			return err
+		}
+		defer changeStmt.Close()
+
+		embStmt, err := tx.Prepare(`
+			INSERT OR REPLACE INTO change_embeddings (change_id, embedding)
+			VALUES (?, ?)
+		`)
+		if err != nil {
+			embStmt = nil
+		} else {
+			defer embStmt.Close()
+		}
+
+		for _, c := range changes {
+			fileID := fileIDs[c.FilePath]
+
+			var affectedFuncsJSON, affectedChunksJSON string
+			var hunksJSON []byte
+
+			if len(c.AffectedFunctions) > 0 {
+				b, _ := json.Marshal(c.AffectedFunctions)
+				affectedFuncsJSON = string(b)
+			}
+			if len(c.AffectedChunkIDs) > 0 {
+				b, _ := json.Marshal(c.AffectedChunkIDs)
+				affectedChunksJSON = string(b)
+			}
+			if len(c.Hunks) > 0 {
+				hunksJSON, _ = json.Marshal(c.Hunks)
+			}
+
+			diffBlob, err := compressDiff([]byte(c.DiffContent))
+			if err != nil {
+				return fmt.Errorf("failed to compress diff for change %s: %w", c.ID, err)
+			}
+			hunksBlob, err := compressDiff(hunksJSON)
+			if err != nil {
+				return fmt.Errorf("failed to compress hunks for change %s: %w", c.ID, err)
+			}
+
+			_, err = changeStmt.Exec(
+				c.ID, c.CommitHash, fileID, string(c.ChangeType), c.OldPath,
+				c.Additions, c.Deletions,
+				affectedFuncsJSON, affectedChunksJSON,
+				diffBlob, hunksBlob, len(c.DiffContent)+len(hunksJSON),
+			)
+			if err != nil {
+				return fmt.Errorf("failed to store change %s: %w", c.ID, err)
+			}
+
+			// Store embedding if present
+			if embStmt != nil && len(c.DiffEmbedding) > 0 {
+				embBytes := floatsToBytes(c.DiffEmbedding)
+				_, err := embStmt.Exec(c.ID, embBytes)
+				if err != nil {
+					return fmt.Errorf("failed to store embedding for change %s: %w", c.ID, err)
+				}
+			}
+		}
+
+		if err := updateCommitFeatures(tx, changes); err != nil {
+			return fmt.Errorf("failed to update commit features: %w", err)
+		}
+
+		if err := updateChangeLinks(tx, changes); err != nil {
+			return fmt.Errorf("failed to update change links: %w", err)
+		}
+
+		if err := updateContributorStats(tx, changeCommitHashes(changes)); err != nil {
+			return fmt.Errorf("failed to update contributor stats: %w", err)
+		}
+
+		return nil
+	})
+}
+
+// updateCommitFeatures recomputes the precomputed search features of every
+// commit touched by changes: lowercased touched paths and affected symbols
+// from all stored changes of the commit, and the normalized mean of the diff
+// embeddings in this batch.
+func updateCommitFeatures(tx *sql.Tx, changes []*types.Change) error {
+	hashes := changeCommitHashes(changes)
+
+	rows, err := tx.Query(`
+		SELECT c.commit_hash, f.path, c.old_path, c.affected_functions
+		FROM changes c JOIN files f ON f.id = c.file_id
+		WHERE c.commit_hash IN (SELECT value FROM json_each(?))
+	`, jsonArray(hashes))
 	if err != nil {
 		return err
 	}
-	defer tx.Rollback()
 
-	changeStmt, err := tx.Prepare(`
-		INSERT OR REPLACE INTO changes
-		(id, commit_hash, file_path, change_type, old_path, diff_content,
-		 additions, deletions, affected_functions, affected_chunk_ids, hunks)
-		VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?)
+	paths := make(map[string]map[string]bool)
+	symbols := make(map[string]map[string]bool)
+	for rows.Next() {
+		var hash, filePath string
+		var oldPath, affectedFuncs sql.NullString
+		if err := rows.Scan(&hash, &filePath, &oldPath, &affectedFuncs); err != nil {
+			rows.Close()
+			return err
+		}
+
+		if paths[hash] == nil {
+			paths[hash] = make(map[string]bool)
+			symbols[hash] = make(map[string]bool)
+		}
+		paths[hash][strings.ToLower(filePath)] = true
+		if oldPath.String != "" {
+			paths[hash][strings.ToLower(oldPath.String)] = true
+		}
+
+		if affectedFuncs.String != "" {
+			var funcs []string
+			json.Unmarshal([]byte(affectedFuncs.String), &funcs)
+			for _, fn := range funcs {
+				symbols[hash][strings.ToLower(fn)] = true
+			}
+		}
+	}
+	rows.Close()
+	if err := rows.Err(); err != nil {
+		return err
+	}
+
+	featureStmt, err := tx.Prepare(`
+		INSERT OR REPLACE INTO commit_features (commit_hash, paths, symbols)
+		VALUES (?, ?, ?)
 	`)
 	if err != nil {
 		return err
 	}
-	defer changeStmt.Close()
+	defer featureStmt.Close()
+
+	for _, hash := range hashes {
+		_, err := featureStmt.Exec(hash, joinSortedKeys(paths[hash]), joinSortedKeys(symbols[hash]))
+		if err != nil {
+			return err
+		}
+	}
+
+	// Per-commit diff embedding: mean of the normalized change embeddings
+	sums := make(map[string][]float32)
+	for _, c := range changes {
+		if len(c.DiffEmbedding) == 0 {
+			continue
+		}
+		sum := sums[c.CommitHash]
+		if sum == nil {
+			sum = make([]float32, len(c.DiffEmbedding))
+			sums[c.CommitHash] = sum
+		}
+		if len(sum) != len(c.DiffEmbedding) {
+			continue
+		}
+		norm := vectorNorm(c.DiffEmbedding)
+		if norm == 0 {
+			continue
+		}
+		for i, v := range c.DiffEmbedding {
+			sum[i] += v / norm
+		}
+	}
+	if len(sums) == 0 {
+		return nil
+	}
 
 	embStmt, err := tx.Prepare(`
-		INSERT OR REPLACE INTO change_embeddings (change_id, embedding)
+		INSERT OR REPLACE INTO commit_diff_embeddings (commit_hash, embedding)
 		VALUES (?, ?)
 	`)
 	if err != nil {
-		embStmt = nil
-	} else {
-		defer embStmt.Close()
+		return err
 	}
+	defer embStmt.Close()
 
-	for _, c := range changes {
-		var affectedFuncsJSON, affectedChunksJSON, hunksJSON string
-
-		if len(c.AffectedFunctions) > 0 {
-			b, _ := json.Marshal(c.AffectedFunctions)
-			affectedFuncsJSON = string(b)
-		}
-		if len(c.AffectedChunkIDs) > 0 {
-			b, _ := json.Marshal(c.AffectedChunkIDs)
-			affectedChunksJSON = string(b)
+	for _, hash := range hashes {
+		sum, ok := sums[hash]
+		if !ok {
+			continue
 		}
-		if len(c.Hunks) > 0 {
-			b, _ := json.Marshal(c.Hunks)
-			hunksJSON = string(b)
+		// Cosine distance ignores magnitude, so the sum is as good as the mean
+		if _, err := embStmt.Exec(hash, floatsToBytes(sum)); err != nil {
+			return err
 		}
+	}
 
-		_, err := changeStmt.Exec(
-			c.ID, c.CommitHash, c.FilePath, string(c.ChangeType), c.OldPath,
-			c.DiffContent, c.Additions, c.Deletions,
-			affectedFuncsJSON, affectedChunksJSON, hunksJSON,
-		)
-		if err != nil {
-			return fmt.Errorf("failed to store change %s: %w", c.ID, err)
-		}
+	return nil
+}
 
-		// Store embedding if present
-		if embStmt != nil && len(c.DiffEmbedding) > 0 {
-			embBytes := floatsToBytes(c.DiffEmbedding)
-			_, err := embStmt.Exec(c.ID, embBytes)
-			if err != nil {
-				return fmt.Errorf("failed to store embedding for change %s: %w", c.ID, err)
-			}
+// changeCommitHashes returns the distinct commit hashes of changes in order.
+func changeCommitHashes(changes []*types.Change) []string {
+	var hashes []string
+	seen := make(map[string]bool)
+	for _, c := range changes {
+		if !seen[c.CommitHash] {
+			seen[c.CommitHash] = true
+			hashes = append(hashes, c.CommitHash)
 		}
 	}
+	return hashes
+}
 
-	return tx.Commit()
+// joinSortedKeys joins set members with newlines in sorted order.
+func joinSortedKeys(set map[string]bool) string {
+	keys := make([]string, 0, len(set))
+	for k := range set {
+		keys = append(keys, k)
+	}
+	sort.Strings(keys)
+	return strings.Join(keys, "\n")
+}
+
+// vectorNorm returns the Euclidean norm of a vector.
+func vectorNorm(v []float32) float32 {
+	var sum float64
+	for _, x := range v {
+		sum += float64(x) * float64(x)
+	}
+	return float32(math.Sqrt(sum))
 }
 
 // GetChange retrieves a change by ID.
 func (s *Store) GetChange(id string) (*types.Change, error) {
 	row := s.db.QueryRow(`
-		SELECT id, commit_hash, file_path, change_type, old_path, diff_content,
-		       additions, deletions, affected_functions, affected_chunk_ids, hunks
-		FROM changes WHERE id = ?
+		SELECT c.id, c.commit_hash, f.path, c.change_type, c.old_path, c.diff_content,
+		       c.additions, c.deletions, c.affected_functions, c.affected_chunk_ids, c.hunks,
+		       c.diff_blob, c.hunks_blob
+		FROM changes c JOIN files f ON f.id = c.file_id
+		WHERE c.id = ?
 	`, id)
 
 	return scanChange(row)
@@ -457,9 +779,11 @@ func (s *Store) GetChange(id string) (*types.Change, error) {
 // GetChangesByCommit returns all changes for a commit.
 func (s *Store) GetChangesByCommit(commitHash string) ([]*types.Change, error) {
 	rows, err := s.db.Query(`
-		SELECT id, commit_hash, file_path, change_type, old_path, diff_content,
-		       additions, deletions, affected_functions, affected_chunk_ids, hunks
-		FROM changes WHERE commit_hash = ?
+		SELECT c.id, c.commit_hash, f.path, c.change_type, c.old_path, c.diff_content,
+		       c.additions, c.deletions, c.affected_functions, c.affected_chunk_ids, c.hunks,
+		       c.diff_blob, c.hunks_blob
+		FROM changes c JOIN files f ON f.id = c.file_id
+		WHERE c.commit_hash = ?
 	`, commitHash)
 	if err != nil {
 		return nil, err
@@ -472,11 +796,13 @@ func (s *Store) GetChangesByCommit(commitHash string) ([]*types.Change, error) {
 // GetChangesByFile returns changes for a specific file.
 func (s *Store) GetChangesByFile(filePath string, limit int) ([]*types.Change, error) {
 	rows, err := s.db.Query(`
-		SELECT c.id, c.commit_hash, c.file_path, c.change_type, c.old_path, c.diff_content,
-		       c.additions, c.deletions, c.affected_functions, c.affected_chunk_ids, c.hunks
+		SELECT c.id, c.commit_hash, f.path, c.change_type, c.old_path, c.diff_content,
+		       c.additions, c.deletions, c.affected_functions, c.affected_chunk_ids, c.hunks,
+		       c.diff_blob, c.hunks_blob
 		FROM changes c
+		JOIN files f ON f.id = c.file_id
 		JOIN commits cm ON c.commit_hash = cm.hash
-		WHERE c.file_path = ?
+		WHERE f.path = ?
 		ORDER BY cm.date DESC
 		LIMIT ?
 	`, filePath, limit)
@@ -494,33 +820,29 @@ func (s *Store) StoreChunkHistory(entries []*types.ChunkHistoryEntry) error {
 		return nil
 	}
 
-	tx, err := s.db.Begin()
-	if err != nil {
-		return err
-	}
-	defer tx.Rollback()
-
-	stmt, err := tx.Prepare(`
-		INSERT OR REPLACE INTO chunk_history
-		(chunk_id, commit_hash, change_type, diff_summary, date, author)
-		VALUES (?, ?, ?, ?, ?, ?)
-	`)
-	if err != nil {
-		return err
-	}
-	defer stmt.Close()
-
-	for _, e := range entries {
-		_, err := stmt.Exec(
-			e.ChunkID, e.CommitHash, e.ChangeType,
-			e.DiffSummary, e.Date.Unix(), e.Author,
-		)
+	return s.writeTo(subsysHistory, writeBulk, func(tx *sql.Tx) error {
+		stmt, err := tx.Prepare(`
+			INSERT OR REPLACE INTO chunk_history
+			(chunk_id, commit_hash, change_type, diff_summary, date, author)
+			VALUES (?, ?, ?, ?, ?, ?)
+		`)
 		if err != nil {
-			return fmt.Errorf("failed to store chunk history: %w", err)
+			return err
 		}
-	}
+		defer stmt.Close()
 
-	return tx.Commit()
+		for _, e := range entries {
+			_, err := stmt.Exec(
+				e.ChunkID, e.CommitHash, e.ChangeType,
+				e.DiffSummary, e.Date.Unix(), e.Author,
+			)
+			if err != nil {
+				return fmt.Errorf("failed to store chunk history: %w", err)
+			}
+		}
+
+		return nil
+	})
 }
 
 // GetChunkHistory returns history for a chunk.
@@ -610,238 +932,484 @@ func (s *Store) GetChunkEvolution(chunkID string) (*types.ChunkEvolution, error)
 }
 
 // SearchHistory performs semantic search across git history.
+//
+// Each search leg (commit message vectors, diff vectors, commit message BM25)
+// only returns candidate IDs with their scores. Commits and changes for all
+// candidates are then hydrated with one batched query each, so the number of
+// queries does not depend on the number of candidates.
 func (s *Store) SearchHistory(ctx context.Context, req *types.HistorySearchRequest) ([]*types.HistorySearchResult, error) {
 	candidateLimit := req.Limit * 5
 	if req.UseReranker && req.RerankCandidates > 0 {
 		candidateLimit = req.RerankCandidates
 	}
 
-	var results []*types.HistorySearchResult
+	// Phase 1: collect candidate IDs and scores from each leg
+	var vecMsgHits, bm25MsgHits, diffHits []scoredID
 
-	// Search commit messages (vector + BM25)
 	if len(req.QueryVec) > 0 {
-		commits, err := s.SearchCommitMessages(ctx, req.QueryVec, candidateLimit)
+		var err error
+		vecMsgHits, err = s.vectorSearchCommitIDs(ctx, req.QueryVec, candidateLimit)
 		if err != nil {
 			return nil, fmt.Errorf("commit message search failed: %w", err)
 		}
 
-		for _, commit := range commits {
-			// Get changes for this commit
-			changes, _ := s.GetChangesByCommit(commit.Hash)
+		// Diff embeddings might not exist
+		diffHits, _ = s.vectorSearchChangeIDs(ctx, req.QueryVec, candidateLimit)
+	}
 
-			// Apply filters
-			if !s.matchesHistoryFilters(commit, changes, req) {
-				continue
+	if req.Query != "" {
+		hits, err := s.bm25SearchCommitIDs(ctx, req.Query, candidateLimit)
+		if err != nil {
+			// BM25 is the only leg without a query vector
+			if len(req.QueryVec) == 0 {
+				return nil, err
 			}
+		} else {
+			bm25MsgHits = hits
+		}
+	}
 
-			for _, change := range changes {
-				results = append(results, &types.HistorySearchResult{
-					Change:       change,
-					Commit:       commit,
-					MessageScore: 1.0, // Placeholder - actual scoring done below
-				})
-			}
+	// Fuse message scores from the vector and BM25 legs
+	vectorWeight, bm25Weight := float32(1.0), float32(1.0)
+	if len(vecMsgHits) > 0 && len(bm25MsgHits) > 0 {
+		vectorWeight, bm25Weight = 0.7, 0.3
+	}
+	messageScores := make(map[string]float32)
+	var msgHashes []string
+	for _, h := range vecMsgHits {
+		if _, ok := messageScores[h.id]; !ok {
+			msgHashes = append(msgHashes, h.id)
+		}
+		messageScores[h.id] += h.score * vectorWeight
+	}
+	for _, h := range bm25MsgHits {
+		if _, ok := messageScores[h.id]; !ok {
+			msgHashes = append(msgHashes, h.id)
 		}
+		messageScores[h.id] += h.score * bm25Weight
 	}
 
-	// Search diff content (vector)
-	if len(req.QueryVec) > 0 {
-		changes, err := s.SearchDiffs(ctx, req.QueryVec, candidateLimit)
-		if err != nil {
-			// Diff embeddings might not exist
-			changes = nil
+	if len(msgHashes) == 0 && len(diffHits) == 0 {
+		return nil, nil
+	}
+
+	// Phase 2: hydrate commits and changes in one query each
+	allHashes := append([]string(nil), msgHashes...)
+	seenHashes := make(map[string]bool, len(msgHashes))
+	for _, h := range msgHashes {
+		seenHashes[h] = true
+	}
+	diffIDs := make([]string, 0, len(diffHits))
+	for _, h := range diffHits {
+		diffIDs = append(diffIDs, h.id)
+		if !seenHashes[h.commitHash] {
+			seenHashes[h.commitHash] = true
+			allHashes = append(allHashes, h.commitHash)
 		}
+	}
+
+	commits, err := s.getCommitsByHashes(ctx, allHashes)
+	if err != nil {
+		return nil, fmt.Errorf("failed to load commits: %w", err)
+	}
+
+	// Related changes need every change of every candidate commit
+	changeHashes := msgHashes
+	if req.IncludeContext {
+		changeHashes = allHashes
+	}
+	changesByCommit, changesByID, err := s.getChangesForCommitsAndIDs(ctx, changeHashes, diffIDs)
+	if err != nil {
+		return nil, fmt.Errorf("failed to load changes: %w", err)
+	}
+
+	// Phase 3: build results, deduplicated by change ID
+	resultsByID := make(map[string]*types.HistorySearchResult)
+	var results []*types.HistorySearchResult
 
+	for _, hash := range msgHashes {
+		commit := commits[hash]
+		if commit == nil {
+			continue
+		}
+		changes := changesByCommit[hash]
+		if !s.matchesHistoryFilters(commit, changes, req) {
+			continue
+		}
 		for _, change := range changes {
-			// Check if already in results
-			found := false
-			for _, r := range results {
-				if r.Change.ID == change.ID {
-					r.DiffScore = 1.0 // Mark as found in diff search
-					found = true
-					break
-				}
+			r := &types.HistorySearchResult{
+				Change:       change,
+				Commit:       commit,
+				MessageScore: messageScores[hash],
 			}
+			resultsByID[change.ID] = r
+			results = append(results, r)
+		}
+	}
+
+	for _, h := range diffHits {
+		if r, ok := resultsByID[h.id]; ok {
+			r.DiffScore = h.score
+			continue
+		}
+		change := changesByID[h.id]
+		commit := commits[h.commitHash]
+		if change == nil || commit == nil {
+			continue
+		}
+		if !s.matchesHistoryFilters(commit, []*types.Change{change}, req) {
+			continue
+		}
+		r := &types.HistorySearchResult{
+			Change:    change,
+			Commit:    commit,
+			DiffScore: h.score,
+		}
+		resultsByID[h.id] = r
+		results = append(results, r)
+	}
+
+	// Apply time decay scoring
+	now := time.Now()
+	decayDays := 30.0 // Half-life in days
+	if req.TimeDecayFactor > 0 {
+		decayDays = float64(30 / req.TimeDecayFactor)
+	}
+	for _, r := range results {
+		age := now.Sub(r.Commit.Date)
+		decayFactor := math.Exp(-age.Hours() / (24 * decayDays * math.Ln2))
+		r.RecencyScore = float32(decayFactor)
+
+		// Combined score
+		r.Score = (r.MessageScore*0.4 + r.DiffScore*0.4 + r.RecencyScore*0.2)
+	}
+
+	// Sort by score
+	sort.SliceStable(results, func(i, j int) bool {
+		return results[i].Score > results[j].Score
+	})
+
+	// Limit results
+	if len(results) > req.Limit {
+		results = results[:req.Limit]
+	}
 
-			if !found {
-				commit, _ := s.GetCommit(change.CommitHash)
-				if commit != nil && s.matchesHistoryFilters(commit, []*types.Change{change}, req) {
-					results = append(results, &types.HistorySearchResult{
-						Change:    change,
-						Commit:    commit,
-						DiffScore: 1.0,
-					})
+	// Diff text is only decompressed for the results that are returned
+	if req.IncludeDiff {
+		changes := make([]*types.Change, len(results))
+		for i, r := range results {
+			changes[i] = r.Change
+		}
+		if err := s.loadChangeDiffs(ctx, changes); err != nil {
+			return nil, fmt.Errorf("failed to load diffs: %w", err)
+		}
+	}
+
+	// Add context if requested
+	if req.IncludeContext {
+		for _, r := range results {
+			// Get related changes in same commit
+			for _, c := range changesByCommit[r.Commit.Hash] {
+				if c.ID != r.Change.ID {
+					r.RelatedChanges = append(r.RelatedChanges, c)
 				}
 			}
 		}
 	}
 
-	// BM25 search on commit messages if no vector
-	if len(req.QueryVec) == 0 && req.Query != "" {
-		commits, err := s.bm25SearchCommits(ctx, req.Query, candidateLimit)
-		if err != nil {
+	return results, nil
+}
+
+// scoredID is a search hit before hydration: an ID with its normalized
+// 0-1 score. commitHash is set for change hits.
+type scoredID struct {
+	id         string
+	commitHash string
+	score      float32
+}
+
+// vectorSearchCommitIDs returns commit hashes ranked by message similarity.
+func (s *Store) vectorSearchCommitIDs(ctx context.Context, queryVec []float32, limit int) ([]scoredID, error) {
+	embBytes := floatsToBytes(queryVec)
+
+	rows, err := s.queryContext(ctx, `
+		SELECT
+			ce.commit_hash,
+			vec_distance_cosine(ce.embedding, ?) as distance
+		FROM commit_embeddings ce
+		ORDER BY distance ASC
+		LIMIT ?
+	`, embBytes, limit)
+	if err != nil {
+		return nil, err
+	}
+	defer rows.Close()
+
+	var hits []scoredID
+	for rows.Next() {
+		var h scoredID
+		var distance float64
+		if err := rows.Scan(&h.id, &distance); err != nil {
 			return nil, err
 		}
+		// Convert distance to similarity score (cosine distance → similarity)
+		h.score = float32(1.0 - distance)
+		hits = append(hits, h)
+	}
 
-		for _, commit := range commits {
-			changes, _ := s.GetChangesByCommit(commit.Hash)
-			if !s.matchesHistoryFilters(commit, changes, req) {
-				continue
-			}
+	return hits, rows.Err()
+}
 
-			for _, change := range changes {
-				results = append(results, &types.HistorySearchResult{
-					Change:       change,
-					Commit:       commit,
-					MessageScore: 1.0,
-				})
-			}
+// vectorSearchChangeIDs returns change IDs ranked by diff similarity.
+func (s *Store) vectorSearchChangeIDs(ctx context.Context, queryVec []float32, limit int) ([]scoredID, error) {
+	embBytes := floatsToBytes(queryVec)
+
+	rows, err := s.queryContext(ctx, `
+		SELECT
+			ce.change_id,
+			c.commit_hash,
+			vec_distance_cosine(ce.embedding, ?) as distance
+		FROM change_embeddings ce
+		JOIN changes c ON c.id = ce.change_id
+		ORDER BY distance ASC
+		LIMIT ?
+	`, embBytes, limit)
+	if err != nil {
+		return nil, err
+	}
+	defer rows.Close()
+
+	var hits []scoredID
+	for rows.Next() {
+		var h scoredID
+		var distance float64
+		if err := rows.Scan(&h.id, &h.commitHash, &distance); err != nil {
+			return nil, err
+		}
+		h.score = float32(1.0 - distance)
+		hits = append(hits, h)
+	}
+
+	return hits, rows.Err()
+}
+
+// bm25SearchCommitIDs returns commit hashes ranked by BM25 over commit messages.
+func (s *Store) bm25SearchCommitIDs(ctx context.Context, query string, limit int) ([]scoredID, error) {
+	rows, err := s.queryContext(ctx, `
+		SELECT hash, bm25(commits_fts) as score
+		FROM commits_fts
+		WHERE commits_fts MATCH ?
+		ORDER BY score
+		LIMIT ?
+	`, escapeFTSQuery(query), limit)
+	if err != nil {
+		return nil, err
+	}
+	defer rows.Close()
+
+	var hits []scoredID
+	for rows.Next() {
+		var h scoredID
+		var bm25Score float64
+		if err := rows.Scan(&h.id, &bm25Score); err != nil {
+			return nil, err
 		}
+		// BM25 scores are negative (lower is better), normalize to 0-1
+		h.score = float32(1.0 / (1.0 + math.Abs(bm25Score)))
+		hits = append(hits, h)
+	}
+
+	return hits, rows.Err()
+}
+
+// getCommitsByHashes loads commits by full hash in a single query.
+func (s *Store) getCommitsByHashes(ctx context.Context, hashes []string) (map[string]*types.Commit, error) {
+	result := make(map[string]*types.Commit, len(hashes))
+	if len(hashes) == 0 {
+		return result, nil
+	}
+
+	rows, err := s.queryContext(ctx, `
+		SELECT hash, short_hash, author, author_email, date, message, parent_hash,
+		       files_changed, insertions, deletions, is_merge, is_tagged, tags, branch, generation
+		FROM commits WHERE hash IN (SELECT value FROM json_each(?))
+	`, jsonArray(hashes))
+	if err != nil {
+		return nil, err
+	}
+	defer rows.Close()
+
+	commits, err := scanCommits(rows)
+	if err != nil {
+		return nil, err
+	}
+	for _, c := range commits {
+		result[c.Hash] = c
 	}
 
-	// Apply time decay scoring
-	now := time.Now()
-	for _, r := range results {
-		age := now.Sub(r.Commit.Date)
-		decayDays := 30.0 // Half-life in days
-		if req.TimeDecayFactor > 0 {
-			decayDays = float64(30 / req.TimeDecayFactor)
-		}
-		decayFactor := math.Exp(-age.Hours() / (24 * decayDays * math.Ln2))
-		r.RecencyScore = float32(decayFactor)
+	return result, nil
+}
 
-		// Combined score
-		r.Score = (r.MessageScore*0.4 + r.DiffScore*0.4 + r.RecencyScore*0.2)
+// getChangesForCommitsAndIDs loads all changes of the given commits plus the
+// given individual changes in a single query. Results are returned grouped by
+// commit hash and indexed by change ID. Diffs and hunks are not loaded; use
+// loadChangeDiffs for the changes that need them.
+func (s *Store) getChangesForCommitsAndIDs(ctx context.Context, commitHashes, changeIDs []string) (map[string][]*types.Change, map[string]*types.Change, error) {
+	byCommit := make(map[string][]*types.Change)
+	byID := make(map[string]*types.Change)
+	if len(commitHashes) == 0 && len(changeIDs) == 0 {
+		return byCommit, byID, nil
+	}
+
+	rows, err := s.queryContext(ctx, `
+		SELECT c.id, c.commit_hash, f.path, c.change_type, c.old_path, NULL,
+		       c.additions, c.deletions, c.affected_functions, c.affected_chunk_ids, NULL,
+		       NULL, NULL
+		FROM changes c JOIN files f ON f.id = c.file_id
+		WHERE c.commit_hash IN (SELECT value FROM json_each(?))
+		   OR c.id IN (SELECT value FROM json_each(?))
+		ORDER BY c.commit_hash, f.path
+	`, jsonArray(commitHashes), jsonArray(changeIDs))
+	if err != nil {
+		return nil, nil, err
 	}
+	defer rows.Close()
 
-	// Sort by score
-	sort.Slice(results, func(i, j int) bool {
-		return results[i].Score > results[j].Score
-	})
-
-	// Limit results
-	if len(results) > req.Limit {
-		results = results[:req.Limit]
+	changes, err := scanChanges(rows)
+	if err != nil {
+		return nil, nil, err
 	}
 
-	// Add context if requested
-	if req.IncludeContext {
-		for _, r := range results {
-			// Get related changes in same commit
-			allChanges, _ := s.GetChangesByCommit(r.Commit.Hash)
-			for _, c := range allChanges {
-				if c.ID != r.Change.ID {
-					r.RelatedChanges = append(r.RelatedChanges, c)
-				}
-			}
+	wantCommit := make(map[string]bool, len(commitHashes))
+	for _, h := range commitHashes {
+		wantCommit[h] = true
+	}
+	for _, c := range changes {
+		byID[c.ID] = c
+		if wantCommit[c.CommitHash] {
+			byCommit[c.CommitHash] = append(byCommit[c.CommitHash], c)
 		}
 	}
 
-	return results, nil
+	return byCommit, byID, nil
 }
 
-// SearchCommitMessages searches commit messages by vector similarity.
-func (s *Store) SearchCommitMessages(ctx context.Context, queryVec []float32, limit int) ([]*types.Commit, error) {
-	embBytes := floatsToBytes(queryVec)
+// loadChangeDiffs fills DiffContent and Hunks of changes loaded without them.
+func (s *Store) loadChangeDiffs(ctx context.Context, changes []*types.Change) error {
+	if len(changes) == 0 {
+		return nil
+	}
 
-	rows, err := s.db.QueryContext(ctx, `
-		SELECT
-			ce.commit_hash,
-			vec_distance_cosine(ce.embedding, ?) as distance
-		FROM commit_embeddings ce
-		ORDER BY distance ASC
-		LIMIT ?
-	`, embBytes, limit)
+	byID := make(map[string][]*types.Change, len(changes))
+	ids := make([]string, 0, len(changes))
+	for _, c := range changes {
+		if _, ok := byID[c.ID]; !ok {
+			ids = append(ids, c.ID)
+		}
+		byID[c.ID] = append(byID[c.ID], c)
+	}
+
+	rows, err := s.queryContext(ctx, `
+		SELECT id, diff_content, hunks, diff_blob, hunks_blob
+		FROM changes
+		WHERE id IN (SELECT value FROM json_each(?))
+	`, jsonArray(ids))
 	if err != nil {
-		return nil, err
+		return err
 	}
 	defer rows.Close()
 
-	var commits []*types.Commit
 	for rows.Next() {
-		var hash string
-		var distance float64
-		if err := rows.Scan(&hash, &distance); err != nil {
-			return nil, err
+		var id string
+		var diffContent, hunks sql.NullString
+		var diffBlob, hunksBlob []byte
+		if err := rows.Scan(&id, &diffContent, &hunks, &diffBlob, &hunksBlob); err != nil {
+			return err
 		}
 
-		commit, err := s.GetCommit(hash)
-		if err != nil {
-			continue
+		var loaded types.Change
+		loaded.DiffContent = diffContent.String
+		if err := decodeChangeDiff(&loaded, diffBlob, hunksBlob, []byte(hunks.String)); err != nil {
+			return fmt.Errorf("change %s: %w", id, err)
 		}
-		if commit != nil {
-			commits = append(commits, commit)
+		for _, c := range byID[id] {
+			c.DiffContent = loaded.DiffContent
+			c.Hunks = loaded.Hunks
 		}
 	}
 
-	return commits, nil
+	return rows.Err()
+}
+
+// SearchCommitMessages searches commit messages by vector similarity.
+func (s *Store) SearchCommitMessages(ctx context.Context, queryVec []float32, limit int) ([]*types.Commit, error) {
+	hits, err := s.vectorSearchCommitIDs(ctx, queryVec, limit)
+	if err != nil {
+		return nil, err
+	}
+	return s.hydrateCommitHits(ctx, hits)
 }
 
 // SearchDiffs searches diff content by vector similarity.
 func (s *Store) SearchDiffs(ctx context.Context, queryVec []float32, limit int) ([]*types.Change, error) {
-	embBytes := floatsToBytes(queryVec)
-
-	rows, err := s.db.QueryContext(ctx, `
-		SELECT
-			ce.change_id,
-			vec_distance_cosine(ce.embedding, ?) as distance
-		FROM change_embeddings ce
-		ORDER BY distance ASC
-		LIMIT ?
-	`, embBytes, limit)
+	hits, err := s.vectorSearchChangeIDs(ctx, queryVec, limit)
 	if err != nil {
 		return nil, err
 	}
-	defer rows.Close()
+	if len(hits) == 0 {
+		return nil, nil
+	}
 
-	var changes []*types.Change
-	for rows.Next() {
-		var id string
-		var distance float64
-		if err := rows.Scan(&id, &distance); err != nil {
-			return nil, err
-		}
+	ids := make([]string, len(hits))
+	for i, h := range hits {
+		ids[i] = h.id
+	}
+	_, byID, err := s.getChangesForCommitsAndIDs(ctx, nil, ids)
+	if err != nil {
+		return nil, err
+	}
 
-		change, err := s.GetChange(id)
-		if err != nil {
-			continue
-		}
-		if change != nil {
-			changes = append(changes, change)
+	changes := make([]*types.Change, 0, len(hits))
+	for _, h := range hits {
+		if c := byID[h.id]; c != nil {
+			changes = append(changes, c)
 		}
 	}
+	if err := s.loadChangeDiffs(ctx, changes); err != nil {
+		return nil, err
+	}
 
 	return changes, nil
 }
 
 // bm25SearchCommits searches commits using BM25.
 func (s *Store) bm25SearchCommits(ctx context.Context, query string, limit int) ([]*types.Commit, error) {
-	rows, err := s.db.QueryContext(ctx, `
-		SELECT hash, bm25(commits_fts) as score
-		FROM commits_fts
-		WHERE commits_fts MATCH ?
-		ORDER BY score
-		LIMIT ?
-	`, escapeFTSQuery(query), limit)
+	hits, err := s.bm25SearchCommitIDs(ctx, query, limit)
 	if err != nil {
 		return nil, err
 	}
-	defer rows.Close()
+	return s.hydrateCommitHits(ctx, hits)
+}
 
-	var commits []*types.Commit
-	for rows.Next() {
-		var hash string
-		var score float64
-		if err := rows.Scan(&hash, &score); err != nil {
-			return nil, err
-		}
+// hydrateCommitHits loads commits for ranked hits, preserving rank order.
+func (s *Store) hydrateCommitHits(ctx context.Context, hits []scoredID) ([]*types.Commit, error) {
+	if len(hits) == 0 {
+		return nil, nil
+	}
 
-		commit, err := s.GetCommit(hash)
-		if err != nil {
-			continue
-		}
-		if commit != nil {
-			commits = append(commits, commit)
+	hashes := make([]string, len(hits))
+	for i, h := range hits {
+		hashes[i] = h.id
+	}
+	byHash, err := s.getCommitsByHashes(ctx, hashes)
+	if err != nil {
+		return nil, err
+	}
+
+	commits := make([]*types.Commit, 0, len(hits))
+	for _, h := range hits {
+		if c := byHash[h.id]; c != nil {
+			commits = append(commits, c)
 		}
 	}
 
@@ -938,146 +1506,352 @@ func (s *Store) matchesHistoryFilters(commit *types.Commit, changes []*types.Cha
 }
 
 // FindRegressionCandidates finds commits that might have introduced a bug.
-func (s *Store) FindRegressionCandidates(ctx context.Context, description string, knownGood, knownBad string, limit int) ([]*types.RegressionCandidate, error) {
-	// Get commits in range
-	commits, err := s.GetCommitRange(knownGood, knownBad)
+//
+// The range knownGood..knownBad is resolved on the stored commit graph. All
+// commits in the range are then scored by one query over the per-commit
+// features precomputed at index time: message and diff embedding similarity
+// to queryVec (when available) plus keyword hits on the commit message,
+// affected symbols and touched paths. Changes are loaded only for the
+// returned candidates.
+func (s *Store) FindRegressionCandidates(ctx context.Context, description string, queryVec []float32, knownGood, knownBad string, limit int) ([]*types.RegressionCandidate, error) {
+	rangeHashes, err := s.resolveCommitRange(ctx, knownGood, knownBad)
 	if err != nil {
 		return nil, err
 	}
-
-	if len(commits) == 0 {
+	if len(rangeHashes) == 0 {
 		return nil, nil
 	}
 
-	// Simple keyword matching for now (can be enhanced with embeddings)
-	keywords := strings.Fields(strings.ToLower(description))
+	features, err := s.loadRegressionFeatures(ctx, rangeHashes, queryVec)
+	if err != nil || len(features) == 0 {
+		return nil, err
+	}
 
-	var candidates []*types.RegressionCandidate
-	for _, commit := range commits {
-		changes, _ := s.GetChangesByCommit(commit.Hash)
+	keywords := strings.Fields(strings.ToLower(description))
 
-		score := float32(0)
-		var reasoning []string
+	minGen, maxGen := features[0].generation, features[0].generation
+	for _, f := range features {
+		if f.generation < minGen {
+			minGen = f.generation
+		}
+		if f.generation > maxGen {
+			maxGen = f.generation
+		}
+	}
 
-		// Check commit message
-		msgLower := strings.ToLower(commit.Message)
+	var scored []*regressionFeatures
+	for _, f := range features {
 		for _, kw := range keywords {
-			if strings.Contains(msgLower, kw) {
-				score += 0.2
-				reasoning = append(reasoning, fmt.Sprintf("Commit message contains '%s'", kw))
+			if strings.Contains(f.message, kw) {
+				f.score += 0.2
+				f.reasoning = append(f.reasoning, fmt.Sprintf("Commit message contains '%s'", kw))
 			}
 		}
 
-		// Check affected functions
-		for _, change := range changes {
-			for _, fn := range change.AffectedFunctions {
-				fnLower := strings.ToLower(fn)
-				for _, kw := range keywords {
-					if strings.Contains(fnLower, kw) {
-						score += 0.3
-						reasoning = append(reasoning, fmt.Sprintf("Changed function '%s' matches keyword", fn))
-					}
+		for _, fn := range splitFeature(f.symbols) {
+			for _, kw := range keywords {
+				if strings.Contains(fn, kw) {
+					f.score += 0.3
+					f.reasoning = append(f.reasoning, fmt.Sprintf("Changed function '%s' matches keyword", fn))
 				}
 			}
+		}
 
-			// Check diff content
-			if change.DiffContent != "" {
-				diffLower := strings.ToLower(change.DiffContent)
-				for _, kw := range keywords {
-					if strings.Contains(diffLower, kw) {
-						score += 0.1
-						reasoning = append(reasoning, fmt.Sprintf("Diff content contains '%s'", kw))
-					}
+		for _, path := range splitFeature(f.paths) {
+			for _, kw := range keywords {
+				if strings.Contains(path, kw) {
+					f.score += 0.1
+					f.reasoning = append(f.reasoning, fmt.Sprintf("Changed file '%s' matches '%s'", path, kw))
 				}
 			}
 		}
 
-		// Prefer more recent commits (more likely to be the regression point)
-		if len(commits) > 1 {
-			idx := 0
-			for i, c := range commits {
-				if c.Hash == commit.Hash {
-					idx = i
-					break
-				}
+		if f.messageSim.Valid && f.messageSim.Float64 > 0 {
+			f.score += float32(f.messageSim.Float64) * 0.3
+			if f.messageSim.Float64 >= 0.5 {
+				f.reasoning = append(f.reasoning, fmt.Sprintf("Commit message is semantically similar (%.2f)", f.messageSim.Float64))
 			}
-			recencyBonus := float32(idx) / float32(len(commits)) * 0.2
-			score += recencyBonus
 		}
-
-		if score > 0 {
-			// Get diff preview
-			var diffPreview string
-			if len(changes) > 0 && changes[0].DiffContent != "" {
-				diff := changes[0].DiffContent
-				if len(diff) > 500 {
-					diff = diff[:500] + "..."
-				}
-				diffPreview = diff
+		if f.diffSim.Valid && f.diffSim.Float64 > 0 {
+			f.score += float32(f.diffSim.Float64) * 0.3
+			if f.diffSim.Float64 >= 0.5 {
+				f.reasoning = append(f.reasoning, fmt.Sprintf("Diff is semantically similar (%.2f)", f.diffSim.Float64))
 			}
+		}
+
+		if f.score == 0 {
+			continue
+		}
 
-			candidates = append(candidates, &types.RegressionCandidate{
-				Commit:      commit,
-				Changes:     changes,
-				Score:       score,
-				Reasoning:   reasoning,
-				DiffPreview: diffPreview,
-			})
+		// Prefer more recent commits (more likely to be the regression point)
+		if maxGen > minGen {
+			f.score += float32(f.generation-minGen) / float32(maxGen-minGen+1) * 0.2
 		}
+
+		scored = append(scored, f)
 	}
 
 	// Sort by score descending
-	sort.Slice(candidates, func(i, j int) bool {
-		return candidates[i].Score > candidates[j].Score
+	sort.SliceStable(scored, func(i, j int) bool {
+		return scored[i].score > scored[j].score
 	})
 
-	if len(candidates) > limit {
-		candidates = candidates[:limit]
+	if len(scored) > limit {
+		scored = scored[:limit]
+	}
+	if len(scored) == 0 {
+		return nil, nil
+	}
+
+	hashes := make([]string, len(scored))
+	for i, f := range scored {
+		hashes[i] = f.hash
+	}
+	commits, err := s.getCommitsByHashes(ctx, hashes)
+	if err != nil {
+		return nil, err
+	}
+	changesByCommit, _, err := s.getChangesForCommitsAndIDs(ctx, hashes, nil)
+	if err != nil {
+		return nil, err
+	}
+	var candidateChanges []*types.Change
+	for _, f := range scored {
+		if commits[f.hash] != nil {
+			candidateChanges = append(candidateChanges, changesByCommit[f.hash]...)
+		}
+	}
+	if err := s.loadChangeDiffs(ctx, candidateChanges); err != nil {
+		return nil, err
+	}
+
+	candidates := make([]*types.RegressionCandidate, 0, len(scored))
+	for _, f := range scored {
+		commit := commits[f.hash]
+		if commit == nil {
+			continue
+		}
+		changes := changesByCommit[f.hash]
+
+		// Get diff preview
+		var diffPreview string
+		if len(changes) > 0 && changes[0].DiffContent != "" {
+			diff := changes[0].DiffContent
+			if len(diff) > 500 {
+				diff = diff[:500] + "..."
+			}
+			diffPreview = diff
+		}
+
+		candidates = append(candidates, &types.RegressionCandidate{
+			Commit:      commit,
+			Changes:     changes,
+			Score:       f.score,
+			Reasoning:   f.reasoning,
+			DiffPreview: diffPreview,
+		})
 	}
 
 	return candidates, nil
 }
 
+// regressionFeatures holds the precomputed search features of one commit in
+// a regression range, plus its score while ranking.
+type regressionFeatures struct {
+	hash       string
+	generation int
+	message    string // lowercased
+	paths      string
+	symbols    string
+	messageSim sql.NullFloat64
+	diffSim    sql.NullFloat64
+
+	score     float32
+	reasoning []string
+}
+
+// loadRegressionFeatures loads features of all commits in hashes with a single
+// query. Embedding similarities are included when queryVec is set and the
+// embedding tables exist.
+func (s *Store) loadRegressionFeatures(ctx context.Context, hashes []string, queryVec []float32) ([]*regressionFeatures, error) {
+	var hasMsgEmb, hasDiffEmb bool
+	if len(queryVec) > 0 {
+		rows, err := s.queryContext(ctx, `
+			SELECT name FROM `+s.schema(subsysHistory)+`.sqlite_master
+			WHERE name IN ('commit_embeddings', 'commit_diff_embeddings')
+		`)
+		if err != nil {
+			return nil, err
+		}
+		for rows.Next() {
+			var name string
+			if err := rows.Scan(&name); err != nil {
+				rows.Close()
+				return nil, err
+			}
+			hasMsgEmb = hasMsgEmb || name == "commit_embeddings"
+			hasDiffEmb = hasDiffEmb || name == "commit_diff_embeddings"
+		}
+		rows.Close()
+	}
+
+	features, err := s.queryRegressionFeatures(ctx, hashes, queryVec, hasMsgEmb, hasDiffEmb)
+	if err != nil && (hasMsgEmb || hasDiffEmb) {
+		// Embedding dimensions may not match the query (model changed)
+		return s.queryRegressionFeatures(ctx, hashes, nil, false, false)
+	}
+	return features, err
+}
+
+func (s *Store) queryRegressionFeatures(ctx context.Context, hashes []string, queryVec []float32, withMsgEmb, withDiffEmb bool) ([]*regressionFeatures, error) {
+	var embBytes []byte
+	if len(queryVec) > 0 {
+		embBytes = floatsToBytes(queryVec)
+	}
+
+	query := `SELECT c.hash, c.generation, lower(c.message), COALESCE(f.paths, ''), COALESCE(f.symbols, '')`
+	var args []any
+	if withMsgEmb {
+		query += `, CASE WHEN ce.embedding IS NULL THEN NULL ELSE 1.0 - vec_distance_cosine(ce.embedding, ?) END`
+		args = append(args, embBytes)
+	} else {
+		query += `, NULL`
+	}
+	if withDiffEmb {
+		query += `, CASE WHEN de.embedding IS NULL THEN NULL ELSE 1.0 - vec_distance_cosine(de.embedding, ?) END`
+		args = append(args, embBytes)
+	} else {
+		query += `, NULL`
+	}
+
+	query += `
+		FROM commits c
+		LEFT JOIN commit_features f ON f.commit_hash = c.hash`
+	if withMsgEmb {
+		query += `
+		LEFT JOIN commit_embeddings ce ON ce.commit_hash = c.hash`
+	}
+	if withDiffEmb {
+		query += `
+		LEFT JOIN commit_diff_embeddings de ON de.commit_hash = c.hash`
+	}
+	query += `
+		WHERE c.hash IN (SELECT value FROM json_each(?))`
+	args = append(args, jsonArray(hashes))
+
+	rows, err := s.queryContext(ctx, query, args...)
+	if err != nil {
+		return nil, err
+	}
+	defer rows.Close()
+
+	var features []*regressionFeatures
+	for rows.Next() {
+		var f regressionFeatures
+		err := rows.Scan(&f.hash, &f.generation, &f.message, &f.paths, &f.symbols, &f.messageSim, &f.diffSim)
+		if err != nil {
+			return nil, err
+		}
+		features = append(features, &f)
+	}
+
+	return features, rows.Err()
+}
+
+// splitFeature splits a newline separated feature column.
+func splitFeature(value string) []string {
+	if value == "" {
+		return nil
+	}
+	return strings.Split(value, "\n")
+}
+
 // GetContributorInsights returns contributor information for code areas.
+//
+// Directory and file paths are answered from the per-(path prefix, author)
+// aggregates maintained by StoreChanges, and symbols from the change_symbols
+// junction table. Only path patterns that are not a plain prefix (e.g.
+// "*.go") fall back to scanning changes.
 func (s *Store) GetContributorInsights(ctx context.Context, paths []string, symbol string) ([]*types.ContributorInsight, error) {
-	// Build query based on paths or symbol
 	var query string
 	var args []any
 
 	if len(paths) > 0 {
-		// Build path conditions
-		conditions := make([]string, len(paths))
-		for i, p := range paths {
-			conditions[i] = "c.file_path LIKE ?"
-			args = append(args, strings.ReplaceAll(p, "*", "%"))
-		}
-		query = fmt.Sprintf(`
-			SELECT cm.author, cm.author_email, COUNT(*) as commits,
-			       SUM(c.additions + c.deletions) as lines,
-			       MAX(cm.date) as last_active
-			FROM changes c
-			JOIN commits cm ON c.commit_hash = cm.hash
-			WHERE %s
-			GROUP BY cm.author_email
-			ORDER BY commits DESC
-		`, strings.Join(conditions, " OR "))
+		prefixes, ok := pathPrefixes(paths)
+		switch {
+		case ok && len(prefixes) == 1:
+			query = `
+				SELECT author, author_email, commits, lines, last_active
+				FROM contributor_path_stats
+				WHERE path_prefix = ?
+				ORDER BY commits DESC
+			`
+			args = append(args, prefixes[0])
+		case ok:
+			// Prefixes are disjoint, so line sums are exact; commits touching
+			// several of them are counted once.
+			query = `
+				SELECT cm.author, cm.author_email, COUNT(DISTINCT t.commit_hash) as commits,
+				       SUM(t.lines) as lines, MAX(cm.date) as last_active
+				FROM commit_path_touches t
+				JOIN commits cm ON t.commit_hash = cm.hash
+				WHERE t.path_prefix IN (SELECT value FROM json_each(?))
+				GROUP BY cm.author_email
+				ORDER BY commits DESC
+			`
+			args = append(args, jsonArray(prefixes))
+		default:
+			patterns := make([]string, len(paths))
+			for i, p := range paths {
+				patterns[i] = strings.ReplaceAll(p, "*", "%")
+			}
+			query = `
+				SELECT cm.author, cm.author_email, COUNT(DISTINCT c.commit_hash) as commits,
+				       SUM(c.additions + c.deletions) as lines,
+				       MAX(cm.date) as last_active
+				FROM changes c
+				JOIN files f ON f.id = c.file_id
+				JOIN commits cm ON c.commit_hash = cm.hash
+				WHERE EXISTS (SELECT 1 FROM json_each(?) p WHERE f.path LIKE p.value)
+				GROUP BY cm.author_email
+				ORDER BY commits DESC
+			`
+			args = append(args, jsonArray(patterns))
+		}
 	} else if symbol != "" {
-		query = `
-			SELECT cm.author, cm.author_email, COUNT(*) as commits,
-			       SUM(c.additions + c.deletions) as lines,
-			       MAX(cm.date) as last_active
-			FROM changes c
-			JOIN commits cm ON c.commit_hash = cm.hash
-			WHERE c.affected_functions LIKE ?
-			GROUP BY cm.author_email
-			ORDER BY commits DESC
-		`
-		args = append(args, "%"+symbol+"%")
+		insights, err := s.symbolContributors(ctx, "cs.symbol_lower = ?", strings.ToLower(symbol))
+		if err != nil || len(insights) > 0 {
+			return insights, err
+		}
+		// No exact match - fall back to substring match on the junction table
+		return s.symbolContributors(ctx, "cs.symbol_lower LIKE ?", "%"+strings.ToLower(symbol)+"%")
 	} else {
 		return nil, fmt.Errorf("either paths or symbol is required")
 	}
 
-	rows, err := s.db.QueryContext(ctx, query, args...)
+	return s.queryContributors(ctx, query, args...)
+}
+
+// symbolContributors aggregates contributors of changes whose affected
+// symbols match the given condition on change_symbols (aliased cs).
+func (s *Store) symbolContributors(ctx context.Context, condition string, arg any) ([]*types.ContributorInsight, error) {
+	return s.queryContributors(ctx, `
+		SELECT cm.author, cm.author_email, COUNT(DISTINCT c.commit_hash) as commits,
+		       SUM(c.additions + c.deletions) as lines,
+		       MAX(cm.date) as last_active
+		FROM change_symbols cs
+		JOIN changes c ON c.id = cs.change_id
+		JOIN commits cm ON c.commit_hash = cm.hash
+		WHERE `+condition+`
+		GROUP BY cm.author_email
+		ORDER BY commits DESC
+	`, arg)
+}
+
+// queryContributors runs a contributor aggregate query returning
+// (author, email, commits, lines, last_active) rows and scores expertise.
+func (s *Store) queryContributors(ctx context.Context, query string, args ...any) ([]*types.ContributorInsight, error) {
+	rows, err := s.queryContext(ctx, query, args...)
 	if err != nil {
 		return nil, err
 	}
@@ -1104,6 +1878,9 @@ func (s *Store) GetContributorInsights(ctx context.Context, paths []string, symb
 
 		insights = append(insights, &insight)
 	}
+	if err := rows.Err(); err != nil {
+		return nil, err
+	}
 
 	// Calculate expertise scores
 	for _, insight := range insights {
@@ -1117,20 +1894,22 @@ func (s *Store) GetContributorInsights(ctx context.Context, paths []string, symb
 func (s *Store) GetGitHistoryStats() (*types.GitHistoryStats, error) {
 	stats := &types.GitHistoryStats{}
 
-	// Count commits
-	row := s.db.QueryRow("SELECT COUNT(*) FROM commits")
-	if err := row.Scan(&stats.TotalCommits); err != nil {
+	// Totals are maintained by triggers (stat_counts.go)
+	counts, err := s.statCounts("commits", "changes", "authors", "diff_raw_bytes", "diff_stored_bytes")
+	if err != nil {
 		return nil, err
 	}
-
-	// Count changes
-	row = s.db.QueryRow("SELECT COUNT(*) FROM changes")
-	if err := row.Scan(&stats.TotalChanges); err != nil {
-		return nil, err
+	stats.TotalCommits = int(counts["commits"])
+	stats.TotalChanges = int(counts["changes"])
+	stats.UniqueAuthors = int(counts["authors"])
+	stats.DiffRawBytes = counts["diff_raw_bytes"]
+	stats.DiffStoredBytes = counts["diff_stored_bytes"]
+	if stats.DiffStoredBytes > 0 {
+		stats.DiffCompressionRatio = float64(stats.DiffRawBytes) / float64(stats.DiffStoredBytes)
 	}
 
-	// Count commits with embeddings
-	row = s.db.QueryRow("SELECT COUNT(*) FROM commit_embeddings")
+	// Count commits with embeddings. vec0 tables cannot have triggers.
+	row := s.db.QueryRow("SELECT COUNT(*) FROM commit_embeddings")
 	row.Scan(&stats.CommitsWithEmbeddings) // Ignore error if table doesn't exist
 
 	// Count changes with embeddings
@@ -1149,10 +1928,6 @@ func (s *Store) GetGitHistoryStats() (*types.GitHistoryStats, error) {
 		}
 	}
 
-	// Count unique authors
-	row = s.db.QueryRow("SELECT COUNT(DISTINCT author_email) FROM commits")
-	row.Scan(&stats.UniqueAuthors)
-
 	// Get last indexed time
 	row = s.db.QueryRow("SELECT value FROM git_index_meta WHERE key = 'last_indexed_time'")
 	var lastIndexedStr string
@@ -1162,6 +1937,13 @@ func (s *Store) GetGitHistoryStats() (*types.GitHistoryStats, error) {
 		}
 	}
 
+	var pageCount, pageSize, freePages int64
+	s.db.QueryRow("PRAGMA page_count").Scan(&pageCount)
+	s.db.QueryRow("PRAGMA page_size").Scan(&pageSize)
+	s.db.QueryRow("PRAGMA freelist_count").Scan(&freePages)
+	stats.DBSizeBytes = pageCount * pageSize
+	stats.DBFreeBytes = freePages * pageSize
+
 	return stats, nil
 }
 
@@ -1176,7 +1958,7 @@ func scanCommit(row *sql.Row) (*types.Commit, error) {
 		&c.Hash, &c.ShortHash, &c.Author, &c.AuthorEmail,
 		&dateUnix, &c.Message, &parentHash,
 		&c.FilesChanged, &c.Insertions, &c.Deletions,
-		&c.IsMerge, &c.IsTagged, &tags, &branch,
+		&c.IsMerge, &c.IsTagged, &tags, &branch, &c.Generation,
 	)
 	if err == sql.ErrNoRows {
 		return nil, nil
@@ -1208,7 +1990,7 @@ func scanCommits(rows *sql.Rows) ([]*types.Commit, error) {
 			&c.Hash, &c.ShortHash, &c.Author, &c.AuthorEmail,
 			&dateUnix, &c.Message, &parentHash,
 			&c.FilesChanged, &c.Insertions, &c.Deletions,
-			&c.IsMerge, &c.IsTagged, &tags, &branch,
+			&c.IsMerge, &c.IsTagged, &tags, &branch, &c.Generation,
 		)
 		if err != nil {
 			return nil, err
@@ -1229,15 +2011,8 @@ func scanCommits(rows *sql.Rows) ([]*types.Commit, error) {
 }
 
 func scanChange(row *sql.Row) (*types.Change, error) {
-	var c types.Change
-	var changeType string
-	var oldPath, diffContent, affectedFuncs, affectedChunks, hunks sql.NullString
-
-	err := row.Scan(
-		&c.ID, &c.CommitHash, &c.FilePath, &changeType, &oldPath,
-		&diffContent, &c.Additions, &c.Deletions,
-		&affectedFuncs, &affectedChunks, &hunks,
-	)
+	var cr changeRow
+	err := row.Scan(cr.dest()...)
 	if err == sql.ErrNoRows {
 		return nil, nil
 	}
@@ -1245,58 +2020,101 @@ func scanChange(row *sql.Row) (*types.Change, error) {
 		return nil, err
 	}
 
-	c.ChangeType = types.ChangeType(changeType)
-	c.OldPath = oldPath.String
-	c.DiffContent = diffContent.String
-
-	if affectedFuncs.Valid && affectedFuncs.String != "" {
-		json.Unmarshal([]byte(affectedFuncs.String), &c.AffectedFunctions)
-	}
-	if affectedChunks.Valid && affectedChunks.String != "" {
-		json.Unmarshal([]byte(affectedChunks.String), &c.AffectedChunkIDs)
-	}
-	if hunks.Valid && hunks.String != "" {
-		json.Unmarshal([]byte(hunks.String), &c.Hunks)
-	}
-
-	return &c, nil
+	return cr.change()
 }
 
 func scanChanges(rows *sql.Rows) ([]*types.Change, error) {
 	var changes []*types.Change
 
 	for rows.Next() {
-		var c types.Change
-		var changeType string
-		var oldPath, diffContent, affectedFuncs, affectedChunks, hunks sql.NullString
+		var cr changeRow
+		if err := rows.Scan(cr.dest()...); err != nil {
+			return nil, err
+		}
 
-		err := rows.Scan(
-			&c.ID, &c.CommitHash, &c.FilePath, &changeType, &oldPath,
-			&diffContent, &c.Additions, &c.Deletions,
-			&affectedFuncs, &affectedChunks, &hunks,
-		)
+		c, err := cr.change()
 		if err != nil {
 			return nil, err
 		}
+		changes = append(changes, c)
+	}
 
-		c.ChangeType = types.ChangeType(changeType)
-		c.OldPath = oldPath.String
-		c.DiffContent = diffContent.String
+	return changes, nil
+}
 
-		if affectedFuncs.Valid && affectedFuncs.String != "" {
-			json.Unmarshal([]byte(affectedFuncs.String), &c.AffectedFunctions)
-		}
-		if affectedChunks.Valid && affectedChunks.String != "" {
-			json.Unmarshal([]byte(affectedChunks.String), &c.AffectedChunkIDs)
-		}
-		if hunks.Valid && hunks.String != "" {
-			json.Unmarshal([]byte(hunks.String), &c.Hunks)
+// changeRow holds the raw columns of a changes row. Diff and hunk blobs are
+// only decompressed when selected, so metadata queries that select NULL in
+// their place never pay for decompression.
+type changeRow struct {
+	c                             types.Change
+	changeType                    string
+	oldPath, diffContent, hunks   sql.NullString
+	affectedFuncs, affectedChunks sql.NullString
+	diffBlob, hunksBlob           []byte
+}
+
+func (r *changeRow) dest() []any {
+	return []any{
+		&r.c.ID, &r.c.CommitHash, &r.c.FilePath, &r.changeType, &r.oldPath,
+		&r.diffContent, &r.c.Additions, &r.c.Deletions,
+		&r.affectedFuncs, &r.affectedChunks, &r.hunks,
+		&r.diffBlob, &r.hunksBlob,
+	}
+}
+
+func (r *changeRow) change() (*types.Change, error) {
+	c := r.c
+	c.ChangeType = types.ChangeType(r.changeType)
+	c.OldPath = r.oldPath.String
+	c.DiffContent = r.diffContent.String
+
+	if r.affectedFuncs.Valid && r.affectedFuncs.String != "" {
+		json.Unmarshal([]byte(r.affectedFuncs.String), &c.AffectedFunctions)
+	}
+	if r.affectedChunks.Valid && r.affectedChunks.String != "" {
+		json.Unmarshal([]byte(r.affectedChunks.String), &c.AffectedChunkIDs)
+	}
+
+	if err := decodeChangeDiff(&c, r.diffBlob, r.hunksBlob, []byte(r.hunks.String)); err != nil {
+		return nil, fmt.Errorf("change %s: %w", c.ID, err)
+	}
+
+	return &c, nil
+}
+
+// decodeChangeDiff fills DiffContent and Hunks from the compressed blobs,
+// or from the legacy hunks JSON of rows stored before compression.
+func decodeChangeDiff(c *types.Change, diffBlob, hunksBlob, legacyHunks []byte) error {
+	if len(diffBlob) > 0 {
+		diff, err := decompressDiff(diffBlob)
+		if err != nil {
+			return fmt.Errorf("failed to decompress diff: %w", err)
 		}
+		c.DiffContent = string(diff)
+	}
 
-		changes = append(changes, &c)
+	hunksJSON := legacyHunks
+	if len(hunksBlob) > 0 {
+		var err error
+		if hunksJSON, err = decompressDiff(hunksBlob); err != nil {
+			return fmt.Errorf("failed to decompress hunks: %w", err)
+		}
+	}
+	if len(hunksJSON) > 0 {
+		json.Unmarshal(hunksJSON, &c.Hunks)
 	}
 
-	return changes, nil
+	return nil
+}
+
+// jsonArray encodes IDs as a JSON array for use with json_each(?), which
+// avoids the bound-parameter limit for large IN lists.
+func jsonArray(ids []string) string {
+	if len(ids) == 0 {
+		return "[]"
+	}
+	b, _ := json.Marshal(ids)
+	return string(b)
 }
 
 // matchGlob performs simple glob matching.
@@ -1317,3 +2135,6 @@ func matchGlob(pattern, str string) bool {
 
 	return strings.Contains(str, patternClean)
 }
+
+// Ensure Store implements GitHistoryStore interface
+var _ provider.GitHistoryStore = (*Store)(nil)
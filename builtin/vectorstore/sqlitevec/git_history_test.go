@@ -2,6 +2,7 @@ package sqlitevec
 
 import (
 	"context"
+	"database/sql"
 	"os"
 	"strings"
 	"testing"
@@ -243,3 +244,445 @@ func TestGitHistoryStoreEmpty(t *testing.T) {
 		}
 	})
 }
+
+func TestSearchHistoryFusesLegs(t *testing.T) {
+	tmpFile, err := os.CreateTemp("", "githistory_search_test_*.db")
+	if err != nil {
+		t.Fatalf("failed to create temp file: %v", err)
+	}
+	tmpFile.Close()
+	defer os.Remove(tmpFile.Name())
+
+	store := New()
+	if err := store.Init(tmpFile.Name()); err != nil {
+		if containsString(err.Error(), "fts5") || containsString(err.Error(), "FTS5") {
+			t.Skip("FTS5 not available in this environment")
+		}
+		t.Fatalf("failed to init store: %v", err)
+	}
+	defer store.Close()
+
+	ctx := context.Background()
+
+	commits := []*types.Commit{
+		{
+			Hash:             "1111111111111111111111111111111111111111",
+			ShortHash:        "1111111",
+			Author:           "Alice",
+			AuthorEmail:      "alice@test.com",
+			Date:             time.Now().Add(-2 * time.Hour),
+			Message:          "Fix parser crash",
+			MessageEmbedding: []float32{1, 0, 0, 0},
+		},
+		{
+			Hash:             "2222222222222222222222222222222222222222",
+			ShortHash:        "2222222",
+			Author:           "Bob",
+			AuthorEmail:      "bob@test.com",
+			Date:             time.Now().Add(-1 * time.Hour),
+			Message:          "Update docs",
+			MessageEmbedding: []float32{0, 1, 0, 0},
+		},
+	}
+	if err := store.StoreCommits(commits); err != nil {
+		t.Fatalf("StoreCommits failed: %v", err)
+	}
+
+	changes := []*types.Change{
+		{
+			ID:            "11111111:parser.go",
+			CommitHash:    commits[0].Hash,
+			FilePath:      "parser.go",
+			ChangeType:    types.ChangeTypeModified,
+			DiffContent:   "-panic(err)\n+return err",
+			DiffEmbedding: []float32{1, 0, 0, 0},
+		},
+		{
+			ID:          "11111111:parser_test.go",
+			CommitHash:  commits[0].Hash,
+			FilePath:    "parser_test.go",
+			ChangeType:  types.ChangeTypeModified,
+			DiffContent: "+func TestCrash(t *testing.T) {}",
+		},
+		{
+			ID:            "22222222:README.md",
+			CommitHash:    commits[1].Hash,
+			FilePath:      "README.md",
+			ChangeType:    types.ChangeTypeModified,
+			DiffContent:   "+docs",
+			DiffEmbedding: []float32{0, 1, 0, 0},
+		},
+	}
+	if err := store.StoreChanges(changes); err != nil {
+		t.Fatalf("StoreChanges failed: %v", err)
+	}
+
+	results, err := store.SearchHistory(ctx, &types.HistorySearchRequest{
+		Query:          "parser",
+		QueryVec:       []float32{1, 0, 0, 0},
+		Limit:          10,
+		IncludeContext: true,
+	})
+	if err != nil {
+		t.Fatalf("SearchHistory failed: %v", err)
+	}
+
+	seen := make(map[string]bool)
+	for _, r := range results {
+		if seen[r.Change.ID] {
+			t.Errorf("change %s returned more than once", r.Change.ID)
+		}
+		seen[r.Change.ID] = true
+	}
+
+	if len(results) == 0 || results[0].Change.ID != "11111111:parser.go" {
+		t.Fatalf("expected parser.go change ranked first, got %+v", results)
+	}
+	top := results[0]
+	if top.MessageScore <= 0 || top.DiffScore <= 0 {
+		t.Errorf("expected both message and diff scores, got message=%v diff=%v", top.MessageScore, top.DiffScore)
+	}
+	if len(top.RelatedChanges) != 1 || top.RelatedChanges[0].FilePath != "parser_test.go" {
+		t.Errorf("expected parser_test.go as related change, got %+v", top.RelatedChanges)
+	}
+}
+
+func TestFindRegressionCandidatesUsesCommitGraph(t *testing.T) {
+	tmpFile, err := os.CreateTemp("", "githistory_regression_test_*.db")
+	if err != nil {
+		t.Fatalf("failed to create temp file: %v", err)
+	}
+	tmpFile.Close()
+	defer os.Remove(tmpFile.Name())
+
+	store := New()
+	if err := store.Init(tmpFile.Name()); err != nil {
+		if containsString(err.Error(), "fts5") || containsString(err.Error(), "FTS5") {
+			t.Skip("FTS5 not available in this environment")
+		}
+		t.Fatalf("failed to init store: %v", err)
+	}
+	defer store.Close()
+
+	ctx := context.Background()
+	now := time.Now()
+
+	// root -> good -> fix -> merge <- side (branched from root, merged after good)
+	commit := func(hash, msg string, age time.Duration, parents ...string) *types.Commit {
+		c := &types.Commit{
+			Hash:         hash,
+			ShortHash:    hash[:7],
+			Author:       "Test User",
+			AuthorEmail:  "test@test.com",
+			Date:         now.Add(-age),
+			Message:      msg,
+			ParentHashes: parents,
+		}
+		if len(parents) > 0 {
+			c.ParentHash = parents[0]
+		}
+		return c
+	}
+	root := commit("a000000000000000000000000000000000000000", "Initial commit", 5*time.Hour)
+	good := commit("b000000000000000000000000000000000000000", "Add parser", 4*time.Hour, root.Hash)
+	side := commit("c000000000000000000000000000000000000000", "Tweak lexer", 3*time.Hour, root.Hash)
+	fix := commit("d000000000000000000000000000000000000000", "Refactor parser errors", 2*time.Hour, good.Hash)
+	merge := commit("e000000000000000000000000000000000000000", "Merge lexer branch", 1*time.Hour, fix.Hash, side.Hash)
+
+	// Newest first, as git log returns them
+	if err := store.StoreCommits([]*types.Commit{merge, fix, side, good, root}); err != nil {
+		t.Fatalf("StoreCommits failed: %v", err)
+	}
+
+	changes := []*types.Change{
+		{ID: "d0000000:parser.go", CommitHash: fix.Hash, FilePath: "parser.go", ChangeType: types.ChangeTypeModified, AffectedFunctions: []string{"ParseExpr"},
+			DiffContent: "-\tpanic(err)\n+\treturn fmt.Errorf(\"parse: %w\", err)\n"},
+		{ID: "c0000000:lexer.go", CommitHash: side.Hash, FilePath: "lexer.go", ChangeType: types.ChangeTypeModified},
+		{ID: "b0000000:parser.go", CommitHash: good.Hash, FilePath: "parser.go", ChangeType: types.ChangeTypeAdded},
+	}
+	if err := store.StoreChanges(changes); err != nil {
+		t.Fatalf("StoreChanges failed: %v", err)
+	}
+
+	t.Run("Generations", func(t *testing.T) {
+		c, err := store.GetCommit(merge.Hash)
+		if err != nil || c == nil {
+			t.Fatalf("GetCommit failed: %v", err)
+		}
+		if c.Generation != 4 {
+			t.Errorf("expected merge generation 4, got %d", c.Generation)
+		}
+	})
+
+	t.Run("Range", func(t *testing.T) {
+		commits, err := store.GetCommitRange(good.Hash, "HEAD")
+		if err != nil {
+			t.Fatalf("GetCommitRange failed: %v", err)
+		}
+		got := make(map[string]bool)
+		for _, c := range commits {
+			got[c.Hash] = true
+		}
+		for _, want := range []string{merge.Hash, fix.Hash, side.Hash} {
+			if !got[want] {
+				t.Errorf("expected %s in range", want[:7])
+			}
+		}
+		if got[good.Hash] || got[root.Hash] {
+			t.Errorf("range must exclude commits reachable from good, got %d commits", len(commits))
+		}
+	})
+
+	t.Run("Candidates", func(t *testing.T) {
+		candidates, err := store.FindRegressionCandidates(ctx, "parseexpr crash", nil, good.Hash, merge.Hash, 10)
+		if err != nil {
+			t.Fatalf("FindRegressionCandidates failed: %v", err)
+		}
+		if len(candidates) == 0 || candidates[0].Commit.Hash != fix.Hash {
+			t.Fatalf("expected fix commit ranked first, got %+v", candidates)
+		}
+		if len(candidates[0].Changes) != 1 || candidates[0].Changes[0].FilePath != "parser.go" {
+			t.Errorf("expected parser.go change on candidate, got %+v", candidates[0].Changes)
+		}
+		if !strings.Contains(candidates[0].DiffPreview, "return fmt.Errorf") {
+			t.Errorf("expected diff preview of the fix, got %q", candidates[0].DiffPreview)
+		}
+		for _, c := range candidates {
+			if c.Commit.Hash == good.Hash {
+				t.Errorf("known good commit must not be a candidate")
+			}
+		}
+	})
+}
+
+func TestCommitGraphBackfill(t *testing.T) {
+	tmpDir, err := os.MkdirTemp("", "commitgraphtest")
+	if err != nil {
+		t.Fatal(err)
+	}
+	defer os.RemoveAll(tmpDir)
+	path := tmpDir + "/index.db"
+
+	// Commits stored before generations and commit_parents: root <- a <- b
+	db, err := sql.Open("sqlite3", path)
+	if err != nil {
+		t.Fatal(err)
+	}
+	for _, stmt := range []string{
+		`CREATE TABLE commits (hash TEXT PRIMARY KEY, short_hash TEXT NOT NULL, author TEXT NOT NULL,
+			author_email TEXT NOT NULL, date INTEGER NOT NULL, message TEXT NOT NULL, parent_hash TEXT,
+			files_changed INTEGER DEFAULT 0, insertions INTEGER DEFAULT 0, deletions INTEGER DEFAULT 0,
+			is_merge BOOLEAN DEFAULT FALSE, is_tagged BOOLEAN DEFAULT FALSE, tags TEXT, branch TEXT)`,
+		`INSERT INTO commits (hash, short_hash, author, author_email, date, message, parent_hash) VALUES
+			('b000000000000000000000000000000000000000', 'b000000', 'A', 'a@test.com', 3, 'Second', 'a000000000000000000000000000000000000000'),
+			('a000000000000000000000000000000000000000', 'a000000', 'A', 'a@test.com', 2, 'First', 'f000000000000000000000000000000000000000'),
+			('f000000000000000000000000000000000000000', 'f000000', 'A', 'a@test.com', 1, 'Root', NULL)`,
+		`PRAGMA user_version = 1`,
+	} {
+		if _, err := db.Exec(stmt); err != nil {
+			db.Close()
+			t.Skipf("cannot build legacy index: %v", err)
+		}
+	}
+	db.Close()
+
+	store := New()
+	if err := store.Init(path); err != nil {
+		if containsString(err.Error(), "fts5") || containsString(err.Error(), "FTS5") {
+			t.Skip("FTS5 not available in this environment")
+		}
+		t.Fatal(err)
+	}
+	defer store.Close()
+
+	c, err := store.GetCommit("b000000000000000000000000000000000000000")
+	if err != nil || c == nil {
+		t.Fatalf("GetCommit failed: %v", err)
+	}
+	if c.Generation != 3 {
+		t.Errorf("generation after upgrade = %d, want 3", c.Generation)
+	}
+	commits, err := store.GetCommitRange("f000000", "HEAD")
+	if err != nil {
+		t.Fatal(err)
+	}
+	if len(commits) != 2 {
+		t.Errorf("range after upgrade has %d commits, want 2", len(commits))
+	}
+}
+
+func TestContributorInsightsAggregates(t *testing.T) {
+	tmpFile, err := os.CreateTemp("", "githistory_contributors_test_*.db")
+	if err != nil {
+		t.Fatalf("failed to create temp file: %v", err)
+	}
+	tmpFile.Close()
+	defer os.Remove(tmpFile.Name())
+
+	store := New()
+	if err := store.Init(tmpFile.Name()); err != nil {
+		if containsString(err.Error(), "fts5") || containsString(err.Error(), "FTS5") {
+			t.Skip("FTS5 not available in this environment")
+		}
+		t.Fatalf("failed to init store: %v", err)
+	}
+	defer store.Close()
+
+	ctx := context.Background()
+	now := time.Now()
+
+	commits := []*types.Commit{
+		{Hash: "a100000000000000000000000000000000000000", ShortHash: "a100000", Author: "Alice", AuthorEmail: "alice@test.com", Date: now.Add(-3 * time.Hour), Message: "Add server"},
+		{Hash: "a200000000000000000000000000000000000000", ShortHash: "a200000", Author: "Alice", AuthorEmail: "alice@test.com", Date: now.Add(-2 * time.Hour), Message: "Tune server"},
+		{Hash: "b100000000000000000000000000000000000000", ShortHash: "b100000", Author: "Bob", AuthorEmail: "bob@test.com", Date: now.Add(-1 * time.Hour), Message: "Fix docs"},
+	}
+	if err := store.StoreCommits(commits); err != nil {
+		t.Fatalf("StoreCommits failed: %v", err)
+	}
+
+	changes := []*types.Change{
+		{ID: "a1:server.go", CommitHash: commits[0].Hash, FilePath: "internal/mcp/server.go", ChangeType: types.ChangeTypeAdded, Additions: 10, AffectedFunctions: []string{"HandleSearch"}},
+		{ID: "a1:tools.go", CommitHash: commits[0].Hash, FilePath: "internal/mcp/tools.go", ChangeType: types.ChangeTypeAdded, Additions: 5},
+		{ID: "a2:server.go", CommitHash: commits[1].Hash, FilePath: "internal/mcp/server.go", ChangeType: types.ChangeTypeModified, Additions: 2, Deletions: 1, AffectedFunctions: []string{"HandleSearch"}},
+		{ID: "b1:readme", CommitHash: commits[2].Hash, FilePath: "docs/README.md", ChangeType: types.ChangeTypeModified, Additions: 4},
+	}
+	if err := store.StoreChanges(changes); err != nil {
+		t.Fatalf("StoreChanges failed: %v", err)
+	}
+	// Re-storing the same changes must not double count
+	if err := store.StoreChanges(changes); err != nil {
+		t.Fatalf("StoreChanges (again) failed: %v", err)
+	}
+
+	byEmail := func(insights []*types.ContributorInsight) map[string]*types.ContributorInsight {
+		m := make(map[string]*types.ContributorInsight)
+		for _, in := range insights {
+			m[in.Email] = in
+		}
+		return m
+	}
+
+	t.Run("DirectoryPrefix", func(t *testing.T) {
+		insights, err := store.GetContributorInsights(ctx, []string{"internal/mcp/**"}, "")
+		if err != nil {
+			t.Fatalf("GetContributorInsights failed: %v", err)
+		}
+		m := byEmail(insights)
+		alice := m["alice@test.com"]
+		if len(insights) != 1 || alice == nil {
+			t.Fatalf("expected only alice, got %d insights", len(insights))
+		}
+		if alice.CommitCount != 2 || alice.LinesChanged != 18 {
+			t.Errorf("expected 2 commits / 18 lines, got %d / %d", alice.CommitCount, alice.LinesChanged)
+		}
+	})
+
+	t.Run("MultiplePrefixes", func(t *testing.T) {
+		insights, err := store.GetContributorInsights(ctx, []string{"internal/mcp/server.go", "docs", "internal/mcp/server.go"}, "")
+		if err != nil {
+			t.Fatalf("GetContributorInsights failed: %v", err)
+		}
+		m := byEmail(insights)
+		if m["alice@test.com"] == nil || m["alice@test.com"].LinesChanged != 13 {
+			t.Errorf("unexpected alice insight: %+v", m["alice@test.com"])
+		}
+		if m["bob@test.com"] == nil || m["bob@test.com"].CommitCount != 1 {
+			t.Errorf("unexpected bob insight: %+v", m["bob@test.com"])
+		}
+	})
+
+	t.Run("Globs", func(t *testing.T) {
+		insights, err := store.GetContributorInsights(ctx, []string{"internal/*/tools.go", "*.md"}, "")
+		if err != nil {
+			t.Fatalf("GetContributorInsights failed: %v", err)
+		}
+		m := byEmail(insights)
+		if m["alice@test.com"] == nil || m["alice@test.com"].LinesChanged != 5 {
+			t.Errorf("unexpected alice insight: %+v", m["alice@test.com"])
+		}
+		if m["bob@test.com"] == nil || m["bob@test.com"].LinesChanged != 4 {
+			t.Errorf("unexpected bob insight: %+v", m["bob@test.com"])
+		}
+	})
+
+	t.Run("Symbol", func(t *testing.T) {
+		insights, err := store.GetContributorInsights(ctx, nil, "handlesearch")
+		if err != nil {
+			t.Fatalf("GetContributorInsights failed: %v", err)
+		}
+		if len(insights) != 1 || insights[0].CommitCount != 2 {
+			t.Fatalf("expected alice with 2 commits, got %+v", insights)
+		}
+	})
+}
+
+func TestChangeDiffCompression(t *testing.T) {
+	tmpFile, err := os.CreateTemp("", "githistory_compression_test_*.db")
+	if err != nil {
+		t.Fatalf("failed to create temp file: %v", err)
+	}
+	tmpFile.Close()
+	defer os.Remove(tmpFile.Name())
+
+	store := New()
+	if err := store.Init(tmpFile.Name()); err != nil {
+		if containsString(err.Error(), "fts5") || containsString(err.Error(), "FTS5") {
+			t.Skip("FTS5 not available in this environment")
+		}
+		t.Fatalf("failed to init store: %v", err)
+	}
+	defer store.Close()
+
+	commit := &types.Commit{
+		Hash:        "f100000000000000000000000000000000000000",
+		ShortHash:   "f100000",
+		Author:      "Test User",
+		AuthorEmail: "test@test.com",
+		Date:        time.Now(),
+		Message:     "Handle errors",
+	}
+	if err := store.StoreCommits([]*types.Commit{commit}); err != nil {
+		t.Fatalf("StoreCommits failed: %v", err)
+	}
+
+	var diff strings.Builder
+	diff.WriteString("diff --git a/main.go b/main.go\n--- a/main.go\n+++ b/main.go\n@@ -1,40 +1,60 @@\n")
+	for i := 0; i < 40; i++ {
+		diff.WriteString("+\tif err != nil {\n+\t\treturn fmt.Errorf(\"failed to load: %w\", err)\n+\t}\n")
+	}
+	change := &types.Change{
+		ID:          "f1000000:main.go",
+		CommitHash:  commit.Hash,
+		FilePath:    "main.go",
+		ChangeType:  types.ChangeTypeModified,
+		DiffContent: diff.String(),
+		Hunks: []types.DiffHunk{
+			{OldStart: 1, OldLines: 40, NewStart: 1, NewLines: 60, Content: diff.String()},
+		},
+	}
+	if err := store.StoreChanges([]*types.Change{change}); err != nil {
+		t.Fatalf("StoreChanges failed: %v", err)
+	}
+
+	got, err := store.GetChange(change.ID)
+	if err != nil || got == nil {
+		t.Fatalf("GetChange failed: %v", err)
+	}
+	if got.DiffContent != change.DiffContent {
+		t.Errorf("diff did not round-trip")
+	}
+	if len(got.Hunks) != 1 || got.Hunks[0].Content != change.DiffContent {
+		t.Errorf("hunks did not round-trip: %+v", got.Hunks)
+	}
+
+	stats, err := store.GetGitHistoryStats()
+	if err != nil {
+		t.Fatalf("GetGitHistoryStats failed: %v", err)
+	}
+	if stats.DiffStoredBytes == 0 || stats.DiffCompressionRatio < 2 {
+		t.Errorf("expected compressed storage, got raw %d / stored %d", stats.DiffRawBytes, stats.DiffStoredBytes)
+	}
+	if stats.DBSizeBytes == 0 {
+		t.Errorf("expected database size to be reported")
+	}
+}
@@ -0,0 +1,318 @@
+package sqlitevec
+
+import (
+	"context"
+	"database/sql"
+	"errors"
+	"fmt"
+	"log/slog"
+	"os"
+	"time"
+)
+
+// Once a database file has gone maintenanceIdle without writes, a
+// maintenance pass:
+//
+//  1. refreshes the planner statistics with ANALYZE, bounded by
+//     analysis_limit;
+//  2. returns free pages to the file system with incremental_vacuum, in
+//     steps of vacuumStepPages, until the pass has written its I/O budget.
+//     Databases created before auto_vacuum was enabled are converted with
+//     one full VACUUM once they are fragmented enough and it fits the
+//     budget;
+//  3. folds the WAL into the database and truncates it.
+//
+// The pass stops between steps when a write to the file comes in; the write
+// schedules the next pass. Split subsystem files (databases.go) are
+// maintained on their own schedules. Maintenance runs through the writer, so it never competes
+// with a write transaction of this process.
+
+var (
+	// maintenanceIdle is how long after the last write a pass runs.
+	maintenanceIdle = time.Minute
+)
+
+const (
+	// defaultMaintenanceBudgetMB bounds the pages a pass writes.
+	defaultMaintenanceBudgetMB = 128
+
+	// vacuumStepPages is the number of pages one incremental_vacuum step
+	// frees.
+	vacuumStepPages = 1024
+
+	// analysisLimit is the approximate number of rows ANALYZE reads per
+	// index.
+	analysisLimit = 1000
+
+	// convertFreeRatio is the share of free pages above which a database
+	// without incremental auto_vacuum is converted with VACUUM.
+	convertFreeRatio = 0.25
+)
+
+// autoVacuumIncremental is the auto_vacuum mode that keeps free pages
+// until incremental_vacuum returns them.
+const autoVacuumIncremental = 2
+
+// storageStats describes a database file.
+type storageStats struct {
+	pageSize   int64
+	pageCount  int64
+	freePages  int64
+	autoVacuum int
+}
+
+// storageStats reads the page statistics of the database file attached as
+// schema.
+func (s *Store) storageStats(schema string) (storageStats, error) {
+	// The pragma functions ignore a schema prefix and freelist_count takes
+	// no schema argument, so the pragmas are read one by one
+	var st storageStats
+	for _, p := range []struct {
+		pragma string
+		dest   any
+	}{
+		{"page_size", &st.pageSize},
+		{"page_count", &st.pageCount},
+		{"freelist_count", &st.freePages},
+		{"auto_vacuum", &st.autoVacuum},
+	} {
+		if err := s.queryRow(fmt.Sprintf("PRAGMA %s.%s", schema, p.pragma)).Scan(p.dest); err != nil {
+			return st, fmt.Errorf("failed to read page statistics: %w", err)
+		}
+	}
+	return st, nil
+}
+
+// maintenanceBudget returns the bytes a pass may write, 0 if maintenance is
+// disabled.
+func (s *Store) maintenanceBudget() int64 {
+	switch budget := s.config.MaintenanceBudgetMB; {
+	case budget < 0:
+		return 0
+	case budget == 0:
+		return defaultMaintenanceBudgetMB * mb
+	default:
+		return int64(budget) * mb
+	}
+}
+
+// noteWrite records write activity on d and schedules a maintenance pass
+// for when it is idle again.
+func (s *Store) noteWrite(d *database) {
+	d.lastWrite.Store(time.Now().UnixNano())
+	if s.maintenanceBudget() == 0 {
+		return
+	}
+
+	d.maintMu.Lock()
+	defer d.maintMu.Unlock()
+
+	if d.maintTimer == nil && !d.maintStopped.Load() {
+		d.maintTimer = time.AfterFunc(maintenanceIdle, func() { s.runScheduledMaintenance(d) })
+	}
+}
+
+// runScheduledMaintenance runs a pass on d once it has been idle for
+// maintenanceIdle.
+func (s *Store) runScheduledMaintenance(d *database) {
+	d.maintMu.Lock()
+	if d.maintStopped.Load() {
+		d.maintMu.Unlock()
+		return
+	}
+	if wait := maintenanceIdle - time.Since(time.Unix(0, d.lastWrite.Load())); wait > 0 {
+		d.maintTimer.Reset(wait)
+		d.maintMu.Unlock()
+		return
+	}
+	d.maintTimer = nil
+	d.maintMu.Unlock()
+
+	if err := s.maintain(d); err != nil && !errors.Is(err, errStoreClosed) {
+		slog.Warn("database maintenance failed", "schema", d.schema, "error", err)
+	}
+}
+
+// stopMaintenance cancels scheduled passes and waits for running ones to
+// stop.
+func (s *Store) stopMaintenance() {
+	for _, d := range s.databases() {
+		d.maintMu.Lock()
+		d.maintStopped.Store(true)
+		if d.maintTimer != nil {
+			d.maintTimer.Stop()
+			d.maintTimer = nil
+		}
+		d.maintMu.Unlock()
+
+		d.maintPassMu.Lock()
+		d.maintPassMu.Unlock()
+	}
+}
+
+// Maintain runs a maintenance pass on every database file.
+func (s *Store) Maintain() error {
+	for _, d := range s.databases() {
+		if err := s.maintain(d); err != nil {
+			return err
+		}
+	}
+	return nil
+}
+
+// maintain runs a maintenance pass on d. Concurrent calls return
+// immediately.
+func (s *Store) maintain(d *database) error {
+	if !d.maintPassMu.TryLock() {
+		return nil
+	}
+	defer d.maintPassMu.Unlock()
+
+	start := time.Now()
+	budget := s.maintenanceBudget()
+	interrupted := func() bool {
+		return d.maintStopped.Load() || d.lastWrite.Load() > start.UnixNano()
+	}
+
+	if err := s.analyze(d); err != nil {
+		return err
+	}
+
+	var written, freed int64
+	if !interrupted() {
+		var err error
+		if written, freed, err = s.reclaimFreePages(d, budget, interrupted); err != nil {
+			return err
+		}
+	}
+
+	// The checkpoint is not skipped when the budget is spent; it is what
+	// keeps the WAL bounded
+	frames, err := s.checkpoint(d)
+	if err != nil {
+		return err
+	}
+
+	d.lastMaintenance.Store(time.Now().Unix())
+	slog.Debug("database maintenance", "schema", d.schema,
+		"freed_pages", freed, "written_bytes", written, "checkpointed_frames", frames,
+		"interrupted", interrupted(), "duration", time.Since(start).Round(time.Millisecond))
+	return nil
+}
+
+// analyze refreshes the planner statistics of d.
+func (s *Store) analyze(d *database) error {
+	err := s.writeConn(d, func(conn *sql.Conn) error {
+		ctx := context.Background()
+		if _, err := conn.ExecContext(ctx, fmt.Sprintf("PRAGMA analysis_limit = %d", analysisLimit)); err != nil {
+			return err
+		}
+		_, err := conn.ExecContext(ctx, "ANALYZE "+d.schema)
+		return err
+	})
+	if err != nil {
+		return fmt.Errorf("failed to analyze: %w", err)
+	}
+	return nil
+}
+
+// reclaimFreePages shrinks the file of d by its free pages, writing at most
+// budget bytes. It returns the bytes written and the pages freed.
+func (s *Store) reclaimFreePages(d *database, budget int64, interrupted func() bool) (written, freed int64, err error) {
+	st, err := s.storageStats(d.schema)
+	if err != nil {
+		return 0, 0, err
+	}
+
+	if st.autoVacuum == autoVacuumIncremental {
+		for st.freePages > freed && written+vacuumStepPages*st.pageSize <= budget && !interrupted() {
+			var n int64
+			err := s.writeConn(d, func(conn *sql.Conn) error {
+				var err error
+				n, err = incrementalVacuum(conn, d.schema, vacuumStepPages)
+				return err
+			})
+			if err != nil {
+				return written, freed, fmt.Errorf("failed to vacuum: %w", err)
+			}
+			if n == 0 {
+				break
+			}
+			freed += n
+			written += n * st.pageSize
+		}
+		return written, freed, nil
+	}
+
+	// VACUUM rewrites the live pages into the WAL and the checkpoint writes
+	// them again
+	if st.pageCount == 0 || float64(st.freePages)/float64(st.pageCount) < convertFreeRatio {
+		return 0, 0, nil
+	}
+	cost := 2 * (st.pageCount - st.freePages) * st.pageSize
+	if cost > budget {
+		if !d.convertSkipped.Swap(true) {
+			slog.Info("database is fragmented but too large to vacuum within the maintenance budget", "schema", d.schema,
+				"free_pages", st.freePages, "pages", st.pageCount, "budget_mb", budget/mb)
+		}
+		return 0, 0, nil
+	}
+	err = s.writeConn(d, func(conn *sql.Conn) error {
+		ctx := context.Background()
+		if _, err := conn.ExecContext(ctx, "PRAGMA "+d.schema+".auto_vacuum = INCREMENTAL"); err != nil {
+			return err
+		}
+		_, err := conn.ExecContext(ctx, "VACUUM "+d.schema)
+		return err
+	})
+	if err != nil {
+		return 0, 0, fmt.Errorf("failed to vacuum: %w", err)
+	}
+	return cost, st.freePages, nil
+}
+
+// incrementalVacuum frees up to pages free pages and returns how many it
+// freed. The pragma frees one page per result row, so it has to be stepped
+// to the end; Exec would stop after the first page.
+func incrementalVacuum(conn *sql.Conn, schema string, pages int) (int64, error) {
+	rows, err := conn.QueryContext(context.Background(), fmt.Sprintf("PRAGMA %s.incremental_vacuum(%d)", schema, pages))
+	if err != nil {
+		return 0, err
+	}
+	defer rows.Close()
+
+	var freed int64
+	for rows.Next() {
+		freed++
+	}
+	return freed, rows.Err()
+}
+
+// checkpoint copies the WAL of d into its file and truncates it. It returns
+// the number of frames copied.
+func (s *Store) checkpoint(d *database) (int64, error) {
+	var busy, frames, copied int64
+	err := s.writeConn(d, func(conn *sql.Conn) error {
+		return conn.QueryRowContext(context.Background(), "PRAGMA "+d.schema+".wal_checkpoint(TRUNCATE)").
+			Scan(&busy, &frames, &copied)
+	})
+	if err != nil {
+		return 0, fmt.Errorf("failed to checkpoint WAL: %w", err)
+	}
+	if busy != 0 {
+		// A reader of another process still uses the WAL; the next pass
+		// retries
+		slog.Debug("WAL checkpoint blocked by readers", "frames", frames, "copied", copied)
+	}
+	return copied, nil
+}
+
+// walSize returns the size of the WAL of the database file at path, 0 if
+// there is none.
+func walSize(path string) int64 {
+	info, err := os.Stat(path + "-wal")
+	if err != nil {
+		return 0
+	}
+	return info.Size()
+}
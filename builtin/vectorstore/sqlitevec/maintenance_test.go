@@ -0,0 +1,89 @@
+package sqlitevec
+
+import (
+	"context"
+	"database/sql"
+	"fmt"
+	"testing"
+)
+
+func TestMaintain(t *testing.T) {
+	store := newWriterTestStore(t)
+
+	// fragment loads an index and deletes it again, leaving free pages
+	fragment := func() {
+		t.Helper()
+		chunks, symbols, refs := bulkTestIndex(2000)
+		if err := store.StoreChunks(chunks); err != nil {
+			t.Fatal(err)
+		}
+		if err := store.StoreSymbols(symbols); err != nil {
+			t.Fatal(err)
+		}
+		if err := store.StoreReferences(refs); err != nil {
+			t.Fatal(err)
+		}
+		files := make([]string, 100)
+		for i := range files {
+			files[i] = fmt.Sprintf("pkg/file%d.go", i)
+		}
+		if err := store.DeleteChunksByFiles(files); err != nil {
+			t.Fatal(err)
+		}
+	}
+	maintain := func() storageStats {
+		t.Helper()
+		before, err := store.storageStats("main")
+		if err != nil {
+			t.Fatal(err)
+		}
+		if before.freePages == 0 {
+			t.Fatal("no free pages to reclaim")
+		}
+		if err := store.Maintain(); err != nil {
+			t.Fatal(err)
+		}
+		after, err := store.storageStats("main")
+		if err != nil {
+			t.Fatal(err)
+		}
+		if after.freePages != 0 || after.pageCount >= before.pageCount {
+			t.Errorf("pages %d (%d free) before maintenance, %d (%d free) after",
+				before.pageCount, before.freePages, after.pageCount, after.freePages)
+		}
+		return after
+	}
+
+	fragment()
+	if st := maintain(); st.autoVacuum != autoVacuumIncremental {
+		t.Errorf("auto_vacuum = %d on a new database", st.autoVacuum)
+	}
+	stats, err := store.GetStats()
+	if err != nil {
+		t.Fatal(err)
+	}
+	if stats.WALSizeBytes != 0 || stats.LastMaintenance.IsZero() {
+		t.Errorf("WAL of %d bytes, last maintenance %v after a pass", stats.WALSizeBytes, stats.LastMaintenance)
+	}
+	var analyzed bool
+	store.db.QueryRow("SELECT EXISTS (SELECT 1 FROM sqlite_master WHERE name = 'sqlite_stat1')").Scan(&analyzed)
+	if !analyzed {
+		t.Error("no planner statistics after a pass")
+	}
+
+	// Databases created without auto_vacuum are converted
+	err = store.writeConn(store.dbs[subsysIndex], func(conn *sql.Conn) error {
+		if _, err := conn.ExecContext(context.Background(), "PRAGMA auto_vacuum = NONE"); err != nil {
+			return err
+		}
+		_, err := conn.ExecContext(context.Background(), "VACUUM")
+		return err
+	})
+	if err != nil {
+		t.Fatal(err)
+	}
+	fragment()
+	if st := maintain(); st.autoVacuum != autoVacuumIncremental {
+		t.Errorf("auto_vacuum = %d after converting", st.autoVacuum)
+	}
+}
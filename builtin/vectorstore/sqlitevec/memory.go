@@ -94,18 +94,15 @@ func (s *Store) createMemorySchema() error {
 		return err
 	}
 
-	_, err = s.db.Exec(`
-		CREATE TRIGGER IF NOT EXISTS memories_au AFTER UPDATE ON memories BEGIN
-			INSERT INTO memories_fts(memories_fts, rowid, id, content, summary)
-			VALUES('delete', old.rowid, old.id, old.content, old.summary);
-			INSERT INTO memories_fts(rowid, id, content, summary)
-			VALUES (new.rowid, new.id, new.content, new.summary);
-		END
-	`)
-	if err != nil {
+	if err := s.updateMemoriesFTSTrigger(); err != nil {
 		return err
 	}
 
+	// Lazy confidence decay columns
+	if err := s.createConfidenceSchema(); err != nil {
+		return fmt.Errorf("failed to create confidence columns: %w", err)
+	}
+
 	// Memory sessions table
 	_, err = s.db.Exec(`
 		CREATE TABLE IF NOT EXISTS memory_sessions (
@@ -151,13 +148,13 @@ func (s *Store) createMemorySchema() error {
 }
 
 // createMemoryEmbeddingsTable creates vector table for memory embeddings.
-func (s *Store) createMemoryEmbeddingsTable(dimensions int) error {
-	_, err := s.db.Exec(fmt.Sprintf(`
-		CREATE VIRTUAL TABLE IF NOT EXISTS memory_embeddings USING vec0(
+func createMemoryEmbeddingsTable(tx *sql.Tx, schema string, dimensions int) error {
+	_, err := tx.Exec(fmt.Sprintf(`
+		CREATE VIRTUAL TABLE IF NOT EXISTS %s.memory_embeddings USING vec0(
 			memory_id TEXT PRIMARY KEY,
 			embedding float[%d]
 		)
-	`, dimensions))
+	`, schema, dimensions))
 	if err != nil {
 		return fmt.Errorf("failed to create memory_embeddings table: %w", err)
 	}
@@ -175,102 +172,108 @@ func (s *Store) StoreMemories(memories []*types.MemoryEntry) error {
 		return nil
 	}
 
-	// Create embedding table if we have embeddings
-	for _, m := range memories {
-		if len(m.Embedding) > 0 {
-			if err := s.createMemoryEmbeddingsTable(len(m.Embedding)); err != nil {
-				return err
+	return s.writeTo(subsysMemory, writeInteractive, func(tx *sql.Tx) error {
+		// Create embedding table if we have embeddings
+		for _, m := range memories {
+			if len(m.Embedding) > 0 {
+				if err := createMemoryEmbeddingsTable(tx, s.schema(subsysMemory), len(m.Embedding)); err != nil {
+					return err
+				}
+				break
 			}
-			break
 		}
-	}
-
-	tx, err := s.db.Begin()
-	if err != nil {
-		return err
-	}
-	defer tx.Rollback()
-
-	memoryStmt, err := tx.Prepare(`
-		INSERT OR REPLACE INTO memories
-		(id, content, summary, category, tags, importance, confidence, access_count,
-		 channel, related_memories, related_chunks, related_commits, session_id,
-		 created_at, updated_at, accessed_at, expires_at)
-		VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?)
-	`)
-	if err != nil {
-		return err
-	}
-	defer memoryStmt.Close()
-
-	embStmt, err := tx.Prepare(`
-		INSERT OR REPLACE INTO memory_embeddings (memory_id, embedding)
-		VALUES (?, ?)
-	`)
-	if err != nil {
-		embStmt = nil
-	} else {
-		defer embStmt.Close()
-	}
-
-	for _, m := range memories {
-		var tagsJSON, relMemJSON, relChunksJSON, relCommitsJSON string
-		var expiresAt sql.NullInt64
 
-		if len(m.Tags) > 0 {
-			b, _ := json.Marshal(m.Tags)
-			tagsJSON = string(b)
-		}
-		if len(m.RelatedMemories) > 0 {
-			b, _ := json.Marshal(m.RelatedMemories)
-			relMemJSON = string(b)
-		}
-		if len(m.RelatedChunks) > 0 {
-			b, _ := json.Marshal(m.RelatedChunks)
-			relChunksJSON = string(b)
-		}
-		if len(m.RelatedCommits) > 0 {
-			b, _ := json.Marshal(m.RelatedCommits)
-			relCommitsJSON = string(b)
-		}
-		if m.ExpiresAt != nil {
-			expiresAt.Int64 = m.ExpiresAt.Unix()
-			expiresAt.Valid = true
+		memoryStmt, err := tx.Prepare(`
+			INSERT OR REPLACE INTO memories
+			(id, content, summary, category, tags, importance, confidence, access_count,
+			 channel, related_memories, related_chunks, related_commits, session_id,
+			 created_at, updated_at, accessed_at, expires_at, confidence_at, confidence_key)
+			VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?)
+		`)
+		if err != nil {
+			return err
 		}
+		defer memoryStmt.Close()
 
-		_, err := memoryStmt.Exec(
-			m.ID, m.Content, m.Summary, string(m.Category), tagsJSON,
-			m.Importance, m.Confidence, m.AccessCount,
-			m.Channel, relMemJSON, relChunksJSON, relCommitsJSON, m.SessionID,
-			m.CreatedAt.Unix(), m.UpdatedAt.Unix(), m.AccessedAt.Unix(), expiresAt,
-		)
+		embStmt, err := tx.Prepare(`
+			INSERT OR REPLACE INTO memory_embeddings (memory_id, embedding)
+			VALUES (?, ?)
+		`)
 		if err != nil {
-			return fmt.Errorf("failed to store memory %s: %w", m.ID, err)
+			embStmt = nil
+		} else {
+			defer embStmt.Close()
 		}
 
-		// Store embedding if present
-		if embStmt != nil && len(m.Embedding) > 0 {
-			embBytes := floatsToBytes(m.Embedding)
-			_, err := embStmt.Exec(m.ID, embBytes)
+		// Stored confidence is the base for lazy decay from now
+		now := time.Now().Unix()
+		halfLife := s.confidenceHalfLife.Load()
+
+		for _, m := range memories {
+			var tagsJSON, relMemJSON, relChunksJSON, relCommitsJSON string
+			var expiresAt sql.NullInt64
+
+			if len(m.Tags) > 0 {
+				b, _ := json.Marshal(m.Tags)
+				tagsJSON = string(b)
+			}
+			if len(m.RelatedMemories) > 0 {
+				b, _ := json.Marshal(m.RelatedMemories)
+				relMemJSON = string(b)
+			}
+			if len(m.RelatedChunks) > 0 {
+				b, _ := json.Marshal(m.RelatedChunks)
+				relChunksJSON = string(b)
+			}
+			if len(m.RelatedCommits) > 0 {
+				b, _ := json.Marshal(m.RelatedCommits)
+				relCommitsJSON = string(b)
+			}
+			if m.ExpiresAt != nil {
+				expiresAt.Int64 = m.ExpiresAt.Unix()
+				expiresAt.Valid = true
+			}
+
+			_, err := memoryStmt.Exec(
+				m.ID, m.Content, m.Summary, string(m.Category), tagsJSON,
+				m.Importance, m.Confidence, m.AccessCount,
+				m.Channel, relMemJSON, relChunksJSON, relCommitsJSON, m.SessionID,
+				m.CreatedAt.Unix(), m.UpdatedAt.Unix(), m.AccessedAt.Unix(), expiresAt,
+				now, confidenceKey(m.Confidence, now, halfLife),
+			)
 			if err != nil {
-				return fmt.Errorf("failed to store embedding for memory %s: %w", m.ID, err)
+				return fmt.Errorf("failed to store memory %s: %w", m.ID, err)
+			}
+
+			// Store embedding if present
+			if embStmt != nil && len(m.Embedding) > 0 {
+				embBytes := floatsToBytes(m.Embedding)
+				_, err := embStmt.Exec(m.ID, embBytes)
+				if err != nil {
+					return fmt.Errorf("failed to store embedding for memory %s: %w", m.ID, err)
+				}
 			}
 		}
-	}
 
-	return tx.Commit()
+		return nil
+	})
 }
 
 // GetMemory retrieves a memory by ID.
 func (s *Store) GetMemory(id string) (*types.MemoryEntry, error) {
-	row := s.db.QueryRow(`
+	row := s.queryRow(`
 		SELECT id, content, summary, category, tags, importance, confidence, access_count,
 		       channel, related_memories, related_chunks, related_commits, session_id,
-		       created_at, updated_at, accessed_at, expires_at
+		       created_at, updated_at, accessed_at, expires_at, confidence_at
 		FROM memories WHERE id = ?
 	`, id)
 
-	return scanMemory(row)
+	m, err := s.scanMemory(row)
+	if err != nil {
+		return nil, err
+	}
+	s.applyPendingAccess(m)
+	return m, nil
 }
 
 // UpdateMemory updates an existing memory entry.
@@ -281,64 +284,48 @@ func (s *Store) UpdateMemory(memory *types.MemoryEntry) error {
 
 // DeleteMemory deletes a memory by ID.
 func (s *Store) DeleteMemory(id string) error {
-	tx, err := s.db.Begin()
-	if err != nil {
-		return err
-	}
-	defer tx.Rollback()
-
-	// Delete embedding
-	_, err = tx.Exec("DELETE FROM memory_embeddings WHERE memory_id = ?", id)
-	if err != nil {
-		// Ignore if table doesn't exist
-	}
+	return s.writeTo(subsysMemory, writeInteractive, func(tx *sql.Tx) error {
+		// Delete embedding
+		_, err := tx.Exec("DELETE FROM memory_embeddings WHERE memory_id = ?", id)
+		if err != nil {
+			// Ignore if table doesn't exist
+		}
 
-	// Delete memory (FTS will be updated by trigger)
-	_, err = tx.Exec("DELETE FROM memories WHERE id = ?", id)
-	if err != nil {
+		// Delete memory (FTS will be updated by trigger)
+		_, err = tx.Exec("DELETE FROM memories WHERE id = ?", id)
 		return err
-	}
-
-	return tx.Commit()
+	})
 }
 
 // DeleteMemoriesByChannel deletes all memories in a channel.
 func (s *Store) DeleteMemoriesByChannel(channel string) error {
-	tx, err := s.db.Begin()
-	if err != nil {
-		return err
-	}
-	defer tx.Rollback()
-
-	// Get memory IDs first
-	rows, err := tx.Query("SELECT id FROM memories WHERE channel = ?", channel)
-	if err != nil {
-		return err
-	}
-
-	var ids []string
-	for rows.Next() {
-		var id string
-		if err := rows.Scan(&id); err != nil {
-			rows.Close()
+	return s.writeTo(subsysMemory, writeInteractive, func(tx *sql.Tx) error {
+		// Get memory IDs first
+		rows, err := tx.Query("SELECT id FROM memories WHERE channel = ?", channel)
+		if err != nil {
 			return err
 		}
-		ids = append(ids, id)
-	}
-	rows.Close()
 
-	// Delete embeddings
-	for _, id := range ids {
-		_, _ = tx.Exec("DELETE FROM memory_embeddings WHERE memory_id = ?", id)
-	}
+		var ids []string
+		for rows.Next() {
+			var id string
+			if err := rows.Scan(&id); err != nil {
+				rows.Close()
+				return err
+			}
+			ids = append(ids, id)
+		}
+		rows.Close()
 
-	// Delete memories
-	_, err = tx.Exec("DELETE FROM memories WHERE channel = ?", channel)
-	if err != nil {
-		return err
-	}
+		// Delete embeddings
+		for _, id := range ids {
+			_, _ = tx.Exec("DELETE FROM memory_embeddings WHERE memory_id = ?", id)
+		}
 
-	return tx.Commit()
+		// Delete memories
+		_, err = tx.Exec("DELETE FROM memories WHERE channel = ?", channel)
+		return err
+	})
 }
 
 // SearchMemories performs hybrid search across memories.
@@ -431,7 +418,7 @@ func (s *Store) SearchMemories(ctx context.Context, req *types.MemorySearchReque
 		results = results[:req.Limit]
 	}
 
-	// Update access count and accessed_at for returned memories
+	// Record access for returned memories (written by a background flush)
 	for _, r := range results {
 		s.touchMemory(r.Memory.ID)
 	}
@@ -459,7 +446,7 @@ func (s *Store) vectorSearchMemories(ctx context.Context, queryVec []float32, li
 	query += " ORDER BY distance ASC LIMIT ?"
 	args = append(args, limit)
 
-	rows, err := s.db.QueryContext(ctx, query, args...)
+	rows, err := s.queryContext(ctx, query, args...)
 	if err != nil {
 		return nil, err
 	}
@@ -504,7 +491,7 @@ func (s *Store) bm25SearchMemories(ctx context.Context, query string, limit int,
 	sqlQuery += " ORDER BY score LIMIT ?"
 	args = append(args, limit)
 
-	rows, err := s.db.QueryContext(ctx, sqlQuery, args...)
+	rows, err := s.queryContext(ctx, sqlQuery, args...)
 	if err != nil {
 		return nil, err
 	}
@@ -559,6 +546,12 @@ func (s *Store) applyMemoryFilters(query string, args []any, req *types.MemorySe
 		args = append(args, req.MinImportance)
 	}
 
+	if req.MinConfidence > 0 {
+		clause, arg := s.minConfidenceFilter(req.MinConfidence)
+		query += clause
+		args = append(args, arg)
+	}
+
 	if !req.IncludeExpired {
 		query += " AND (m.expires_at IS NULL OR m.expires_at > ?)"
 		args = append(args, time.Now().Unix())
@@ -590,15 +583,6 @@ func (s *Store) applyMemoryFilters(query string, args []any, req *types.MemorySe
 	return query, args
 }
 
-// touchMemory updates access count and accessed_at.
-func (s *Store) touchMemory(id string) {
-	_, _ = s.db.Exec(`
-		UPDATE memories
-		SET access_count = access_count + 1, accessed_at = ?
-		WHERE id = ?
-	`, time.Now().Unix(), id)
-}
-
 // RecallMemories is a simplified recall for common use cases.
 func (s *Store) RecallMemories(ctx context.Context, query string, channel string, limit int) ([]*types.MemoryEntry, error) {
 	req := &types.MemorySearchRequest{
@@ -622,11 +606,13 @@ func (s *Store) RecallMemories(ctx context.Context, query string, channel string
 
 // CreateSession creates a new memory session.
 func (s *Store) CreateSession(session *types.MemorySession) error {
-	_, err := s.db.Exec(`
-		INSERT INTO memory_sessions (id, name, description, channel, started_at)
-		VALUES (?, ?, ?, ?, ?)
-	`, session.ID, session.Name, session.Description, session.Channel, session.StartedAt.Unix())
-	return err
+	return s.writeTo(subsysMemory, writeInteractive, func(tx *sql.Tx) error {
+		_, err := tx.Exec(`
+			INSERT INTO memory_sessions (id, name, description, channel, started_at)
+			VALUES (?, ?, ?, ?, ?)
+		`, session.ID, session.Name, session.Description, session.Channel, session.StartedAt.Unix())
+		return err
+	})
 }
 
 // GetSession retrieves a session by ID.
@@ -666,10 +652,12 @@ func (s *Store) GetSession(id string) (*types.MemorySession, error) {
 
 // EndSession marks a session as ended.
 func (s *Store) EndSession(id string) error {
-	_, err := s.db.Exec(`
-		UPDATE memory_sessions SET ended_at = ? WHERE id = ?
-	`, time.Now().Unix(), id)
-	return err
+	return s.writeTo(subsysMemory, writeInteractive, func(tx *sql.Tx) error {
+		_, err := tx.Exec(`
+			UPDATE memory_sessions SET ended_at = ? WHERE id = ?
+		`, time.Now().Unix(), id)
+		return err
+	})
 }
 
 // GetActiveSessions returns active sessions for a channel.
@@ -716,12 +704,14 @@ func (s *Store) GetActiveSessions(channel string) ([]*types.MemorySession, error
 func (s *Store) CreateCheckpoint(checkpoint *types.MemoryCheckpoint) error {
 	memoryIDsJSON, _ := json.Marshal(checkpoint.MemoryIDs)
 
-	_, err := s.db.Exec(`
-		INSERT INTO memory_checkpoints (id, session_id, channel, name, description, created_at, memory_ids)
-		VALUES (?, ?, ?, ?, ?, ?, ?)
-	`, checkpoint.ID, checkpoint.SessionID, checkpoint.Channel, checkpoint.Name,
-		checkpoint.Description, checkpoint.CreatedAt.Unix(), string(memoryIDsJSON))
-	return err
+	return s.writeTo(subsysMemory, writeInteractive, func(tx *sql.Tx) error {
+		_, err := tx.Exec(`
+			INSERT INTO memory_checkpoints (id, session_id, channel, name, description, created_at, memory_ids)
+			VALUES (?, ?, ?, ?, ?, ?, ?)
+		`, checkpoint.ID, checkpoint.SessionID, checkpoint.Channel, checkpoint.Name,
+			checkpoint.Description, checkpoint.CreatedAt.Unix(), string(memoryIDsJSON))
+		return err
+	})
 }
 
 // GetCheckpoint retrieves a checkpoint by ID.
@@ -774,9 +764,12 @@ func (s *Store) RestoreCheckpoint(id string) error {
 			args[i+1] = id
 		}
 
-		_, err = s.db.Exec(
-			"DELETE FROM memories WHERE channel = ? AND id NOT IN ("+strings.Join(placeholders, ",")+")",
-			args...)
+		err = s.writeTo(subsysMemory, writeInteractive, func(tx *sql.Tx) error {
+			_, err := tx.Exec(
+				"DELETE FROM memories WHERE channel = ? AND id NOT IN ("+strings.Join(placeholders, ",")+")",
+				args...)
+			return err
+		})
 		if err != nil {
 			return err
 		}
@@ -827,49 +820,29 @@ func (s *Store) ListCheckpoints(channel string, limit int) ([]*types.MemoryCheck
 func (s *Store) PruneExpired() (int, error) {
 	now := time.Now().Unix()
 
-	// Get IDs of expired memories
-	rows, err := s.db.Query("SELECT id FROM memories WHERE expires_at IS NOT NULL AND expires_at < ?", now)
-	if err != nil {
-		return 0, err
-	}
-
-	var ids []string
-	for rows.Next() {
-		var id string
-		if err := rows.Scan(&id); err != nil {
-			rows.Close()
-			return 0, err
+	var affected int64
+	err := s.writeTo(subsysMemory, writeBulk, func(tx *sql.Tx) error {
+		expired, err := collectIDs(tx, "expired_memories",
+			"SELECT id FROM memories WHERE expires_at IS NOT NULL AND expires_at < ?", now)
+		if err != nil || expired == 0 {
+			return err
 		}
-		ids = append(ids, id)
-	}
-	rows.Close()
-
-	if len(ids) == 0 {
-		return 0, nil
-	}
 
-	tx, err := s.db.Begin()
-	if err != nil {
-		return 0, err
-	}
-	defer tx.Rollback()
+		// The embeddings table only exists once a memory has been embedded
+		_, _ = tx.Exec("DELETE FROM memory_embeddings WHERE memory_id IN (SELECT id FROM temp.expired_memories)")
 
-	// Delete embeddings
-	for _, id := range ids {
-		_, _ = tx.Exec("DELETE FROM memory_embeddings WHERE memory_id = ?", id)
-	}
+		result, err := tx.Exec("DELETE FROM memories WHERE id IN (SELECT id FROM temp.expired_memories)")
+		if err != nil {
+			return err
+		}
 
-	// Delete memories
-	result, err := tx.Exec("DELETE FROM memories WHERE expires_at IS NOT NULL AND expires_at < ?", now)
+		affected, _ = result.RowsAffected()
+		return nil
+	})
 	if err != nil {
 		return 0, err
 	}
 
-	affected, _ := result.RowsAffected()
-	if err := tx.Commit(); err != nil {
-		return 0, err
-	}
-
 	return int(affected), nil
 }
 
@@ -880,26 +853,6 @@ func (s *Store) Consolidate(channel string) error {
 	return nil
 }
 
-// DecayConfidence applies time-based confidence decay to memories.
-func (s *Store) DecayConfidence(halfLifeDays int) error {
-	if halfLifeDays <= 0 {
-		halfLifeDays = 30
-	}
-
-	// Calculate decay factor
-	// confidence_new = confidence_old * exp(-ln(2) * age_days / half_life)
-	now := time.Now().Unix()
-	halfLifeSeconds := int64(halfLifeDays * 24 * 60 * 60)
-
-	_, err := s.db.Exec(`
-		UPDATE memories
-		SET confidence = confidence * exp(-0.693147 * (? - created_at) / ?)
-		WHERE confidence > 0.01
-	`, now, halfLifeSeconds)
-
-	return err
-}
-
 // GetMemoryStats returns statistics about memories.
 func (s *Store) GetMemoryStats(channel string) (*types.MemoryStats, error) {
 	stats := &types.MemoryStats{
@@ -914,49 +867,37 @@ func (s *Store) GetMemoryStats(channel string) (*types.MemoryStats, error) {
 		args = append(args, channel)
 	}
 
-	// Total memories
-	row := s.db.QueryRow("SELECT COUNT(*) FROM memories"+whereClause, args...)
-	row.Scan(&stats.TotalMemories)
-
-	// By category
-	rows, err := s.db.Query("SELECT category, COUNT(*) FROM memories"+whereClause+" GROUP BY category", args...)
-	if err == nil {
-		defer rows.Close()
-		for rows.Next() {
-			var cat string
-			var count int
-			if rows.Scan(&cat, &count) == nil {
-				stats.MemoriesByCategory[types.MemoryCategory(cat)] = count
-			}
-		}
+	// Counts are maintained by triggers (stat_counts.go)
+	byCategory, err := s.groupedCounts("memories", "k2", channel)
+	if err != nil {
+		return nil, err
+	}
+	for cat, count := range byCategory {
+		stats.MemoriesByCategory[types.MemoryCategory(cat)] = count
+		stats.TotalMemories += count
 	}
 
 	// By channel (only if not filtering by channel)
 	if channel == "" {
-		rows, err := s.db.Query("SELECT channel, COUNT(*) FROM memories GROUP BY channel")
-		if err == nil {
-			defer rows.Close()
-			for rows.Next() {
-				var ch string
-				var count int
-				if rows.Scan(&ch, &count) == nil {
-					stats.MemoriesByChannel[ch] = count
-				}
-			}
+		byChannel, err := s.groupedCounts("memories", "k1", "")
+		if err != nil {
+			return nil, err
+		}
+		for ch, count := range byChannel {
+			stats.MemoriesByChannel[ch] = count
 		}
 	}
 
-	// Active sessions
-	row = s.db.QueryRow("SELECT COUNT(*) FROM memory_sessions WHERE ended_at IS NULL")
-	row.Scan(&stats.ActiveSessions)
-
-	// Checkpoints
-	row = s.db.QueryRow("SELECT COUNT(*) FROM memory_checkpoints")
-	row.Scan(&stats.TotalCheckpoints)
+	counts, err := s.statCounts("active_sessions", "memory_checkpoints")
+	if err != nil {
+		return nil, err
+	}
+	stats.ActiveSessions = int(counts["active_sessions"])
+	stats.TotalCheckpoints = int(counts["memory_checkpoints"])
 
 	// Date range
 	var oldest, newest sql.NullInt64
-	row = s.db.QueryRow("SELECT MIN(created_at), MAX(created_at) FROM memories" + whereClause)
+	row := s.db.QueryRow("SELECT MIN(created_at), MAX(created_at) FROM memories"+whereClause, args...)
 	if row.Scan(&oldest, &newest) == nil {
 		if oldest.Valid {
 			t := time.Unix(oldest.Int64, 0)
@@ -975,19 +916,20 @@ func (s *Store) GetMemoryStats(channel string) (*types.MemoryStats, error) {
 	return stats, nil
 }
 
-// Helper function to scan a memory from a row.
-func scanMemory(row *sql.Row) (*types.MemoryEntry, error) {
+// Helper function to scan a memory from a row. Confidence is returned
+// decayed to now.
+func (s *Store) scanMemory(row *sql.Row) (*types.MemoryEntry, error) {
 	var m types.MemoryEntry
 	var summary, tags, relMem, relChunks, relCommits, sessionID sql.NullString
 	var createdAt, updatedAt, accessedAt int64
-	var expiresAt sql.NullInt64
+	var expiresAt, confidenceAt sql.NullInt64
 	var category string
 
 	err := row.Scan(
 		&m.ID, &m.Content, &summary, &category, &tags,
 		&m.Importance, &m.Confidence, &m.AccessCount,
 		&m.Channel, &relMem, &relChunks, &relCommits, &sessionID,
-		&createdAt, &updatedAt, &accessedAt, &expiresAt,
+		&createdAt, &updatedAt, &accessedAt, &expiresAt, &confidenceAt,
 	)
 	if err == sql.ErrNoRows {
 		return nil, nil
@@ -1002,6 +944,7 @@ func scanMemory(row *sql.Row) (*types.MemoryEntry, error) {
 	m.CreatedAt = time.Unix(createdAt, 0)
 	m.UpdatedAt = time.Unix(updatedAt, 0)
 	m.AccessedAt = time.Unix(accessedAt, 0)
+	m.Confidence = s.decayedConfidence(m.Confidence, confidenceAt.Int64)
 
 	if expiresAt.Valid {
 		t := time.Unix(expiresAt.Int64, 0)
@@ -491,3 +491,184 @@ func TestMemoryTTL(t *testing.T) {
 		t.Error("valid memory should remain")
 	}
 }
+
+func TestMemoryAccessBuffered(t *testing.T) {
+	tmpDir, err := os.MkdirTemp("", "accesstest")
+	if err != nil {
+		t.Fatal(err)
+	}
+	defer os.RemoveAll(tmpDir)
+
+	store := New()
+	if err := store.Init(tmpDir + "/test.db"); err != nil {
+		if containsString(err.Error(), "fts5") || containsString(err.Error(), "FTS5") {
+			t.Skip("FTS5 not available in this environment")
+		}
+		t.Fatal(err)
+	}
+	defer store.Close()
+
+	past := time.Now().Add(-time.Hour)
+	store.StoreMemory(&types.MemoryEntry{
+		ID:         "mem_access",
+		Content:    "Recalled often",
+		Category:   types.MemoryCategoryNote,
+		Channel:    "main",
+		Importance: 0.5,
+		Confidence: 1.0,
+		CreatedAt:  past,
+		UpdatedAt:  past,
+		AccessedAt: past,
+	})
+
+	store.touchMemory("mem_access")
+	store.touchMemory("mem_access")
+
+	// Not written yet, but visible through GetMemory
+	var count int
+	if err := store.db.QueryRow("SELECT access_count FROM memories WHERE id = ?", "mem_access").Scan(&count); err != nil {
+		t.Fatal(err)
+	}
+	if count != 0 {
+		t.Errorf("access_count before flush = %d, want 0", count)
+	}
+	got, _ := store.GetMemory("mem_access")
+	if got == nil || got.AccessCount != 2 || !got.AccessedAt.After(past) {
+		t.Errorf("GetMemory before flush = %+v, want 2 accesses", got)
+	}
+
+	if err := store.FlushMemoryAccess(); err != nil {
+		t.Fatalf("FlushMemoryAccess failed: %v", err)
+	}
+	if err := store.db.QueryRow("SELECT access_count FROM memories WHERE id = ?", "mem_access").Scan(&count); err != nil {
+		t.Fatal(err)
+	}
+	if count != 2 {
+		t.Errorf("access_count after flush = %d, want 2", count)
+	}
+	if got, _ := store.GetMemory("mem_access"); got == nil || got.AccessCount != 2 {
+		t.Errorf("GetMemory after flush = %+v, want 2 accesses", got)
+	}
+}
+
+func TestMemoryConfidenceDecay(t *testing.T) {
+	tmpDir, err := os.MkdirTemp("", "decaytest")
+	if err != nil {
+		t.Fatal(err)
+	}
+	defer os.RemoveAll(tmpDir)
+
+	store := New()
+	if err := store.Init(tmpDir + "/test.db"); err != nil {
+		if containsString(err.Error(), "fts5") || containsString(err.Error(), "FTS5") {
+			t.Skip("FTS5 not available in this environment")
+		}
+		t.Fatal(err)
+	}
+	defer store.Close()
+
+	now := time.Now()
+	store.StoreMemory(&types.MemoryEntry{
+		ID:         "mem_decay",
+		Content:    "Confidence fades over time",
+		Category:   types.MemoryCategoryNote,
+		Channel:    "main",
+		Importance: 0.5,
+		Confidence: 1.0,
+		CreatedAt:  now,
+		UpdatedAt:  now,
+	})
+
+	// Confidence was set 30 days ago
+	monthAgo := now.Add(-30 * 24 * time.Hour).Unix()
+	if _, err := store.db.Exec("UPDATE memories SET confidence_at = ? WHERE id = ?", monthAgo, "mem_decay"); err != nil {
+		t.Fatal(err)
+	}
+
+	got, _ := store.GetMemory("mem_decay")
+	if got == nil || got.Confidence != 1.0 {
+		t.Fatalf("confidence without decay = %+v, want 1.0", got)
+	}
+
+	if err := store.DecayConfidence(30); err != nil {
+		t.Fatalf("DecayConfidence failed: %v", err)
+	}
+	got, _ = store.GetMemory("mem_decay")
+	if got == nil || got.Confidence < 0.49 || got.Confidence > 0.51 {
+		t.Fatalf("confidence after one half-life = %+v, want 0.5", got)
+	}
+
+	ctx := context.Background()
+	for _, tt := range []struct {
+		min  float32
+		want int
+	}{{0.4, 1}, {0.6, 0}} {
+		results, err := store.SearchMemories(ctx, &types.MemorySearchRequest{
+			Query:         "confidence",
+			Limit:         10,
+			MinConfidence: tt.min,
+		})
+		if err != nil {
+			t.Fatalf("SearchMemories failed: %v", err)
+		}
+		if len(results) != tt.want {
+			t.Errorf("min_confidence %.1f returned %d results, want %d", tt.min, len(results), tt.want)
+		}
+	}
+
+	// Updating rebases the decayed confidence at the current time
+	if err := store.UpdateMemory(got); err != nil {
+		t.Fatal(err)
+	}
+	updated, _ := store.GetMemory("mem_decay")
+	if updated == nil || updated.Confidence < 0.49 || updated.Confidence > 0.51 {
+		t.Errorf("confidence after update = %+v, want 0.5", updated)
+	}
+}
+
+func TestSchemaRevisionReopen(t *testing.T) {
+	tmpDir, err := os.MkdirTemp("", "schematest")
+	if err != nil {
+		t.Fatal(err)
+	}
+	defer os.RemoveAll(tmpDir)
+	dbPath := tmpDir + "/test.db"
+
+	store := New()
+	if err := store.Init(dbPath); err != nil {
+		if containsString(err.Error(), "fts5") || containsString(err.Error(), "FTS5") {
+			t.Skip("FTS5 not available in this environment")
+		}
+		t.Fatal(err)
+	}
+	if err := store.DecayConfidence(7); err != nil {
+		t.Fatal(err)
+	}
+	var revision int
+	store.db.QueryRow("PRAGMA user_version").Scan(&revision)
+	store.Close()
+	if revision != schemaRevision {
+		t.Fatalf("user_version = %d, want %d", revision, schemaRevision)
+	}
+
+	// A current database skips schema setup but still loads its settings
+	reopened := New()
+	if err := reopened.Init(dbPath); err != nil {
+		t.Fatal(err)
+	}
+	defer reopened.Close()
+
+	if got, want := reopened.confidenceHalfLife.Load(), int64(7*24*60*60); got != want {
+		t.Errorf("half-life after reopen = %d, want %d", got, want)
+	}
+	if err := reopened.StoreMemory(&types.MemoryEntry{
+		ID:        "mem_reopen",
+		Content:   "Schema survives reopening",
+		Category:  types.MemoryCategoryNote,
+		Channel:   "main",
+		CreatedAt: time.Now(),
+		UpdatedAt: time.Now(),
+	}); err != nil {
+		t.Errorf("StoreMemory after reopen: %v", err)
+	}
+}
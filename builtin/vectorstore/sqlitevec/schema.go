@@ -0,0 +1,110 @@
+package sqlitevec
+
+import (
+	"fmt"
+	"log/slog"
+)
+
+// schemaRevision identifies the layout produced by the schema creators and
+// is stored in PRAGMA user_version. Init skips the creators, their column
+// migrations and backfills when a database is already at this revision, so
+// opening an up-to-date index is a single pragma read.
+//
+// Bump it with every change to schemaCreators or createStatCounts,
+// including the backfill versions they check. Split subsystem files
+// (databases.go) record their revision each.
+const schemaRevision = 5
+
+// schemaCreator creates or migrates the tables of one part of the schema.
+type schemaCreator struct {
+	name   string
+	create func(*Store) error
+}
+
+// schemaCreators are the creators of each subsystem's tables.
+var schemaCreators = [numSubsystems][]schemaCreator{
+	subsysIndex:   {{"", (*Store).createSchema}},
+	subsysHistory: {{"git history ", (*Store).createGitHistorySchema}},
+	subsysMemory:  {{"memory ", (*Store).createMemorySchema}, {"todo ", (*Store).createTodoSchema}},
+}
+
+// setupSchema brings the database files to schemaRevision. Split subsystem
+// files are set up after the index, each with its own revision.
+func (s *Store) setupSchema(settings connSettings) error {
+	if !s.split() {
+		var creators []schemaCreator
+		for _, c := range schemaCreators {
+			creators = append(creators, c...)
+		}
+		if err := s.runCreators(creators); err != nil {
+			return err
+		}
+		return s.loadSchemaSettings()
+	}
+
+	if err := s.runCreators(schemaCreators[subsysIndex]); err != nil {
+		return err
+	}
+	for sub := subsysHistory; sub < numSubsystems; sub++ {
+		if err := s.setupSubsystem(sub, settings, schemaCreators[sub]); err != nil {
+			return err
+		}
+	}
+	return s.loadSchemaSettings()
+}
+
+// runCreators brings the main database of s to schemaRevision with
+// creators, followed by the counters of the tables it holds.
+func (s *Store) runCreators(creators []schemaCreator) error {
+	var revision int
+	if err := s.db.QueryRow("PRAGMA user_version").Scan(&revision); err != nil {
+		return fmt.Errorf("failed to read schema revision: %w", err)
+	}
+	if revision == schemaRevision {
+		return nil
+	}
+	if revision > schemaRevision {
+		slog.Warn("index was written by a newer version", "path", s.path, "revision", revision, "supported", schemaRevision)
+	}
+
+	for _, c := range creators {
+		if err := c.create(s); err != nil {
+			return fmt.Errorf("failed to create %sschema: %w", c.name, err)
+		}
+	}
+	if err := s.createStatCounts(); err != nil {
+		return fmt.Errorf("failed to create stat counters: %w", err)
+	}
+
+	if revision < schemaRevision {
+		if _, err := s.db.Exec(fmt.Sprintf("PRAGMA user_version = %d", schemaRevision)); err != nil {
+			return fmt.Errorf("failed to set schema revision: %w", err)
+		}
+	}
+	return nil
+}
+
+// loadSchemaSettings loads the settings the schema creators read into the
+// store, for databases whose schema is already current.
+func (s *Store) loadSchemaSettings() error {
+	if err := s.loadVectorDimensions(); err != nil {
+		return err
+	}
+	return s.loadConfidenceHalfLife()
+}
+
+// repairFTS checks the chunks FTS index and rebuilds it if corrupted. It
+// runs in the background after Init; Close waits for it.
+func (s *Store) repairFTS() {
+	defer s.background.Done()
+
+	if err := s.CheckFTSHealth(); err != nil {
+		slog.Warn("FTS index unhealthy, rebuilding", "error", err)
+		if rebuildErr := s.RebuildFTS(); rebuildErr != nil {
+			slog.Error("failed to rebuild FTS index", "error", rebuildErr)
+			// Continue anyway - search will work without FTS
+			return
+		}
+		slog.Info("FTS index rebuilt successfully")
+	}
+}
@@ -0,0 +1,355 @@
+package sqlitevec
+
+import (
+	"database/sql"
+	"fmt"
+	"strings"
+)
+
+// The totals reported by GetStats, GetMemoryStats, GetTodoStats and
+// GetGitHistoryStats are kept in stat_counts by triggers, so status calls
+// read a few counter rows instead of scanning the tables. A counter has up
+// to two keys for grouped totals (memories by channel and category, chunks
+// by file). Rows of grouped counters are dropped when they reach zero.
+//
+// With split database files, each file keeps the counters of its own tables;
+// triggers cannot write to another file.
+//
+// Connections run with recursive_triggers, so INSERT OR REPLACE fires the
+// delete triggers of the rows it replaces.
+
+// countTrigger describes the triggers maintaining counters for one table.
+type countTrigger struct {
+	table string
+	// count returns the statements counting row ("new" or "old") with
+	// sign "+1" or "-1"
+	count func(row, sign string) []string
+	// Columns whose update moves the row between keys, with the condition
+	// under which the update trigger runs
+	updateOf, updateWhen string
+}
+
+// countAdd adds delta to a counter row, creating it if needed.
+func countAdd(counter, k1, k2, delta string) string {
+	return fmt.Sprintf(`INSERT INTO stat_counts (counter, k1, k2, n) VALUES ('%s', %s, %s, %s)
+		ON CONFLICT DO UPDATE SET n = n + excluded.n`, counter, k1, k2, delta)
+}
+
+// distinctAdd counts rows per key in counter and keeps the number of keys
+// with rows in distinct.
+func distinctAdd(counter, key, distinct, sign string) []string {
+	perKey := fmt.Sprintf("(SELECT n FROM stat_counts WHERE counter = '%s' AND k1 = %s AND k2 = '')", counter, key)
+	if sign == "+1" {
+		return []string{
+			countAdd(counter, key, "''", "1"),
+			fmt.Sprintf("UPDATE stat_counts SET n = n + 1 WHERE counter = '%s' AND k1 = '' AND k2 = '' AND %s = 1", distinct, perKey),
+		}
+	}
+	return []string{
+		fmt.Sprintf("UPDATE stat_counts SET n = n - 1 WHERE counter = '%s' AND k1 = '' AND k2 = '' AND %s = 1", distinct, perKey),
+		countAdd(counter, key, "''", "-1"),
+		fmt.Sprintf("DELETE FROM stat_counts WHERE counter = '%s' AND k1 = %s AND k2 = '' AND n <= 0", counter, key),
+	}
+}
+
+// groupedAdd adds to a grouped counter and drops its row at zero.
+func groupedAdd(counter, k1, k2, sign string) []string {
+	stmts := []string{countAdd(counter, k1, k2, sign)}
+	if sign == "-1" {
+		stmts = append(stmts, fmt.Sprintf("DELETE FROM stat_counts WHERE counter = '%s' AND k1 = %s AND k2 = %s AND n <= 0", counter, k1, k2))
+	}
+	return stmts
+}
+
+// diffRawSize and diffStoredSize are the bytes of a change's diff before and
+// after compression; rows stored before compression count as uncompressed.
+const (
+	diffLegacySize = `COALESCE(length(CAST(%[1]s.diff_content AS BLOB)), 0) + COALESCE(length(CAST(%[1]s.hunks AS BLOB)), 0)`
+	diffRawSize    = `CASE WHEN %[1]s.diff_blob IS NULL AND %[1]s.hunks_blob IS NULL THEN ` + diffLegacySize + ` ELSE COALESCE(%[1]s.raw_size, 0) END`
+	diffStoredSize = `CASE WHEN %[1]s.diff_blob IS NULL AND %[1]s.hunks_blob IS NULL THEN ` + diffLegacySize +
+		` ELSE COALESCE(length(%[1]s.diff_blob), 0) + COALESCE(length(%[1]s.hunks_blob), 0) END`
+)
+
+var countTriggers = []countTrigger{
+	{
+		table: "chunks",
+		count: func(row, sign string) []string {
+			return append([]string{countAdd("chunks", "''", "''", sign)},
+				distinctAdd("file_chunks", row+".file_id", "indexed_files", sign)...)
+		},
+		updateOf: "file_id", updateWhen: "old.file_id IS NOT new.file_id",
+	},
+	{
+		table: "symbols",
+		count: func(row, sign string) []string {
+			return []string{countAdd("symbols", "''", "''", sign)}
+		},
+	},
+	{
+		table: "refs",
+		count: func(row, sign string) []string {
+			return []string{countAdd("refs", "''", "''", sign)}
+		},
+	},
+	{
+		table: "memories",
+		count: func(row, sign string) []string {
+			return groupedAdd("memories", "COALESCE("+row+".channel, '')", row+".category", sign)
+		},
+		updateOf: "channel, category", updateWhen: "old.channel IS NOT new.channel OR old.category IS NOT new.category",
+	},
+	{
+		table: "memory_checkpoints",
+		count: func(row, sign string) []string {
+			return []string{countAdd("memory_checkpoints", "''", "''", sign)}
+		},
+	},
+	{
+		table: "memory_sessions",
+		count: func(row, sign string) []string {
+			return []string{countAdd("active_sessions", "''", "''", fmt.Sprintf("%s * (%s.ended_at IS NULL)", sign, row))}
+		},
+		updateOf: "ended_at", updateWhen: "(old.ended_at IS NULL) != (new.ended_at IS NULL)",
+	},
+	{
+		table: "todos",
+		count: func(row, sign string) []string {
+			channel := "COALESCE(" + row + ".channel, '')"
+			return append(groupedAdd("todo_status", channel, row+".status", sign),
+				groupedAdd("todo_priority", channel, row+".priority", sign)...)
+		},
+		updateOf:   "channel, status, priority",
+		updateWhen: "old.channel IS NOT new.channel OR old.status IS NOT new.status OR old.priority IS NOT new.priority",
+	},
+	{
+		table: "commits",
+		count: func(row, sign string) []string {
+			return append([]string{countAdd("commits", "''", "''", sign)},
+				distinctAdd("commit_authors", row+".author_email", "authors", sign)...)
+		},
+		updateOf: "author_email", updateWhen: "old.author_email IS NOT new.author_email",
+	},
+	{
+		table: "changes",
+		count: func(row, sign string) []string {
+			return []string{
+				countAdd("changes", "''", "''", sign),
+				countAdd("diff_raw_bytes", "''", "''", sign+" * ("+fmt.Sprintf(diffRawSize, row)+")"),
+				countAdd("diff_stored_bytes", "''", "''", sign+" * ("+fmt.Sprintf(diffStoredSize, row)+")"),
+			}
+		},
+		updateOf:   "diff_content, hunks, diff_blob, hunks_blob, raw_size",
+		updateWhen: "1",
+	},
+}
+
+// statTriggerSQL returns the CREATE TRIGGER statements for t.
+func (t countTrigger) statTriggerSQL() []string {
+	body := func(stmts ...[]string) string {
+		var all []string
+		for _, s := range stmts {
+			all = append(all, s...)
+		}
+		return "\t" + strings.Join(all, ";\n\t") + ";"
+	}
+	triggers := []string{
+		fmt.Sprintf("CREATE TRIGGER IF NOT EXISTS stat_%s_ai AFTER INSERT ON %s BEGIN\n%s\nEND",
+			t.table, t.table, body(t.count("new", "+1"))),
+		fmt.Sprintf("CREATE TRIGGER IF NOT EXISTS stat_%s_ad AFTER DELETE ON %s BEGIN\n%s\nEND",
+			t.table, t.table, body(t.count("old", "-1"))),
+	}
+	if t.updateOf != "" {
+		triggers = append(triggers, fmt.Sprintf(
+			"CREATE TRIGGER IF NOT EXISTS stat_%s_au AFTER UPDATE OF %s ON %s WHEN %s BEGIN\n%s\nEND",
+			t.table, t.updateOf, t.table, t.updateWhen, body(t.count("old", "-1"), t.count("new", "+1"))))
+	}
+	return triggers
+}
+
+// createStatCounts creates the counters and triggers of the tables in the
+// main schema and recounts them. It runs after the other schema creators.
+func (s *Store) createStatCounts() error {
+	tx, err := s.db.Begin()
+	if err != nil {
+		return err
+	}
+	defer tx.Rollback()
+
+	tables, err := mainTables(tx)
+	if err != nil {
+		return err
+	}
+
+	_, err = tx.Exec(`
+		CREATE TABLE IF NOT EXISTS stat_counts (
+			counter TEXT NOT NULL,
+			k1 TEXT NOT NULL DEFAULT '',
+			k2 TEXT NOT NULL DEFAULT '',
+			n INTEGER NOT NULL DEFAULT 0,
+			PRIMARY KEY (counter, k1, k2)
+		) WITHOUT ROWID
+	`)
+	if err != nil {
+		return err
+	}
+	for _, t := range countTriggers {
+		if !tables[t.table] {
+			continue
+		}
+		for _, stmt := range t.statTriggerSQL() {
+			if _, err := tx.Exec(stmt); err != nil {
+				return fmt.Errorf("failed to create %s counter triggers: %w", t.table, err)
+			}
+		}
+	}
+
+	if err := recountStats(tx, nil); err != nil {
+		return err
+	}
+	return tx.Commit()
+}
+
+// statRecount recomputes a counter from its table.
+type statRecount struct{ table, query string }
+
+// statRecounts recompute each counter from its table.
+var statRecounts = map[string]statRecount{
+	"chunks":             {"chunks", "SELECT 'chunks', '', '', COUNT(*) FROM chunks"},
+	"symbols":            {"symbols", "SELECT 'symbols', '', '', COUNT(*) FROM symbols"},
+	"refs":               {"refs", "SELECT 'refs', '', '', COUNT(*) FROM refs"},
+	"file_chunks":        {"chunks", "SELECT 'file_chunks', file_id, '', COUNT(*) FROM chunks GROUP BY file_id"},
+	"indexed_files":      {"chunks", "SELECT 'indexed_files', '', '', COUNT(DISTINCT file_id) FROM chunks"},
+	"memories":           {"memories", "SELECT 'memories', COALESCE(channel, ''), category, COUNT(*) FROM memories GROUP BY 2, 3"},
+	"memory_checkpoints": {"memory_checkpoints", "SELECT 'memory_checkpoints', '', '', COUNT(*) FROM memory_checkpoints"},
+	"active_sessions":    {"memory_sessions", "SELECT 'active_sessions', '', '', COUNT(*) FROM memory_sessions WHERE ended_at IS NULL"},
+	"todo_status":        {"todos", "SELECT 'todo_status', COALESCE(channel, ''), status, COUNT(*) FROM todos GROUP BY 2, 3"},
+	"todo_priority":      {"todos", "SELECT 'todo_priority', COALESCE(channel, ''), priority, COUNT(*) FROM todos GROUP BY 2, 3"},
+	"commits":            {"commits", "SELECT 'commits', '', '', COUNT(*) FROM commits"},
+	"commit_authors":     {"commits", "SELECT 'commit_authors', author_email, '', COUNT(*) FROM commits GROUP BY author_email"},
+	"authors":            {"commits", "SELECT 'authors', '', '', COUNT(DISTINCT author_email) FROM commits"},
+	"changes":            {"changes", "SELECT 'changes', '', '', COUNT(*) FROM changes"},
+	"diff_raw_bytes":     {"changes", "SELECT 'diff_raw_bytes', '', '', COALESCE(SUM(" + fmt.Sprintf(diffRawSize, "c") + "), 0) FROM changes c"},
+	"diff_stored_bytes":  {"changes", "SELECT 'diff_stored_bytes', '', '', COALESCE(SUM(" + fmt.Sprintf(diffStoredSize, "c") + "), 0) FROM changes c"},
+}
+
+// indexCounters are the counters of the chunk, symbol and reference tables.
+var indexCounters = []string{"chunks", "symbols", "refs", "file_chunks", "indexed_files"}
+
+// recountStats recomputes counters from their tables, all those of the
+// tables in the main schema if counters is nil.
+func recountStats(tx *sql.Tx, counters []string) error {
+	if counters == nil {
+		tables, err := mainTables(tx)
+		if err != nil {
+			return err
+		}
+		for counter, r := range statRecounts {
+			if tables[r.table] {
+				counters = append(counters, counter)
+			}
+		}
+	}
+	for _, counter := range counters {
+		if _, err := tx.Exec("DELETE FROM stat_counts WHERE counter = ?", counter); err != nil {
+			return err
+		}
+		_, err := tx.Exec("INSERT INTO stat_counts (counter, k1, k2, n) " + statRecounts[counter].query)
+		if err != nil {
+			return fmt.Errorf("failed to recount %s: %w", counter, err)
+		}
+	}
+	return nil
+}
+
+// countersOf returns the counters of tables.
+func countersOf(tables []string) []string {
+	var counters []string
+	for counter, r := range statRecounts {
+		for _, t := range tables {
+			if r.table == t {
+				counters = append(counters, counter)
+			}
+		}
+	}
+	return counters
+}
+
+// mainTables returns the names of the tables in the main schema.
+func mainTables(tx *sql.Tx) (map[string]bool, error) {
+	rows, err := tx.Query("SELECT name FROM main.sqlite_master WHERE type = 'table'")
+	if err != nil {
+		return nil, err
+	}
+	defer rows.Close()
+
+	tables := make(map[string]bool)
+	for rows.Next() {
+		var name string
+		if err := rows.Scan(&name); err != nil {
+			return nil, err
+		}
+		tables[name] = true
+	}
+	return tables, rows.Err()
+}
+
+// statCountsTable returns the counter rows of all database files.
+func (s *Store) statCountsTable() string {
+	if !s.split() {
+		return "stat_counts"
+	}
+	var parts []string
+	for _, d := range s.databases() {
+		parts = append(parts, "SELECT * FROM "+d.schema+".stat_counts")
+	}
+	return "(" + strings.Join(parts, " UNION ALL ") + ")"
+}
+
+// statCounts reads scalar counters.
+func (s *Store) statCounts(counters ...string) (map[string]int64, error) {
+	rows, err := s.query(fmt.Sprintf(
+		"SELECT counter, n FROM %s WHERE counter IN (SELECT value FROM json_each(?)) AND k1 = '' AND k2 = ''",
+		s.statCountsTable()), jsonArray(counters))
+	if err != nil {
+		return nil, err
+	}
+	defer rows.Close()
+
+	counts := make(map[string]int64, len(counters))
+	for rows.Next() {
+		var counter string
+		var n int64
+		if err := rows.Scan(&counter, &n); err != nil {
+			return nil, err
+		}
+		counts[counter] = n
+	}
+	return counts, rows.Err()
+}
+
+// groupedCounts sums a grouped counter by k1 or k2 ("k1" or "k2" in by),
+// optionally for one k1 value.
+func (s *Store) groupedCounts(counter, by, k1 string) (map[string]int, error) {
+	query := "SELECT " + by + ", SUM(n) FROM " + s.statCountsTable() + " WHERE counter = ?"
+	args := []any{counter}
+	if k1 != "" {
+		query += " AND k1 = ?"
+		args = append(args, k1)
+	}
+	rows, err := s.query(query+" GROUP BY "+by+" HAVING SUM(n) > 0", args...)
+	if err != nil {
+		return nil, err
+	}
+	defer rows.Close()
+
+	counts := make(map[string]int)
+	for rows.Next() {
+		var key string
+		var n int
+		if err := rows.Scan(&key, &n); err != nil {
+			return nil, err
+		}
+		counts[key] = n
+	}
+	return counts, rows.Err()
+}
@@ -0,0 +1,112 @@
+package sqlitevec
+
+import (
+	"database/sql"
+	"fmt"
+	"testing"
+	"time"
+
+	"github.com/spetr/mcp-codewizard/pkg/types"
+)
+
+func TestStatCounts(t *testing.T) {
+	store := newWriterTestStore(t)
+	now := time.Now()
+
+	var chunks []*types.ChunkWithEmbedding
+	for i := 0; i < 6; i++ {
+		file := fmt.Sprintf("f%d.go", i%3)
+		chunks = append(chunks, &types.ChunkWithEmbedding{Chunk: &types.Chunk{
+			ID: fmt.Sprintf("%s:%d:h", file, i), FilePath: file, Language: "go", Content: "func f()",
+			ChunkType: types.ChunkTypeFunction, StartLine: i, EndLine: i, Hash: "h",
+		}})
+	}
+	if err := store.StoreChunks(chunks); err != nil {
+		t.Fatal(err)
+	}
+	symbol := &types.Symbol{ID: "f0.go:f:1", Name: "f", Kind: types.SymbolKindFunction, FilePath: "f0.go", StartLine: 1, EndLine: 2}
+	for i := 0; i < 2; i++ { // Replacing a row does not count it twice
+		if err := store.StoreSymbols([]*types.Symbol{symbol}); err != nil {
+			t.Fatal(err)
+		}
+	}
+	if err := store.DeleteChunksByFile("f1.go"); err != nil {
+		t.Fatal(err)
+	}
+
+	stats, err := store.GetStats()
+	if err != nil {
+		t.Fatal(err)
+	}
+	if stats.TotalChunks != 4 || stats.IndexedFiles != 2 || stats.TotalSymbols != 1 {
+		t.Errorf("stats = %+v, want 4 chunks in 2 files and 1 symbol", stats)
+	}
+
+	for i, category := range []types.MemoryCategory{types.MemoryCategoryDecision, types.MemoryCategoryFact, types.MemoryCategoryFact} {
+		err := store.StoreMemory(&types.MemoryEntry{
+			ID: fmt.Sprintf("mem_%d", i), Content: "memory", Category: category,
+			Channel: "main", CreatedAt: now, UpdatedAt: now,
+		})
+		if err != nil {
+			t.Fatal(err)
+		}
+	}
+	memStats, err := store.GetMemoryStats("main")
+	if err != nil {
+		t.Fatal(err)
+	}
+	if memStats.TotalMemories != 3 || memStats.MemoriesByCategory[types.MemoryCategoryFact] != 2 {
+		t.Errorf("memory stats = %+v", memStats)
+	}
+
+	for i, status := range []types.TodoStatus{types.TodoStatusPending, types.TodoStatusPending, types.TodoStatusInProgress} {
+		err := store.StoreTodo(&types.TodoItem{
+			ID: fmt.Sprintf("todo_%d", i), Title: "todo", Status: status, Priority: types.TodoPriorityHigh,
+			Channel: "main", CreatedAt: now, UpdatedAt: now,
+		})
+		if err != nil {
+			t.Fatal(err)
+		}
+	}
+	if err := store.CompleteTodo("todo_0"); err != nil {
+		t.Fatal(err)
+	}
+	todoStats, err := store.GetTodoStats("")
+	if err != nil {
+		t.Fatal(err)
+	}
+	if todoStats.TotalTodos != 3 || todoStats.TodosByStatus[types.TodoStatusCompleted] != 1 ||
+		todoStats.TodosByStatus[types.TodoStatusPending] != 1 || todoStats.TodosByChannel["main"] != 3 {
+		t.Errorf("todo stats = %+v", todoStats)
+	}
+
+	// The maintained counters match a recount
+	snapshot := func() map[string]int64 {
+		rows, err := store.db.Query("SELECT counter || '/' || k1 || '/' || k2, n FROM stat_counts WHERE n != 0")
+		if err != nil {
+			t.Fatal(err)
+		}
+		defer rows.Close()
+		counts := make(map[string]int64)
+		for rows.Next() {
+			var key string
+			var n int64
+			if err := rows.Scan(&key, &n); err != nil {
+				t.Fatal(err)
+			}
+			counts[key] = n
+		}
+		return counts
+	}
+	maintained := snapshot()
+	err = store.write(writeBulk, func(tx *sql.Tx) error {
+		return recountStats(tx, nil)
+	})
+	if err != nil {
+		t.Fatal(err)
+	}
+	recounted := snapshot()
+	if fmt.Sprint(maintained) != fmt.Sprint(recounted) {
+		t.Errorf("maintained counters %v, recounted %v", maintained, recounted)
+	}
+}
@@ -12,16 +12,18 @@ import (
 	"math"
 	"os"
 	"path/filepath"
+	"regexp"
 	"sort"
+	"strconv"
 	"strings"
 	"sync"
+	"sync/atomic"
 	"time"
 
 	"github.com/spetr/mcp-codewizard/pkg/provider"
 	"github.com/spetr/mcp-codewizard/pkg/types"
 
 	sqlite_vec "github.com/asg017/sqlite-vec-go-bindings/cgo"
-	_ "github.com/mattn/go-sqlite3"
 )
 
 var (
@@ -39,12 +41,54 @@ type Store struct {
 	dimensions     int
 	enableFTS      bool
 	vectorTableSQL string
+
+	// Connection tuning and prepared read statements (conn.go)
+	config Config
+	stmts  stmtCache
+
+	// Decompressed chunk bodies (chunk_content.go)
+	contents contentCache
+
+	// Buffered memory access statistics, see access_stats.go
+	accessMu      sync.Mutex
+	accessPending map[string]memoryAccess
+	accessTimer   *time.Timer
+	accessFlushMu sync.Mutex
+
+	// Scheduled FTS segment merging (fts_maintenance.go)
+	ftsMu     sync.Mutex
+	ftsTimer  *time.Timer
+	ftsPassMu sync.Mutex
+
+	// Memory confidence half-life in seconds, 0 = no decay (confidence.go)
+	confidenceHalfLife atomic.Int64
+
+	// Background startup work, waited for by Close
+	background sync.WaitGroup
+
+	// Database files by subsystem, with the writer all writes to their
+	// tables go through after Init (databases.go, writer.go). Without split
+	// files, all entries are the same.
+	dbs [numSubsystems]*database
 }
 
-// New creates a new sqlite-vec store.
+// New creates a new sqlite-vec store with automatic connection tuning and
+// uncompressed chunk bodies.
 func New() *Store {
+	return NewWithConfig(Config{})
+}
+
+// NewWithConfig creates a new sqlite-vec store with the given connection
+// tuning.
+func NewWithConfig(cfg Config) *Store {
+	cacheMB := cfg.ContentCacheMB
+	if cacheMB <= 0 {
+		cacheMB = defaultContentCacheMB
+	}
 	return &Store{
 		enableFTS: true,
+		config:    cfg,
+		contents:  contentCache{maxBytes: cacheMB * mb},
 	}
 }
 
@@ -69,12 +113,23 @@ func (s *Store) Init(path string) error {
 		return fmt.Errorf("failed to create directory: %w", err)
 	}
 
-	// Open database with sqlite-vec extension
-	// WAL mode for concurrent reads, busy_timeout to wait for locks instead of failing immediately
-	db, err := sql.Open("sqlite3", path+"?_journal_mode=WAL&_synchronous=NORMAL&_busy_timeout=5000")
-	if err != nil {
-		return fmt.Errorf("failed to open database: %w", err)
+	var dbSize int64
+	if info, err := os.Stat(path); err == nil {
+		dbSize = info.Size()
 	}
+	settings := resolveSettings(s.config, dbSize, availableMemory())
+	slog.Debug("sqlite connection settings", "cache_kb", settings.cacheKB, "mmap_bytes", settings.mmapBytes,
+		"temp_store", settings.tempStore, "max_conns", settings.maxConns)
+
+	// Open database with sqlite-vec extension. Split subsystem files are
+	// attached to every connection.
+	split := s.config.SplitDatabases || splitExists(path)
+	s.dbs = newDatabases(path, split)
+	db := sql.OpenDB(newConnector(path+"?"+dsnOptions(!split), settings, s.attachments()))
+	// Idle connections are kept so their page cache and prepared statements
+	// survive between queries
+	db.SetMaxOpenConns(settings.maxConns)
+	db.SetMaxIdleConns(settings.maxConns)
 	s.db = db
 
 	// Enable sqlite-vec extension
@@ -82,44 +137,40 @@ func (s *Store) Init(path string) error {
 		return fmt.Errorf("sqlite-vec extension not available: %w", err)
 	}
 
-	// Create schema
-	if err := s.createSchema(); err != nil {
-		return fmt.Errorf("failed to create schema: %w", err)
-	}
-
-	// Create git history schema
-	if err := s.createGitHistorySchema(); err != nil {
-		return fmt.Errorf("failed to create git history schema: %w", err)
+	if err := s.setupSchema(settings); err != nil {
+		return err
 	}
 
-	// Create memory schema
-	if err := s.createMemorySchema(); err != nil {
-		return fmt.Errorf("failed to create memory schema: %w", err)
+	for _, d := range s.databases() {
+		d.writer = newWriter(db, s.writeLockStatement(d))
+		// Maintenance runs once the store has been idle after opening, too
+		s.noteWrite(d)
 	}
 
-	// Create todo schema
-	if err := s.createTodoSchema(); err != nil {
-		return fmt.Errorf("failed to create todo schema: %w", err)
+	if err := s.finishBulkLoad(); err != nil {
+		return fmt.Errorf("failed to finish interrupted bulk load: %w", err)
 	}
 
-	// Check FTS health and auto-repair if corrupted
-	if err := s.CheckFTSHealth(); err != nil {
-		slog.Warn("FTS index unhealthy, rebuilding", "error", err)
-		if rebuildErr := s.RebuildFTS(); rebuildErr != nil {
-			slog.Error("failed to rebuild FTS index", "error", rebuildErr)
-			// Continue anyway - search will work without FTS
-		} else {
-			slog.Info("FTS index rebuilt successfully")
-		}
-	}
+	// Check FTS health and auto-repair if corrupted, without holding up
+	// startup
+	s.background.Add(1)
+	go s.repairFTS()
 
 	return nil
 }
 
-// createSchema creates all necessary tables.
+// createSchema creates all necessary tables. Chunks, symbols and references
+// are keyed by integer rowids; their string IDs are kept in a unique key
+// column, and file paths are stored once in the files dictionary.
 func (s *Store) createSchema() error {
+	tx, err := s.db.Begin()
+	if err != nil {
+		return err
+	}
+	defer tx.Rollback()
+
 	// Metadata table
-	_, err := s.db.Exec(`
+	_, err = tx.Exec(`
 		CREATE TABLE IF NOT EXISTS metadata (
 			key TEXT PRIMARY KEY,
 			value TEXT NOT NULL
@@ -129,11 +180,36 @@ func (s *Store) createSchema() error {
 		return err
 	}
 
-	// Chunks table
-	_, err = s.db.Exec(`
+	// File path dictionary, shared by the index and git history tables
+	_, err = tx.Exec(`
+		CREATE TABLE IF NOT EXISTS files (
+			id INTEGER PRIMARY KEY,
+			path TEXT NOT NULL UNIQUE
+		)
+	`)
+	if err != nil {
+		return err
+	}
+
+	// Tables of databases keyed by strings are moved aside and copied over
+	// once the new tables exist
+	legacy, err := columnExists(tx, "chunks", "file_path")
+	if err != nil {
+		return err
+	}
+	if legacy {
+		if err := renameLegacyIndexTables(tx); err != nil {
+			return fmt.Errorf("failed to migrate index tables: %w", err)
+		}
+	}
+
+	// Chunks table. content is empty when the body is compressed in
+	// content_blob.
+	_, err = tx.Exec(`
 		CREATE TABLE IF NOT EXISTS chunks (
-			id TEXT PRIMARY KEY,
-			file_path TEXT NOT NULL,
+			id INTEGER PRIMARY KEY,
+			key TEXT NOT NULL UNIQUE,
+			file_id INTEGER NOT NULL REFERENCES files(id),
 			language TEXT NOT NULL,
 			content TEXT NOT NULL,
 			chunk_type TEXT NOT NULL,
@@ -142,28 +218,63 @@ func (s *Store) createSchema() error {
 			start_line INTEGER NOT NULL,
 			end_line INTEGER NOT NULL,
 			hash TEXT NOT NULL,
-			created_at DATETIME DEFAULT CURRENT_TIMESTAMP
+			created_at DATETIME DEFAULT CURRENT_TIMESTAMP,
+			content_blob BLOB
 		)
 	`)
 	if err != nil {
 		return err
 	}
 
-	// Index on file_path for deletion
-	_, err = s.db.Exec(`CREATE INDEX IF NOT EXISTS idx_chunks_file_path ON chunks(file_path)`)
+	// Databases created before chunk bodies were compressed
+	hasBlob, err := columnExists(tx, "chunks", "content_blob")
 	if err != nil {
 		return err
 	}
+	if !hasBlob {
+		if _, err := tx.Exec("ALTER TABLE chunks ADD COLUMN content_blob BLOB"); err != nil {
+			return fmt.Errorf("failed to add column chunks.content_blob: %w", err)
+		}
+	}
 
-	// FTS5 for BM25 search
+	// Index on file_id for deletion
+	_, err = tx.Exec(`CREATE INDEX IF NOT EXISTS idx_chunks_file ON chunks(file_id)`)
+	if err != nil {
+		return err
+	}
+
+	// FTS5 for BM25 search. The table is contentless: it keeps only the
+	// index, and the triggers supply the decompressed text. contentless_delete
+	// lets rows be deleted by rowid alone.
 	if s.enableFTS {
-		_, err = s.db.Exec(`
+		// FTS tables that read their text from chunks cannot index
+		// compressed bodies; they are replaced and refilled
+		var ftsSQL string
+		err := tx.QueryRow("SELECT sql FROM sqlite_master WHERE name = 'chunks_fts'").Scan(&ftsSQL)
+		if err != nil && err != sql.ErrNoRows {
+			return err
+		}
+		refill := strings.Contains(ftsSQL, "content='chunks'")
+		if refill {
+			for _, stmt := range []string{
+				"DROP TRIGGER IF EXISTS chunks_ai",
+				"DROP TRIGGER IF EXISTS chunks_ad",
+				"DROP TRIGGER IF EXISTS chunks_au",
+				"DROP TABLE chunks_fts",
+			} {
+				if _, err := tx.Exec(stmt); err != nil {
+					return err
+				}
+			}
+		}
+
+		_, err = tx.Exec(`
 			CREATE VIRTUAL TABLE IF NOT EXISTS chunks_fts USING fts5(
-				id,
+				key,
 				content,
 				name,
-				content='chunks',
-				content_rowid='rowid',
+				content='',
+				contentless_delete=1,
 				tokenize='porter unicode61'
 			)
 		`)
@@ -172,46 +283,51 @@ func (s *Store) createSchema() error {
 		}
 
 		// Triggers to keep FTS in sync
-		_, err = s.db.Exec(`
+		_, err = tx.Exec(`
 			CREATE TRIGGER IF NOT EXISTS chunks_ai AFTER INSERT ON chunks BEGIN
-				INSERT INTO chunks_fts(rowid, id, content, name)
-				VALUES (new.rowid, new.id, new.content, new.name);
+				INSERT INTO chunks_fts(rowid, key, content, name)
+				VALUES (new.id, new.key, chunk_text(new.content, new.content_blob), new.name);
 			END
 		`)
 		if err != nil {
 			return err
 		}
 
-		_, err = s.db.Exec(`
+		_, err = tx.Exec(`
 			CREATE TRIGGER IF NOT EXISTS chunks_ad AFTER DELETE ON chunks BEGIN
-				INSERT INTO chunks_fts(chunks_fts, rowid, id, content, name)
-				VALUES('delete', old.rowid, old.id, old.content, old.name);
+				DELETE FROM chunks_fts WHERE rowid = old.id;
 			END
 		`)
 		if err != nil {
 			return err
 		}
 
-		_, err = s.db.Exec(`
+		_, err = tx.Exec(`
 			CREATE TRIGGER IF NOT EXISTS chunks_au AFTER UPDATE ON chunks BEGIN
-				INSERT INTO chunks_fts(chunks_fts, rowid, id, content, name)
-				VALUES('delete', old.rowid, old.id, old.content, old.name);
-				INSERT INTO chunks_fts(rowid, id, content, name)
-				VALUES (new.rowid, new.id, new.content, new.name);
+				DELETE FROM chunks_fts WHERE rowid = old.id;
+				INSERT INTO chunks_fts(rowid, key, content, name)
+				VALUES (new.id, new.key, chunk_text(new.content, new.content_blob), new.name);
 			END
 		`)
 		if err != nil {
 			return err
 		}
+
+		if refill {
+			if err := fillChunksFTS(tx); err != nil {
+				return fmt.Errorf("failed to refill FTS index: %w", err)
+			}
+		}
 	}
 
 	// Symbols table
-	_, err = s.db.Exec(`
+	_, err = tx.Exec(`
 		CREATE TABLE IF NOT EXISTS symbols (
-			id TEXT PRIMARY KEY,
+			id INTEGER PRIMARY KEY,
+			key TEXT NOT NULL UNIQUE,
 			name TEXT NOT NULL,
 			kind TEXT NOT NULL,
-			file_path TEXT NOT NULL,
+			file_id INTEGER NOT NULL REFERENCES files(id),
 			start_line INTEGER NOT NULL,
 			end_line INTEGER NOT NULL,
 			line_count INTEGER NOT NULL DEFAULT 1,
@@ -224,31 +340,33 @@ func (s *Store) createSchema() error {
 		return err
 	}
 
-	_, err = s.db.Exec(`CREATE INDEX IF NOT EXISTS idx_symbols_name ON symbols(name)`)
+	_, err = tx.Exec(`CREATE INDEX IF NOT EXISTS idx_symbols_name ON symbols(name)`)
 	if err != nil {
 		return err
 	}
-	_, err = s.db.Exec(`CREATE INDEX IF NOT EXISTS idx_symbols_kind ON symbols(kind)`)
+	_, err = tx.Exec(`CREATE INDEX IF NOT EXISTS idx_symbols_kind ON symbols(kind)`)
 	if err != nil {
 		return err
 	}
-	_, err = s.db.Exec(`CREATE INDEX IF NOT EXISTS idx_symbols_file_path ON symbols(file_path)`)
+	_, err = tx.Exec(`CREATE INDEX IF NOT EXISTS idx_symbols_file ON symbols(file_id)`)
 	if err != nil {
 		return err
 	}
-	_, err = s.db.Exec(`CREATE INDEX IF NOT EXISTS idx_symbols_line_count ON symbols(line_count)`)
+	_, err = tx.Exec(`CREATE INDEX IF NOT EXISTS idx_symbols_line_count ON symbols(line_count)`)
 	if err != nil {
 		return err
 	}
 
-	// References table
-	_, err = s.db.Exec(`
+	// References table. from_symbol and to_symbol are names as written in
+	// the source rather than symbol keys, so they stay text.
+	_, err = tx.Exec(`
 		CREATE TABLE IF NOT EXISTS refs (
-			id TEXT PRIMARY KEY,
+			id INTEGER PRIMARY KEY,
+			key TEXT NOT NULL UNIQUE,
 			from_symbol TEXT NOT NULL,
 			to_symbol TEXT NOT NULL,
 			kind TEXT NOT NULL,
-			file_path TEXT NOT NULL,
+			file_id INTEGER NOT NULL REFERENCES files(id),
 			line INTEGER NOT NULL,
 			is_external BOOLEAN NOT NULL DEFAULT FALSE
 		)
@@ -257,19 +375,23 @@ func (s *Store) createSchema() error {
 		return err
 	}
 
-	_, err = s.db.Exec(`CREATE INDEX IF NOT EXISTS idx_refs_from ON refs(from_symbol)`)
+	_, err = tx.Exec(`CREATE INDEX IF NOT EXISTS idx_refs_from ON refs(from_symbol)`)
+	if err != nil {
+		return err
+	}
+	_, err = tx.Exec(`CREATE INDEX IF NOT EXISTS idx_refs_to ON refs(to_symbol)`)
 	if err != nil {
 		return err
 	}
-	_, err = s.db.Exec(`CREATE INDEX IF NOT EXISTS idx_refs_to ON refs(to_symbol)`)
+	_, err = tx.Exec(`CREATE INDEX IF NOT EXISTS idx_refs_file ON refs(file_id)`)
 	if err != nil {
 		return err
 	}
 
 	// File cache table for incremental indexing
-	_, err = s.db.Exec(`
+	_, err = tx.Exec(`
 		CREATE TABLE IF NOT EXISTS file_cache (
-			file_path TEXT PRIMARY KEY,
+			file_id INTEGER PRIMARY KEY REFERENCES files(id),
 			file_hash TEXT NOT NULL,
 			config_hash TEXT NOT NULL,
 			indexed_at DATETIME DEFAULT CURRENT_TIMESTAMP
@@ -279,37 +401,119 @@ func (s *Store) createSchema() error {
 		return err
 	}
 
+	if legacy {
+		if err := copyLegacyIndexTables(tx); err != nil {
+			return fmt.Errorf("failed to migrate index tables: %w", err)
+		}
+	}
+
+	return tx.Commit()
+}
+
+// addColumnIfMissing adds a column to an existing table. CREATE TABLE IF NOT
+// EXISTS leaves tables from older databases untouched, so new columns are
+// added here.
+func (s *Store) addColumnIfMissing(table, column, decl string) error {
+	exists, err := columnExists(s.db, table, column)
+	if err != nil || exists {
+		return err
+	}
+
+	_, err = s.db.Exec(fmt.Sprintf("ALTER TABLE %s ADD COLUMN %s %s", table, column, decl))
+	if err != nil {
+		return fmt.Errorf("failed to add column %s.%s: %w", table, column, err)
+	}
 	return nil
 }
 
+// columnExists reports whether table has the given column. It is false for
+// tables that do not exist.
+func columnExists(q rowQuerier, table, column string) (bool, error) {
+	var n int
+	err := q.QueryRow("SELECT COUNT(*) FROM pragma_table_info(?) WHERE name = ?", table, column).Scan(&n)
+	if err != nil {
+		return false, fmt.Errorf("failed to read columns of %s: %w", table, err)
+	}
+	return n > 0, nil
+}
+
 // createVectorTable creates the vector table with the specified dimensions.
 func (s *Store) createVectorTable(dimensions int) error {
 	if s.dimensions == dimensions {
 		return nil // Already created
 	}
 
-	s.dimensions = dimensions
+	err := s.write(writeBulk, func(tx *sql.Tx) error {
+		// Drop existing vector table if dimensions changed
+		_, _ = tx.Exec("DROP TABLE IF EXISTS chunk_embeddings")
+		return createChunkEmbeddingsTable(tx, dimensions)
+	})
+	if err != nil {
+		return fmt.Errorf("failed to create vector table: %w", err)
+	}
 
-	// Drop existing vector table if dimensions changed
-	_, _ = s.db.Exec("DROP TABLE IF EXISTS chunk_embeddings")
+	s.dimensions = dimensions
+	return nil
+}
 
-	// Create vector table using sqlite-vec
-	_, err := s.db.Exec(fmt.Sprintf(`
+// createChunkEmbeddingsTable creates the vector table for chunk embeddings.
+// Rows are keyed by the rowid of their chunk.
+func createChunkEmbeddingsTable(tx *sql.Tx, dimensions int) error {
+	_, err := tx.Exec(fmt.Sprintf(`
 		CREATE VIRTUAL TABLE IF NOT EXISTS chunk_embeddings USING vec0(
-			chunk_id TEXT PRIMARY KEY,
 			embedding float[%d]
 		)
 	`, dimensions))
+	return err
+}
+
+var vectorDimensionsRe = regexp.MustCompile(`float\[(\d+)\]`)
+
+// vectorTableDimensions returns the dimensions of an existing vector table,
+// 0 if it does not exist.
+func vectorTableDimensions(q rowQuerier, table string) (int, error) {
+	var ddl string
+	err := q.QueryRow("SELECT sql FROM sqlite_master WHERE name = ?", table).Scan(&ddl)
+	if err == sql.ErrNoRows {
+		return 0, nil
+	}
 	if err != nil {
-		return fmt.Errorf("failed to create vector table: %w", err)
+		return 0, err
 	}
+	m := vectorDimensionsRe.FindStringSubmatch(ddl)
+	if m == nil {
+		return 0, nil
+	}
+	return strconv.Atoi(m[1])
+}
 
+// loadVectorDimensions picks up the dimensions of the chunk vector table, so
+// the first StoreChunks after opening an index does not recreate it.
+func (s *Store) loadVectorDimensions() error {
+	dimensions, err := vectorTableDimensions(s.db, "chunk_embeddings")
+	if err != nil {
+		return fmt.Errorf("failed to read vector table dimensions: %w", err)
+	}
+	s.dimensions = dimensions
 	return nil
 }
 
 // Close releases resources and closes connections.
 func (s *Store) Close() error {
 	if s.db != nil {
+		s.background.Wait()
+		s.stopAccessFlush()
+		s.stopFTSMaintenance()
+		s.stopMaintenance()
+		if err := s.FlushMemoryAccess(); err != nil {
+			slog.Warn("failed to flush memory access stats", "error", err)
+		}
+		for _, d := range s.databases() {
+			if d.writer != nil {
+				d.writer.close()
+			}
+		}
+		s.stmts.close()
 		return s.db.Close()
 	}
 	return nil
@@ -328,71 +532,102 @@ func (s *Store) StoreChunks(chunks []*types.ChunkWithEmbedding) error {
 		}
 	}
 
-	tx, err := s.db.Begin()
-	if err != nil {
-		return err
-	}
-	defer tx.Rollback()
-
-	// Prepare statements
-	chunkStmt, err := tx.Prepare(`
-		INSERT OR REPLACE INTO chunks
-		(id, file_path, language, content, chunk_type, name, parent_name, start_line, end_line, hash)
-		VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?, ?)
-	`)
-	if err != nil {
-		return err
-	}
-	defer chunkStmt.Close()
-
-	embeddingStmt, err := tx.Prepare(`
-		INSERT OR REPLACE INTO chunk_embeddings (chunk_id, embedding)
-		VALUES (?, ?)
-	`)
-	if err != nil {
-		return err
-	}
-	defer embeddingStmt.Close()
+	err := s.write(writeBulk, func(tx *sql.Tx) error {
+		// Prepare statements. Existing chunks are updated in place so their
+		// rowid, which keys the FTS and vector rows, stays the same.
+		chunkStmt, err := tx.Prepare(`
+			INSERT INTO chunks
+			(key, file_id, language, content, content_blob, chunk_type, name, parent_name, start_line, end_line, hash)
+			VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?)
+			ON CONFLICT(key) DO UPDATE SET
+				file_id = excluded.file_id, language = excluded.language,
+				content = excluded.content, content_blob = excluded.content_blob,
+				chunk_type = excluded.chunk_type, name = excluded.name, parent_name = excluded.parent_name,
+				start_line = excluded.start_line, end_line = excluded.end_line, hash = excluded.hash
+			RETURNING id
+		`)
+		if err != nil {
+			return err
+		}
+		defer chunkStmt.Close()
 
-	for _, cwe := range chunks {
-		c := cwe.Chunk
+		deleteEmbeddingStmt, err := tx.Prepare("DELETE FROM chunk_embeddings WHERE rowid = ?")
+		if err != nil {
+			return err
+		}
+		defer deleteEmbeddingStmt.Close()
 
-		// Store chunk
-		_, err := chunkStmt.Exec(
-			c.ID, c.FilePath, c.Language, c.Content,
-			string(c.ChunkType), c.Name, c.ParentName,
-			c.StartLine, c.EndLine, c.Hash,
-		)
+		embeddingStmt, err := tx.Prepare(`
+			INSERT INTO chunk_embeddings (rowid, embedding)
+			VALUES (?, ?)
+		`)
 		if err != nil {
-			return fmt.Errorf("failed to store chunk %s: %w", c.ID, err)
+			return err
 		}
+		defer embeddingStmt.Close()
+
+		files := newFileIDs(tx)
+		for _, cwe := range chunks {
+			c := cwe.Chunk
 
-		// Store embedding
-		if len(cwe.Embedding) > 0 {
-			embBytes := floatsToBytes(cwe.Embedding)
-			_, err := embeddingStmt.Exec(c.ID, embBytes)
+			fileID, err := files.get(c.FilePath)
+			if err != nil {
+				return err
+			}
+			content, contentBlob, err := s.encodeContent(c.Content)
 			if err != nil {
-				return fmt.Errorf("failed to store embedding for %s: %w", c.ID, err)
+				return fmt.Errorf("failed to compress chunk %s: %w", c.ID, err)
+			}
+
+			// Store chunk
+			var rowID int64
+			err = chunkStmt.QueryRow(
+				c.ID, fileID, c.Language, content, contentBlob,
+				string(c.ChunkType), c.Name, c.ParentName,
+				c.StartLine, c.EndLine, c.Hash,
+			).Scan(&rowID)
+			if err != nil {
+				return fmt.Errorf("failed to store chunk %s: %w", c.ID, err)
+			}
+
+			// Store embedding
+			if len(cwe.Embedding) > 0 {
+				if _, err := deleteEmbeddingStmt.Exec(rowID); err != nil {
+					return fmt.Errorf("failed to replace embedding for %s: %w", c.ID, err)
+				}
+				embBytes := floatsToBytes(cwe.Embedding)
+				_, err := embeddingStmt.Exec(rowID, embBytes)
+				if err != nil {
+					return fmt.Errorf("failed to store embedding for %s: %w", c.ID, err)
+				}
 			}
 		}
-	}
 
-	return tx.Commit()
+		return nil
+	})
+	if err == nil {
+		s.scheduleFTSMaintenance()
+	}
+	return err
 }
 
 // GetChunk retrieves a chunk by ID.
 func (s *Store) GetChunk(id string) (*types.Chunk, error) {
-	row := s.db.QueryRow(`
-		SELECT id, file_path, language, content, chunk_type, name, parent_name, start_line, end_line, hash
-		FROM chunks WHERE id = ?
+	row := s.queryRow(`
+		SELECT c.id, c.key, f.path, c.language, c.content, c.content_blob, c.chunk_type, c.name, c.parent_name,
+		       c.start_line, c.end_line, c.hash
+		FROM chunks c JOIN files f ON f.id = c.file_id
+		WHERE c.key = ?
 	`, id)
 
 	var chunk types.Chunk
+	var rowID int64
+	var contentBlob []byte
 	var chunkType string
 	var name, parentName sql.NullString
 
 	err := row.Scan(
-		&chunk.ID, &chunk.FilePath, &chunk.Language, &chunk.Content,
+		&rowID, &chunk.ID, &chunk.FilePath, &chunk.Language, &chunk.Content, &contentBlob,
 		&chunkType, &name, &parentName, &chunk.StartLine, &chunk.EndLine, &chunk.Hash,
 	)
 	if err == sql.ErrNoRows {
@@ -401,6 +636,9 @@ func (s *Store) GetChunk(id string) (*types.Chunk, error) {
 	if err != nil {
 		return nil, err
 	}
+	if chunk.Content, err = s.chunkContent(rowID, chunk.Hash, chunk.Content, contentBlob); err != nil {
+		return nil, err
+	}
 
 	chunk.ChunkType = types.ChunkType(chunkType)
 	chunk.Name = name.String
@@ -409,57 +647,59 @@ func (s *Store) GetChunk(id string) (*types.Chunk, error) {
 	return &chunk, nil
 }
 
+// deleteFilesBatch bounds the files removed per write transaction, so that
+// interactive writes are not held up by a large bulk delete.
+const deleteFilesBatch = 500
+
 // DeleteChunksByFile removes all chunks for a file.
 func (s *Store) DeleteChunksByFile(filePath string) error {
-	tx, err := s.db.Begin()
-	if err != nil {
-		return err
-	}
-	defer tx.Rollback()
-
-	// Get chunk IDs first
-	rows, err := tx.Query("SELECT id FROM chunks WHERE file_path = ?", filePath)
-	if err != nil {
-		return err
-	}
+	return s.DeleteChunksByFiles([]string{filePath})
+}
 
-	var ids []string
-	for rows.Next() {
-		var id string
-		if err := rows.Scan(&id); err != nil {
-			rows.Close()
-			return err
-		}
-		ids = append(ids, id)
-	}
-	rows.Close()
+// DeleteChunksByFiles removes all chunks, symbols and references of the
+// files with set-based deletes.
+func (s *Store) DeleteChunksByFiles(filePaths []string) error {
+	for start := 0; start < len(filePaths); start += deleteFilesBatch {
+		batch := filePaths[start:min(start+deleteFilesBatch, len(filePaths))]
+		err := s.write(writeBulk, func(tx *sql.Tx) error {
+			files, err := collectIDs(tx, "deleted_files",
+				"SELECT id FROM files WHERE path IN (SELECT value FROM json_each(?))", jsonArray(batch))
+			if err != nil || files == 0 {
+				return err
+			}
+			chunks, err := collectIDs(tx, "deleted_chunks",
+				"SELECT id FROM chunks WHERE file_id IN (SELECT id FROM temp.deleted_files)")
+			if err != nil {
+				return err
+			}
 
-	// Delete embeddings
-	for _, id := range ids {
-		_, err := tx.Exec("DELETE FROM chunk_embeddings WHERE chunk_id = ?", id)
+			var stmts []string
+			if chunks > 0 {
+				// FTS rows are removed by the chunk delete trigger
+				stmts = append(stmts,
+					"DELETE FROM chunk_embeddings WHERE rowid IN (SELECT id FROM temp.deleted_chunks)",
+					"DELETE FROM chunks WHERE id IN (SELECT id FROM temp.deleted_chunks)",
+				)
+			}
+			stmts = append(stmts,
+				"DELETE FROM symbols WHERE file_id IN (SELECT id FROM temp.deleted_files)",
+				"DELETE FROM refs WHERE file_id IN (SELECT id FROM temp.deleted_files)",
+			)
+			for _, stmt := range stmts {
+				if _, err := tx.Exec(stmt); err != nil {
+					return err
+				}
+			}
+			return nil
+		})
 		if err != nil {
-			return err
+			return fmt.Errorf("failed to delete chunks: %w", err)
 		}
 	}
-
-	// Delete chunks (FTS will be updated by trigger)
-	_, err = tx.Exec("DELETE FROM chunks WHERE file_path = ?", filePath)
-	if err != nil {
-		return err
-	}
-
-	// Delete symbols and references for this file
-	_, err = tx.Exec("DELETE FROM symbols WHERE file_path = ?", filePath)
-	if err != nil {
-		return err
-	}
-
-	_, err = tx.Exec("DELETE FROM refs WHERE file_path = ?", filePath)
-	if err != nil {
-		return err
+	if len(filePaths) > 0 {
+		s.scheduleFTSMaintenance()
 	}
-
-	return tx.Commit()
+	return nil
 }
 
 // Search performs hybrid search (BM25 + vector).
@@ -492,12 +732,13 @@ func (s *Store) vectorSearch(ctx context.Context, req *types.SearchRequest) ([]*
 	// Vector similarity search using sqlite-vec
 	query := `
 		SELECT
-			ce.chunk_id,
+			c.id, c.key,
 			vec_distance_cosine(ce.embedding, ?) as distance,
-			c.file_path, c.language, c.content, c.chunk_type,
+			f.path, c.language, c.content, c.content_blob, c.chunk_type,
 			c.name, c.parent_name, c.start_line, c.end_line, c.hash
 		FROM chunk_embeddings ce
-		JOIN chunks c ON ce.chunk_id = c.id
+		JOIN chunks c ON c.id = ce.rowid
+		JOIN files f ON f.id = c.file_id
 	`
 
 	args := []any{embBytes}
@@ -530,7 +771,7 @@ func (s *Store) vectorSearch(ctx context.Context, req *types.SearchRequest) ([]*
 	query += " ORDER BY distance ASC LIMIT ?"
 	args = append(args, limit)
 
-	rows, err := s.db.QueryContext(ctx, query, args...)
+	rows, err := s.queryContext(ctx, query, args...)
 	if err != nil {
 		return nil, fmt.Errorf("vector search failed: %w", err)
 	}
@@ -539,20 +780,25 @@ func (s *Store) vectorSearch(ctx context.Context, req *types.SearchRequest) ([]*
 	var results []*types.SearchResult
 	for rows.Next() {
 		var (
-			chunkID   string
-			distance  float64
-			chunk     types.Chunk
-			chunkType string
+			rowID       int64
+			chunkID     string
+			distance    float64
+			chunk       types.Chunk
+			contentBlob []byte
+			chunkType   string
 		)
 
 		err := rows.Scan(
-			&chunkID, &distance,
-			&chunk.FilePath, &chunk.Language, &chunk.Content, &chunkType,
+			&rowID, &chunkID, &distance,
+			&chunk.FilePath, &chunk.Language, &chunk.Content, &contentBlob, &chunkType,
 			&chunk.Name, &chunk.ParentName, &chunk.StartLine, &chunk.EndLine, &chunk.Hash,
 		)
 		if err != nil {
 			return nil, err
 		}
+		if chunk.Content, err = s.chunkContent(rowID, chunk.Hash, chunk.Content, contentBlob); err != nil {
+			return nil, err
+		}
 
 		chunk.ID = chunkID
 		chunk.ChunkType = types.ChunkType(chunkType)
@@ -584,11 +830,12 @@ func (s *Store) bm25Search(ctx context.Context, req *types.SearchRequest) ([]*ty
 	// FTS5 BM25 search
 	query := `
 		SELECT
-			c.id, bm25(chunks_fts) as bm25_score,
-			c.file_path, c.language, c.content, c.chunk_type,
+			c.id, c.key, bm25(chunks_fts) as bm25_score,
+			f.path, c.language, c.content, c.content_blob, c.chunk_type,
 			c.name, c.parent_name, c.start_line, c.end_line, c.hash
 		FROM chunks_fts fts
-		JOIN chunks c ON fts.id = c.id
+		JOIN chunks c ON c.id = fts.rowid
+		JOIN files f ON f.id = c.file_id
 		WHERE chunks_fts MATCH ?
 	`
 
@@ -617,7 +864,7 @@ func (s *Store) bm25Search(ctx context.Context, req *types.SearchRequest) ([]*ty
 	query += " ORDER BY bm25_score LIMIT ?"
 	args = append(args, limit)
 
-	rows, err := s.db.QueryContext(ctx, query, args...)
+	rows, err := s.queryContext(ctx, query, args...)
 	if err != nil {
 		return nil, fmt.Errorf("BM25 search failed: %w", err)
 	}
@@ -626,20 +873,25 @@ func (s *Store) bm25Search(ctx context.Context, req *types.SearchRequest) ([]*ty
 	var results []*types.SearchResult
 	for rows.Next() {
 		var (
-			chunkID   string
-			bm25Score float64
-			chunk     types.Chunk
-			chunkType string
+			rowID       int64
+			chunkID     string
+			bm25Score   float64
+			chunk       types.Chunk
+			contentBlob []byte
+			chunkType   string
 		)
 
 		err := rows.Scan(
-			&chunkID, &bm25Score,
-			&chunk.FilePath, &chunk.Language, &chunk.Content, &chunkType,
+			&rowID, &chunkID, &bm25Score,
+			&chunk.FilePath, &chunk.Language, &chunk.Content, &contentBlob, &chunkType,
 			&chunk.Name, &chunk.ParentName, &chunk.StartLine, &chunk.EndLine, &chunk.Hash,
 		)
 		if err != nil {
 			return nil, err
 		}
+		if chunk.Content, err = s.chunkContent(rowID, chunk.Hash, chunk.Content, contentBlob); err != nil {
+			return nil, err
+		}
 
 		chunk.ID = chunkID
 		chunk.ChunkType = types.ChunkType(chunkType)
@@ -778,44 +1030,46 @@ func (s *Store) StoreSymbols(symbols []*types.Symbol) error {
 		return nil
 	}
 
-	tx, err := s.db.Begin()
-	if err != nil {
-		return err
-	}
-	defer tx.Rollback()
-
-	stmt, err := tx.Prepare(`
-		INSERT OR REPLACE INTO symbols
-		(id, name, kind, file_path, start_line, end_line, line_count, signature, visibility, doc_comment)
-		VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?, ?)
-	`)
-	if err != nil {
-		return err
-	}
-	defer stmt.Close()
-
-	for _, sym := range symbols {
-		lineCount := sym.LineCount
-		if lineCount == 0 {
-			lineCount = sym.ComputeLineCount()
-		}
-		_, err := stmt.Exec(
-			sym.ID, sym.Name, string(sym.Kind), sym.FilePath,
-			sym.StartLine, sym.EndLine, lineCount, sym.Signature, sym.Visibility, sym.DocComment,
-		)
+	return s.write(writeBulk, func(tx *sql.Tx) error {
+		stmt, err := tx.Prepare(`
+			INSERT OR REPLACE INTO symbols
+			(key, name, kind, file_id, start_line, end_line, line_count, signature, visibility, doc_comment)
+			VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?, ?)
+		`)
 		if err != nil {
-			return fmt.Errorf("failed to store symbol %s: %w", sym.ID, err)
+			return err
 		}
-	}
+		defer stmt.Close()
 
-	return tx.Commit()
+		files := newFileIDs(tx)
+		for _, sym := range symbols {
+			fileID, err := files.get(sym.FilePath)
+			if err != nil {
+				return err
+			}
+			lineCount := sym.LineCount
+			if lineCount == 0 {
+				lineCount = sym.ComputeLineCount()
+			}
+			_, err = stmt.Exec(
+				sym.ID, sym.Name, string(sym.Kind), fileID,
+				sym.StartLine, sym.EndLine, lineCount, sym.Signature, sym.Visibility, sym.DocComment,
+			)
+			if err != nil {
+				return fmt.Errorf("failed to store symbol %s: %w", sym.ID, err)
+			}
+		}
+
+		return nil
+	})
 }
 
 // GetSymbol retrieves a symbol by ID.
 func (s *Store) GetSymbol(id string) (*types.Symbol, error) {
-	row := s.db.QueryRow(`
-		SELECT id, name, kind, file_path, start_line, end_line, line_count, signature, visibility, doc_comment
-		FROM symbols WHERE id = ?
+	row := s.queryRow(`
+		SELECT s.key, s.name, s.kind, f.path, s.start_line, s.end_line, s.line_count, s.signature, s.visibility, s.doc_comment
+		FROM symbols s JOIN files f ON f.id = s.file_id
+		WHERE s.key = ?
 	`, id)
 
 	var sym types.Symbol
@@ -842,48 +1096,53 @@ func (s *Store) GetSymbol(id string) (*types.Symbol, error) {
 }
 
 // FindSymbols searches symbols by name pattern and kind.
-func (s *Store) FindSymbols(query string, kind types.SymbolKind, limit int) ([]*types.Symbol, error) {
-	return s.FindSymbolsAdvanced(query, kind, 0, "", limit)
+func (s *Store) FindSymbols(ctx context.Context, query string, kind types.SymbolKind, limit int) ([]*types.Symbol, error) {
+	return s.findSymbols(ctx, query, kind, 0, "", limit)
 }
 
 // FindSymbolsAdvanced searches symbols with additional filtering options.
 // minLines: minimum line count (0 = no filter)
 // sortBy: "lines" to sort by line_count descending, "name" for name ascending, "" for default
 func (s *Store) FindSymbolsAdvanced(query string, kind types.SymbolKind, minLines int, sortBy string, limit int) ([]*types.Symbol, error) {
+	return s.findSymbols(context.Background(), query, kind, minLines, sortBy, limit)
+}
+
+func (s *Store) findSymbols(ctx context.Context, query string, kind types.SymbolKind, minLines int, sortBy string, limit int) ([]*types.Symbol, error) {
 	sqlQuery := `
-		SELECT id, name, kind, file_path, start_line, end_line, line_count, signature, visibility, doc_comment
-		FROM symbols WHERE 1=1
+		SELECT s.key, s.name, s.kind, f.path, s.start_line, s.end_line, s.line_count, s.signature, s.visibility, s.doc_comment
+		FROM symbols s JOIN files f ON f.id = s.file_id
+		WHERE 1=1
 	`
 	args := []any{}
 
 	if query != "" {
-		sqlQuery += " AND name LIKE ?"
+		sqlQuery += " AND s.name LIKE ?"
 		args = append(args, "%"+query+"%")
 	}
 
 	if kind != "" {
-		sqlQuery += " AND kind = ?"
+		sqlQuery += " AND s.kind = ?"
 		args = append(args, string(kind))
 	}
 
 	if minLines > 0 {
-		sqlQuery += " AND line_count >= ?"
+		sqlQuery += " AND s.line_count >= ?"
 		args = append(args, minLines)
 	}
 
 	switch sortBy {
 	case "lines":
-		sqlQuery += " ORDER BY line_count DESC"
+		sqlQuery += " ORDER BY s.line_count DESC"
 	case "name":
-		sqlQuery += " ORDER BY name ASC"
+		sqlQuery += " ORDER BY s.name ASC"
 	default:
-		sqlQuery += " ORDER BY name ASC"
+		sqlQuery += " ORDER BY s.name ASC"
 	}
 
 	sqlQuery += " LIMIT ?"
 	args = append(args, limit)
 
-	rows, err := s.db.Query(sqlQuery, args...)
+	rows, err := s.queryContext(ctx, sqlQuery, args...)
 	if err != nil {
 		return nil, err
 	}
@@ -911,21 +1170,21 @@ func (s *Store) FindSymbolsAdvanced(query string, kind types.SymbolKind, minLine
 		symbols = append(symbols, &sym)
 	}
 
-	return symbols, nil
+	return symbols, rows.Err()
 }
 
 // FindLongFunctions returns functions sorted by line count (longest first).
 func (s *Store) FindLongFunctions(minLines int, limit int) ([]*types.Symbol, error) {
 	sqlQuery := `
-		SELECT id, name, kind, file_path, start_line, end_line, line_count, signature, visibility, doc_comment
-		FROM symbols
-		WHERE kind IN ('function', 'method')
-		AND line_count >= ?
-		ORDER BY line_count DESC
+		SELECT s.key, s.name, s.kind, f.path, s.start_line, s.end_line, s.line_count, s.signature, s.visibility, s.doc_comment
+		FROM symbols s JOIN files f ON f.id = s.file_id
+		WHERE s.kind IN ('function', 'method')
+		AND s.line_count >= ?
+		ORDER BY s.line_count DESC
 		LIMIT ?
 	`
 
-	rows, err := s.db.Query(sqlQuery, minLines, limit)
+	rows, err := s.query(sqlQuery, minLines, limit)
 	if err != nil {
 		return nil, err
 	}
@@ -962,33 +1221,34 @@ func (s *Store) StoreReferences(refs []*types.Reference) error {
 		return nil
 	}
 
-	tx, err := s.db.Begin()
-	if err != nil {
-		return err
-	}
-	defer tx.Rollback()
-
-	stmt, err := tx.Prepare(`
-		INSERT OR REPLACE INTO refs
-		(id, from_symbol, to_symbol, kind, file_path, line, is_external)
-		VALUES (?, ?, ?, ?, ?, ?, ?)
-	`)
-	if err != nil {
-		return err
-	}
-	defer stmt.Close()
-
-	for _, ref := range refs {
-		_, err := stmt.Exec(
-			ref.ID, ref.FromSymbol, ref.ToSymbol, string(ref.Kind),
-			ref.FilePath, ref.Line, ref.IsExternal,
-		)
+	return s.write(writeBulk, func(tx *sql.Tx) error {
+		stmt, err := tx.Prepare(`
+			INSERT OR REPLACE INTO refs
+			(key, from_symbol, to_symbol, kind, file_id, line, is_external)
+			VALUES (?, ?, ?, ?, ?, ?, ?)
+		`)
 		if err != nil {
-			return fmt.Errorf("failed to store reference %s: %w", ref.ID, err)
+			return err
 		}
-	}
+		defer stmt.Close()
 
-	return tx.Commit()
+		files := newFileIDs(tx)
+		for _, ref := range refs {
+			fileID, err := files.get(ref.FilePath)
+			if err != nil {
+				return err
+			}
+			_, err = stmt.Exec(
+				ref.ID, ref.FromSymbol, ref.ToSymbol, string(ref.Kind),
+				fileID, ref.Line, ref.IsExternal,
+			)
+			if err != nil {
+				return fmt.Errorf("failed to store reference %s: %w", ref.ID, err)
+			}
+		}
+
+		return nil
+	})
 }
 
 // GetCallers returns references TO a symbol.
@@ -1002,23 +1262,24 @@ func (s *Store) GetCallers(symbolID string, limit int) ([]*types.Reference, erro
 
 	// Build query with all possible matches
 	query := `
-		SELECT id, from_symbol, to_symbol, kind, file_path, line, is_external
-		FROM refs WHERE to_symbol = ? OR to_symbol = ?`
+		SELECT r.key, r.from_symbol, r.to_symbol, r.kind, f.path, r.line, r.is_external
+		FROM refs r JOIN files f ON f.id = r.file_id
+		WHERE r.to_symbol = ? OR r.to_symbol = ?`
 	args := []interface{}{symbolID, symbolName}
 
 	if qualifiedName != "" {
-		query += ` OR to_symbol = ?`
+		query += ` OR r.to_symbol = ?`
 		args = append(args, qualifiedName)
 	}
 
 	// Also match qualified references ending with .symbolName (e.g., "simple.DetectLanguage")
-	query += ` OR to_symbol LIKE ?`
+	query += ` OR r.to_symbol LIKE ?`
 	args = append(args, "%."+symbolName)
 
 	query += ` LIMIT ?`
 	args = append(args, limit)
 
-	rows, err := s.db.Query(query, args...)
+	rows, err := s.query(query, args...)
 	if err != nil {
 		return nil, err
 	}
@@ -1071,9 +1332,10 @@ func (s *Store) GetCallees(symbolID string, limit int) ([]*types.Reference, erro
 	// Extract the symbol name to match against refs.
 	symbolName := extractSymbolName(symbolID)
 
-	rows, err := s.db.Query(`
-		SELECT id, from_symbol, to_symbol, kind, file_path, line, is_external
-		FROM refs WHERE from_symbol = ? OR from_symbol = ? LIMIT ?
+	rows, err := s.query(`
+		SELECT r.key, r.from_symbol, r.to_symbol, r.kind, f.path, r.line, r.is_external
+		FROM refs r JOIN files f ON f.id = r.file_id
+		WHERE r.from_symbol = ? OR r.from_symbol = ? LIMIT ?
 	`, symbolID, symbolName, limit)
 	if err != nil {
 		return nil, err
@@ -1084,10 +1346,11 @@ func (s *Store) GetCallees(symbolID string, limit int) ([]*types.Reference, erro
 }
 
 // FindReferencesByKind returns all references of a specific kind.
-func (s *Store) FindReferencesByKind(kind types.RefKind, limit int) ([]*types.Reference, error) {
-	rows, err := s.db.Query(`
-		SELECT id, from_symbol, to_symbol, kind, file_path, line, is_external
-		FROM refs WHERE kind = ? LIMIT ?
+func (s *Store) FindReferencesByKind(ctx context.Context, kind types.RefKind, limit int) ([]*types.Reference, error) {
+	rows, err := s.queryContext(ctx, `
+		SELECT r.key, r.from_symbol, r.to_symbol, r.kind, f.path, r.line, r.is_external
+		FROM refs r JOIN files f ON f.id = r.file_id
+		WHERE r.kind = ? LIMIT ?
 	`, string(kind), limit)
 	if err != nil {
 		return nil, err
@@ -1098,10 +1361,11 @@ func (s *Store) FindReferencesByKind(kind types.RefKind, limit int) ([]*types.Re
 }
 
 // GetAllReferences returns all references for building call graphs.
-func (s *Store) GetAllReferences(limit int) ([]*types.Reference, error) {
-	rows, err := s.db.Query(`
-		SELECT id, from_symbol, to_symbol, kind, file_path, line, is_external
-		FROM refs WHERE is_external = 0 LIMIT ?
+func (s *Store) GetAllReferences(ctx context.Context, limit int) ([]*types.Reference, error) {
+	rows, err := s.queryContext(ctx, `
+		SELECT r.key, r.from_symbol, r.to_symbol, r.kind, f.path, r.line, r.is_external
+		FROM refs r JOIN files f ON f.id = r.file_id
+		WHERE r.is_external = 0 LIMIT ?
 	`, limit)
 	if err != nil {
 		return nil, err
@@ -1128,12 +1392,12 @@ func scanReferences(rows *sql.Rows) ([]*types.Reference, error) {
 		ref.Kind = types.RefKind(kind)
 		refs = append(refs, &ref)
 	}
-	return refs, nil
+	return refs, rows.Err()
 }
 
 // GetMetadata returns index metadata.
 func (s *Store) GetMetadata() (*types.IndexMetadata, error) {
-	row := s.db.QueryRow("SELECT value FROM metadata WHERE key = 'index_metadata'")
+	row := s.queryRow("SELECT value FROM metadata WHERE key = 'index_metadata'")
 
 	var jsonData string
 	err := row.Scan(&jsonData)
@@ -1159,43 +1423,44 @@ func (s *Store) SetMetadata(meta *types.IndexMetadata) error {
 		return err
 	}
 
-	_, err = s.db.Exec(`
-		INSERT OR REPLACE INTO metadata (key, value) VALUES ('index_metadata', ?)
-	`, string(jsonData))
-	return err
+	return s.write(writeBulk, func(tx *sql.Tx) error {
+		_, err := tx.Exec(`
+			INSERT OR REPLACE INTO metadata (key, value) VALUES ('index_metadata', ?)
+		`, string(jsonData))
+		return err
+	})
 }
 
 // GetStats returns store statistics.
 func (s *Store) GetStats() (*types.StoreStats, error) {
 	stats := &types.StoreStats{}
 
-	// Count chunks
-	row := s.db.QueryRow("SELECT COUNT(*) FROM chunks")
-	if err := row.Scan(&stats.TotalChunks); err != nil {
-		return nil, err
-	}
-
-	// Count symbols
-	row = s.db.QueryRow("SELECT COUNT(*) FROM symbols")
-	if err := row.Scan(&stats.TotalSymbols); err != nil {
-		return nil, err
-	}
-
-	// Count references
-	row = s.db.QueryRow("SELECT COUNT(*) FROM refs")
-	if err := row.Scan(&stats.TotalReferences); err != nil {
-		return nil, err
-	}
-
-	// Count unique files
-	row = s.db.QueryRow("SELECT COUNT(DISTINCT file_path) FROM chunks")
-	if err := row.Scan(&stats.IndexedFiles); err != nil {
+	// Totals are maintained by triggers (stat_counts.go)
+	counts, err := s.statCounts("chunks", "symbols", "refs", "indexed_files")
+	if err != nil {
 		return nil, err
 	}
+	stats.TotalChunks = int(counts["chunks"])
+	stats.TotalSymbols = int(counts["symbols"])
+	stats.TotalReferences = int(counts["refs"])
+	stats.IndexedFiles = int(counts["indexed_files"])
 
-	// Get DB file size
-	if info, err := os.Stat(s.path); err == nil {
-		stats.DBSizeBytes = info.Size()
+	// Sizes of all database files
+	for _, d := range s.databases() {
+		if info, err := os.Stat(d.path); err == nil {
+			stats.DBSizeBytes += info.Size()
+		}
+		storage, err := s.storageStats(d.schema)
+		if err != nil {
+			return nil, err
+		}
+		stats.PageSize = storage.pageSize
+		stats.PageCount += storage.pageCount
+		stats.FreePages += storage.freePages
+		stats.WALSizeBytes += walSize(d.path)
+		if last := d.lastMaintenance.Load(); last > 0 && time.Unix(last, 0).After(stats.LastMaintenance) {
+			stats.LastMaintenance = time.Unix(last, 0)
+		}
 	}
 
 	// Get last indexed time
@@ -1209,7 +1474,10 @@ func (s *Store) GetStats() (*types.StoreStats, error) {
 
 // GetFileHash returns the cached hash for a file.
 func (s *Store) GetFileHash(filePath string) (string, error) {
-	row := s.db.QueryRow("SELECT file_hash FROM file_cache WHERE file_path = ?", filePath)
+	row := s.queryRow(`
+		SELECT fc.file_hash FROM file_cache fc JOIN files f ON f.id = fc.file_id
+		WHERE f.path = ?
+	`, filePath)
 
 	var hash string
 	err := row.Scan(&hash)
@@ -1221,16 +1489,22 @@ func (s *Store) GetFileHash(filePath string) (string, error) {
 
 // SetFileHash stores the hash for a file.
 func (s *Store) SetFileHash(filePath, hash, configHash string) error {
-	_, err := s.db.Exec(`
-		INSERT OR REPLACE INTO file_cache (file_path, file_hash, config_hash, indexed_at)
-		VALUES (?, ?, ?, ?)
-	`, filePath, hash, configHash, time.Now())
-	return err
+	return s.write(writeBulk, func(tx *sql.Tx) error {
+		fileID, err := newFileIDs(tx).get(filePath)
+		if err != nil {
+			return err
+		}
+		_, err = tx.Exec(`
+			INSERT OR REPLACE INTO file_cache (file_id, file_hash, config_hash, indexed_at)
+			VALUES (?, ?, ?, ?)
+		`, fileID, hash, configHash, time.Now())
+		return err
+	})
 }
 
 // GetAllFileHashes returns all cached file hashes.
 func (s *Store) GetAllFileHashes() (map[string]string, error) {
-	rows, err := s.db.Query("SELECT file_path, file_hash FROM file_cache")
+	rows, err := s.db.Query("SELECT f.path, fc.file_hash FROM file_cache fc JOIN files f ON f.id = fc.file_id")
 	if err != nil {
 		return nil, err
 	}
@@ -1250,8 +1524,10 @@ func (s *Store) GetAllFileHashes() (map[string]string, error) {
 
 // DeleteFileCache removes file from cache.
 func (s *Store) DeleteFileCache(filePath string) error {
-	_, err := s.db.Exec("DELETE FROM file_cache WHERE file_path = ?", filePath)
-	return err
+	return s.write(writeBulk, func(tx *sql.Tx) error {
+		_, err := tx.Exec("DELETE FROM file_cache WHERE file_id = (SELECT id FROM files WHERE path = ?)", filePath)
+		return err
+	})
 }
 
 // Helper functions
@@ -1300,16 +1576,28 @@ func (s *Store) CheckFTSHealth() error {
 		return nil // FTS not created yet, will be created on first use
 	}
 
-	// Try a simple query that exercises the FTS JOIN
-	// This will fail if there are orphaned FTS entries
-	_, err = s.db.Exec(`
-		SELECT c.id FROM chunks_fts fts
-		JOIN chunks c ON fts.rowid = c.rowid
-		LIMIT 1
-	`)
+	// chunks_fts is contentless, so orphaned or missing entries do not make
+	// queries fail; compare the row count FTS5 keeps with the chunk counter
+	// in a single statement so both come from the same snapshot
+	var averages []byte
+	var chunks int64
+	err = s.db.QueryRow(`
+		SELECT (SELECT block FROM chunks_fts_data WHERE id = ?),
+		       (SELECT n FROM stat_counts WHERE counter = 'chunks' AND k1 = '' AND k2 = '')
+	`, ftsAveragesRowID).Scan(&averages, &chunks)
 	if err != nil {
 		return fmt.Errorf("FTS index corrupted: %w", err)
 	}
+	var indexed uint64
+	if len(averages) > 0 {
+		var n int
+		if indexed, n = getVarint(averages); n == 0 {
+			return errors.New("FTS index corrupted: malformed averages record")
+		}
+	}
+	if int64(indexed) != chunks {
+		return fmt.Errorf("FTS index out of sync: %d rows indexed, %d chunks", indexed, chunks)
+	}
 
 	return nil
 }
@@ -1321,7 +1609,12 @@ func (s *Store) RebuildFTS() error {
 		return nil
 	}
 
-	_, err := s.db.Exec(`INSERT INTO chunks_fts(chunks_fts) VALUES('rebuild')`)
+	err := s.write(writeBulk, func(tx *sql.Tx) error {
+		if _, err := tx.Exec(`INSERT INTO chunks_fts(chunks_fts) VALUES('delete-all')`); err != nil {
+			return err
+		}
+		return fillChunksFTS(tx)
+	})
 	if err != nil {
 		return fmt.Errorf("failed to rebuild FTS index: %w", err)
 	}
@@ -1329,5 +1622,15 @@ func (s *Store) RebuildFTS() error {
 	return nil
 }
 
+// fillChunksFTS indexes all chunks into an empty FTS table. Contentless
+// tables have no 'rebuild' command.
+func fillChunksFTS(tx *sql.Tx) error {
+	_, err := tx.Exec(`
+		INSERT INTO chunks_fts(rowid, key, content, name)
+		SELECT id, key, chunk_text(content, content_blob), name FROM chunks
+	`)
+	return err
+}
+
 // Ensure Store implements VectorStore interface
 var _ provider.VectorStore = (*Store)(nil)
@@ -0,0 +1,9 @@
+//go:build !linux
+
+package sqlitevec
+
+// availableMemory returns 0 (unknown); the connection settings then use
+// conservative limits.
+func availableMemory() int64 {
+	return 0
+}
@@ -0,0 +1,31 @@
+package sqlitevec
+
+import (
+	"database/sql"
+	"fmt"
+)
+
+// Bulk deletes collect the ids of the rows to remove in a temp table first,
+// then clear every table with one "WHERE ... IN (SELECT id FROM temp.<t>)"
+// statement, including the vec0 tables that otherwise took one statement
+// per row.
+
+// collectIDs replaces the contents of temp.<table> with the ids returned by
+// query and returns how many there are. Temp tables are per connection, so
+// it is created on first use; the id column has no type and keeps integer
+// and text ids as they are.
+func collectIDs(tx *sql.Tx, table, query string, args ...any) (int64, error) {
+	for _, stmt := range []string{
+		"CREATE TEMP TABLE IF NOT EXISTS " + table + " (id PRIMARY KEY)",
+		"DELETE FROM temp." + table,
+	} {
+		if _, err := tx.Exec(stmt); err != nil {
+			return 0, fmt.Errorf("failed to prepare %s: %w", table, err)
+		}
+	}
+	result, err := tx.Exec("INSERT OR IGNORE INTO temp."+table+" (id) "+query, args...)
+	if err != nil {
+		return 0, fmt.Errorf("failed to collect %s: %w", table, err)
+	}
+	return result.RowsAffected()
+}
@@ -114,13 +114,13 @@ func (s *Store) createTodoSchema() error {
 }
 
 // createTodoEmbeddingsTable creates vector table for todo embeddings.
-func (s *Store) createTodoEmbeddingsTable(dimensions int) error {
-	_, err := s.db.Exec(fmt.Sprintf(`
-		CREATE VIRTUAL TABLE IF NOT EXISTS todo_embeddings USING vec0(
+func createTodoEmbeddingsTable(tx *sql.Tx, schema string, dimensions int) error {
+	_, err := tx.Exec(fmt.Sprintf(`
+		CREATE VIRTUAL TABLE IF NOT EXISTS %s.todo_embeddings USING vec0(
 			todo_id TEXT PRIMARY KEY,
 			embedding float[%d]
 		)
-	`, dimensions))
+	`, schema, dimensions))
 	if err != nil {
 		return fmt.Errorf("failed to create todo_embeddings table: %w", err)
 	}
@@ -138,109 +138,105 @@ func (s *Store) StoreTodos(todos []*types.TodoItem) error {
 		return nil
 	}
 
-	// Create embedding table if we have embeddings
-	for _, t := range todos {
-		if len(t.Embedding) > 0 {
-			if err := s.createTodoEmbeddingsTable(len(t.Embedding)); err != nil {
-				return err
+	return s.writeTo(subsysMemory, writeInteractive, func(tx *sql.Tx) error {
+		// Create embedding table if we have embeddings
+		for _, t := range todos {
+			if len(t.Embedding) > 0 {
+				if err := createTodoEmbeddingsTable(tx, s.schema(subsysMemory), len(t.Embedding)); err != nil {
+					return err
+				}
+				break
 			}
-			break
 		}
-	}
-
-	tx, err := s.db.Begin()
-	if err != nil {
-		return err
-	}
-	defer tx.Rollback()
-
-	todoStmt, err := tx.Prepare(`
-		INSERT OR REPLACE INTO todos
-		(id, title, description, status, priority, tags, parent_id, channel,
-		 related_memories, related_chunks, related_commits, blocked_by,
-		 progress, effort, actual_effort, session_id,
-		 created_at, updated_at, due_date, started_at, completed_at)
-		VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?)
-	`)
-	if err != nil {
-		return err
-	}
-	defer todoStmt.Close()
-
-	embStmt, err := tx.Prepare(`
-		INSERT OR REPLACE INTO todo_embeddings (todo_id, embedding)
-		VALUES (?, ?)
-	`)
-	if err != nil {
-		embStmt = nil
-	} else {
-		defer embStmt.Close()
-	}
 
-	for _, t := range todos {
-		var tagsJSON, relMemJSON, relChunksJSON, relCommitsJSON, blockedByJSON string
-		var dueDate, startedAt, completedAt sql.NullInt64
-
-		if len(t.Tags) > 0 {
-			b, _ := json.Marshal(t.Tags)
-			tagsJSON = string(b)
-		}
-		if len(t.RelatedMemories) > 0 {
-			b, _ := json.Marshal(t.RelatedMemories)
-			relMemJSON = string(b)
-		}
-		if len(t.RelatedChunks) > 0 {
-			b, _ := json.Marshal(t.RelatedChunks)
-			relChunksJSON = string(b)
-		}
-		if len(t.RelatedCommits) > 0 {
-			b, _ := json.Marshal(t.RelatedCommits)
-			relCommitsJSON = string(b)
-		}
-		if len(t.BlockedBy) > 0 {
-			b, _ := json.Marshal(t.BlockedBy)
-			blockedByJSON = string(b)
-		}
-		if t.DueDate != nil {
-			dueDate.Int64 = t.DueDate.Unix()
-			dueDate.Valid = true
-		}
-		if t.StartedAt != nil {
-			startedAt.Int64 = t.StartedAt.Unix()
-			startedAt.Valid = true
-		}
-		if t.CompletedAt != nil {
-			completedAt.Int64 = t.CompletedAt.Unix()
-			completedAt.Valid = true
+		todoStmt, err := tx.Prepare(`
+			INSERT OR REPLACE INTO todos
+			(id, title, description, status, priority, tags, parent_id, channel,
+			 related_memories, related_chunks, related_commits, blocked_by,
+			 progress, effort, actual_effort, session_id,
+			 created_at, updated_at, due_date, started_at, completed_at)
+			VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?)
+		`)
+		if err != nil {
+			return err
 		}
+		defer todoStmt.Close()
 
-		_, err := todoStmt.Exec(
-			t.ID, t.Title, t.Description, string(t.Status), string(t.Priority),
-			tagsJSON, t.ParentID, t.Channel,
-			relMemJSON, relChunksJSON, relCommitsJSON, blockedByJSON,
-			t.Progress, t.Effort, t.ActualEffort, t.SessionID,
-			t.CreatedAt.Unix(), t.UpdatedAt.Unix(), dueDate, startedAt, completedAt,
-		)
+		embStmt, err := tx.Prepare(`
+			INSERT OR REPLACE INTO todo_embeddings (todo_id, embedding)
+			VALUES (?, ?)
+		`)
 		if err != nil {
-			return fmt.Errorf("failed to store todo %s: %w", t.ID, err)
+			embStmt = nil
+		} else {
+			defer embStmt.Close()
 		}
 
-		// Store embedding if present
-		if embStmt != nil && len(t.Embedding) > 0 {
-			embBytes := floatsToBytes(t.Embedding)
-			_, err := embStmt.Exec(t.ID, embBytes)
+		for _, t := range todos {
+			var tagsJSON, relMemJSON, relChunksJSON, relCommitsJSON, blockedByJSON string
+			var dueDate, startedAt, completedAt sql.NullInt64
+
+			if len(t.Tags) > 0 {
+				b, _ := json.Marshal(t.Tags)
+				tagsJSON = string(b)
+			}
+			if len(t.RelatedMemories) > 0 {
+				b, _ := json.Marshal(t.RelatedMemories)
+				relMemJSON = string(b)
+			}
+			if len(t.RelatedChunks) > 0 {
+				b, _ := json.Marshal(t.RelatedChunks)
+				relChunksJSON = string(b)
+			}
+			if len(t.RelatedCommits) > 0 {
+				b, _ := json.Marshal(t.RelatedCommits)
+				relCommitsJSON = string(b)
+			}
+			if len(t.BlockedBy) > 0 {
+				b, _ := json.Marshal(t.BlockedBy)
+				blockedByJSON = string(b)
+			}
+			if t.DueDate != nil {
+				dueDate.Int64 = t.DueDate.Unix()
+				dueDate.Valid = true
+			}
+			if t.StartedAt != nil {
+				startedAt.Int64 = t.StartedAt.Unix()
+				startedAt.Valid = true
+			}
+			if t.CompletedAt != nil {
+				completedAt.Int64 = t.CompletedAt.Unix()
+				completedAt.Valid = true
+			}
+
+			_, err := todoStmt.Exec(
+				t.ID, t.Title, t.Description, string(t.Status), string(t.Priority),
+				tagsJSON, t.ParentID, t.Channel,
+				relMemJSON, relChunksJSON, relCommitsJSON, blockedByJSON,
+				t.Progress, t.Effort, t.ActualEffort, t.SessionID,
+				t.CreatedAt.Unix(), t.UpdatedAt.Unix(), dueDate, startedAt, completedAt,
+			)
 			if err != nil {
-				return fmt.Errorf("failed to store embedding for todo %s: %w", t.ID, err)
+				return fmt.Errorf("failed to store todo %s: %w", t.ID, err)
+			}
+
+			// Store embedding if present
+			if embStmt != nil && len(t.Embedding) > 0 {
+				embBytes := floatsToBytes(t.Embedding)
+				_, err := embStmt.Exec(t.ID, embBytes)
+				if err != nil {
+					return fmt.Errorf("failed to store embedding for todo %s: %w", t.ID, err)
+				}
 			}
 		}
-	}
 
-	return tx.Commit()
+		return nil
+	})
 }
 
 // GetTodo retrieves a todo by ID.
 func (s *Store) GetTodo(id string) (*types.TodoItem, error) {
-	row := s.db.QueryRow(`
+	row := s.queryRow(`
 		SELECT id, title, description, status, priority, tags, parent_id, channel,
 		       related_memories, related_chunks, related_commits, blocked_by,
 		       progress, effort, actual_effort, session_id,
@@ -259,25 +255,21 @@ func (s *Store) UpdateTodo(todo *types.TodoItem) error {
 
 // DeleteTodo deletes a todo by ID.
 func (s *Store) DeleteTodo(id string) error {
-	tx, err := s.db.Begin()
-	if err != nil {
-		return err
-	}
-	defer tx.Rollback()
-
-	// Delete embedding
-	_, _ = tx.Exec("DELETE FROM todo_embeddings WHERE todo_id = ?", id)
+	return s.writeTo(subsysMemory, writeInteractive, func(tx *sql.Tx) error {
+		// Delete embedding
+		_, _ = tx.Exec("DELETE FROM todo_embeddings WHERE todo_id = ?", id)
 
-	// Delete todo (FTS will be updated by trigger)
-	_, err = tx.Exec("DELETE FROM todos WHERE id = ?", id)
-	if err != nil {
-		return err
-	}
+		// Delete todo (FTS will be updated by trigger)
+		_, err := tx.Exec("DELETE FROM todos WHERE id = ?", id)
+		if err != nil {
+			return err
+		}
 
-	// Also delete children
-	_, _ = tx.Exec("DELETE FROM todos WHERE parent_id = ?", id)
+		// Also delete children
+		_, _ = tx.Exec("DELETE FROM todos WHERE parent_id = ?", id)
 
-	return tx.Commit()
+		return nil
+	})
 }
 
 // UpdateTodoStatus updates just the status of a todo.
@@ -294,15 +286,16 @@ func (s *Store) UpdateTodoStatus(id string, status types.TodoStatus) error {
 		completedAt.Valid = true
 	}
 
-	_, err := s.db.Exec(`
-		UPDATE todos
-		SET status = ?, updated_at = ?,
-		    started_at = COALESCE(started_at, ?),
-		    completed_at = ?
-		WHERE id = ?
-	`, string(status), now, startedAt, completedAt, id)
-
-	return err
+	return s.writeTo(subsysMemory, writeInteractive, func(tx *sql.Tx) error {
+		_, err := tx.Exec(`
+			UPDATE todos
+			SET status = ?, updated_at = ?,
+			    started_at = COALESCE(started_at, ?),
+			    completed_at = ?
+			WHERE id = ?
+		`, string(status), now, startedAt, completedAt, id)
+		return err
+	})
 }
 
 // CompleteTodo marks a todo as completed.
@@ -317,41 +310,18 @@ func (s *Store) StartTodo(id string) error {
 
 // DeleteTodosByChannel deletes all todos in a channel.
 func (s *Store) DeleteTodosByChannel(channel string) error {
-	tx, err := s.db.Begin()
-	if err != nil {
-		return err
-	}
-	defer tx.Rollback()
-
-	// Get todo IDs first
-	rows, err := tx.Query("SELECT id FROM todos WHERE channel = ?", channel)
-	if err != nil {
-		return err
-	}
-
-	var ids []string
-	for rows.Next() {
-		var id string
-		if err := rows.Scan(&id); err != nil {
-			rows.Close()
+	return s.writeTo(subsysMemory, writeInteractive, func(tx *sql.Tx) error {
+		todos, err := collectIDs(tx, "deleted_todos", "SELECT id FROM todos WHERE channel = ?", channel)
+		if err != nil || todos == 0 {
 			return err
 		}
-		ids = append(ids, id)
-	}
-	rows.Close()
 
-	// Delete embeddings
-	for _, id := range ids {
-		_, _ = tx.Exec("DELETE FROM todo_embeddings WHERE todo_id = ?", id)
-	}
+		// The embeddings table only exists once a todo has been embedded
+		_, _ = tx.Exec("DELETE FROM todo_embeddings WHERE todo_id IN (SELECT id FROM temp.deleted_todos)")
 
-	// Delete todos
-	_, err = tx.Exec("DELETE FROM todos WHERE channel = ?", channel)
-	if err != nil {
+		_, err = tx.Exec("DELETE FROM todos WHERE id IN (SELECT id FROM temp.deleted_todos)")
 		return err
-	}
-
-	return tx.Commit()
+	})
 }
 
 // GetTodoChildren returns children of a todo.
@@ -374,10 +344,12 @@ func (s *Store) GetTodoChildren(parentID string) ([]*types.TodoItem, error) {
 
 // MoveTodo moves a todo to a new parent.
 func (s *Store) MoveTodo(id string, newParentID string) error {
-	_, err := s.db.Exec(`
-		UPDATE todos SET parent_id = ?, updated_at = ? WHERE id = ?
-	`, newParentID, time.Now().Unix(), id)
-	return err
+	return s.writeTo(subsysMemory, writeInteractive, func(tx *sql.Tx) error {
+		_, err := tx.Exec(`
+			UPDATE todos SET parent_id = ?, updated_at = ? WHERE id = ?
+		`, newParentID, time.Now().Unix(), id)
+		return err
+	})
 }
 
 // SearchTodos performs hybrid search on todos.
@@ -500,7 +472,7 @@ func (s *Store) vectorSearchTodos(ctx context.Context, queryVec []float32, limit
 	query += " ORDER BY distance ASC LIMIT ?"
 	args = append(args, limit)
 
-	rows, err := s.db.QueryContext(ctx, query, args...)
+	rows, err := s.queryContext(ctx, query, args...)
 	if err != nil {
 		return nil, err
 	}
@@ -546,7 +518,7 @@ func (s *Store) bm25SearchTodos(ctx context.Context, query string, limit int, re
 	sqlQuery += " ORDER BY score LIMIT ?"
 	args = append(args, limit)
 
-	rows, err := s.db.QueryContext(ctx, sqlQuery, args...)
+	rows, err := s.queryContext(ctx, sqlQuery, args...)
 	if err != nil {
 		return nil, err
 	}
@@ -673,7 +645,7 @@ func (s *Store) ListTodos(ctx context.Context, channel string, statuses []types.
 	query += " LIMIT ?"
 	args = append(args, limit)
 
-	rows, err := s.db.QueryContext(ctx, query, args...)
+	rows, err := s.queryContext(ctx, query, args...)
 	if err != nil {
 		return nil, err
 	}
@@ -775,61 +747,38 @@ func (s *Store) GetTodoStats(channel string) (*types.TodoStats, error) {
 		TodosByChannel:  make(map[string]int),
 	}
 
-	whereClause := ""
-	args := []any{}
-	if channel != "" {
-		whereClause = " WHERE channel = ?"
-		args = append(args, channel)
+	// Counts are maintained by triggers (stat_counts.go)
+	byStatus, err := s.groupedCounts("todo_status", "k2", channel)
+	if err != nil {
+		return nil, err
 	}
-
-	// Total todos
-	row := s.db.QueryRow("SELECT COUNT(*) FROM todos"+whereClause, args...)
-	row.Scan(&stats.TotalTodos)
-
-	// By status
-	rows, err := s.db.Query("SELECT status, COUNT(*) FROM todos"+whereClause+" GROUP BY status", args...)
-	if err == nil {
-		defer rows.Close()
-		for rows.Next() {
-			var status string
-			var count int
-			if rows.Scan(&status, &count) == nil {
-				stats.TodosByStatus[types.TodoStatus(status)] = count
-			}
-		}
+	for status, count := range byStatus {
+		stats.TodosByStatus[types.TodoStatus(status)] = count
+		stats.TotalTodos += count
 	}
 
-	// By priority
-	rows, err = s.db.Query("SELECT priority, COUNT(*) FROM todos"+whereClause+" GROUP BY priority", args...)
-	if err == nil {
-		defer rows.Close()
-		for rows.Next() {
-			var priority string
-			var count int
-			if rows.Scan(&priority, &count) == nil {
-				stats.TodosByPriority[types.TodoPriority(priority)] = count
-			}
-		}
+	byPriority, err := s.groupedCounts("todo_priority", "k2", channel)
+	if err != nil {
+		return nil, err
+	}
+	for priority, count := range byPriority {
+		stats.TodosByPriority[types.TodoPriority(priority)] = count
 	}
 
 	// By channel (only if not filtering)
 	if channel == "" {
-		rows, err := s.db.Query("SELECT channel, COUNT(*) FROM todos GROUP BY channel")
-		if err == nil {
-			defer rows.Close()
-			for rows.Next() {
-				var ch string
-				var count int
-				if rows.Scan(&ch, &count) == nil {
-					stats.TodosByChannel[ch] = count
-				}
-			}
+		byChannel, err := s.groupedCounts("todo_status", "k1", "")
+		if err != nil {
+			return nil, err
+		}
+		for ch, count := range byChannel {
+			stats.TodosByChannel[ch] = count
 		}
 	}
 
 	// Overdue count
 	now := time.Now().Unix()
-	row = s.db.QueryRow("SELECT COUNT(*) FROM todos WHERE due_date < ? AND status NOT IN ('completed', 'cancelled')"+
+	row := s.db.QueryRow("SELECT COUNT(*) FROM todos WHERE due_date < ? AND status NOT IN ('completed', 'cancelled')"+
 		func() string {
 			if channel != "" {
 				return " AND channel = ?"
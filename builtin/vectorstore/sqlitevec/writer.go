@@ -0,0 +1,305 @@
+package sqlitevec
+
+import (
+	"context"
+	"database/sql"
+	"errors"
+	"fmt"
+	"sync"
+)
+
+// All writes after Init go through a single writer goroutine, instead of
+// every method opening its own transaction and waiting out the others on
+// busy_timeout. The writer group-commits: it runs every queued operation it
+// can take in one transaction, each inside a savepoint so a failing
+// operation is rolled back without affecting the others. Interactive writes
+// are taken before bulk indexing writes.
+//
+// Operations run on the writer goroutine and must not submit writes
+// themselves.
+
+// writePriority orders queued writes.
+type writePriority int
+
+const (
+	writeInteractive writePriority = iota // Memories, todos: a tool call is waiting
+	writeBulk                             // Indexing, git history, bookkeeping
+)
+
+const (
+	// writeQueueSize is the capacity of each priority queue; submitters
+	// block while it is full.
+	writeQueueSize = 256
+
+	// maxBatchOps caps the operations committed in one transaction.
+	maxBatchOps = 128
+
+	// maxBulkBatchOps caps the bulk operations in one transaction, so an
+	// interactive write queued behind a batch waits for little indexing.
+	maxBulkBatchOps = 8
+)
+
+var errStoreClosed = errors.New("store is closed")
+
+// writeOp is a queued write.
+type writeOp struct {
+	fn   func(tx *sql.Tx) error
+	conn func(conn *sql.Conn) error // Instead of fn: runs outside a transaction
+	done chan error                 // Buffered; receives the result once committed
+}
+
+// writer owns all write transactions of a store.
+type writer struct {
+	db     *sql.DB
+	lock   string           // Run first in each transaction, if set (writeLockStatement)
+	queues [2]chan *writeOp // Indexed by writePriority
+
+	mu      sync.RWMutex // Guards closed against sends on closed queues
+	closed  bool
+	stopped chan struct{}
+}
+
+func newWriter(db *sql.DB, lock string) *writer {
+	w := &writer{
+		db:      db,
+		lock:    lock,
+		stopped: make(chan struct{}),
+	}
+	for i := range w.queues {
+		w.queues[i] = make(chan *writeOp, writeQueueSize)
+	}
+	go w.run()
+	return w
+}
+
+// submit queues fn and returns a future that receives its result after the
+// transaction it ran in has committed.
+func (w *writer) submit(prio writePriority, fn func(tx *sql.Tx) error) <-chan error {
+	return w.enqueue(prio, &writeOp{fn: fn, done: make(chan error, 1)})
+}
+
+// submitConn queues fn to run on a connection of its own, between
+// transactions, for statements that cannot run inside one (VACUUM,
+// wal_checkpoint).
+func (w *writer) submitConn(prio writePriority, fn func(conn *sql.Conn) error) <-chan error {
+	return w.enqueue(prio, &writeOp{conn: fn, done: make(chan error, 1)})
+}
+
+func (w *writer) enqueue(prio writePriority, op *writeOp) <-chan error {
+	w.mu.RLock()
+	defer w.mu.RUnlock()
+	if w.closed {
+		op.done <- errStoreClosed
+		return op.done
+	}
+	w.queues[prio] <- op
+	return op.done
+}
+
+// close stops accepting writes and waits until the queued ones are done.
+func (w *writer) close() {
+	w.mu.Lock()
+	if !w.closed {
+		w.closed = true
+		for _, q := range w.queues {
+			close(q)
+		}
+	}
+	w.mu.Unlock()
+	<-w.stopped
+}
+
+func (w *writer) run() {
+	defer close(w.stopped)
+
+	interactive, bulk := w.queues[writeInteractive], w.queues[writeBulk]
+	for interactive != nil || bulk != nil {
+		var op *writeOp
+		var ok, isBulk bool
+
+		// Interactive writes first; otherwise wait for either
+		select {
+		case op, ok = <-interactive:
+		default:
+			select {
+			case op, ok = <-interactive:
+			case op, ok = <-bulk:
+				isBulk = true
+			}
+		}
+		if !ok {
+			if isBulk {
+				bulk = nil
+			} else {
+				interactive = nil
+			}
+			continue
+		}
+
+		batch := []*writeOp{op}
+		bulkOps := 0
+		if isBulk {
+			bulkOps = 1
+		}
+	gather:
+		for len(batch) < maxBatchOps {
+			select {
+			case op, ok := <-interactive:
+				if !ok {
+					break gather
+				}
+				batch = append(batch, op)
+				continue
+			default:
+			}
+			if bulkOps >= maxBulkBatchOps {
+				break gather
+			}
+			select {
+			case op, ok := <-bulk:
+				if !ok {
+					break gather
+				}
+				batch = append(batch, op)
+				bulkOps++
+			default:
+				break gather
+			}
+		}
+
+		w.commit(batch)
+	}
+}
+
+// commit runs a batch and delivers the results. Transactional operations
+// are grouped into one transaction; connection operations run on their own.
+func (w *writer) commit(batch []*writeOp) {
+	for len(batch) > 0 {
+		n := 0
+		for n < len(batch) && batch[n].conn == nil {
+			n++
+		}
+		if n == 0 {
+			batch[0].done <- w.runConn(batch[0])
+			batch = batch[1:]
+			continue
+		}
+		w.commitTx(batch[:n])
+		batch = batch[n:]
+	}
+}
+
+// commitTx runs operations in one transaction and delivers the results.
+func (w *writer) commitTx(batch []*writeOp) {
+	results := make([]error, len(batch))
+	err := w.runBatch(batch, results)
+	for i, op := range batch {
+		if err != nil && results[i] == nil {
+			results[i] = err
+		}
+		op.done <- results[i]
+	}
+}
+
+// runBatch runs the operations of a batch, storing each one's error in
+// results. It returns an error if the transaction as a whole failed.
+func (w *writer) runBatch(batch []*writeOp, results []error) error {
+	tx, err := w.db.Begin()
+	if err != nil {
+		return fmt.Errorf("failed to begin transaction: %w", err)
+	}
+	defer tx.Rollback()
+	if w.lock != "" {
+		if _, err := tx.Exec(w.lock); err != nil {
+			return fmt.Errorf("failed to lock database: %w", err)
+		}
+	}
+
+	if len(batch) == 1 {
+		if results[0] = runWriteOp(batch[0], tx, nil); results[0] != nil {
+			return nil
+		}
+		return tx.Commit()
+	}
+
+	for i, op := range batch {
+		if _, err := tx.Exec("SAVEPOINT write_op"); err != nil {
+			return fmt.Errorf("failed to create savepoint: %w", err)
+		}
+		if results[i] = runWriteOp(op, tx, nil); results[i] != nil {
+			// SQLite rolls back the whole transaction on some errors, in
+			// which case the savepoint is gone as well
+			if _, err := tx.Exec("ROLLBACK TO write_op"); err != nil {
+				return fmt.Errorf("write batch aborted: %w", results[i])
+			}
+		}
+		if _, err := tx.Exec("RELEASE write_op"); err != nil {
+			return fmt.Errorf("failed to release savepoint: %w", err)
+		}
+	}
+
+	return tx.Commit()
+}
+
+// runConn runs a connection operation.
+func (w *writer) runConn(op *writeOp) error {
+	conn, err := w.db.Conn(context.Background())
+	if err != nil {
+		return fmt.Errorf("failed to get connection: %w", err)
+	}
+	defer conn.Close()
+	return runWriteOp(op, nil, conn)
+}
+
+// runWriteOp runs one operation, turning a panic into an error so it
+// cannot take the writer down.
+func runWriteOp(op *writeOp, tx *sql.Tx, conn *sql.Conn) (err error) {
+	defer func() {
+		if r := recover(); r != nil {
+			err = fmt.Errorf("write panicked: %v", r)
+		}
+	}()
+	if op.conn != nil {
+		return op.conn(conn)
+	}
+	return op.fn(tx)
+}
+
+// submitWrite queues a write to the index and returns its completion
+// future.
+func (s *Store) submitWrite(prio writePriority, fn func(tx *sql.Tx) error) <-chan error {
+	return s.submitWriteTo(subsysIndex, prio, fn)
+}
+
+// submitWriteTo queues a write to the tables of sub and returns its
+// completion future.
+func (s *Store) submitWriteTo(sub subsystem, prio writePriority, fn func(tx *sql.Tx) error) <-chan error {
+	d := s.dbs[sub]
+	if d == nil || d.writer == nil {
+		done := make(chan error, 1)
+		done <- errStoreClosed
+		return done
+	}
+	s.noteWrite(d)
+	return d.writer.submit(prio, fn)
+}
+
+// write runs fn on the index writer and waits until it has committed.
+func (s *Store) write(prio writePriority, fn func(tx *sql.Tx) error) error {
+	return <-s.submitWrite(prio, fn)
+}
+
+// writeTo runs fn on the writer of sub's tables and waits until it has
+// committed. fn must not write tables of other subsystems.
+func (s *Store) writeTo(sub subsystem, prio writePriority, fn func(tx *sql.Tx) error) error {
+	return <-s.submitWriteTo(sub, prio, fn)
+}
+
+// writeConn runs fn on the writer of d outside a transaction and waits for
+// it. Unlike write, it does not count as activity for idle maintenance.
+func (s *Store) writeConn(d *database, fn func(conn *sql.Conn) error) error {
+	if d.writer == nil {
+		return errStoreClosed
+	}
+	return <-d.writer.submitConn(writeBulk, fn)
+}
@@ -0,0 +1,176 @@
+package sqlitevec
+
+import (
+	"database/sql"
+	"errors"
+	"fmt"
+	"os"
+	"sync"
+	"testing"
+	"time"
+
+	"github.com/spetr/mcp-codewizard/pkg/types"
+)
+
+func newWriterTestStore(t *testing.T) *Store {
+	t.Helper()
+	tmpDir, err := os.MkdirTemp("", "writertest")
+	if err != nil {
+		t.Fatal(err)
+	}
+	t.Cleanup(func() { os.RemoveAll(tmpDir) })
+
+	store := New()
+	if err := store.Init(tmpDir + "/test.db"); err != nil {
+		if containsString(err.Error(), "fts5") || containsString(err.Error(), "FTS5") {
+			t.Skip("FTS5 not available in this environment")
+		}
+		t.Fatal(err)
+	}
+	t.Cleanup(func() { store.Close() })
+	return store
+}
+
+// blockWriter occupies the writer until the returned function is called,
+// so that writes submitted meanwhile are committed as one batch.
+func blockWriter(s *Store) func() {
+	started := make(chan struct{})
+	release := make(chan struct{})
+	s.submitWrite(writeBulk, func(tx *sql.Tx) error {
+		close(started)
+		<-release
+		return nil
+	})
+	<-started
+	return func() { close(release) }
+}
+
+func setMeta(key string) func(tx *sql.Tx) error {
+	return func(tx *sql.Tx) error {
+		_, err := tx.Exec("INSERT OR REPLACE INTO metadata (key, value) VALUES (?, 'x')", key)
+		return err
+	}
+}
+
+func TestWriterBatchIsolation(t *testing.T) {
+	store := newWriterTestStore(t)
+
+	release := blockWriter(store)
+	a := store.submitWrite(writeInteractive, setMeta("a"))
+	b := store.submitWrite(writeInteractive, func(tx *sql.Tx) error {
+		if err := setMeta("b")(tx); err != nil {
+			return err
+		}
+		return errors.New("fail after write")
+	})
+	c := store.submitWrite(writeInteractive, setMeta("c"))
+	release()
+
+	if err := <-a; err != nil {
+		t.Errorf("a: %v", err)
+	}
+	if err := <-b; err == nil {
+		t.Error("b: expected error")
+	}
+	if err := <-c; err != nil {
+		t.Errorf("c: %v", err)
+	}
+
+	for key, want := range map[string]int{"a": 1, "b": 0, "c": 1} {
+		var n int
+		if err := store.db.QueryRow("SELECT COUNT(*) FROM metadata WHERE key = ?", key).Scan(&n); err != nil {
+			t.Fatal(err)
+		}
+		if n != want {
+			t.Errorf("key %s: %d rows, want %d", key, n, want)
+		}
+	}
+}
+
+func TestWriterPriority(t *testing.T) {
+	store := newWriterTestStore(t)
+
+	var mu sync.Mutex
+	var order []string
+	record := func(name string) func(tx *sql.Tx) error {
+		return func(tx *sql.Tx) error {
+			mu.Lock()
+			order = append(order, name)
+			mu.Unlock()
+			return nil
+		}
+	}
+
+	release := blockWriter(store)
+	var futures []<-chan error
+	for i := 0; i < 3; i++ {
+		futures = append(futures, store.submitWrite(writeBulk, record(fmt.Sprintf("bulk%d", i))))
+	}
+	futures = append(futures, store.submitWrite(writeInteractive, record("interactive")))
+	release()
+
+	for _, f := range futures {
+		if err := <-f; err != nil {
+			t.Fatal(err)
+		}
+	}
+	if len(order) != 4 || order[0] != "interactive" {
+		t.Errorf("order = %v, want interactive first", order)
+	}
+}
+
+func TestWriterConcurrentWrites(t *testing.T) {
+	store := newWriterTestStore(t)
+
+	var wg sync.WaitGroup
+	errs := make(chan error, 64)
+	for g := 0; g < 8; g++ {
+		wg.Add(1)
+		go func(g int) {
+			defer wg.Done()
+			now := time.Now()
+			for i := 0; i < 8; i++ {
+				id := fmt.Sprintf("%d_%d", g, i)
+				if err := store.StoreMemory(&types.MemoryEntry{
+					ID: "mem_" + id, Content: "memory " + id, Category: types.MemoryCategoryNote,
+					Channel: "main", Confidence: 1, CreatedAt: now, UpdatedAt: now, AccessedAt: now,
+				}); err != nil {
+					errs <- err
+					return
+				}
+				if err := store.StoreTodo(&types.TodoItem{
+					ID: "todo_" + id, Title: "todo " + id, Status: types.TodoStatusPending,
+					Priority: types.TodoPriorityMedium, Channel: "main", CreatedAt: now, UpdatedAt: now,
+				}); err != nil {
+					errs <- err
+					return
+				}
+				if err := store.SetFileHash("file_"+id, "hash", "config"); err != nil {
+					errs <- err
+					return
+				}
+			}
+		}(g)
+	}
+	wg.Wait()
+	close(errs)
+	for err := range errs {
+		t.Error(err)
+	}
+
+	var memories, todos int
+	store.db.QueryRow("SELECT COUNT(*) FROM memories").Scan(&memories)
+	store.db.QueryRow("SELECT COUNT(*) FROM todos").Scan(&todos)
+	if memories != 64 || todos != 64 {
+		t.Errorf("stored %d memories and %d todos, want 64 each", memories, todos)
+	}
+}
+
+func TestWriterClosed(t *testing.T) {
+	store := newWriterTestStore(t)
+	store.Close()
+
+	if err := store.SetFileHash("file", "hash", "config"); !errors.Is(err, errStoreClosed) {
+		t.Errorf("write after Close: %v, want errStoreClosed", err)
+	}
+}
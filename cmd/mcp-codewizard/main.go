@@ -5,9 +5,11 @@ import (
 	"bufio"
 	"context"
 	"encoding/json"
+	"errors"
 	"fmt"
 	"log/slog"
 	"os"
+	"os/exec"
 	"os/signal"
 	"path/filepath"
 	"runtime"
@@ -91,11 +93,12 @@ var indexCmd = &cobra.Command{
 
 		dryRun, _ := cmd.Flags().GetBool("dry-run")
 		force, _ := cmd.Flags().GetBool("force")
+		revision, _ := cmd.Flags().GetString("revision")
 
 		if dryRun {
 			runDryRun(path)
 		} else {
-			runIndex(path, force)
+			runIndex(path, force, revision)
 		}
 	},
 }
@@ -126,9 +129,19 @@ var statusCmd = &cobra.Command{
 var serveCmd = &cobra.Command{
 	Use:   "serve",
 	Short: "Start MCP server",
+	Long: `Start the MCP server.
+
+Without --stdio the server runs as the project's shared daemon, serving MCP
+over a Unix socket (and optionally streamable HTTP on localhost) to any
+number of clients. With --stdio it proxies to that daemon, starting it in
+the background if needed; --no-daemon serves the session in-process.`,
 	Run: func(cmd *cobra.Command, args []string) {
-		stdio, _ := cmd.Flags().GetBool("stdio")
-		runServe(stdio)
+		var opts serveOptions
+		opts.stdio, _ = cmd.Flags().GetBool("stdio")
+		opts.noDaemon, _ = cmd.Flags().GetBool("no-daemon")
+		opts.httpAddr, _ = cmd.Flags().GetString("http")
+		opts.idleTimeout, _ = cmd.Flags().GetDuration("idle-timeout")
+		runServe(opts)
 	},
 }
 
@@ -407,6 +420,9 @@ var callCmd = &cobra.Command{
 	Short: "Call any MCP tool directly (for debugging)",
 	Long: `Call any MCP tool by name with JSON arguments.
 
+The call is forwarded to the project's running MCP daemon when there is
+one, and runs in-process otherwise.
+
 Examples:
   mcp-codewizard call get_callers '{"symbol": "main"}'
   mcp-codewizard call get_dead_code '{"type": "functions", "limit": 10}'
@@ -750,6 +766,7 @@ func init() {
 
 	indexCmd.Flags().Bool("dry-run", false, "show what would be indexed")
 	indexCmd.Flags().Bool("force", false, "force reindex all files")
+	indexCmd.Flags().String("revision", "", "index a commit, tag or branch from git into .mcp-codewizard/revisions/<commit>.db")
 
 	searchCmd.Flags().IntP("limit", "l", 10, "maximum results")
 	searchCmd.Flags().StringP("mode", "m", "hybrid", "search mode (vector, bm25, hybrid)")
@@ -758,6 +775,9 @@ func init() {
 	statusCmd.Flags().BoolP("verbose", "v", false, "show detailed statistics")
 
 	serveCmd.Flags().Bool("stdio", false, "use stdio transport (for MCP)")
+	serveCmd.Flags().Bool("no-daemon", false, "with --stdio, serve in-process instead of through the shared daemon")
+	serveCmd.Flags().String("http", "", "also serve streamable HTTP on this localhost address (e.g. 127.0.0.1:7777)")
+	serveCmd.Flags().Duration("idle-timeout", 0, "stop the daemon after this long without clients (0 = never)")
 
 	watchCmd.Flags().Int("debounce", 500, "debounce time in milliseconds")
 
@@ -954,10 +974,27 @@ func setupLogging() {
 	slog.SetDefault(slog.New(handler))
 }
 
+// newStore creates a vector store based on config.
+func newStore(cfg *config.Config) *sqlitevec.Store {
+	return sqlitevec.NewWithConfig(sqlitevec.Config{
+		CacheSizeMB: cfg.VectorStore.CacheSizeMB,
+		MmapSizeMB:  cfg.VectorStore.MmapSizeMB,
+		TempStore:   cfg.VectorStore.TempStore,
+		MaxConns:    cfg.VectorStore.MaxConns,
+
+		CompressChunks: cfg.VectorStore.CompressChunks,
+		ContentCacheMB: cfg.VectorStore.ContentCacheMB,
+
+		MaintenanceBudgetMB: cfg.VectorStore.MaintenanceBudgetMB,
+
+		SplitDatabases: cfg.VectorStore.SplitDatabases,
+	})
+}
+
 // createProviders creates all providers based on config.
 func createProviders(cfg *config.Config) (provider.VectorStore, provider.EmbeddingProvider, provider.ChunkingStrategy, provider.Reranker, error) {
 	// Create vector store
-	store := sqlitevec.New()
+	store := newStore(cfg)
 
 	// Create embedding provider
 	var embedding provider.EmbeddingProvider
@@ -1060,9 +1097,9 @@ func runDryRun(path string) {
 	}
 }
 
-func runIndex(path string, force bool) {
+func runIndex(path string, force bool, revision string) {
 	absPath, _ := filepath.Abs(path)
-	slog.Info("indexing", "path", absPath, "force", force)
+	slog.Info("indexing", "path", absPath, "force", force, "revision", revision)
 
 	cfg, warnings, err := config.Load(absPath)
 	if err != nil {
@@ -1113,8 +1150,18 @@ func runIndex(path string, force bool) {
 		}
 	}()
 
-	// Initialize store
+	// Initialize store. A revision gets its own index so the working
+	// tree's index.db, which the daemon serves and patches, stays intact.
 	dbPath := config.IndexDBPath(absPath)
+	if revision != "" {
+		commit, err := index.ResolveRevision(ctx, absPath, revision)
+		if err != nil {
+			slog.Error("failed to resolve revision", "error", err)
+			os.Exit(1)
+		}
+		revision = commit
+		dbPath = config.RevisionDBPath(absPath, commit)
+	}
 	if err := store.Init(dbPath); err != nil {
 		slog.Error("failed to init store", "error", err)
 		os.Exit(1)
@@ -1132,6 +1179,7 @@ func runIndex(path string, force bool) {
 		Store:      store,
 		Embedding:  embedding,
 		Chunker:    chunker,
+		Revision:   revision,
 		OnProgress: func(p types.IndexProgress) {
 			if p.Phase != "" {
 				fmt.Printf("\r[%s] Files: %d/%d, Chunks: %d/%d",
@@ -1160,12 +1208,61 @@ func runIndex(path string, force bool) {
 		fmt.Printf("Files: %d, Chunks: %d, Symbols: %d\n",
 			stats.IndexedFiles, stats.TotalChunks, stats.TotalSymbols)
 	}
+	if revision != "" {
+		fmt.Printf("Revision index: %s\n", dbPath)
+	}
 }
 
 func runSearch(query string, limit int, mode string, noRerank bool) {
 	cwd, _ := os.Getwd()
 	slog.Debug("searching", "query", query, "limit", limit, "mode", mode, "no-rerank", noRerank)
 
+	// A running daemon answers from its warm index
+	if blocks, ok := callDaemonTool(cwd, "search_code", map[string]any{
+		"query":     query,
+		"limit":     limit,
+		"mode":      mode,
+		"no_rerank": noRerank,
+	}); ok {
+		var entries []struct {
+			File      string  `json:"file"`
+			StartLine int     `json:"start_line"`
+			EndLine   int     `json:"end_line"`
+			Type      string  `json:"type"`
+			Name      string  `json:"name"`
+			Score     float32 `json:"score"`
+			Content   string  `json:"content"`
+		}
+		if len(blocks) == 0 {
+			slog.Error("empty search response from daemon")
+			os.Exit(1)
+		}
+		if err := json.Unmarshal([]byte(blocks[0]), &entries); err != nil {
+			slog.Error("invalid search response from daemon", "error", err)
+			os.Exit(1)
+		}
+		// Notes such as a truncation notice follow the results
+		for _, note := range blocks[1:] {
+			fmt.Fprintln(os.Stderr, note)
+		}
+		results := make([]*types.SearchResult, len(entries))
+		for i, e := range entries {
+			results[i] = &types.SearchResult{
+				Chunk: &types.Chunk{
+					FilePath:  e.File,
+					StartLine: e.StartLine,
+					EndLine:   e.EndLine,
+					ChunkType: types.ChunkType(e.Type),
+					Name:      e.Name,
+					Content:   e.Content,
+				},
+				Score: e.Score,
+			}
+		}
+		printSearchResults(results)
+		return
+	}
+
 	cfg, _, err := config.Load(cwd)
 	if err != nil {
 		slog.Error("failed to load config", "error", err)
@@ -1217,7 +1314,10 @@ func runSearch(query string, limit int, mode string, noRerank bool) {
 		os.Exit(1)
 	}
 
-	// Display results
+	printSearchResults(results)
+}
+
+func printSearchResults(results []*types.SearchResult) {
 	if len(results) == 0 {
 		fmt.Println("No results found")
 		return
@@ -1290,10 +1390,51 @@ func runStatus(verbose bool) {
 	}
 }
 
-func runServe(stdio bool) {
+// serveOptions are the flags of the serve command.
+type serveOptions struct {
+	stdio       bool
+	noDaemon    bool
+	httpAddr    string
+	idleTimeout time.Duration
+}
+
+// daemonIdleTimeout is the idle timeout of auto-started daemons.
+const daemonIdleTimeout = 10 * time.Minute
+
+func runServe(opts serveOptions) {
 	cwd, _ := os.Getwd()
+	stdio := opts.stdio
+	socket := config.DaemonSocketPath(cwd)
+
+	// stdio sessions attach to the project's shared daemon
+	if stdio && !opts.noDaemon {
+		if ensureDaemon(cwd, socket) {
+			slog.Info("proxying MCP session to daemon", "socket", socket)
+			if err := mcp.ProxyStdio(context.Background(), socket, os.Stdin, os.Stdout); err != nil {
+				slog.Error("proxy error", "error", err)
+				os.Exit(1)
+			}
+			return
+		}
+		slog.Warn("daemon unavailable, serving in-process")
+	}
+
 	slog.Info("starting MCP server", "stdio", stdio)
 
+	// A daemon claims its socket before it opens and migrates the index
+	if !stdio {
+		release, err := mcp.LockDaemon(socket)
+		if errors.Is(err, mcp.ErrDaemonRunning) {
+			slog.Info("daemon already running for this project")
+			return
+		}
+		if err != nil {
+			slog.Error("failed to claim daemon socket", "error", err)
+			os.Exit(1)
+		}
+		defer release()
+	}
+
 	cfg, warnings, err := config.Load(cwd)
 	if err != nil {
 		slog.Error("failed to load config", "error", err)
@@ -1322,6 +1463,9 @@ func runServe(stdio bool) {
 		sig := <-sigChan
 		slog.Info("received shutdown signal", "signal", sig)
 		cancel()
+		if !stdio {
+			return // The daemon shuts down and cleans up on its own
+		}
 
 		// Cleanup resources
 		slog.Info("closing providers...")
@@ -1353,16 +1497,6 @@ func runServe(stdio bool) {
 		os.Exit(1)
 	}
 
-	// Warmup providers
-	if err := embedding.Warmup(ctx); err != nil {
-		slog.Warn("embedding warmup failed", "error", err)
-	}
-	if reranker != nil {
-		if err := reranker.Warmup(ctx); err != nil {
-			slog.Warn("reranker warmup failed", "error", err)
-		}
-	}
-
 	// Create MCP server
 	server, err := mcp.New(mcp.Config{
 		ProjectDir: cwd,
@@ -1371,11 +1505,17 @@ func runServe(stdio bool) {
 		Embedding:  embedding,
 		Chunker:    chunker,
 		Reranker:   reranker,
+		NewStore:   func() provider.VectorStore { return newStore(cfg) },
 	})
 	if err != nil {
 		slog.Error("failed to create server", "error", err)
 		os.Exit(1)
 	}
+	defer server.Close()
+
+	// Models load while the server already answers; tools that need them
+	// wait
+	server.Warmup(ctx)
 
 	// Run server
 	if stdio {
@@ -1390,11 +1530,65 @@ func runServe(stdio bool) {
 			}
 		}
 	} else {
-		fmt.Println("HTTP server not implemented yet. Use --stdio for MCP.")
-		os.Exit(1)
+		err := server.ServeDaemon(ctx, mcp.DaemonConfig{
+			SocketPath:  socket,
+			HTTPAddr:    opts.httpAddr,
+			IdleTimeout: opts.idleTimeout,
+		})
+		if err != nil {
+			slog.Error("daemon error", "error", err)
+			os.Exit(1)
+		}
+		slog.Info("daemon stopped")
 	}
 }
 
+// ensureDaemon attaches to the project's daemon, starting one in the
+// background if none is running. Returns false if no daemon came up.
+func ensureDaemon(cwd, socket string) bool {
+	if mcp.DaemonAlive(socket) {
+		return true
+	}
+
+	exe, err := os.Executable()
+	if err != nil {
+		slog.Warn("failed to locate executable", "error", err)
+		return false
+	}
+
+	logPath := config.DaemonLogPath(cwd)
+	if err := os.MkdirAll(filepath.Dir(logPath), 0755); err != nil {
+		slog.Warn("failed to create daemon log directory", "error", err)
+		return false
+	}
+	logFile, err := os.OpenFile(logPath, os.O_CREATE|os.O_WRONLY|os.O_APPEND, 0644)
+	if err != nil {
+		slog.Warn("failed to open daemon log", "error", err)
+		return false
+	}
+	defer logFile.Close()
+
+	cmd := exec.Command(exe, "serve",
+		"--idle-timeout", daemonIdleTimeout.String(),
+		"--log-level", logLevel,
+		"--log-format", logFormat,
+	)
+	cmd.Dir = cwd
+	cmd.Stdout = logFile
+	cmd.Stderr = logFile
+	cmd.SysProcAttr = detachedProcAttr()
+
+	slog.Info("starting MCP daemon", "log", logPath)
+	if err := cmd.Start(); err != nil {
+		slog.Warn("failed to start daemon", "error", err)
+		return false
+	}
+	cmd.Process.Release()
+
+	// Startup opens the index and warms up the providers
+	return mcp.WaitForDaemon(socket, 60*time.Second)
+}
+
 func runConfigInit() {
 	cwd, _ := os.Getwd()
 	cfg := config.DefaultConfig()
@@ -1805,7 +1999,7 @@ func runInit(path string, preset string, skipIndex bool, jsonOutput bool) {
 		_, _ = fmt.Scanln(&response)
 		if response == "" || response == "y" || response == "Y" {
 			fmt.Println()
-			runIndex(absPath, false)
+			runIndex(absPath, false, "")
 		}
 	}
 }
@@ -2025,6 +2219,7 @@ func runMemoryStatus() {
 		slog.Error("failed to open memory store", "error", err)
 		os.Exit(1)
 	}
+	defer store.Close()
 
 	summary := store.GetSummary()
 	git := memory.NewGitIntegration(store)
@@ -2065,6 +2260,7 @@ func runMemoryNotesList(limit int, tag string) {
 		slog.Error("failed to open memory store", "error", err)
 		os.Exit(1)
 	}
+	defer store.Close()
 
 	req := memory.ListNotesRequest{Limit: limit}
 	if tag != "" {
@@ -2097,6 +2293,7 @@ func runMemoryDecisionsList(limit int, status string) {
 		slog.Error("failed to open memory store", "error", err)
 		os.Exit(1)
 	}
+	defer store.Close()
 
 	req := memory.ListDecisionsRequest{Limit: limit}
 	if status != "" {
@@ -2126,6 +2323,7 @@ func runMemoryIssuesList(limit int, openOnly bool) {
 		slog.Error("failed to open memory store", "error", err)
 		os.Exit(1)
 	}
+	defer store.Close()
 
 	req := memory.ListIssuesRequest{Limit: limit}
 	if openOnly {
@@ -2166,6 +2364,7 @@ func runMemorySessions(limit int) {
 		slog.Error("failed to open memory store", "error", err)
 		os.Exit(1)
 	}
+	defer store.Close()
 
 	sessions, err := store.GetSessionHistory(limit)
 	if err != nil {
@@ -2200,6 +2399,7 @@ func runMemoryContext() {
 		slog.Error("failed to open memory store", "error", err)
 		os.Exit(1)
 	}
+	defer store.Close()
 
 	summary := store.GetContextSummary()
 	fmt.Println(summary)
@@ -2213,6 +2413,7 @@ func runMemoryExport() {
 		slog.Error("failed to open memory store", "error", err)
 		os.Exit(1)
 	}
+	defer store.Close()
 
 	mem, err := store.Export()
 	if err != nil {
@@ -2244,6 +2445,7 @@ func runMemoryClear(force bool) {
 		slog.Error("failed to open memory store", "error", err)
 		os.Exit(1)
 	}
+	defer store.Close()
 
 	if err := store.Clear(); err != nil {
 		slog.Error("failed to clear memory", "error", err)
@@ -2261,6 +2463,7 @@ func runMemoryInstallHooks() {
 		slog.Error("failed to open memory store", "error", err)
 		os.Exit(1)
 	}
+	defer store.Close()
 
 	git := memory.NewGitIntegration(store)
 
@@ -2636,6 +2839,7 @@ func runSyncGithub(all, prs bool, limit int, labels []string, assignee string) {
 		slog.Error("failed to open memory store", "error", err)
 		os.Exit(1)
 	}
+	defer store.Close()
 
 	// Store issues
 	for _, req := range requests {
@@ -2672,6 +2876,11 @@ func runCall(tool string, jsonArgs string) {
 		os.Exit(1)
 	}
 
+	if blocks, ok := callDaemonTool(cwd, tool, args); ok {
+		fmt.Println(strings.Join(blocks, "\n"))
+		return
+	}
+
 	// Load config
 	cfg, _, err := config.Load(cwd)
 	if err != nil {
@@ -2694,13 +2903,6 @@ func runCall(tool string, jsonArgs string) {
 		os.Exit(1)
 	}
 
-	// Create search engine
-	searchEngine := search.New(search.Config{
-		Store:     store,
-		Embedding: embedding,
-		Reranker:  reranker,
-	})
-
 	// Create MCP server for tool handling
 	mcpServer, err := mcp.New(mcp.Config{
 		ProjectDir: cwd,
@@ -2713,20 +2915,38 @@ func runCall(tool string, jsonArgs string) {
 		slog.Error("failed to create MCP server", "error", err)
 		os.Exit(1)
 	}
+	defer mcpServer.Close()
 
-	// Map tool name to simplified command output
-	// Since MCP doesn't expose CallTool directly, we handle common cases here
-	fmt.Printf("Tool: %s\nArgs: %s\n\n", tool, jsonArgs)
-	fmt.Println("Note: Direct tool invocation is limited. Use the specific subcommands instead:")
-	fmt.Println("  analysis callers/callees/symbols/dead-code/complexity/entry-points/imports")
-	fmt.Println("  git index/search/blame/evolution/regression/commit/contributors/history")
-	fmt.Println("  todo list/add/search/update/complete/delete/stats")
-	fmt.Println("  chunk <id>")
-	fmt.Println()
+	result, err := mcpServer.CallTool(context.Background(), tool, args)
+	if err != nil {
+		slog.Error("tool call failed", "tool", tool, "error", err)
+		os.Exit(1)
+	}
+	if result.IsError {
+		fmt.Fprintln(os.Stderr, mcp.ToolResultText(result))
+		os.Exit(1)
+	}
+	fmt.Println(mcp.ToolResultText(result))
+}
 
-	// Show search engine and MCP server are available
-	_ = searchEngine
-	_ = mcpServer
+// callDaemonTool runs a tool on the project's daemon when one is running,
+// skipping provider setup and store initialization. It returns false when
+// the caller should run in-process; a tool error ends the command. The
+// result's text blocks are returned separately, the JSON result first.
+func callDaemonTool(cwd, tool string, args map[string]any) ([]string, bool) {
+	blocks, isError, err := mcp.CallDaemonTool(context.Background(), config.DaemonSocketPath(cwd), tool, args)
+	if errors.Is(err, mcp.ErrNoDaemon) {
+		return nil, false
+	}
+	if err != nil {
+		slog.Error("daemon call failed", "tool", tool, "error", err)
+		os.Exit(1)
+	}
+	if isError {
+		fmt.Fprintln(os.Stderr, strings.Join(blocks, "\n"))
+		os.Exit(1)
+	}
+	return blocks, true
 }
 
 // runChunk gets a chunk with context
@@ -2835,10 +3055,14 @@ func runClear(force bool) {
 		os.Exit(1)
 	}
 
+	filePaths := make([]string, 0, len(hashes))
 	for filePath := range hashes {
-		if err := store.DeleteChunksByFile(filePath); err != nil {
-			slog.Warn("failed to delete chunks", "file", filePath, "error", err)
-		}
+		filePaths = append(filePaths, filePath)
+	}
+	if err := store.DeleteChunksByFiles(filePaths); err != nil {
+		slog.Warn("failed to delete chunks", "error", err)
+	}
+	for _, filePath := range filePaths {
 		if err := store.DeleteFileCache(filePath); err != nil {
 			slog.Warn("failed to delete cache", "file", filePath, "error", err)
 		}
@@ -2940,13 +3164,13 @@ func runAnalysisDeadCode(codeType string, limit int) {
 
 	switch codeType {
 	case "functions":
-		results, err = deadCodeAnalyzer.FindDeadFunctions(limit)
+		results, err = deadCodeAnalyzer.FindDeadFunctions(context.Background(), limit)
 	case "types":
-		results, err = deadCodeAnalyzer.FindUnusedTypes(limit)
+		results, err = deadCodeAnalyzer.FindUnusedTypes(context.Background(), limit)
 	case "all":
-		results, err = deadCodeAnalyzer.FindDeadCode(limit)
+		results, err = deadCodeAnalyzer.FindDeadCode(context.Background(), limit)
 	default:
-		results, err = deadCodeAnalyzer.FindDeadFunctions(limit)
+		results, err = deadCodeAnalyzer.FindDeadFunctions(context.Background(), limit)
 	}
 
 	if err != nil {
@@ -3054,7 +3278,7 @@ func runAnalysisEntryPoints(entryType string, limit int) {
 		return
 	}
 
-	entryPoints, err := searchEngine.GetEntryPoints(limit)
+	entryPoints, err := searchEngine.GetEntryPoints(context.Background(), limit)
 	if err != nil {
 		slog.Error("failed to get entry points", "error", err)
 		os.Exit(1)
@@ -3088,7 +3312,7 @@ func runAnalysisImports(limit int) {
 		return
 	}
 
-	graph, err := searchEngine.GetImportGraph(limit)
+	graph, err := searchEngine.GetImportGraph(context.Background(), limit)
 	if err != nil {
 		slog.Error("failed to get import graph", "error", err)
 		os.Exit(1)
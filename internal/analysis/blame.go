@@ -3,6 +3,7 @@ package analysis
 
 import (
 	"bufio"
+	"context"
 	"fmt"
 	"os/exec"
 	"path/filepath"
@@ -62,7 +63,7 @@ func (b *BlameAnalyzer) IsGitRepo() bool {
 }
 
 // GetFileBlame returns blame info for all lines in a file.
-func (b *BlameAnalyzer) GetFileBlame(filePath string) (*FileBlame, error) {
+func (b *BlameAnalyzer) GetFileBlame(ctx context.Context, filePath string) (*FileBlame, error) {
 	// Make path relative to project dir
 	relPath, err := filepath.Rel(b.projectDir, filePath)
 	if err != nil {
@@ -70,7 +71,7 @@ func (b *BlameAnalyzer) GetFileBlame(filePath string) (*FileBlame, error) {
 	}
 
 	// Run git blame with porcelain format for easy parsing
-	cmd := exec.Command("git", "blame", "--porcelain", relPath)
+	cmd := exec.CommandContext(ctx, "git", "blame", "--porcelain", relPath)
 	cmd.Dir = b.projectDir
 
 	output, err := cmd.Output()
@@ -82,7 +83,7 @@ func (b *BlameAnalyzer) GetFileBlame(filePath string) (*FileBlame, error) {
 }
 
 // GetRangeBlame returns aggregated blame info for a line range.
-func (b *BlameAnalyzer) GetRangeBlame(filePath string, startLine, endLine int) (*ChunkBlame, error) {
+func (b *BlameAnalyzer) GetRangeBlame(ctx context.Context, filePath string, startLine, endLine int) (*ChunkBlame, error) {
 	// Make path relative to project dir
 	relPath, err := filepath.Rel(b.projectDir, filePath)
 	if err != nil {
@@ -91,7 +92,7 @@ func (b *BlameAnalyzer) GetRangeBlame(filePath string, startLine, endLine int) (
 
 	// Run git blame for specific range
 	rangeArg := fmt.Sprintf("-L%d,%d", startLine, endLine)
-	cmd := exec.Command("git", "blame", "--porcelain", rangeArg, relPath)
+	cmd := exec.CommandContext(ctx, "git", "blame", "--porcelain", rangeArg, relPath)
 	cmd.Dir = b.projectDir
 
 	output, err := cmd.Output()
@@ -1,6 +1,7 @@
 package analysis
 
 import (
+	"context"
 	"sort"
 	"strings"
 
@@ -131,9 +132,10 @@ func NewDeadCodeAnalyzer(store provider.VectorStore) *DeadCodeAnalyzer {
 }
 
 // BuildGraph constructs the call graph from stored symbols and references.
-func (d *DeadCodeAnalyzer) BuildGraph() error {
+// Loading stops when ctx ends.
+func (d *DeadCodeAnalyzer) BuildGraph(ctx context.Context) error {
 	// 1. Load all symbols
-	symbols, err := d.store.FindSymbols("", "", 100000)
+	symbols, err := d.store.FindSymbols(ctx, "", "", 100000)
 	if err != nil {
 		return err
 	}
@@ -144,7 +146,7 @@ func (d *DeadCodeAnalyzer) BuildGraph() error {
 	}
 
 	// 2. Load all internal references
-	refs, err := d.store.GetAllReferences(1000000)
+	refs, err := d.store.GetAllReferences(ctx, 1000000)
 	if err != nil {
 		return err
 	}
@@ -254,13 +256,16 @@ func (d *DeadCodeAnalyzer) ComputeReachable() {
 }
 
 // FindDeadCode finds all unreachable symbols.
-func (d *DeadCodeAnalyzer) FindDeadCode(limit int) ([]*DeadCodeResult, error) {
+func (d *DeadCodeAnalyzer) FindDeadCode(ctx context.Context, limit int) ([]*DeadCodeResult, error) {
 	// Build graph if not already built
 	if len(d.symbols) == 0 {
-		if err := d.BuildGraph(); err != nil {
+		if err := d.BuildGraph(ctx); err != nil {
 			return nil, err
 		}
 	}
+	if err := ctx.Err(); err != nil {
+		return nil, err
+	}
 
 	// Compute reachability
 	d.ComputeReachable()
@@ -311,8 +316,8 @@ func (d *DeadCodeAnalyzer) FindDeadCode(limit int) ([]*DeadCodeResult, error) {
 }
 
 // FindDeadFunctions finds only unreachable functions and methods.
-func (d *DeadCodeAnalyzer) FindDeadFunctions(limit int) ([]*DeadCodeResult, error) {
-	allDead, err := d.FindDeadCode(0)
+func (d *DeadCodeAnalyzer) FindDeadFunctions(ctx context.Context, limit int) ([]*DeadCodeResult, error) {
+	allDead, err := d.FindDeadCode(ctx, 0)
 	if err != nil {
 		return nil, err
 	}
@@ -331,8 +336,8 @@ func (d *DeadCodeAnalyzer) FindDeadFunctions(limit int) ([]*DeadCodeResult, erro
 }
 
 // FindUnusedTypes finds only unreachable types.
-func (d *DeadCodeAnalyzer) FindUnusedTypes(limit int) ([]*DeadCodeResult, error) {
-	allDead, err := d.FindDeadCode(0)
+func (d *DeadCodeAnalyzer) FindUnusedTypes(ctx context.Context, limit int) ([]*DeadCodeResult, error) {
+	allDead, err := d.FindDeadCode(ctx, 0)
 	if err != nil {
 		return nil, err
 	}
@@ -549,7 +554,7 @@ func (d *DeadCodeAnalyzer) getLanguageConfig(sym *types.Symbol) *LanguageConfig
 // GetStats returns statistics about the call graph.
 func (d *DeadCodeAnalyzer) GetStats() map[string]int {
 	if len(d.symbols) == 0 {
-		_ = d.BuildGraph()
+		_ = d.BuildGraph(context.Background())
 		d.ComputeReachable()
 	}
 
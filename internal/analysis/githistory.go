@@ -152,18 +152,23 @@ func (g *GitHistoryAnalyzer) parseCommitLog(output string) ([]*types.Commit, err
 
 			timestamp, _ := strconv.ParseInt(parts[4], 10, 64)
 			parentHash := ""
+			var parentHashes []string
 			if len(parts) > 6 {
-				parentHash = strings.Split(parts[6], " ")[0] // First parent
+				parentHashes = strings.Fields(parts[6])
+				if len(parentHashes) > 0 {
+					parentHash = parentHashes[0] // First parent
+				}
 			}
 
 			currentCommit = &types.Commit{
-				Hash:        parts[0],
-				ShortHash:   parts[1],
-				Author:      parts[2],
-				AuthorEmail: parts[3],
-				Date:        time.Unix(timestamp, 0),
-				Message:     parts[5],
-				ParentHash:  parentHash,
+				Hash:         parts[0],
+				ShortHash:    parts[1],
+				Author:       parts[2],
+				AuthorEmail:  parts[3],
+				Date:         time.Unix(timestamp, 0),
+				Message:      parts[5],
+				ParentHash:   parentHash,
+				ParentHashes: parentHashes,
 			}
 
 			// Parse refs (tags, branches)
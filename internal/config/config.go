@@ -33,6 +33,15 @@ type MCPConfig struct {
 	// - "router": only route, list_tools, suggest_tool (3 tools)
 	// - "hybrid": essential tools + router for others (~10 tools + router)
 	Mode string `mapstructure:"mode" yaml:"mode"`
+
+	// PrettyJSON indents tool responses. Compact JSON is smaller and faster
+	// to produce.
+	PrettyJSON bool `mapstructure:"pretty_json" yaml:"pretty_json"`
+
+	// MaxResponseBytes caps the size of a tool response; the longest result
+	// list is truncated to fit. 0 uses the default (512 KiB), -1 disables
+	// the cap.
+	MaxResponseBytes int `mapstructure:"max_response_bytes" yaml:"max_response_bytes"`
 }
 
 // EmbeddingConfig contains embedding provider configuration.
@@ -70,6 +79,27 @@ type SearchConfig struct {
 // VectorStoreConfig contains vector store configuration.
 type VectorStoreConfig struct {
 	Provider string `mapstructure:"provider" yaml:"provider"` // sqlitevec
+
+	// Connection tuning; zero values are sized from the database size and
+	// available memory.
+	CacheSizeMB int    `mapstructure:"cache_size_mb" yaml:"cache_size_mb,omitempty"` // page cache per connection
+	MmapSizeMB  int    `mapstructure:"mmap_size_mb" yaml:"mmap_size_mb,omitempty"`   // memory-mapped reads, -1 disables
+	TempStore   string `mapstructure:"temp_store" yaml:"temp_store,omitempty"`       // memory, file
+	MaxConns    int    `mapstructure:"max_conns" yaml:"max_conns,omitempty"`         // open connections
+
+	// Chunk bodies are stored compressed and decompressed through an
+	// in-memory cache of ContentCacheMB (0 = default).
+	CompressChunks bool `mapstructure:"compress_chunks" yaml:"compress_chunks"`
+	ContentCacheMB int  `mapstructure:"content_cache_mb" yaml:"content_cache_mb,omitempty"`
+
+	// Idle maintenance (ANALYZE, incremental vacuum, WAL checkpoint) writes
+	// at most this much per pass (0 = default, -1 disables).
+	MaintenanceBudgetMB int `mapstructure:"maintenance_budget_mb" yaml:"maintenance_budget_mb,omitempty"`
+
+	// Git history and memories/todos are kept in database files of their
+	// own, each with its own WAL, writer and maintenance. Once split, an
+	// index stays split.
+	SplitDatabases bool `mapstructure:"split_databases" yaml:"split_databases,omitempty"`
 }
 
 // IndexConfig contains indexing configuration.
@@ -128,7 +158,8 @@ func DefaultConfig() *Config {
 			DefaultLimit: 10,
 		},
 		VectorStore: VectorStoreConfig{
-			Provider: "sqlitevec",
+			Provider:       "sqlitevec",
+			CompressChunks: true,
 		},
 		Index: IndexConfig{
 			Include: []string{
@@ -202,6 +233,36 @@ func IndexDBPath(projectRoot string) string {
 	return filepath.Join(ConfigDir(projectRoot), "index.db")
 }
 
+// RevisionDBPath returns the path to the index of a git commit. Revision
+// indexes are kept apart from index.db, which follows the working tree.
+func RevisionDBPath(projectRoot, commit string) string {
+	return filepath.Join(ConfigDir(projectRoot), "revisions", commit+".db")
+}
+
+// DaemonSocketPath returns the Unix socket of the project's shared daemon.
+// Sockets live in a per-user runtime directory rather than the project
+// because socket paths are limited to about 100 bytes.
+func DaemonSocketPath(projectRoot string) string {
+	dir := os.Getenv("XDG_RUNTIME_DIR")
+	if dir != "" {
+		dir = filepath.Join(dir, "mcp-codewizard")
+	} else {
+		dir = filepath.Join(os.TempDir(), fmt.Sprintf("mcp-codewizard-%d", os.Getuid()))
+	}
+
+	abs, err := filepath.Abs(projectRoot)
+	if err != nil {
+		abs = projectRoot
+	}
+	hash := sha256.Sum256([]byte(abs))
+	return filepath.Join(dir, hex.EncodeToString(hash[:8])+".sock")
+}
+
+// DaemonLogPath returns the log file of an auto-started daemon.
+func DaemonLogPath(projectRoot string) string {
+	return filepath.Join(ConfigDir(projectRoot), "local", "daemon.log")
+}
+
 // Load loads configuration from file, falling back to defaults.
 func Load(projectRoot string) (*Config, []string, error) {
 	cfg := DefaultConfig()
@@ -328,6 +389,11 @@ func Validate(cfg *Config) []error {
 		errs = append(errs, fmt.Errorf("invalid search mode: %s", cfg.Search.Mode))
 	}
 
+	// Validate vector store tuning
+	if cfg.VectorStore.TempStore != "" && cfg.VectorStore.TempStore != "memory" && cfg.VectorStore.TempStore != "file" {
+		errs = append(errs, fmt.Errorf("invalid vectorstore temp_store: %s (valid: memory, file)", cfg.VectorStore.TempStore))
+	}
+
 	// Validate MCP mode
 	validMCPModes := map[string]bool{
 		"full": true, "router": true, "hybrid": true, "": true,
@@ -0,0 +1,215 @@
+package index
+
+import (
+	"bufio"
+	"bytes"
+	"context"
+	"fmt"
+	"io"
+	"log/slog"
+	"os/exec"
+	"path/filepath"
+	"strconv"
+	"strings"
+
+	"github.com/spetr/mcp-codewizard/builtin/chunking/simple"
+	"github.com/spetr/mcp-codewizard/pkg/types"
+)
+
+// Indexing a revision reads files straight from the object database, so any
+// commit, tag or branch can be indexed without checking it out. Files are
+// listed with `git ls-tree -r` and their contents streamed through a single
+// `git cat-file --batch` process while earlier files are being chunked.
+//
+// SourceFile.Hash is the git blob ID for these files, so unchanged files are
+// skipped before their content is ever read.
+
+// ResolveRevision resolves a commit-ish to a full commit hash.
+func ResolveRevision(ctx context.Context, dir, rev string) (string, error) {
+	cmd := exec.CommandContext(ctx, "git", "rev-parse", "--verify", "--quiet", "--end-of-options", rev+"^{commit}")
+	cmd.Dir = dir
+
+	output, err := cmd.Output()
+	if err != nil {
+		return "", fmt.Errorf("unknown revision %q", rev)
+	}
+
+	return strings.TrimSpace(string(output)), nil
+}
+
+// scanRevision lists the files of idx.revision that match the include and
+// exclude patterns. Contents are not loaded; see streamRevisionBlobs.
+func (idx *Indexer) scanRevision(ctx context.Context) ([]*types.SourceFile, error) {
+	commit, err := ResolveRevision(ctx, idx.projectDir, idx.revision)
+	if err != nil {
+		return nil, err
+	}
+	slog.Info("indexing revision", "revision", idx.revision, "commit", commit)
+
+	// Run from the project directory, ls-tree lists only the files below it,
+	// with paths relative to it, also for a project in a subdirectory of its
+	// repository
+	cmd := exec.CommandContext(ctx, "git", "ls-tree", "-r", "-l", "-z", commit)
+	cmd.Dir = idx.projectDir
+
+	output, err := cmd.Output()
+	if err != nil {
+		return nil, fmt.Errorf("git ls-tree failed: %w", err)
+	}
+
+	maxSize := parseSize(idx.config.Limits.MaxFileSize)
+	var files []*types.SourceFile
+
+	for _, entry := range bytes.Split(output, []byte{0}) {
+		// <mode> SP <type> SP <object> SP+ <size> TAB <path>
+		meta, path, ok := strings.Cut(string(entry), "\t")
+		if !ok {
+			continue
+		}
+		fields := strings.Fields(meta)
+		if len(fields) != 4 || fields[1] != "blob" || fields[0] == "120000" {
+			continue // Submodules and symlinks
+		}
+
+		if !idx.matchesPatterns(path) {
+			continue
+		}
+
+		size, _ := strconv.ParseInt(fields[3], 10, 64)
+		if size > maxSize {
+			slog.Warn("failed to read file", "path", path, "error", fmt.Errorf("file too large: %d > %d", size, maxSize))
+			continue
+		}
+
+		fullPath := filepath.Join(idx.projectDir, path)
+		files = append(files, &types.SourceFile{
+			Path:     fullPath,
+			Language: simple.DetectLanguage(fullPath),
+			Hash:     fields[2],
+		})
+
+		if len(files) >= idx.config.Limits.MaxFiles {
+			break
+		}
+	}
+
+	return files, nil
+}
+
+// matchesPatterns reports whether a project-relative path is included and not
+// excluded by the index configuration.
+func (idx *Indexer) matchesPatterns(path string) bool {
+	included := false
+	for _, pattern := range idx.config.Index.Include {
+		if matchGlob(pattern, path) {
+			included = true
+			break
+		}
+	}
+	if !included {
+		return false
+	}
+
+	for _, pattern := range idx.config.Index.Exclude {
+		if matchGlob(pattern, path) {
+			return false
+		}
+	}
+
+	return true
+}
+
+// streamRevisionBlobs fills in the content of files (whose Hash is a blob ID)
+// from `git cat-file --batch` and sends each file to out as soon as it has
+// been read. Missing blobs are logged and skipped.
+func (idx *Indexer) streamRevisionBlobs(ctx context.Context, files []*types.SourceFile, out chan<- *types.SourceFile) error {
+	if len(files) == 0 {
+		return nil
+	}
+
+	cmd := exec.CommandContext(ctx, "git", "cat-file", "--batch")
+	cmd.Dir = idx.projectDir
+
+	stdin, err := cmd.StdinPipe()
+	if err != nil {
+		return err
+	}
+	stdout, err := cmd.StdoutPipe()
+	if err != nil {
+		return err
+	}
+	if err := cmd.Start(); err != nil {
+		return fmt.Errorf("failed to start git cat-file: %w", err)
+	}
+
+	// Requests are written from a separate goroutine so git never blocks on
+	// a full stdout pipe while we are still writing object IDs.
+	writeErr := make(chan error, 1)
+	go func() {
+		w := bufio.NewWriter(stdin)
+		var err error
+		for _, f := range files {
+			if _, err = w.WriteString(f.Hash + "\n"); err != nil {
+				break
+			}
+		}
+		if err == nil {
+			err = w.Flush()
+		}
+		stdin.Close()
+		writeErr <- err
+	}()
+
+	readErr := readBlobs(ctx, bufio.NewReaderSize(stdout, 64*1024), files, out)
+	if readErr != nil {
+		// Unblock the writer and reap the process
+		io.Copy(io.Discard, stdout)
+	}
+	werr := <-writeErr
+	waitErr := cmd.Wait()
+
+	switch {
+	case readErr != nil:
+		return readErr
+	case werr != nil:
+		return fmt.Errorf("git cat-file: %w", werr)
+	case waitErr != nil:
+		return fmt.Errorf("git cat-file: %w", waitErr)
+	}
+	return nil
+}
+
+// readBlobs parses `git cat-file --batch` output for files, in order.
+func readBlobs(ctx context.Context, r *bufio.Reader, files []*types.SourceFile, out chan<- *types.SourceFile) error {
+	for _, f := range files {
+		if ctx.Err() != nil {
+			return ctx.Err()
+		}
+
+		// <object> SP <type> SP <size> LF, or <object> SP missing LF
+		header, err := r.ReadString('\n')
+		if err != nil {
+			return fmt.Errorf("git cat-file: %w", err)
+		}
+		fields := strings.Fields(header)
+		if len(fields) != 3 {
+			slog.Warn("failed to read file", "path", f.Path, "error", strings.TrimSpace(header))
+			continue
+		}
+
+		size, err := strconv.Atoi(fields[2])
+		if err != nil {
+			return fmt.Errorf("git cat-file: bad header %q", header)
+		}
+
+		content := make([]byte, size+1) // Trailing LF
+		if _, err := io.ReadFull(r, content); err != nil {
+			return fmt.Errorf("git cat-file: %w", err)
+		}
+		f.Content = content[:size]
+
+		out <- f
+	}
+
+	return nil
+}
@@ -0,0 +1,90 @@
+package index
+
+import (
+	"context"
+	"os"
+	"os/exec"
+	"path/filepath"
+	"sort"
+	"strings"
+	"testing"
+
+	"github.com/spetr/mcp-codewizard/internal/config"
+	"github.com/spetr/mcp-codewizard/pkg/types"
+)
+
+func TestScanRevisionInSubdirectory(t *testing.T) {
+	if _, err := exec.LookPath("git"); err != nil {
+		t.Skip("git not available")
+	}
+
+	repoDir, err := os.MkdirTemp("", "index-revision-test-*")
+	if err != nil {
+		t.Fatal(err)
+	}
+	defer os.RemoveAll(repoDir)
+
+	git := func(args ...string) {
+		cmd := exec.Command("git", args...)
+		cmd.Dir = repoDir
+		cmd.Env = append(os.Environ(),
+			"GIT_AUTHOR_NAME=Test", "GIT_AUTHOR_EMAIL=test@test.com",
+			"GIT_COMMITTER_NAME=Test", "GIT_COMMITTER_EMAIL=test@test.com")
+		if out, err := cmd.CombinedOutput(); err != nil {
+			t.Fatalf("git %v failed: %v\n%s", args, err, out)
+		}
+	}
+	write := func(path, content string) {
+		full := filepath.Join(repoDir, path)
+		if err := os.MkdirAll(filepath.Dir(full), 0755); err != nil {
+			t.Fatal(err)
+		}
+		if err := os.WriteFile(full, []byte(content), 0644); err != nil {
+			t.Fatal(err)
+		}
+	}
+
+	// The project is a subdirectory of its repository
+	git("init", "-q")
+	write("outside.go", "package outside\n")
+	write("project/main.go", "package main\n")
+	write("project/pkg/util.go", "package pkg\n")
+	git("add", ".")
+	git("commit", "-q", "-m", "initial")
+	// The working tree differs from the revision
+	write("project/main.go", "package changed\n")
+
+	projectDir := filepath.Join(repoDir, "project")
+	idx := New(Config{ProjectDir: projectDir, Config: config.DefaultConfig(), Revision: "HEAD"})
+
+	ctx := context.Background()
+	files, err := idx.scanRevision(ctx)
+	if err != nil {
+		t.Fatal(err)
+	}
+	var paths []string
+	for _, f := range files {
+		paths = append(paths, f.Path)
+	}
+	sort.Strings(paths)
+	want := []string{filepath.Join(projectDir, "main.go"), filepath.Join(projectDir, "pkg", "util.go")}
+	if strings.Join(paths, ",") != strings.Join(want, ",") {
+		t.Fatalf("paths = %v, want %v", paths, want)
+	}
+
+	out := make(chan *types.SourceFile, len(files))
+	if err := idx.streamRevisionBlobs(ctx, files, out); err != nil {
+		t.Fatal(err)
+	}
+	close(out)
+	contents := make(map[string]string)
+	for f := range out {
+		contents[f.Path] = string(f.Content)
+	}
+	if got := contents[want[0]]; got != "package main\n" {
+		t.Errorf("main.go content = %q, want the committed one", got)
+	}
+	if got := contents[want[1]]; got != "package pkg\n" {
+		t.Errorf("util.go content = %q", got)
+	}
+}
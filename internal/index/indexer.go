@@ -28,6 +28,7 @@ type Indexer struct {
 	chunker    provider.ChunkingStrategy
 	projectDir string
 	configHash string
+	revision   string
 
 	// Progress tracking
 	progressMu sync.Mutex
@@ -43,6 +44,12 @@ type Config struct {
 	Embedding  provider.EmbeddingProvider
 	Chunker    provider.ChunkingStrategy
 	OnProgress func(types.IndexProgress)
+
+	// Revision indexes a commit, tag or branch from the object database
+	// instead of the working tree. Empty means the working tree. Store
+	// should then be a revision index (config.RevisionDBPath), not the
+	// working tree's index.db.
+	Revision string
 }
 
 // New creates a new indexer.
@@ -54,6 +61,7 @@ func New(cfg Config) *Indexer {
 		chunker:    cfg.Chunker,
 		projectDir: cfg.ProjectDir,
 		configHash: cfg.Config.Hash(),
+		revision:   cfg.Revision,
 		onProgress: cfg.OnProgress,
 	}
 }
@@ -132,19 +140,26 @@ func (idx *Indexer) Index(ctx context.Context, force bool) error {
 	// Phase 4: Store all data
 	idx.updateProgress("storing", len(filesToProcess), len(filesToProcess), len(allChunks), len(allChunks), "")
 
-	if err := idx.store.StoreChunks(chunksWithEmbeddings); err != nil {
-		return fmt.Errorf("failed to store chunks: %w", err)
-	}
+	if loader, ok := idx.store.(provider.BulkLoader); ok && idx.replacesIndex(force) {
+		// Forced and initial runs write the whole index
+		if err := loader.BulkLoad(chunksWithEmbeddings, allSymbols, allRefs); err != nil {
+			return fmt.Errorf("failed to store index: %w", err)
+		}
+	} else {
+		if err := idx.store.StoreChunks(chunksWithEmbeddings); err != nil {
+			return fmt.Errorf("failed to store chunks: %w", err)
+		}
 
-	if len(allSymbols) > 0 {
-		if err := idx.store.StoreSymbols(allSymbols); err != nil {
-			slog.Warn("failed to store symbols", "error", err)
+		if len(allSymbols) > 0 {
+			if err := idx.store.StoreSymbols(allSymbols); err != nil {
+				slog.Warn("failed to store symbols", "error", err)
+			}
 		}
-	}
 
-	if len(allRefs) > 0 {
-		if err := idx.store.StoreReferences(allRefs); err != nil {
-			slog.Warn("failed to store references", "error", err)
+		if len(allRefs) > 0 {
+			if err := idx.store.StoreReferences(allRefs); err != nil {
+				slog.Warn("failed to store references", "error", err)
+			}
 		}
 	}
 
@@ -178,11 +193,14 @@ func (idx *Indexer) Index(ctx context.Context, force bool) error {
 		return fmt.Errorf("failed to store metadata: %w", err)
 	}
 
-	// Rebuild FTS index to ensure consistency after batch operations
+	// The store keeps the FTS index in sync as chunks are written; rebuild it
+	// only if it turns out to be inconsistent
 	if maintainer, ok := idx.store.(provider.Maintainer); ok {
-		slog.Debug("rebuilding FTS index after indexing")
-		if err := maintainer.RebuildFTS(); err != nil {
-			slog.Warn("failed to rebuild FTS index", "error", err)
+		if err := maintainer.CheckFTSHealth(); err != nil {
+			slog.Warn("FTS index unhealthy after indexing, rebuilding", "error", err)
+			if err := maintainer.RebuildFTS(); err != nil {
+				slog.Warn("failed to rebuild FTS index", "error", err)
+			}
 		}
 	}
 
@@ -202,6 +220,10 @@ func (idx *Indexer) Index(ctx context.Context, force bool) error {
 func (idx *Indexer) scanFiles(ctx context.Context) ([]*types.SourceFile, error) {
 	var files []*types.SourceFile
 
+	if idx.revision != "" {
+		return idx.scanRevision(ctx)
+	}
+
 	// Try to use git ls-files first
 	if idx.config.Index.UseGitIgnore {
 		gitFiles, err := idx.scanWithGit(ctx)
@@ -366,9 +388,21 @@ func (idx *Indexer) readFile(path string) (*types.SourceFile, error) {
 	return file, nil
 }
 
+// replacesIndex reports whether this run writes the whole index: it is
+// forced, or the store is still empty.
+func (idx *Indexer) replacesIndex(force bool) bool {
+	if force {
+		return true
+	}
+	stats, err := idx.store.GetStats()
+	return err == nil && stats != nil &&
+		stats.TotalChunks == 0 && stats.TotalSymbols == 0 && stats.TotalReferences == 0
+}
+
 // filterChangedFiles filters out files that haven't changed.
 func (idx *Indexer) filterChangedFiles(ctx context.Context, files []*types.SourceFile) ([]*types.SourceFile, error) {
 	var changed []*types.SourceFile
+	var stale []string
 
 	for _, file := range files {
 		cachedHash, err := idx.store.GetFileHash(file.Path)
@@ -379,14 +413,16 @@ func (idx *Indexer) filterChangedFiles(ctx context.Context, files []*types.Sourc
 		}
 
 		if cachedHash != file.Hash {
-			// File has changed, delete old chunks first
-			if err := idx.store.DeleteChunksByFile(file.Path); err != nil {
-				slog.Warn("failed to delete old chunks", "file", file.Path, "error", err)
-			}
 			changed = append(changed, file)
+			stale = append(stale, file.Path)
 		}
 	}
 
+	// Delete the old chunks of changed files in bulk
+	if err := idx.store.DeleteChunksByFiles(stale); err != nil {
+		slog.Warn("failed to delete old chunks", "files", len(stale), "error", err)
+	}
+
 	return changed, nil
 }
 
@@ -441,11 +477,19 @@ func (idx *Indexer) chunkFilesParallel(ctx context.Context, files []*types.Sourc
 		}()
 	}
 
-	// Send work
-	for _, file := range files {
-		fileCh <- file
-	}
-	close(fileCh)
+	// Send work. Revision files are read from git while workers chunk.
+	feedErr := make(chan error, 1)
+	go func() {
+		defer close(fileCh)
+		if idx.revision != "" {
+			feedErr <- idx.streamRevisionBlobs(ctx, files, fileCh)
+			return
+		}
+		for _, file := range files {
+			fileCh <- file
+		}
+		feedErr <- nil
+	}()
 
 	// Wait for workers
 	go func() {
@@ -467,6 +511,10 @@ func (idx *Indexer) chunkFilesParallel(ctx context.Context, files []*types.Sourc
 		allRefs = append(allRefs, res.refs...)
 	}
 
+	if err := <-feedErr; err != nil {
+		return nil, nil, nil, err
+	}
+
 	return allChunks, allSymbols, allRefs, nil
 }
 
@@ -0,0 +1,248 @@
+package mcp
+
+import (
+	"context"
+	"encoding/json"
+	"errors"
+	"fmt"
+	"log/slog"
+	"net"
+	"net/http"
+	"os"
+	"path/filepath"
+	"sync"
+	"time"
+
+	"github.com/mark3labs/mcp-go/server"
+)
+
+// A daemon owns the index, file watcher and caches of one project and serves
+// MCP to any number of clients over streamable HTTP, on a Unix socket and
+// optionally on a localhost TCP address. `serve --stdio` proxies to it (see
+// ProxyStdio), so concurrent agent sessions share one process and one
+// writer instead of each opening the database and watching the tree.
+
+// DaemonEndpoint is the MCP endpoint path of the daemon.
+const DaemonEndpoint = "/mcp"
+
+// daemonHealthPath answers liveness probes from proxies.
+const daemonHealthPath = "/health"
+
+// daemonCallPath runs a single tool call without an MCP session, for CLI
+// commands (see CallDaemonTool).
+const daemonCallPath = "/call"
+
+// ErrDaemonRunning is returned by ServeDaemon when another daemon already
+// serves the socket.
+var ErrDaemonRunning = errors.New("daemon already running")
+
+// DaemonConfig configures ServeDaemon.
+type DaemonConfig struct {
+	SocketPath  string        // Unix socket to listen on
+	HTTPAddr    string        // Optional localhost address for streamable HTTP
+	IdleTimeout time.Duration // Exit after this long without clients, 0 = never
+}
+
+// daemonHealth is the response of the health endpoint.
+type daemonHealth struct {
+	ProjectDir string `json:"project_dir"`
+	PID        int    `json:"pid"`
+	StartedAt  string `json:"started_at"`
+}
+
+// LockDaemon claims the socket for a new daemon. It returns
+// ErrDaemonRunning if another daemon holds the lock or answers on the
+// socket. The caller takes it before opening the index, so a second daemon
+// never migrates a database the running one owns, and holds it while
+// ServeDaemon runs.
+func LockDaemon(socketPath string) (func(), error) {
+	dir := filepath.Dir(socketPath)
+	if err := os.MkdirAll(dir, 0700); err != nil {
+		return nil, fmt.Errorf("failed to create socket directory: %w", err)
+	}
+	if err := checkSocketDir(dir); err != nil {
+		return nil, err
+	}
+
+	unlock, err := lockDaemon(socketPath + ".lock")
+	if err != nil {
+		return nil, ErrDaemonRunning
+	}
+	if DaemonAlive(socketPath) {
+		unlock()
+		return nil, ErrDaemonRunning
+	}
+	return unlock, nil
+}
+
+// ServeDaemon serves MCP on the configured listeners until ctx is cancelled
+// or no client has been connected for IdleTimeout. The file watcher runs
+// once for all clients. The caller must hold the daemon lock (LockDaemon).
+func (s *Server) ServeDaemon(ctx context.Context, cfg DaemonConfig) error {
+	// A socket left behind by a crashed daemon is removed
+	os.Remove(cfg.SocketPath)
+
+	unixListener, err := listenUnix(cfg.SocketPath)
+	if err != nil {
+		return fmt.Errorf("failed to listen on %s: %w", cfg.SocketPath, err)
+	}
+	defer os.Remove(cfg.SocketPath)
+
+	listeners := []net.Listener{unixListener}
+	if cfg.HTTPAddr != "" {
+		tcpListener, err := listenLoopback(cfg.HTTPAddr)
+		if err != nil {
+			unixListener.Close()
+			return err
+		}
+		listeners = append(listeners, tcpListener)
+	}
+
+	health, _ := json.Marshal(daemonHealth{
+		ProjectDir: s.projectDir,
+		PID:        os.Getpid(),
+		StartedAt:  time.Now().Format(time.RFC3339),
+	})
+	mux := http.NewServeMux()
+	mux.Handle(DaemonEndpoint, server.NewStreamableHTTPServer(s.mcpServer, server.WithEndpointPath(DaemonEndpoint)))
+	mux.HandleFunc(daemonHealthPath, func(w http.ResponseWriter, r *http.Request) {
+		w.Header().Set("Content-Type", "application/json")
+		w.Write(health)
+	})
+	mux.HandleFunc(daemonCallPath, s.handleDaemonCall)
+
+	conns := newConnTracker()
+	httpServer := &http.Server{
+		Handler:   mux,
+		ConnState: conns.connState,
+	}
+
+	if err := s.startWatcher(); err != nil {
+		slog.Warn("failed to start file watcher", "error", err)
+	}
+	defer s.stopWatcher()
+
+	serveErr := make(chan error, len(listeners))
+	for _, l := range listeners {
+		slog.Info("MCP daemon listening", "address", l.Addr().String())
+		go func(l net.Listener) {
+			serveErr <- httpServer.Serve(l)
+		}(l)
+	}
+
+	var idle <-chan time.Time
+	if cfg.IdleTimeout > 0 {
+		ticker := time.NewTicker(min(cfg.IdleTimeout/4, 30*time.Second) + time.Second)
+		defer ticker.Stop()
+		idle = ticker.C
+	}
+
+	var runErr error
+loop:
+	for {
+		select {
+		case <-ctx.Done():
+			break loop
+		case err := <-serveErr:
+			if !errors.Is(err, http.ErrServerClosed) {
+				runErr = err
+			}
+			break loop
+		case <-idle:
+			if conns.idleFor() >= cfg.IdleTimeout {
+				slog.Info("no clients connected, shutting down daemon", "idle_timeout", cfg.IdleTimeout)
+				break loop
+			}
+		}
+	}
+
+	shutdownCtx, cancel := context.WithTimeout(context.Background(), 5*time.Second)
+	defer cancel()
+	if err := httpServer.Shutdown(shutdownCtx); err != nil {
+		httpServer.Close()
+	}
+
+	return runErr
+}
+
+// handleDaemonCall runs one tool call posted by CallDaemonTool.
+func (s *Server) handleDaemonCall(w http.ResponseWriter, r *http.Request) {
+	if r.Method != http.MethodPost {
+		http.Error(w, "method not allowed", http.StatusMethodNotAllowed)
+		return
+	}
+
+	var call daemonCallRequest
+	if err := json.NewDecoder(r.Body).Decode(&call); err != nil {
+		http.Error(w, fmt.Sprintf("invalid request: %v", err), http.StatusBadRequest)
+		return
+	}
+
+	result, err := s.CallTool(r.Context(), call.Tool, call.Arguments)
+	var resp daemonCallResponse
+	if err != nil {
+		resp = daemonCallResponse{Blocks: []string{err.Error()}, IsError: true}
+	} else {
+		resp = daemonCallResponse{Blocks: ToolResultTexts(result), IsError: result.IsError}
+	}
+
+	w.Header().Set("Content-Type", "application/json")
+	json.NewEncoder(w).Encode(resp)
+}
+
+// listenLoopback listens on addr, which must be a loopback address: the
+// daemon has no authentication.
+func listenLoopback(addr string) (net.Listener, error) {
+	host, _, err := net.SplitHostPort(addr)
+	if err != nil {
+		return nil, fmt.Errorf("invalid HTTP address %q: %w", addr, err)
+	}
+	if host != "localhost" {
+		if ip := net.ParseIP(host); ip == nil || !ip.IsLoopback() {
+			return nil, fmt.Errorf("HTTP address %q is not a loopback address", addr)
+		}
+	}
+
+	l, err := net.Listen("tcp", addr)
+	if err != nil {
+		return nil, fmt.Errorf("failed to listen on %s: %w", addr, err)
+	}
+	return l, nil
+}
+
+// connTracker counts open client connections for the idle timeout.
+type connTracker struct {
+	mu        sync.Mutex
+	open      int
+	idleSince time.Time
+}
+
+func newConnTracker() *connTracker {
+	return &connTracker{idleSince: time.Now()}
+}
+
+func (t *connTracker) connState(_ net.Conn, state http.ConnState) {
+	t.mu.Lock()
+	defer t.mu.Unlock()
+
+	switch state {
+	case http.StateNew:
+		t.open++
+	case http.StateHijacked, http.StateClosed:
+		t.open--
+		if t.open == 0 {
+			t.idleSince = time.Now()
+		}
+	}
+}
+
+// idleFor returns how long no connection has been open.
+func (t *connTracker) idleFor() time.Duration {
+	t.mu.Lock()
+	defer t.mu.Unlock()
+
+	if t.open > 0 {
+		return 0
+	}
+	return time.Since(t.idleSince)
+}
@@ -0,0 +1,77 @@
+//go:build !windows
+
+package mcp
+
+import (
+	"errors"
+	"os"
+	"path/filepath"
+	"testing"
+)
+
+func TestCheckSocketDir(t *testing.T) {
+	base := t.TempDir()
+
+	private := filepath.Join(base, "private")
+	if err := os.Mkdir(private, 0700); err != nil {
+		t.Fatal(err)
+	}
+	if err := checkSocketDir(private); err != nil {
+		t.Errorf("private directory rejected: %v", err)
+	}
+
+	shared := filepath.Join(base, "shared")
+	if err := os.Mkdir(shared, 0700); err != nil {
+		t.Fatal(err)
+	}
+	if err := os.Chmod(shared, 0777); err != nil {
+		t.Fatal(err)
+	}
+	if err := checkSocketDir(shared); err == nil {
+		t.Error("world-writable directory accepted")
+	}
+
+	link := filepath.Join(base, "link")
+	if err := os.Symlink(private, link); err != nil {
+		t.Fatal(err)
+	}
+	if err := checkSocketDir(link); err == nil {
+		t.Error("symlinked directory accepted")
+	}
+
+	// Clients refuse to dial into a directory that fails the check
+	if DaemonAlive(filepath.Join(shared, "d.sock")) {
+		t.Error("DaemonAlive in a shared directory = true")
+	}
+}
+
+func TestLockDaemon(t *testing.T) {
+	socket := filepath.Join(t.TempDir(), "daemon", "d.sock")
+
+	release, err := LockDaemon(socket)
+	if err != nil {
+		t.Fatal(err)
+	}
+	if fi, err := os.Stat(filepath.Dir(socket)); err != nil || fi.Mode().Perm() != 0700 {
+		t.Errorf("socket directory = %v, %v; want mode 0700", fi, err)
+	}
+	if _, err := LockDaemon(socket); !errors.Is(err, ErrDaemonRunning) {
+		t.Errorf("second LockDaemon = %v, want ErrDaemonRunning", err)
+	}
+
+	l, err := listenUnix(socket)
+	if err != nil {
+		t.Skipf("unix sockets not available: %v", err)
+	}
+	if fi, err := os.Stat(socket); err != nil || fi.Mode().Perm() != 0600 {
+		t.Errorf("socket = %v, %v; want mode 0600", fi, err)
+	}
+	l.Close()
+
+	release()
+	release, err = LockDaemon(socket)
+	if err != nil {
+		t.Fatalf("LockDaemon after release: %v", err)
+	}
+	release()
+}
@@ -0,0 +1,35 @@
+//go:build windows
+
+package mcp
+
+import (
+	"net"
+	"os"
+)
+
+// lockDaemon takes an exclusive lock so only one daemon per socket starts.
+// The lock file stays open while the daemon runs, so Windows refuses to
+// remove it; a stale one left by a crashed daemon is removed.
+func lockDaemon(path string) (func(), error) {
+	os.Remove(path)
+	f, err := os.OpenFile(path, os.O_CREATE|os.O_EXCL|os.O_RDWR, 0600)
+	if err != nil {
+		return nil, err
+	}
+	return func() {
+		f.Close()
+		os.Remove(path)
+	}, nil
+}
+
+// checkSocketDir accepts any directory; the socket directory lives in the
+// user's profile on Windows.
+func checkSocketDir(dir string) error {
+	_, err := os.Stat(dir)
+	return err
+}
+
+// listenUnix listens on the socket.
+func listenUnix(path string) (net.Listener, error) {
+	return net.Listen("unix", path)
+}
@@ -58,8 +58,7 @@ func (s *Server) handleGrepCode(ctx context.Context, req mcp.CallToolRequest) (*
 		}
 	}
 
-	jsonResult, _ := json.MarshalIndent(result, "", "  ")
-	return mcp.NewToolResultText(string(jsonResult)), nil
+	return s.jsonResult(result), nil
 }
 
 // grepWithRipgrep uses ripgrep (rg) for fast searching.
@@ -0,0 +1,426 @@
+package mcp
+
+import (
+	"bufio"
+	"bytes"
+	"context"
+	"encoding/json"
+	"errors"
+	"fmt"
+	"io"
+	"log/slog"
+	"net"
+	"net/http"
+	"path/filepath"
+	"strings"
+	"sync"
+	"time"
+)
+
+// daemonBaseURL is the URL of the daemon on its Unix socket; the host is
+// ignored by the socket dialer.
+const daemonBaseURL = "http://codewizard"
+
+// sessionHeader carries the MCP session ID of the streamable HTTP transport.
+const sessionHeader = "Mcp-Session-Id"
+
+// DaemonClient returns an HTTP client that talks to the daemon on a Unix
+// socket. It refuses sockets in a directory another user could control.
+func DaemonClient(socketPath string) *http.Client {
+	return &http.Client{
+		Transport: &http.Transport{
+			DialContext: func(ctx context.Context, _, _ string) (net.Conn, error) {
+				if err := checkSocketDir(filepath.Dir(socketPath)); err != nil {
+					return nil, err
+				}
+				var d net.Dialer
+				return d.DialContext(ctx, "unix", socketPath)
+			},
+			MaxIdleConnsPerHost: 4,
+		},
+	}
+}
+
+// DaemonAlive reports whether a daemon answers on the socket.
+func DaemonAlive(socketPath string) bool {
+	client := DaemonClient(socketPath)
+	client.Timeout = time.Second
+	defer client.CloseIdleConnections()
+
+	resp, err := client.Get(daemonBaseURL + daemonHealthPath)
+	if err != nil {
+		return false
+	}
+	resp.Body.Close()
+	return resp.StatusCode == http.StatusOK
+}
+
+// WaitForDaemon polls the socket until a daemon answers or timeout passes.
+func WaitForDaemon(socketPath string, timeout time.Duration) bool {
+	deadline := time.Now().Add(timeout)
+	for {
+		if DaemonAlive(socketPath) {
+			return true
+		}
+		if time.Now().After(deadline) {
+			return false
+		}
+		time.Sleep(100 * time.Millisecond)
+	}
+}
+
+// ErrNoDaemon is returned by CallDaemonTool when no daemon serves the
+// socket; the caller should run the tool in-process.
+var ErrNoDaemon = errors.New("no daemon running")
+
+// daemonCallRequest and daemonCallResponse are the body of the daemon's
+// call endpoint.
+type daemonCallRequest struct {
+	Tool      string         `json:"tool"`
+	Arguments map[string]any `json:"arguments,omitempty"`
+}
+
+type daemonCallResponse struct {
+	Blocks  []string `json:"blocks"`
+	Text    string   `json:"text,omitempty"` // Joined blocks, from older daemons
+	IsError bool     `json:"is_error,omitempty"`
+}
+
+// CallDaemonTool runs one tool on the daemon and returns the text blocks of
+// its result (see ToolResultTexts) and whether the tool reported an error.
+// It skips the MCP session handshake, so a CLI command costs one request on
+// a warm index.
+func CallDaemonTool(ctx context.Context, socketPath, tool string, args map[string]any) ([]string, bool, error) {
+	body, err := json.Marshal(daemonCallRequest{Tool: tool, Arguments: args})
+	if err != nil {
+		return nil, false, err
+	}
+
+	req, err := http.NewRequestWithContext(ctx, http.MethodPost, daemonBaseURL+daemonCallPath, bytes.NewReader(body))
+	if err != nil {
+		return nil, false, err
+	}
+	req.Header.Set("Content-Type", "application/json")
+
+	client := DaemonClient(socketPath)
+	defer client.CloseIdleConnections()
+
+	resp, err := client.Do(req)
+	if err != nil {
+		// Nothing reached a daemon, so the call is safe to run in-process
+		var opErr *net.OpError
+		if errors.As(err, &opErr) && opErr.Op == "dial" {
+			return nil, false, ErrNoDaemon
+		}
+		return nil, false, err
+	}
+	defer resp.Body.Close()
+
+	if resp.StatusCode == http.StatusNotFound {
+		// A daemon from an older binary without the call endpoint
+		return nil, false, ErrNoDaemon
+	}
+	if resp.StatusCode != http.StatusOK {
+		msg, _ := io.ReadAll(io.LimitReader(resp.Body, 4096))
+		return nil, false, fmt.Errorf("daemon returned %s: %s", resp.Status, strings.TrimSpace(string(msg)))
+	}
+
+	var result daemonCallResponse
+	if err := json.NewDecoder(resp.Body).Decode(&result); err != nil {
+		return nil, false, fmt.Errorf("failed to decode daemon response: %w", err)
+	}
+	if len(result.Blocks) == 0 && result.Text != "" {
+		result.Blocks = []string{result.Text}
+	}
+	return result.Blocks, result.IsError, nil
+}
+
+// jsonrpcEnvelope holds the fields the proxy needs to route a message.
+type jsonrpcEnvelope struct {
+	ID     json.RawMessage `json:"id,omitempty"`
+	Method string          `json:"method,omitempty"`
+	Params json.RawMessage `json:"params,omitempty"`
+}
+
+// stdioProxy relays newline-delimited JSON-RPC between stdio and the
+// daemon's streamable HTTP endpoint.
+type stdioProxy struct {
+	client *http.Client
+	url    string
+
+	outMu sync.Mutex
+	out   *bufio.Writer
+
+	sessionMu sync.Mutex
+	session   string
+
+	// Cancel functions of in-flight requests by JSON-RPC ID
+	inflightMu sync.Mutex
+	inflight   map[string]context.CancelFunc
+}
+
+// ProxyStdio relays MCP messages from stdin to the daemon on socketPath and
+// writes responses and server notifications to stdout, until stdin is
+// closed or ctx is cancelled.
+func ProxyStdio(ctx context.Context, socketPath string, stdin io.Reader, stdout io.Writer) error {
+	p := &stdioProxy{
+		client:   DaemonClient(socketPath),
+		url:      daemonBaseURL + DaemonEndpoint,
+		out:      bufio.NewWriter(stdout),
+		inflight: make(map[string]context.CancelFunc),
+	}
+	defer p.client.CloseIdleConnections()
+
+	ctx, cancel := context.WithCancel(ctx)
+	defer cancel()
+
+	reader := bufio.NewReaderSize(stdin, 64*1024)
+	var inflight sync.WaitGroup
+	var readErr error
+
+	for {
+		line, err := reader.ReadBytes('\n')
+		if msg := bytes.TrimSpace(line); len(msg) > 0 {
+			var env jsonrpcEnvelope
+			if jerr := json.Unmarshal(msg, &env); jerr != nil {
+				slog.Warn("proxy: invalid JSON-RPC message", "error", jerr)
+			} else if len(env.ID) > 0 && env.Method != "" && env.Method != "initialize" {
+				// Requests run concurrently so a slow tool call does not
+				// block the others
+				reqCtx := p.track(ctx, env.ID)
+				inflight.Add(1)
+				go func(msg []byte, env jsonrpcEnvelope) {
+					defer inflight.Done()
+					defer p.untrack(env.ID)
+					p.forward(reqCtx, msg, env)
+				}(append([]byte(nil), msg...), env)
+			} else {
+				if env.Method == "notifications/cancelled" {
+					// Dropping the HTTP request cancels the handler's
+					// context in the daemon
+					var params struct {
+						RequestID json.RawMessage `json:"requestId"`
+					}
+					if json.Unmarshal(env.Params, &params) == nil {
+						p.cancel(params.RequestID)
+					}
+				}
+				// initialize (which establishes the session), notifications
+				// and responses keep their order
+				p.forward(ctx, msg, env)
+			}
+		}
+		if err != nil {
+			if !errors.Is(err, io.EOF) {
+				readErr = err
+			}
+			break
+		}
+	}
+
+	inflight.Wait()
+	p.endSession()
+	return readErr
+}
+
+// track registers an in-flight request and returns its context.
+func (p *stdioProxy) track(ctx context.Context, id json.RawMessage) context.Context {
+	ctx, cancel := context.WithCancel(ctx)
+	p.inflightMu.Lock()
+	p.inflight[string(id)] = cancel
+	p.inflightMu.Unlock()
+	return ctx
+}
+
+func (p *stdioProxy) untrack(id json.RawMessage) {
+	p.inflightMu.Lock()
+	cancel := p.inflight[string(id)]
+	delete(p.inflight, string(id))
+	p.inflightMu.Unlock()
+	if cancel != nil {
+		cancel()
+	}
+}
+
+// cancel aborts an in-flight request. The client expects no reply.
+func (p *stdioProxy) cancel(id json.RawMessage) {
+	p.inflightMu.Lock()
+	cancel := p.inflight[string(id)]
+	p.inflightMu.Unlock()
+	if cancel != nil {
+		cancel()
+	}
+}
+
+// forward posts one message and relays the reply.
+func (p *stdioProxy) forward(ctx context.Context, msg []byte, env jsonrpcEnvelope) {
+	if err := p.post(ctx, msg); err != nil {
+		if errors.Is(err, context.Canceled) && ctx.Err() != nil {
+			return
+		}
+		slog.Warn("proxy: daemon request failed", "method", env.Method, "error", err)
+		if len(env.ID) > 0 && env.Method != "" {
+			p.writeError(env.ID, err)
+		}
+	}
+}
+
+func (p *stdioProxy) post(ctx context.Context, msg []byte) error {
+	req, err := http.NewRequestWithContext(ctx, http.MethodPost, p.url, bytes.NewReader(msg))
+	if err != nil {
+		return err
+	}
+	req.Header.Set("Content-Type", "application/json")
+	req.Header.Set("Accept", "application/json, text/event-stream")
+	if session := p.sessionID(); session != "" {
+		req.Header.Set(sessionHeader, session)
+	}
+
+	resp, err := p.client.Do(req)
+	if err != nil {
+		return err
+	}
+	defer resp.Body.Close()
+
+	if session := resp.Header.Get(sessionHeader); session != "" && p.setSession(session) {
+		go p.listen(ctx)
+	}
+
+	switch {
+	case resp.StatusCode == http.StatusAccepted || resp.StatusCode == http.StatusNoContent:
+		return nil
+	case resp.StatusCode >= 300:
+		body, _ := io.ReadAll(io.LimitReader(resp.Body, 4096))
+		return fmt.Errorf("daemon returned %s: %s", resp.Status, strings.TrimSpace(string(body)))
+	}
+
+	return p.relay(resp)
+}
+
+// listen relays server-initiated messages from the session's GET stream.
+// Servers that do not offer one simply reject the request.
+func (p *stdioProxy) listen(ctx context.Context) {
+	req, err := http.NewRequestWithContext(ctx, http.MethodGet, p.url, nil)
+	if err != nil {
+		return
+	}
+	req.Header.Set("Accept", "text/event-stream")
+	req.Header.Set(sessionHeader, p.sessionID())
+
+	resp, err := p.client.Do(req)
+	if err != nil {
+		return
+	}
+	defer resp.Body.Close()
+
+	if resp.StatusCode != http.StatusOK {
+		return
+	}
+	if err := p.relay(resp); err != nil && ctx.Err() == nil {
+		slog.Debug("proxy: notification stream closed", "error", err)
+	}
+}
+
+// relay writes the JSON-RPC messages of a response, either a single JSON
+// body or a server-sent event stream, to stdout.
+func (p *stdioProxy) relay(resp *http.Response) error {
+	if !strings.HasPrefix(resp.Header.Get("Content-Type"), "text/event-stream") {
+		body, err := io.ReadAll(resp.Body)
+		if err != nil {
+			return err
+		}
+		if len(bytes.TrimSpace(body)) > 0 {
+			p.write(body)
+		}
+		return nil
+	}
+
+	// SSE: messages are "data:" lines terminated by a blank line
+	scanner := bufio.NewScanner(resp.Body)
+	scanner.Buffer(make([]byte, 64*1024), 64*1024*1024)
+	var data bytes.Buffer
+	for scanner.Scan() {
+		line := scanner.Bytes()
+		if len(line) == 0 {
+			if data.Len() > 0 {
+				p.write(data.Bytes())
+				data.Reset()
+			}
+			continue
+		}
+		if payload, ok := bytes.CutPrefix(line, []byte("data:")); ok {
+			if data.Len() > 0 {
+				data.WriteByte('\n')
+			}
+			data.Write(bytes.TrimPrefix(payload, []byte(" ")))
+		}
+	}
+	if data.Len() > 0 {
+		p.write(data.Bytes())
+	}
+	return scanner.Err()
+}
+
+// write emits one message as a single stdout line.
+func (p *stdioProxy) write(msg []byte) {
+	var compact bytes.Buffer
+	if err := json.Compact(&compact, msg); err != nil {
+		slog.Warn("proxy: invalid message from daemon", "error", err)
+		return
+	}
+
+	p.outMu.Lock()
+	defer p.outMu.Unlock()
+	compact.WriteByte('\n')
+	p.out.Write(compact.Bytes())
+	p.out.Flush()
+}
+
+// writeError answers a request the daemon could not handle.
+func (p *stdioProxy) writeError(id json.RawMessage, err error) {
+	msg, _ := json.Marshal(map[string]any{
+		"jsonrpc": "2.0",
+		"id":      id,
+		"error": map[string]any{
+			"code":    -32603,
+			"message": "mcp-codewizard daemon unavailable: " + err.Error(),
+		},
+	})
+	p.write(msg)
+}
+
+func (p *stdioProxy) sessionID() string {
+	p.sessionMu.Lock()
+	defer p.sessionMu.Unlock()
+	return p.session
+}
+
+// setSession records the session ID and reports whether it is new.
+func (p *stdioProxy) setSession(id string) bool {
+	p.sessionMu.Lock()
+	defer p.sessionMu.Unlock()
+	if p.session == id {
+		return false
+	}
+	p.session = id
+	return true
+}
+
+// endSession tells the daemon the client is gone.
+func (p *stdioProxy) endSession() {
+	session := p.sessionID()
+	if session == "" {
+		return
+	}
+
+	ctx, cancel := context.WithTimeout(context.Background(), time.Second)
+	defer cancel()
+	req, err := http.NewRequestWithContext(ctx, http.MethodDelete, p.url, nil)
+	if err != nil {
+		return
+	}
+	req.Header.Set(sessionHeader, session)
+	if resp, err := p.client.Do(req); err == nil {
+		resp.Body.Close()
+	}
+}
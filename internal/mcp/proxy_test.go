@@ -0,0 +1,246 @@
+package mcp
+
+import (
+	"bytes"
+	"context"
+	"encoding/json"
+	"io"
+	"net"
+	"net/http"
+	"os"
+	"path/filepath"
+	"strings"
+	"sync/atomic"
+	"testing"
+
+	"github.com/spetr/mcp-codewizard/internal/config"
+)
+
+// fakeDaemonState records what the fake daemon saw.
+type fakeDaemonState struct {
+	ended     atomic.Bool // Session was deleted
+	started   atomic.Bool // A "slow" request arrived
+	cancelled atomic.Bool // A "slow" request was dropped by the client
+}
+
+// fakeDaemon serves a minimal streamable HTTP endpoint on a Unix socket.
+func fakeDaemon(t *testing.T) (string, *fakeDaemonState) {
+	t.Helper()
+
+	socket := filepath.Join(t.TempDir(), "d.sock")
+	l, err := net.Listen("unix", socket)
+	if err != nil {
+		t.Skipf("unix sockets not available: %v", err)
+	}
+
+	state := &fakeDaemonState{}
+	mux := http.NewServeMux()
+	mux.HandleFunc(daemonHealthPath, func(w http.ResponseWriter, r *http.Request) {
+		w.Write([]byte(`{}`))
+	})
+	mux.HandleFunc(daemonCallPath, func(w http.ResponseWriter, r *http.Request) {
+		var call daemonCallRequest
+		json.NewDecoder(r.Body).Decode(&call)
+		json.NewEncoder(w).Encode(daemonCallResponse{
+			Blocks:  []string{call.Tool + ":" + call.Arguments["query"].(string)},
+			IsError: call.Tool != "search_code",
+		})
+	})
+	mux.HandleFunc(DaemonEndpoint, func(w http.ResponseWriter, r *http.Request) {
+		switch r.Method {
+		case http.MethodGet:
+			w.WriteHeader(http.StatusMethodNotAllowed)
+			return
+		case http.MethodDelete:
+			state.ended.Store(r.Header.Get(sessionHeader) == "s1")
+			return
+		}
+
+		var msg struct {
+			ID     json.RawMessage `json:"id"`
+			Method string          `json:"method"`
+		}
+		body, _ := io.ReadAll(r.Body)
+		json.Unmarshal(body, &msg)
+
+		switch {
+		case msg.Method == "initialize":
+			w.Header().Set(sessionHeader, "s1")
+			w.Header().Set("Content-Type", "application/json")
+			w.Write([]byte(`{"jsonrpc":"2.0","id":` + string(msg.ID) + `,"result":{"protocolVersion":"2025-03-26"}}`))
+		case r.Header.Get(sessionHeader) != "s1":
+			http.Error(w, "missing session", http.StatusBadRequest)
+		case len(msg.ID) == 0:
+			w.WriteHeader(http.StatusAccepted)
+		case msg.Method == "slow":
+			state.started.Store(true)
+			<-r.Context().Done()
+			state.cancelled.Store(true)
+		default:
+			// Streamed response: a progress notification, then the result
+			w.Header().Set("Content-Type", "text/event-stream")
+			w.Write([]byte("event: message\ndata: {\"jsonrpc\":\"2.0\",\"method\":\"notifications/progress\"}\n\n"))
+			w.Write([]byte("event: message\ndata: {\"jsonrpc\":\"2.0\",\n"))
+			w.Write([]byte("data:  \"id\":" + string(msg.ID) + ",\"result\":{}}\n\n"))
+		}
+	})
+
+	srv := &http.Server{Handler: mux}
+	go srv.Serve(l)
+	t.Cleanup(func() { srv.Close() })
+
+	return socket, state
+}
+
+func TestProxyStdio(t *testing.T) {
+	socket, state := fakeDaemon(t)
+
+	if !DaemonAlive(socket) {
+		t.Fatal("DaemonAlive = false, want true")
+	}
+	if DaemonAlive(filepath.Join(t.TempDir(), "missing.sock")) {
+		t.Error("DaemonAlive on a missing socket = true, want false")
+	}
+
+	stdin := strings.NewReader(strings.Join([]string{
+		`{"jsonrpc":"2.0","id":1,"method":"initialize","params":{}}`,
+		`{"jsonrpc":"2.0","method":"notifications/initialized"}`,
+		`{"jsonrpc":"2.0","id":2,"method":"tools/call","params":{"name":"search_code"}}`,
+	}, "\n") + "\n")
+	var stdout bytes.Buffer
+
+	if err := ProxyStdio(context.Background(), socket, stdin, &stdout); err != nil {
+		t.Fatalf("ProxyStdio failed: %v", err)
+	}
+
+	lines := strings.Split(strings.TrimSpace(stdout.String()), "\n")
+	want := []string{
+		`{"jsonrpc":"2.0","id":1,"result":{"protocolVersion":"2025-03-26"}}`,
+		`{"jsonrpc":"2.0","method":"notifications/progress"}`,
+		`{"jsonrpc":"2.0","id":2,"result":{}}`,
+	}
+	if strings.Join(lines, "\n") != strings.Join(want, "\n") {
+		t.Errorf("proxy output:\n%s\nwant:\n%s", strings.Join(lines, "\n"), strings.Join(want, "\n"))
+	}
+	if !state.ended.Load() {
+		t.Error("session was not ended when stdin closed")
+	}
+}
+
+func TestProxyStdioDaemonGone(t *testing.T) {
+	socket := filepath.Join(t.TempDir(), "missing.sock")
+	stdin := strings.NewReader(`{"jsonrpc":"2.0","id":7,"method":"tools/list"}` + "\n")
+	var stdout bytes.Buffer
+
+	if err := ProxyStdio(context.Background(), socket, stdin, &stdout); err != nil {
+		t.Fatalf("ProxyStdio failed: %v", err)
+	}
+
+	var resp struct {
+		ID    int `json:"id"`
+		Error struct {
+			Code int `json:"code"`
+		} `json:"error"`
+	}
+	if err := json.Unmarshal(stdout.Bytes(), &resp); err != nil {
+		t.Fatalf("invalid error response %q: %v", stdout.String(), err)
+	}
+	if resp.ID != 7 || resp.Error.Code != -32603 {
+		t.Errorf("error response = %+v, want id 7 with code -32603", resp)
+	}
+}
+
+func TestProxyStdioCancel(t *testing.T) {
+	socket, state := fakeDaemon(t)
+
+	stdin, input := io.Pipe()
+	var stdout bytes.Buffer
+	done := make(chan error, 1)
+	go func() {
+		done <- ProxyStdio(context.Background(), socket, stdin, &stdout)
+	}()
+
+	io.WriteString(input, `{"jsonrpc":"2.0","id":1,"method":"initialize","params":{}}`+"\n")
+	io.WriteString(input, `{"jsonrpc":"2.0","id":9,"method":"slow","params":{}}`+"\n")
+	waitFor(t, state.started.Load)
+	io.WriteString(input, `{"jsonrpc":"2.0","method":"notifications/cancelled","params":{"requestId":9}}`+"\n")
+	waitFor(t, state.cancelled.Load)
+	input.Close()
+
+	if err := <-done; err != nil {
+		t.Fatalf("ProxyStdio failed: %v", err)
+	}
+	if strings.Contains(stdout.String(), `"id":9`) {
+		t.Errorf("cancelled request was answered: %s", stdout.String())
+	}
+}
+
+func TestCallDaemonTool(t *testing.T) {
+	socket, _ := fakeDaemon(t)
+	ctx := context.Background()
+
+	blocks, isError, err := CallDaemonTool(ctx, socket, "search_code", map[string]any{"query": "auth"})
+	if err != nil {
+		t.Fatalf("CallDaemonTool: %v", err)
+	}
+	if len(blocks) != 1 || blocks[0] != "search_code:auth" || isError {
+		t.Errorf("CallDaemonTool = %q, %v; want [search_code:auth], false", blocks, isError)
+	}
+
+	if _, isError, _ := CallDaemonTool(ctx, socket, "grep_code", map[string]any{"query": "x"}); !isError {
+		t.Error("tool error not reported")
+	}
+
+	_, _, err = CallDaemonTool(ctx, filepath.Join(t.TempDir(), "missing.sock"), "search_code", nil)
+	if err != ErrNoDaemon {
+		t.Errorf("CallDaemonTool without daemon: err = %v, want ErrNoDaemon", err)
+	}
+}
+
+func TestCallDaemonToolOverBudget(t *testing.T) {
+	projectDir := t.TempDir()
+	var content strings.Builder
+	for i := 0; i < 200; i++ {
+		content.WriteString("needle := \"a line long enough to fill the response budget quickly\"\n")
+	}
+	if err := os.WriteFile(filepath.Join(projectDir, "big.go"), []byte(content.String()), 0644); err != nil {
+		t.Fatal(err)
+	}
+
+	cfg := config.DefaultConfig()
+	cfg.MCP.MaxResponseBytes = 4096
+	s := &Server{projectDir: projectDir, config: cfg, sched: newScheduler()}
+
+	socket := filepath.Join(t.TempDir(), "d.sock")
+	l, err := net.Listen("unix", socket)
+	if err != nil {
+		t.Skipf("unix sockets not available: %v", err)
+	}
+	mux := http.NewServeMux()
+	mux.HandleFunc(daemonCallPath, s.handleDaemonCall)
+	srv := &http.Server{Handler: mux}
+	go srv.Serve(l)
+	t.Cleanup(func() { srv.Close() })
+
+	blocks, isError, err := CallDaemonTool(context.Background(), socket, "grep_code", map[string]any{
+		"pattern": "needle", "max_results": 200, "context_lines": 0, "indexed_only": false,
+	})
+	if err != nil || isError {
+		t.Fatalf("CallDaemonTool = %q, %v, %v", blocks, isError, err)
+	}
+
+	// The JSON result and the truncation note arrive as separate blocks
+	if len(blocks) != 2 {
+		t.Fatalf("got %d blocks, want the result and a note", len(blocks))
+	}
+	var result GrepResult
+	if err := json.Unmarshal([]byte(blocks[0]), &result); err != nil {
+		t.Fatalf("first block is not the JSON result: %v", err)
+	}
+	if len(result.Matches) == 0 || len(result.Matches) >= 200 {
+		t.Errorf("%d matches in the truncated result", len(result.Matches))
+	}
+	if !strings.HasPrefix(blocks[1], "[truncated") {
+		t.Errorf("note = %q", blocks[1])
+	}
+}
@@ -0,0 +1,267 @@
+package mcp
+
+import (
+	"bytes"
+	"encoding/json"
+	"fmt"
+	"reflect"
+	"strings"
+	"sync"
+
+	"github.com/mark3labs/mcp-go/mcp"
+)
+
+// Tool results are encoded as compact JSON through pooled buffers. Indented
+// output is available with mcp.pretty_json for people reading raw
+// responses; agents do not need it.
+//
+// Responses are capped at a byte budget (mcp.max_response_bytes). A result
+// over the budget loses trailing items of its longest list until it fits,
+// and a second text block tells the client how much was left out, so the
+// JSON stays valid and keeps its shape.
+
+// defaultMaxResponseBytes is the response budget when none is configured.
+const defaultMaxResponseBytes = 512 << 10
+
+// maxPooledBuffer keeps buffers of rare huge responses out of the pool.
+const maxPooledBuffer = 4 << 20
+
+// jsonBuffer is a pooled buffer with an encoder writing into it.
+type jsonBuffer struct {
+	bytes.Buffer
+	enc *json.Encoder
+}
+
+var jsonBufferPool = sync.Pool{
+	New: func() any {
+		b := &jsonBuffer{}
+		b.enc = json.NewEncoder(&b.Buffer)
+		// Code is full of <, > and &; escaping them only inflates results
+		b.enc.SetEscapeHTML(false)
+		return b
+	},
+}
+
+func getJSONBuffer() *jsonBuffer {
+	return jsonBufferPool.Get().(*jsonBuffer)
+}
+
+func putJSONBuffer(b *jsonBuffer) {
+	if b.Cap() > maxPooledBuffer {
+		return
+	}
+	b.Reset()
+	jsonBufferPool.Put(b)
+}
+
+// encode replaces the buffer contents with the compact encoding of v.
+func (b *jsonBuffer) encode(v any) error {
+	b.Reset()
+	if err := b.enc.Encode(v); err != nil {
+		return err
+	}
+	b.Truncate(b.Len() - 1) // Encoder terminates values with a newline
+	return nil
+}
+
+// jsonResult encodes v as the text of a tool result, within the response
+// budget.
+func (s *Server) jsonResult(v any) *mcp.CallToolResult {
+	buf := getJSONBuffer()
+	defer putJSONBuffer(buf)
+
+	if err := buf.encode(v); err != nil {
+		return mcp.NewToolResultError(fmt.Sprintf("failed to encode result: %v", err))
+	}
+
+	note := ""
+	if budget := s.responseBudget(); budget > 0 && buf.Len() > budget {
+		note = fitBudget(buf, v, budget)
+	}
+
+	text := s.formatJSON(buf)
+	if note == "" {
+		return mcp.NewToolResultText(text)
+	}
+	return &mcp.CallToolResult{
+		Content: []mcp.Content{mcp.NewTextContent(text), mcp.NewTextContent(note)},
+	}
+}
+
+// formatJSON returns the buffer as text, indented if configured.
+func (s *Server) formatJSON(buf *jsonBuffer) string {
+	if s.config == nil || !s.config.MCP.PrettyJSON {
+		return buf.String()
+	}
+
+	pretty := getJSONBuffer()
+	defer putJSONBuffer(pretty)
+	if err := json.Indent(&pretty.Buffer, buf.Bytes(), "", "  "); err != nil {
+		return buf.String()
+	}
+	return pretty.String()
+}
+
+// responseBudget returns the maximum response size in bytes, 0 for none.
+func (s *Server) responseBudget() int {
+	if s.config == nil || s.config.MCP.MaxResponseBytes == 0 {
+		return defaultMaxResponseBytes
+	}
+	if s.config.MCP.MaxResponseBytes < 0 {
+		return 0
+	}
+	return s.config.MCP.MaxResponseBytes
+}
+
+// fitBudget re-encodes v into buf with its longest list shortened to the
+// most items that fit the budget, and returns a note for the client. A
+// result without a list is left whole.
+func fitBudget(buf *jsonBuffer, v any, budget int) string {
+	size := buf.Len()
+	list := longestList(v)
+	if list == nil {
+		return fmt.Sprintf("[response is %d bytes, over the %d byte budget]", size, budget)
+	}
+
+	total := list.len()
+	best := -1
+	lo, hi := 0, total-1
+	// The first probe assumes bytes grow linearly with items
+	mid := min(total*budget/size, hi)
+	for lo <= hi {
+		if err := buf.encode(list.cut(mid)); err == nil && buf.Len() <= budget {
+			best = mid
+			lo = mid + 1
+		} else {
+			hi = mid - 1
+		}
+		mid = lo + (hi-lo)/2
+	}
+
+	if best < 0 {
+		best = 0
+	}
+	if err := buf.encode(list.cut(best)); err != nil {
+		buf.encode(v)
+		return fmt.Sprintf("[response is %d bytes, over the %d byte budget]", size, budget)
+	}
+
+	return fmt.Sprintf("[truncated: showing %d of %d %s to stay within %d bytes; narrow the query or lower the limit]",
+		best, total, list.name, budget)
+}
+
+// resultList is a list inside a result that can be shortened.
+type resultList struct {
+	name string
+	size int
+	cut  func(n int) any // Returns the result with the list cut to n items
+}
+
+func (l *resultList) len() int {
+	return l.size
+}
+
+// listTrimmer is implemented by results whose bulk is not a list at their
+// top level, such as the nested nodes of a tree.
+type listTrimmer interface {
+	trimList() *resultList
+}
+
+// longestList finds the longest list of a result: the result itself, or a
+// field or map entry at its top level. Results that implement listTrimmer
+// provide their own.
+func longestList(v any) *resultList {
+	if t, ok := v.(listTrimmer); ok {
+		return t.trimList()
+	}
+
+	rv := reflect.ValueOf(v)
+	for rv.Kind() == reflect.Pointer || rv.Kind() == reflect.Interface {
+		if rv.IsNil() {
+			return nil
+		}
+		rv = rv.Elem()
+	}
+
+	switch rv.Kind() {
+	case reflect.Slice:
+		if rv.Len() < 2 {
+			return nil
+		}
+		return &resultList{
+			name: "items",
+			size: rv.Len(),
+			cut:  func(n int) any { return rv.Slice(0, n).Interface() },
+		}
+
+	case reflect.Map:
+		if rv.Type().Key().Kind() != reflect.String {
+			return nil
+		}
+		var longest *resultList
+		iter := rv.MapRange()
+		for iter.Next() {
+			val := iter.Value()
+			if val.Kind() == reflect.Interface {
+				val = val.Elem()
+			}
+			if val.Kind() != reflect.Slice || val.Len() < 2 || (longest != nil && val.Len() <= longest.len()) {
+				continue
+			}
+			key, slice := iter.Key(), val
+			longest = &resultList{
+				name: key.String(),
+				size: slice.Len(),
+				cut: func(n int) any {
+					// Copy the map so the caller's result is not modified
+					cp := reflect.MakeMapWithSize(rv.Type(), rv.Len())
+					it := rv.MapRange()
+					for it.Next() {
+						cp.SetMapIndex(it.Key(), it.Value())
+					}
+					cp.SetMapIndex(key, slice.Slice(0, n))
+					return cp.Interface()
+				},
+			}
+		}
+		return longest
+
+	case reflect.Struct:
+		var longest *resultList
+		for i := 0; i < rv.NumField(); i++ {
+			field := rv.Type().Field(i)
+			val := rv.Field(i)
+			if !field.IsExported() {
+				continue
+			}
+			if val.Kind() == reflect.Interface {
+				val = val.Elem()
+			}
+			if val.Kind() != reflect.Slice || val.Len() < 2 || (longest != nil && val.Len() <= longest.len()) {
+				continue
+			}
+			index, slice := i, val
+			longest = &resultList{
+				name: jsonFieldName(field),
+				size: slice.Len(),
+				cut: func(n int) any {
+					cp := reflect.New(rv.Type()).Elem()
+					cp.Set(rv)
+					cp.Field(index).Set(slice.Slice(0, n))
+					return cp.Interface()
+				},
+			}
+		}
+		return longest
+	}
+
+	return nil
+}
+
+// jsonFieldName returns the JSON name of a struct field.
+func jsonFieldName(f reflect.StructField) string {
+	if tag, _, _ := strings.Cut(f.Tag.Get("json"), ","); tag != "" && tag != "-" {
+		return tag
+	}
+	return f.Name
+}
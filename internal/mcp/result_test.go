@@ -0,0 +1,298 @@
+package mcp
+
+import (
+	"encoding/json"
+	"fmt"
+	"strings"
+	"testing"
+
+	"github.com/mark3labs/mcp-go/mcp"
+
+	"github.com/spetr/mcp-codewizard/internal/config"
+)
+
+func newResultServer(maxBytes int, pretty bool) *Server {
+	cfg := &config.Config{}
+	cfg.MCP.MaxResponseBytes = maxBytes
+	cfg.MCP.PrettyJSON = pretty
+	return &Server{config: cfg}
+}
+
+// resultJSON returns the JSON block of a tool result and the note, if any.
+func resultJSON(t *testing.T, result *mcp.CallToolResult) (string, string) {
+	t.Helper()
+	if result.IsError {
+		t.Fatalf("unexpected error result: %s", ToolResultText(result))
+	}
+	var texts []string
+	for _, c := range result.Content {
+		texts = append(texts, ToolResultText(&mcp.CallToolResult{Content: []mcp.Content{c}}))
+	}
+	switch len(texts) {
+	case 1:
+		return texts[0], ""
+	case 2:
+		return texts[0], texts[1]
+	}
+	t.Fatalf("unexpected %d content blocks", len(texts))
+	return "", ""
+}
+
+func testSymbols(n int) []symbolResult {
+	symbols := make([]symbolResult, n)
+	for i := range symbols {
+		symbols[i] = symbolResult{
+			ID:         fmt.Sprintf("sym-%d", i),
+			Name:       fmt.Sprintf("Handler%d", i),
+			Kind:       "function",
+			File:       "internal/mcp/server.go",
+			StartLine:  i * 10,
+			EndLine:    i*10 + 8,
+			LineCount:  9,
+			Signature:  fmt.Sprintf("func Handler%d(ctx context.Context) error", i),
+			Visibility: "public",
+		}
+	}
+	return symbols
+}
+
+func TestJSONResultCompact(t *testing.T) {
+	s := newResultServer(0, false)
+	text, note := resultJSON(t, s.jsonResult(map[string]any{"code": "a < b && c > d"}))
+	if note != "" {
+		t.Errorf("unexpected note %q", note)
+	}
+	if text != `{"code":"a < b && c > d"}` {
+		t.Errorf("got %s", text)
+	}
+}
+
+func TestJSONResultPretty(t *testing.T) {
+	s := newResultServer(0, true)
+	text, _ := resultJSON(t, s.jsonResult(map[string]any{"count": 1}))
+	if text != "{\n  \"count\": 1\n}" {
+		t.Errorf("got %q", text)
+	}
+}
+
+func TestJSONResultTruncatesSlice(t *testing.T) {
+	symbols := testSymbols(200)
+	full, _ := json.Marshal(symbols)
+	budget := len(full) / 4
+
+	s := newResultServer(budget, false)
+	text, note := resultJSON(t, s.jsonResult(symbols))
+	if len(text) > budget {
+		t.Errorf("result is %d bytes, budget %d", len(text), budget)
+	}
+
+	var got []symbolResult
+	if err := json.Unmarshal([]byte(text), &got); err != nil {
+		t.Fatalf("truncated result is not valid JSON: %v", err)
+	}
+	if len(got) == 0 || len(got) >= len(symbols) {
+		t.Fatalf("kept %d of %d items", len(got), len(symbols))
+	}
+	// The most items that fit are kept
+	next, _ := json.Marshal(symbols[:len(got)+1])
+	if len(next) <= budget {
+		t.Errorf("kept %d items but %d fit", len(got), len(got)+1)
+	}
+	if want := fmt.Sprintf("showing %d of %d items", len(got), len(symbols)); !strings.Contains(note, want) {
+		t.Errorf("note %q does not contain %q", note, want)
+	}
+}
+
+func TestJSONResultTruncatesStructField(t *testing.T) {
+	todos := make([]todoListItem, 100)
+	for i := range todos {
+		todos[i] = todoListItem{ID: fmt.Sprintf("todo-%d", i), Title: strings.Repeat("x", 100)}
+	}
+	response := todoListResponse{Channel: "default", Count: len(todos), Todos: todos}
+
+	s := newResultServer(2000, false)
+	text, note := resultJSON(t, s.jsonResult(response))
+
+	var got todoListResponse
+	if err := json.Unmarshal([]byte(text), &got); err != nil {
+		t.Fatalf("truncated result is not valid JSON: %v", err)
+	}
+	if got.Channel != "default" || got.Count != len(todos) {
+		t.Errorf("other fields changed: %+v", got)
+	}
+	if len(got.Todos) == 0 || len(got.Todos) >= len(todos) {
+		t.Errorf("kept %d of %d todos", len(got.Todos), len(todos))
+	}
+	if !strings.Contains(note, "todos") {
+		t.Errorf("note %q does not name the list", note)
+	}
+	if len(response.Todos) != len(todos) {
+		t.Error("truncation modified the caller's result")
+	}
+}
+
+func TestJSONResultTruncatesMapEntry(t *testing.T) {
+	results := testSymbols(100)
+	response := map[string]any{"query": "handler", "results": results, "tags": []string{"a", "b"}}
+
+	s := newResultServer(1500, false)
+	text, note := resultJSON(t, s.jsonResult(response))
+
+	var got struct {
+		Query   string         `json:"query"`
+		Results []symbolResult `json:"results"`
+		Tags    []string       `json:"tags"`
+	}
+	if err := json.Unmarshal([]byte(text), &got); err != nil {
+		t.Fatalf("truncated result is not valid JSON: %v", err)
+	}
+	if got.Query != "handler" || len(got.Tags) != 2 {
+		t.Errorf("other entries changed: %+v", got)
+	}
+	if len(got.Results) >= len(results) {
+		t.Errorf("results were not truncated")
+	}
+	if !strings.Contains(note, "results") {
+		t.Errorf("note %q does not name the list", note)
+	}
+	if len(response["results"].([]symbolResult)) != len(results) {
+		t.Error("truncation modified the caller's result")
+	}
+}
+
+func TestJSONResultUnlimited(t *testing.T) {
+	symbols := testSymbols(200)
+	s := newResultServer(-1, false)
+	text, note := resultJSON(t, s.jsonResult(symbols))
+	if note != "" {
+		t.Errorf("unexpected note %q", note)
+	}
+	var got []symbolResult
+	if err := json.Unmarshal([]byte(text), &got); err != nil || len(got) != len(symbols) {
+		t.Errorf("got %d items, err %v", len(got), err)
+	}
+}
+
+// benchmarkPayloads are typical responses of the most used tools.
+func benchmarkPayloads() map[string]any {
+	content := strings.Repeat("\tif err != nil && len(x) > 0 {\n\t\treturn err\n\t}\n", 10)
+
+	search := make([]searchCodeResult, 10)
+	for i := range search {
+		search[i] = searchCodeResult{ID: fmt.Sprintf("chunk-%d", i), File: "internal/mcp/server.go", StartLine: i * 40,
+			EndLine: i*40 + 30, Language: "go", Type: "function", Name: fmt.Sprintf("handle%d", i), Score: 0.8, Content: content}
+	}
+	refs := make([]referenceResult, 50)
+	for i := range refs {
+		refs[i] = referenceResult{From: fmt.Sprintf("pkg.Caller%d", i), File: "internal/mcp/router.go", Line: i, Kind: "call"}
+	}
+	history := historyResponse{Query: "fix race", Results: make([]historyResult, 10)}
+	for i := range history.Results {
+		history.Results[i] = historyResult{Score: 0.7, CommitHash: "699c824", CommitDate: "2026-10-17 12:00", Author: "dev",
+			Message: "Fix race in watcher", File: "internal/watcher/watcher.go", ChangeType: "modify", Additions: 12,
+			Deletions: 3, AffectedFunctions: []string{"Start", "Stop"}, Diff: content}
+	}
+	recall := memoryRecallResponse{Query: "conventions", Channel: "default", Memories: make([]recalledMemory, 10)}
+	for i := range recall.Memories {
+		recall.Memories[i] = recalledMemory{ID: fmt.Sprintf("mem-%d", i), Content: "Errors are wrapped with fmt.Errorf and %w",
+			Category: "convention", Importance: 0.8, Confidence: 0.9, Score: 0.75, CreatedAt: "2026-10-17 12:00", Tags: []string{"go"}}
+	}
+	todos := todoListResponse{Channel: "default", Todos: make([]todoListItem, 20)}
+	for i := range todos.Todos {
+		todos.Todos[i] = todoListItem{ID: fmt.Sprintf("todo-%d", i), Title: "Add tests for the scheduler", Status: "pending", Priority: "medium"}
+	}
+	grep := GrepResult{Backend: "ripgrep", Matches: make([]GrepMatch, 50)}
+	for i := range grep.Matches {
+		grep.Matches[i] = GrepMatch{File: "internal/mcp/server.go", Line: i * 7, Content: "\treturn s.jsonResult(response), nil"}
+	}
+	root := &TreeNode{Name: ".", Type: "directory", Path: "."}
+	for i := 0; i < 10; i++ {
+		dir := &TreeNode{Name: fmt.Sprintf("pkg%d", i), Type: "directory", Path: fmt.Sprintf("pkg%d", i)}
+		for j := 0; j < 10; j++ {
+			dir.Children = append(dir.Children, &TreeNode{Name: fmt.Sprintf("file%d.go", j), Type: "file",
+				Path: fmt.Sprintf("pkg%d/file%d.go", i, j), Size: 4096, Language: "go", Indexed: true})
+		}
+		root.Children = append(root.Children, dir)
+	}
+
+	return map[string]any{
+		"search_code":      search,
+		"get_chunk":        chunkResult{ID: "chunk-1", File: "internal/mcp/server.go", StartLine: 1, EndLine: 30, Language: "go", Type: "function", Name: "handle", Content: content},
+		"get_callers":      refs,
+		"get_callees":      refs,
+		"get_symbols":      testSymbols(50),
+		"search_history":   history,
+		"memory_recall":    recall,
+		"todo_list":        todos,
+		"grep_code":        grep,
+		"get_project_tree": TreeResult{Root: root, TotalFiles: 100, TotalDirs: 10, Indexed: 100},
+	}
+}
+
+// BenchmarkToolResult compares the previous indented encoding with
+// jsonResult for the most used tools.
+func BenchmarkToolResult(b *testing.B) {
+	s := newResultServer(0, false)
+	for name, payload := range benchmarkPayloads() {
+		payload := payload
+		b.Run(name+"/indent", func(b *testing.B) {
+			b.ReportAllocs()
+			for i := 0; i < b.N; i++ {
+				data, _ := json.MarshalIndent(payload, "", "  ")
+				_ = mcp.NewToolResultText(string(data))
+			}
+		})
+		b.Run(name+"/compact", func(b *testing.B) {
+			b.ReportAllocs()
+			for i := 0; i < b.N; i++ {
+				_ = s.jsonResult(payload)
+			}
+		})
+	}
+}
+
+func TestJSONResultTruncatesTree(t *testing.T) {
+	root := &TreeNode{Name: "project", Type: "directory"}
+	for d := 0; d < 10; d++ {
+		dir := &TreeNode{Name: fmt.Sprintf("pkg%d", d), Type: "directory", Path: fmt.Sprintf("pkg%d", d), FileCount: 20}
+		for f := 0; f < 20; f++ {
+			dir.Children = append(dir.Children, &TreeNode{
+				Name: fmt.Sprintf("file%d.go", f), Type: "file",
+				Path: fmt.Sprintf("pkg%d/file%d.go", d, f), Language: "go", Size: 1024,
+			})
+		}
+		root.Children = append(root.Children, dir)
+	}
+	tree := &TreeResult{Root: root, TotalFiles: 200, TotalDirs: 11}
+	full, _ := json.Marshal(tree)
+	budget := len(full) / 4
+
+	s := newResultServer(budget, false)
+	text, note := resultJSON(t, s.jsonResult(tree))
+	if len(text) > budget {
+		t.Errorf("result is %d bytes, budget %d", len(text), budget)
+	}
+
+	var got TreeResult
+	if err := json.Unmarshal([]byte(text), &got); err != nil {
+		t.Fatalf("truncated tree is not valid JSON: %v", err)
+	}
+	if !got.Truncated || got.TotalFiles != 200 {
+		t.Errorf("truncated = %v, total files = %d", got.Truncated, got.TotalFiles)
+	}
+	// Breadth-first: the top level is kept whole before deeper nodes
+	if len(got.Root.Children) != 10 {
+		t.Errorf("kept %d of 10 top-level directories", len(got.Root.Children))
+	}
+	kept := countTreeNodes(got.Root) - 1
+	if kept <= 10 || kept >= 210 {
+		t.Errorf("kept %d of 210 nodes", kept)
+	}
+	if want := fmt.Sprintf("showing %d of 210 tree nodes", kept); !strings.Contains(note, want) {
+		t.Errorf("note %q does not contain %q", note, want)
+	}
+	// The caller's tree is not modified
+	if len(root.Children[9].Children) != 20 {
+		t.Error("original tree was pruned")
+	}
+}
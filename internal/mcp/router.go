@@ -3,7 +3,6 @@ package mcp
 
 import (
 	"context"
-	"encoding/json"
 	"fmt"
 	"sort"
 	"strings"
@@ -60,7 +59,7 @@ var toolCategories = []ToolCategory{
 			{Name: "get_status", Description: "[DIRECT] Is codebase indexed? How many files?", Required: nil, Optional: nil},
 			{Name: "get_file_summary", Description: "What's in this file? Imports, exports, functions, complexity", Required: []string{"file"}, Optional: []string{"quick"}},
 			{Name: "get_project_tree", Description: "Directory structure as tree (json/text/markdown)", Optional: []string{"path", "depth", "include_files", "format"}},
-			{Name: "index_codebase", Description: "Index/reindex the codebase for search", Optional: []string{"force", "ignore_patterns", "custom_extensions"}},
+			{Name: "index_codebase", Description: "Index/reindex the codebase for search", Optional: []string{"force", "ignore_patterns", "custom_extensions", "revision"}},
 			{Name: "clear_index", Description: "Delete the entire index", Required: nil, Optional: nil},
 		},
 	},
@@ -84,7 +83,7 @@ var toolCategories = []ToolCategory{
 		Description: "Additional memory operations (store/recall are direct)",
 		Tools: []ToolInfo{
 			{Name: "memory_store", Description: "[DIRECT] Store knowledge for future sessions", Required: []string{"content"}, Optional: []string{"category", "tags", "importance", "channel", "ttl_days"}},
-			{Name: "memory_recall", Description: "[DIRECT] Search stored memories", Required: []string{"query"}, Optional: []string{"limit", "channel", "categories", "tags", "min_importance"}},
+			{Name: "memory_recall", Description: "[DIRECT] Search stored memories", Required: []string{"query"}, Optional: []string{"limit", "channel", "categories", "tags", "min_importance", "min_confidence"}},
 			{Name: "memory_forget", Description: "Delete a specific memory by ID", Required: []string{"id"}},
 			{Name: "memory_checkpoint", Description: "Save snapshot of all memories", Required: []string{"name"}, Optional: []string{"description", "channel"}},
 			{Name: "memory_restore", Description: "Restore memories from checkpoint", Required: []string{"checkpoint_id"}},
@@ -275,6 +274,74 @@ func (s *Server) handleRoute(ctx context.Context, req mcp.CallToolRequest) (*mcp
 	return handler(ctx, newReq)
 }
 
+// CallTool runs a tool by name, whether or not the MCP mode exposes it.
+func (s *Server) CallTool(ctx context.Context, name string, args map[string]any) (*mcp.CallToolResult, error) {
+	handler, ok := s.getToolHandlers()[name]
+	if !ok {
+		return nil, fmt.Errorf("unknown tool: %s", name)
+	}
+	if args == nil {
+		args = make(map[string]any)
+	}
+
+	return s.scheduleTool(handler)(ctx, mcp.CallToolRequest{
+		Params: mcp.CallToolParams{
+			Name:      name,
+			Arguments: args,
+		},
+	})
+}
+
+// scheduleTool runs a tool handler on a worker of the tool's class. Calls
+// through the router are scheduled by the routed tool.
+func (s *Server) scheduleTool(next server.ToolHandlerFunc) server.ToolHandlerFunc {
+	return func(ctx context.Context, req mcp.CallToolRequest) (*mcp.CallToolResult, error) {
+		name := req.Params.Name
+		if name == "route" {
+			name = req.GetString("tool", "")
+		}
+
+		class := classOf(name)
+		if class == classSearch || class == classIndexing {
+			if err := s.awaitWarmup(ctx); err != nil {
+				return mcp.NewToolResultError(fmt.Sprintf("%s not started: %v", name, err)), nil
+			}
+		}
+
+		release, err := s.sched.acquire(ctx, class)
+		if err != nil {
+			return mcp.NewToolResultError(fmt.Sprintf("%s not started: %v", name, err)), nil
+		}
+		defer release()
+
+		return next(ctx, req)
+	}
+}
+
+// ToolResultText returns the text content of a tool result.
+func ToolResultText(result *mcp.CallToolResult) string {
+	return strings.Join(ToolResultTexts(result), "\n")
+}
+
+// ToolResultTexts returns the text blocks of a tool result. A JSON result
+// is the first block; later ones are notes such as a truncation notice.
+func ToolResultTexts(result *mcp.CallToolResult) []string {
+	if result == nil {
+		return nil
+	}
+
+	var parts []string
+	for _, c := range result.Content {
+		switch tc := c.(type) {
+		case mcp.TextContent:
+			parts = append(parts, tc.Text)
+		case *mcp.TextContent:
+			parts = append(parts, tc.Text)
+		}
+	}
+	return parts
+}
+
 // handleListTools returns available tools, optionally filtered by category.
 func (s *Server) handleListTools(ctx context.Context, req mcp.CallToolRequest) (*mcp.CallToolResult, error) {
 	category := req.GetString("category", "")
@@ -318,12 +385,7 @@ func (s *Server) handleListTools(ctx context.Context, req mcp.CallToolRequest) (
 		result = summary
 	}
 
-	data, err := json.MarshalIndent(result, "", "  ")
-	if err != nil {
-		return nil, err
-	}
-
-	return mcp.NewToolResultText(string(data)), nil
+	return s.jsonResult(result), nil
 }
 
 // handleSuggestTool suggests the best tool for a given intent.
@@ -450,8 +512,7 @@ func (s *Server) handleSuggestTool(ctx context.Context, req mcp.CallToolRequest)
 		"suggestions": suggestions,
 	}
 
-	data, _ := json.MarshalIndent(result, "", "  ")
-	return mcp.NewToolResultText(string(data)), nil
+	return s.jsonResult(result), nil
 }
 
 // findSimilarTools finds tools with similar names.
@@ -0,0 +1,202 @@
+package mcp
+
+import (
+	"context"
+	"errors"
+	"fmt"
+	"sync/atomic"
+	"time"
+)
+
+// Tool calls are scheduled by class so that indexing or heavy analysis
+// cannot starve cheap lookups from the same client. Each class has a fixed
+// number of workers and a bounded queue: calls beyond the queue are rejected
+// at once instead of piling up, and a call cancelled while queued never runs.
+
+// toolClass is the scheduling class of a tool.
+type toolClass int
+
+const (
+	classInteractive toolClass = iota // Point lookups and small writes
+	classSearch                       // Searches that may embed or rerank
+	classAnalysis                     // Whole-index and git analysis
+	classIndexing                     // Index builds and imports
+	numToolClasses
+)
+
+var toolClassNames = [numToolClasses]string{"interactive", "search", "analysis", "indexing"}
+
+func (c toolClass) String() string {
+	return toolClassNames[c]
+}
+
+// classLimit bounds one class: workers calls run at once, queue more wait.
+type classLimit struct {
+	workers int
+	queue   int
+}
+
+var classLimits = [numToolClasses]classLimit{
+	classInteractive: {workers: 16, queue: 256},
+	classSearch:      {workers: 4, queue: 32},
+	classAnalysis:    {workers: 2, queue: 8},
+	classIndexing:    {workers: 1, queue: 2},
+}
+
+// toolClasses assigns tools to classes. Unlisted tools are interactive.
+var toolClasses = map[string]toolClass{
+	"search_code":    classSearch,
+	"grep_code":      classSearch,
+	"fuzzy_search":   classSearch,
+	"search_history": classSearch,
+	"memory_recall":  classSearch,
+	"todo_search":    classSearch,
+
+	"get_symbols":                classAnalysis,
+	"get_dead_code":              classAnalysis,
+	"get_complexity":             classAnalysis,
+	"get_entry_points":           classAnalysis,
+	"get_import_graph":           classAnalysis,
+	"get_refactoring_candidates": classAnalysis,
+	"get_project_tree":           classAnalysis,
+	"get_blame":                  classAnalysis,
+	"get_chunk_history":          classAnalysis,
+	"get_code_evolution":         classAnalysis,
+	"find_regression":            classAnalysis,
+	"get_commit_context":         classAnalysis,
+	"get_contributor_insights":   classAnalysis,
+	"detect_environment":         classAnalysis,
+
+	"index_codebase":    classIndexing,
+	"index_git_history": classIndexing,
+	"clear_index":       classIndexing,
+	"init_project":      classIndexing,
+	"github_sync":       classIndexing,
+}
+
+// classOf returns the scheduling class of a tool.
+func classOf(tool string) toolClass {
+	if c, ok := toolClasses[tool]; ok {
+		return c
+	}
+	return classInteractive
+}
+
+// errOverloaded is returned when a class queue is full.
+var errOverloaded = errors.New("server busy")
+
+// classPool holds the workers and counters of one class.
+type classPool struct {
+	class toolClass
+	slots chan struct{}
+	limit classLimit
+
+	running   atomic.Int64
+	queued    atomic.Int64
+	admitted  atomic.Int64
+	rejected  atomic.Int64
+	cancelled atomic.Int64
+	waitNanos atomic.Int64
+	maxWait   atomic.Int64
+}
+
+// scheduler admits tool calls into their class pools.
+type scheduler struct {
+	pools [numToolClasses]*classPool
+}
+
+func newScheduler() *scheduler {
+	s := &scheduler{}
+	for c := toolClass(0); c < numToolClasses; c++ {
+		s.pools[c] = &classPool{
+			class: c,
+			slots: make(chan struct{}, classLimits[c].workers),
+			limit: classLimits[c],
+		}
+	}
+	return s
+}
+
+// acquire waits for a worker of class. The returned function releases it.
+// It fails when the class queue is full or ctx ends while waiting.
+func (s *scheduler) acquire(ctx context.Context, class toolClass) (func(), error) {
+	p := s.pools[class]
+
+	select {
+	case p.slots <- struct{}{}:
+		p.admit(0)
+		return p.release, nil
+	default:
+	}
+
+	if p.queued.Add(1) > int64(p.limit.queue) {
+		p.queued.Add(-1)
+		p.rejected.Add(1)
+		return nil, fmt.Errorf("%w: too many queued %s calls", errOverloaded, class)
+	}
+	defer p.queued.Add(-1)
+
+	start := time.Now()
+	select {
+	case p.slots <- struct{}{}:
+		p.admit(time.Since(start))
+		return p.release, nil
+	case <-ctx.Done():
+		p.cancelled.Add(1)
+		return nil, ctx.Err()
+	}
+}
+
+func (p *classPool) admit(wait time.Duration) {
+	p.running.Add(1)
+	p.admitted.Add(1)
+	p.waitNanos.Add(int64(wait))
+	for {
+		max := p.maxWait.Load()
+		if int64(wait) <= max || p.maxWait.CompareAndSwap(max, int64(wait)) {
+			return
+		}
+	}
+}
+
+func (p *classPool) release() {
+	p.running.Add(-1)
+	<-p.slots
+}
+
+// classStats reports the load of one scheduling class.
+type classStats struct {
+	Class      string  `json:"class"`
+	Workers    int     `json:"workers"`
+	Running    int64   `json:"running"`
+	Queued     int64   `json:"queued"`
+	QueueLimit int     `json:"queue_limit"`
+	Admitted   int64   `json:"admitted"`
+	Rejected   int64   `json:"rejected"`
+	Cancelled  int64   `json:"cancelled"`
+	AvgWaitMs  float64 `json:"avg_wait_ms"`
+	MaxWaitMs  float64 `json:"max_wait_ms"`
+}
+
+// stats returns a snapshot of every class.
+func (s *scheduler) stats() []classStats {
+	out := make([]classStats, 0, numToolClasses)
+	for _, p := range s.pools {
+		st := classStats{
+			Class:      p.class.String(),
+			Workers:    p.limit.workers,
+			Running:    p.running.Load(),
+			Queued:     p.queued.Load(),
+			QueueLimit: p.limit.queue,
+			Admitted:   p.admitted.Load(),
+			Rejected:   p.rejected.Load(),
+			Cancelled:  p.cancelled.Load(),
+			MaxWaitMs:  float64(p.maxWait.Load()) / float64(time.Millisecond),
+		}
+		if st.Admitted > 0 {
+			st.AvgWaitMs = float64(p.waitNanos.Load()) / float64(st.Admitted) / float64(time.Millisecond)
+		}
+		out = append(out, st)
+	}
+	return out
+}
@@ -0,0 +1,102 @@
+package mcp
+
+import (
+	"context"
+	"errors"
+	"testing"
+	"time"
+)
+
+func TestSchedulerAdmission(t *testing.T) {
+	s := newScheduler()
+	ctx := context.Background()
+
+	// Occupy the only indexing worker
+	release, err := s.acquire(ctx, classIndexing)
+	if err != nil {
+		t.Fatalf("acquire: %v", err)
+	}
+
+	// Interactive calls are not blocked by indexing
+	done, err := s.acquire(ctx, classInteractive)
+	if err != nil {
+		t.Fatalf("interactive acquire: %v", err)
+	}
+	done()
+
+	// Fill the indexing queue
+	admitted := make(chan func(), classLimits[classIndexing].queue)
+	for i := 0; i < classLimits[classIndexing].queue; i++ {
+		go func() {
+			r, err := s.acquire(ctx, classIndexing)
+			if err != nil {
+				t.Errorf("queued acquire: %v", err)
+				return
+			}
+			admitted <- r
+		}()
+	}
+	waitFor(t, func() bool { return s.pools[classIndexing].queued.Load() == int64(classLimits[classIndexing].queue) })
+
+	if _, err := s.acquire(ctx, classIndexing); !errors.Is(err, errOverloaded) {
+		t.Errorf("acquire on full queue: err = %v, want errOverloaded", err)
+	}
+
+	// Queued calls run one at a time as workers free up
+	release()
+	for i := 0; i < classLimits[classIndexing].queue; i++ {
+		(<-admitted)()
+	}
+
+	st := s.stats()[classIndexing]
+	if st.Admitted != 1+int64(classLimits[classIndexing].queue) || st.Rejected != 1 || st.Running != 0 || st.Queued != 0 {
+		t.Errorf("stats = %+v", st)
+	}
+	if st.MaxWaitMs <= 0 {
+		t.Errorf("MaxWaitMs = %v, want > 0", st.MaxWaitMs)
+	}
+}
+
+func TestSchedulerCancelQueued(t *testing.T) {
+	s := newScheduler()
+
+	release, _ := s.acquire(context.Background(), classIndexing)
+	defer release()
+
+	ctx, cancel := context.WithTimeout(context.Background(), 20*time.Millisecond)
+	defer cancel()
+	if _, err := s.acquire(ctx, classIndexing); !errors.Is(err, context.DeadlineExceeded) {
+		t.Errorf("acquire = %v, want deadline exceeded", err)
+	}
+
+	st := s.stats()[classIndexing]
+	if st.Cancelled != 1 || st.Queued != 0 {
+		t.Errorf("stats = %+v", st)
+	}
+}
+
+func TestClassOf(t *testing.T) {
+	tests := map[string]toolClass{
+		"get_chunk":      classInteractive,
+		"search_code":    classSearch,
+		"get_dead_code":  classAnalysis,
+		"index_codebase": classIndexing,
+		"unknown_tool":   classInteractive,
+	}
+	for tool, want := range tests {
+		if got := classOf(tool); got != want {
+			t.Errorf("classOf(%q) = %v, want %v", tool, got, want)
+		}
+	}
+}
+
+func waitFor(t *testing.T, cond func() bool) {
+	t.Helper()
+	deadline := time.Now().Add(2 * time.Second)
+	for !cond() {
+		if time.Now().After(deadline) {
+			t.Fatal("condition not met")
+		}
+		time.Sleep(time.Millisecond)
+	}
+}
@@ -4,13 +4,14 @@ package mcp
 import (
 	"bufio"
 	"context"
-	"encoding/json"
 	"fmt"
 	"log/slog"
+	"math"
 	"os"
 	"path/filepath"
 	"strconv"
 	"strings"
+	"sync"
 	"time"
 
 	"github.com/mark3labs/mcp-go/mcp"
@@ -19,6 +20,7 @@ import (
 	"github.com/spetr/mcp-codewizard/internal/analysis"
 	"github.com/spetr/mcp-codewizard/internal/config"
 	"github.com/spetr/mcp-codewizard/internal/index"
+	"github.com/spetr/mcp-codewizard/internal/memory"
 	"github.com/spetr/mcp-codewizard/internal/search"
 	"github.com/spetr/mcp-codewizard/internal/wizard"
 	"github.com/spetr/mcp-codewizard/pkg/provider"
@@ -31,6 +33,7 @@ type Server struct {
 	projectDir string
 	config     *config.Config
 	store      provider.VectorStore
+	newStore   func() provider.VectorStore
 	embedding  provider.EmbeddingProvider
 	chunker    provider.ChunkingStrategy
 	reranker   provider.Reranker
@@ -39,6 +42,16 @@ type Server struct {
 	// File watcher for automatic re-indexing
 	watcher       *index.Watcher
 	watcherCancel context.CancelFunc
+
+	// Worker pools per tool class
+	sched *scheduler
+
+	// Background provider warmup, nil if not started (startup.go)
+	warmup *warmupStatus
+
+	// Project memory store, opened on first use (tools_project_memory.go)
+	memoryMu    sync.Mutex
+	memoryStore *memory.Store
 }
 
 // Config contains server configuration.
@@ -49,6 +62,10 @@ type Config struct {
 	Embedding  provider.EmbeddingProvider
 	Chunker    provider.ChunkingStrategy
 	Reranker   provider.Reranker
+
+	// NewStore creates an uninitialized store for revision indexes, which
+	// are kept apart from Store. Nil disables indexing revisions.
+	NewStore func() provider.VectorStore
 }
 
 // New creates a new MCP server.
@@ -57,9 +74,11 @@ func New(cfg Config) (*Server, error) {
 		projectDir: cfg.ProjectDir,
 		config:     cfg.Config,
 		store:      cfg.Store,
+		newStore:   cfg.NewStore,
 		embedding:  cfg.Embedding,
 		chunker:    cfg.Chunker,
 		reranker:   cfg.Reranker,
+		sched:      newScheduler(),
 	}
 
 	// Create search engine
@@ -74,6 +93,7 @@ func New(cfg Config) (*Server, error) {
 		"mcp-codewizard",
 		"0.1.0",
 		server.WithLogging(),
+		server.WithToolHandlerMiddleware(s.scheduleTool),
 	)
 
 	// Register tools based on MCP mode
@@ -104,6 +124,7 @@ func (s *Server) registerTools(mcpServer *server.MCPServer) {
 		mcp.WithBoolean("force", mcp.Description("Reindex all")),
 		mcp.WithArray("ignore_patterns", mcp.Description("Exclude patterns")),
 		mcp.WithArray("custom_extensions", mcp.Description("Extra extensions")),
+		mcp.WithString("revision", mcp.Description("Commit, tag or branch to index into a separate revision index instead of the working tree")),
 	), s.handleIndexCodebase)
 
 	mcpServer.AddTool(mcp.NewTool("search_code",
@@ -332,6 +353,7 @@ func (s *Server) registerTools(mcpServer *server.MCPServer) {
 		mcp.WithArray("categories", mcp.Description("Categories")),
 		mcp.WithArray("tags", mcp.Description("Tags")),
 		mcp.WithNumber("min_importance", mcp.Description("Min importance")),
+		mcp.WithNumber("min_confidence", mcp.Description("Min confidence")),
 	), s.handleMemoryRecall)
 
 	mcpServer.AddTool(mcp.NewTool("memory_forget",
@@ -418,8 +440,9 @@ func (s *Server) handleIndexCodebase(ctx context.Context, req mcp.CallToolReques
 	force := req.GetBool("force", false)
 	ignorePatterns := req.GetStringSlice("ignore_patterns", nil)
 	customExtensions := req.GetStringSlice("custom_extensions", nil)
+	revision := req.GetString("revision", "")
 
-	slog.Info("starting indexing", "force", force, "ignore_patterns", ignorePatterns, "custom_extensions", customExtensions)
+	slog.Info("starting indexing", "force", force, "ignore_patterns", ignorePatterns, "custom_extensions", customExtensions, "revision", revision)
 
 	// Create a copy of config with runtime overrides
 	indexConfig := s.config
@@ -445,13 +468,35 @@ func (s *Server) handleIndexCodebase(ctx context.Context, req mcp.CallToolReques
 		}
 	}
 
+	// A revision is indexed into its own database; the served index and its
+	// watcher follow the working tree
+	store := s.store
+	dbPath := ""
+	if revision != "" {
+		if s.newStore == nil {
+			return mcp.NewToolResultError("indexing a revision is not supported by this server"), nil
+		}
+		commit, err := index.ResolveRevision(ctx, s.projectDir, revision)
+		if err != nil {
+			return mcp.NewToolResultError(err.Error()), nil
+		}
+		revision = commit
+		dbPath = config.RevisionDBPath(s.projectDir, commit)
+		store = s.newStore()
+		if err := store.Init(dbPath); err != nil {
+			return mcp.NewToolResultError(fmt.Sprintf("failed to open revision index: %v", err)), nil
+		}
+		defer store.Close()
+	}
+
 	// Create indexer
 	indexer := index.New(index.Config{
 		ProjectDir: s.projectDir,
 		Config:     indexConfig,
-		Store:      s.store,
+		Store:      store,
 		Embedding:  s.embedding,
 		Chunker:    s.chunker,
+		Revision:   revision,
 		OnProgress: func(p types.IndexProgress) {
 			slog.Debug("progress", "phase", p.Phase, "files", p.ProcessedFiles, "chunks", p.ProcessedChunks)
 		},
@@ -462,7 +507,7 @@ func (s *Server) handleIndexCodebase(ctx context.Context, req mcp.CallToolReques
 	}
 
 	// Get stats
-	stats, err := s.store.GetStats()
+	stats, err := store.GetStats()
 	if err != nil {
 		return mcp.NewToolResultError(fmt.Sprintf("failed to get stats: %v", err)), nil
 	}
@@ -475,9 +520,27 @@ func (s *Server) handleIndexCodebase(ctx context.Context, req mcp.CallToolReques
 		"references": stats.TotalReferences,
 		"db_size":    formatBytes(stats.DBSizeBytes),
 	}
+	if revision != "" {
+		result["revision"] = revision
+		result["db_path"] = dbPath
+	}
+
+	return s.jsonResult(result), nil
+}
 
-	jsonResult, _ := json.MarshalIndent(result, "", "  ")
-	return mcp.NewToolResultText(string(jsonResult)), nil
+// searchCodeResult is one result of search_code.
+type searchCodeResult struct {
+	ID            string          `json:"id"`
+	File          string          `json:"file"`
+	StartLine     int             `json:"start_line"`
+	EndLine       int             `json:"end_line"`
+	Language      string          `json:"language"`
+	Type          types.ChunkType `json:"type"`
+	Name          string          `json:"name"`
+	Score         float32         `json:"score"`
+	Content       string          `json:"content"`
+	ContextBefore string          `json:"context_before,omitempty"`
+	ContextAfter  string          `json:"context_after,omitempty"`
 }
 
 func (s *Server) handleSearchCode(ctx context.Context, req mcp.CallToolRequest) (*mcp.CallToolResult, error) {
@@ -523,34 +586,43 @@ func (s *Server) handleSearchCode(ctx context.Context, req mcp.CallToolRequest)
 	}
 
 	// Format results
-	var formatted []map[string]any
+	var formatted []searchCodeResult
 	for _, r := range results {
-		entry := map[string]any{
-			"id":         r.Chunk.ID,
-			"file":       r.Chunk.FilePath,
-			"start_line": r.Chunk.StartLine,
-			"end_line":   r.Chunk.EndLine,
-			"language":   r.Chunk.Language,
-			"type":       r.Chunk.ChunkType,
-			"name":       r.Chunk.Name,
-			"score":      r.Score,
-			"content":    r.Chunk.Content,
+		entry := searchCodeResult{
+			ID:        r.Chunk.ID,
+			File:      r.Chunk.FilePath,
+			StartLine: r.Chunk.StartLine,
+			EndLine:   r.Chunk.EndLine,
+			Language:  r.Chunk.Language,
+			Type:      r.Chunk.ChunkType,
+			Name:      r.Chunk.Name,
+			Score:     r.Score,
+			Content:   r.Chunk.Content,
 		}
 
 		if includeContext {
-			if r.ContextBefore != "" {
-				entry["context_before"] = r.ContextBefore
-			}
-			if r.ContextAfter != "" {
-				entry["context_after"] = r.ContextAfter
-			}
+			entry.ContextBefore = r.ContextBefore
+			entry.ContextAfter = r.ContextAfter
 		}
 
 		formatted = append(formatted, entry)
 	}
 
-	jsonResult, _ := json.MarshalIndent(formatted, "", "  ")
-	return mcp.NewToolResultText(string(jsonResult)), nil
+	return s.jsonResult(formatted), nil
+}
+
+// chunkResult is the result of get_chunk.
+type chunkResult struct {
+	ID            string          `json:"id"`
+	File          string          `json:"file"`
+	StartLine     int             `json:"start_line"`
+	EndLine       int             `json:"end_line"`
+	Language      string          `json:"language"`
+	Type          types.ChunkType `json:"type"`
+	Name          string          `json:"name"`
+	Content       string          `json:"content"`
+	ContextBefore string          `json:"context_before"`
+	ContextAfter  string          `json:"context_after"`
 }
 
 func (s *Server) handleGetChunk(ctx context.Context, req mcp.CallToolRequest) (*mcp.CallToolResult, error) {
@@ -579,21 +651,20 @@ func (s *Server) handleGetChunk(ctx context.Context, req mcp.CallToolRequest) (*
 	// Get context from file
 	contextBefore, contextAfter := getChunkContext(chunk.FilePath, chunk.StartLine, chunk.EndLine, contextLines)
 
-	result := map[string]any{
-		"id":             chunk.ID,
-		"file":           chunk.FilePath,
-		"start_line":     chunk.StartLine,
-		"end_line":       chunk.EndLine,
-		"language":       chunk.Language,
-		"type":           chunk.ChunkType,
-		"name":           chunk.Name,
-		"content":        chunk.Content,
-		"context_before": contextBefore,
-		"context_after":  contextAfter,
+	result := chunkResult{
+		ID:            chunk.ID,
+		File:          chunk.FilePath,
+		StartLine:     chunk.StartLine,
+		EndLine:       chunk.EndLine,
+		Language:      chunk.Language,
+		Type:          chunk.ChunkType,
+		Name:          chunk.Name,
+		Content:       chunk.Content,
+		ContextBefore: contextBefore,
+		ContextAfter:  contextAfter,
 	}
 
-	jsonResult, _ := json.MarshalIndent(result, "", "  ")
-	return mcp.NewToolResultText(string(jsonResult)), nil
+	return s.jsonResult(result), nil
 }
 
 // findChunkBySymbolID tries to find a chunk using a symbol ID format (file:name:line).
@@ -660,8 +731,25 @@ func (s *Server) handleGetStatus(ctx context.Context, req mcp.CallToolRequest) (
 		result["tool_version"] = meta.ToolVersion
 	}
 
-	jsonResult, _ := json.MarshalIndent(result, "", "  ")
-	return mcp.NewToolResultText(string(jsonResult)), nil
+	storage := map[string]any{
+		"free_pages": stats.FreePages,
+		"free_space": formatBytes(stats.FreePages * stats.PageSize),
+		"wal_size":   formatBytes(stats.WALSizeBytes),
+	}
+	if stats.PageCount > 0 {
+		storage["fragmentation"] = fmt.Sprintf("%.1f%%", float64(stats.FreePages)*100/float64(stats.PageCount))
+	}
+	if !stats.LastMaintenance.IsZero() {
+		storage["last_maintenance"] = stats.LastMaintenance.Format("2006-01-02 15:04:05")
+	}
+	result["storage"] = storage
+
+	result["scheduler"] = s.sched.stats()
+	if warmup := s.warmupState(); warmup != nil {
+		result["warmup"] = warmup
+	}
+
+	return s.jsonResult(result), nil
 }
 
 func (s *Server) handleClearIndex(ctx context.Context, req mcp.CallToolRequest) (*mcp.CallToolResult, error) {
@@ -671,10 +759,14 @@ func (s *Server) handleClearIndex(ctx context.Context, req mcp.CallToolRequest)
 		return mcp.NewToolResultError(fmt.Sprintf("failed to get files: %v", err)), nil
 	}
 
+	filePaths := make([]string, 0, len(hashes))
 	for filePath := range hashes {
-		if err := s.store.DeleteChunksByFile(filePath); err != nil {
-			slog.Warn("failed to delete chunks", "file", filePath, "error", err)
-		}
+		filePaths = append(filePaths, filePath)
+	}
+	if err := s.store.DeleteChunksByFiles(filePaths); err != nil {
+		slog.Warn("failed to delete chunks", "error", err)
+	}
+	for _, filePath := range filePaths {
 		if err := s.store.DeleteFileCache(filePath); err != nil {
 			slog.Warn("failed to delete cache", "file", filePath, "error", err)
 		}
@@ -683,6 +775,16 @@ func (s *Server) handleClearIndex(ctx context.Context, req mcp.CallToolRequest)
 	return mcp.NewToolResultText(`{"success": true, "message": "Index cleared"}`), nil
 }
 
+// referenceResult is one result of get_callers or get_callees.
+type referenceResult struct {
+	From       string        `json:"from,omitempty"`
+	To         string        `json:"to,omitempty"`
+	File       string        `json:"file"`
+	Line       int           `json:"line"`
+	Kind       types.RefKind `json:"kind"`
+	IsExternal bool          `json:"is_external"`
+}
+
 func (s *Server) handleGetCallers(ctx context.Context, req mcp.CallToolRequest) (*mcp.CallToolResult, error) {
 	symbol := req.GetString("symbol", "")
 	if symbol == "" {
@@ -696,19 +798,18 @@ func (s *Server) handleGetCallers(ctx context.Context, req mcp.CallToolRequest)
 		return mcp.NewToolResultError(fmt.Sprintf("failed to get callers: %v", err)), nil
 	}
 
-	var formatted []map[string]any
+	var formatted []referenceResult
 	for _, r := range refs {
-		formatted = append(formatted, map[string]any{
-			"from":        r.FromSymbol,
-			"file":        r.FilePath,
-			"line":        r.Line,
-			"kind":        r.Kind,
-			"is_external": r.IsExternal,
+		formatted = append(formatted, referenceResult{
+			From:       r.FromSymbol,
+			File:       r.FilePath,
+			Line:       r.Line,
+			Kind:       r.Kind,
+			IsExternal: r.IsExternal,
 		})
 	}
 
-	jsonResult, _ := json.MarshalIndent(formatted, "", "  ")
-	return mcp.NewToolResultText(string(jsonResult)), nil
+	return s.jsonResult(formatted), nil
 }
 
 func (s *Server) handleGetCallees(ctx context.Context, req mcp.CallToolRequest) (*mcp.CallToolResult, error) {
@@ -724,19 +825,31 @@ func (s *Server) handleGetCallees(ctx context.Context, req mcp.CallToolRequest)
 		return mcp.NewToolResultError(fmt.Sprintf("failed to get callees: %v", err)), nil
 	}
 
-	var formatted []map[string]any
+	var formatted []referenceResult
 	for _, r := range refs {
-		formatted = append(formatted, map[string]any{
-			"to":          r.ToSymbol,
-			"file":        r.FilePath,
-			"line":        r.Line,
-			"kind":        r.Kind,
-			"is_external": r.IsExternal,
+		formatted = append(formatted, referenceResult{
+			To:         r.ToSymbol,
+			File:       r.FilePath,
+			Line:       r.Line,
+			Kind:       r.Kind,
+			IsExternal: r.IsExternal,
 		})
 	}
 
-	jsonResult, _ := json.MarshalIndent(formatted, "", "  ")
-	return mcp.NewToolResultText(string(jsonResult)), nil
+	return s.jsonResult(formatted), nil
+}
+
+// symbolResult is one result of get_symbols.
+type symbolResult struct {
+	ID         string           `json:"id"`
+	Name       string           `json:"name"`
+	Kind       types.SymbolKind `json:"kind"`
+	File       string           `json:"file"`
+	StartLine  int              `json:"start_line"`
+	EndLine    int              `json:"end_line"`
+	LineCount  int              `json:"line_count"`
+	Signature  string           `json:"signature"`
+	Visibility string           `json:"visibility"`
 }
 
 func (s *Server) handleGetSymbols(ctx context.Context, req mcp.CallToolRequest) (*mcp.CallToolResult, error) {
@@ -753,23 +866,22 @@ func (s *Server) handleGetSymbols(ctx context.Context, req mcp.CallToolRequest)
 		return mcp.NewToolResultError(fmt.Sprintf("failed to search symbols: %v", err)), nil
 	}
 
-	var formatted []map[string]any
+	var formatted []symbolResult
 	for _, sym := range symbols {
-		formatted = append(formatted, map[string]any{
-			"id":         sym.ID,
-			"name":       sym.Name,
-			"kind":       sym.Kind,
-			"file":       sym.FilePath,
-			"start_line": sym.StartLine,
-			"end_line":   sym.EndLine,
-			"line_count": sym.LineCount,
-			"signature":  sym.Signature,
-			"visibility": sym.Visibility,
+		formatted = append(formatted, symbolResult{
+			ID:         sym.ID,
+			Name:       sym.Name,
+			Kind:       sym.Kind,
+			File:       sym.FilePath,
+			StartLine:  sym.StartLine,
+			EndLine:    sym.EndLine,
+			LineCount:  sym.LineCount,
+			Signature:  sym.Signature,
+			Visibility: sym.Visibility,
 		})
 	}
 
-	jsonResult, _ := json.MarshalIndent(formatted, "", "  ")
-	return mcp.NewToolResultText(string(jsonResult)), nil
+	return s.jsonResult(formatted), nil
 }
 
 func (s *Server) handleGetRefactoringCandidates(ctx context.Context, req mcp.CallToolRequest) (*mcp.CallToolResult, error) {
@@ -826,7 +938,7 @@ func (s *Server) handleGetRefactoringCandidates(ctx context.Context, req mcp.Cal
 
 	// Get dead code (unused functions)
 	deadCodeAnalyzer := analysis.NewDeadCodeAnalyzer(s.store)
-	deadCode, err := deadCodeAnalyzer.FindDeadFunctions(limit)
+	deadCode, err := deadCodeAnalyzer.FindDeadFunctions(ctx, limit)
 	if err == nil && len(deadCode) > 0 {
 		var deadFormatted []map[string]any
 		for _, dc := range deadCode {
@@ -842,15 +954,14 @@ func (s *Server) handleGetRefactoringCandidates(ctx context.Context, req mcp.Cal
 		result["dead_code"] = deadFormatted
 	}
 
-	jsonResult, _ := json.MarshalIndent(result, "", "  ")
-	return mcp.NewToolResultText(string(jsonResult)), nil
+	return s.jsonResult(result), nil
 }
 
 func (s *Server) handleGetEntryPoints(ctx context.Context, req mcp.CallToolRequest) (*mcp.CallToolResult, error) {
 	limit := req.GetInt("limit", 100)
 	filterType := req.GetString("type", "")
 
-	entryPoints, err := s.search.GetEntryPoints(limit)
+	entryPoints, err := s.search.GetEntryPoints(ctx, limit)
 	if err != nil {
 		return mcp.NewToolResultError(fmt.Sprintf("failed to get entry points: %v", err)), nil
 	}
@@ -879,14 +990,13 @@ func (s *Server) handleGetEntryPoints(ctx context.Context, req mcp.CallToolReque
 		})
 	}
 
-	jsonResult, _ := json.MarshalIndent(formatted, "", "  ")
-	return mcp.NewToolResultText(string(jsonResult)), nil
+	return s.jsonResult(formatted), nil
 }
 
 func (s *Server) handleGetImportGraph(ctx context.Context, req mcp.CallToolRequest) (*mcp.CallToolResult, error) {
 	limit := req.GetInt("limit", 1000)
 
-	graph, err := s.search.GetImportGraph(limit)
+	graph, err := s.search.GetImportGraph(ctx, limit)
 	if err != nil {
 		return mcp.NewToolResultError(fmt.Sprintf("failed to get import graph: %v", err)), nil
 	}
@@ -900,8 +1010,7 @@ func (s *Server) handleGetImportGraph(ctx context.Context, req mcp.CallToolReque
 		"import_details":   graph.Edges,
 	}
 
-	jsonResult, _ := json.MarshalIndent(result, "", "  ")
-	return mcp.NewToolResultText(string(jsonResult)), nil
+	return s.jsonResult(result), nil
 }
 
 func (s *Server) handleFuzzySearch(ctx context.Context, req mcp.CallToolRequest) (*mcp.CallToolResult, error) {
@@ -932,8 +1041,7 @@ func (s *Server) handleFuzzySearch(ctx context.Context, req mcp.CallToolRequest)
 			"count":   len(files),
 			"matches": files,
 		}
-		jsonResult, _ := json.MarshalIndent(result, "", "  ")
-		return mcp.NewToolResultText(string(jsonResult)), nil
+		return s.jsonResult(result), nil
 	}
 
 	// Fuzzy search symbols
@@ -963,8 +1071,7 @@ func (s *Server) handleFuzzySearch(ctx context.Context, req mcp.CallToolRequest)
 		"matches": formatted,
 	}
 
-	jsonResult, _ := json.MarshalIndent(result, "", "  ")
-	return mcp.NewToolResultText(string(jsonResult)), nil
+	return s.jsonResult(result), nil
 }
 
 func (s *Server) handleGetFileSummary(ctx context.Context, req mcp.CallToolRequest) (*mcp.CallToolResult, error) {
@@ -1087,8 +1194,7 @@ func (s *Server) handleGetFileSummary(ctx context.Context, req mcp.CallToolReque
 		}
 	}
 
-	jsonResult, _ := json.MarshalIndent(result, "", "  ")
-	return mcp.NewToolResultText(string(jsonResult)), nil
+	return s.jsonResult(result), nil
 }
 
 // getTopImports returns the most imported packages.
@@ -1131,8 +1237,7 @@ func (s *Server) handleDetectEnvironment(ctx context.Context, req mcp.CallToolRe
 		return mcp.NewToolResultError(fmt.Sprintf("failed to detect environment: %v", err)), nil
 	}
 
-	jsonResult, _ := json.MarshalIndent(result, "", "  ")
-	return mcp.NewToolResultText(string(jsonResult)), nil
+	return s.jsonResult(result), nil
 }
 
 func (s *Server) handleValidateConfig(ctx context.Context, req mcp.CallToolRequest) (*mcp.CallToolResult, error) {
@@ -1148,8 +1253,7 @@ func (s *Server) handleValidateConfig(ctx context.Context, req mcp.CallToolReque
 		return mcp.NewToolResultError(fmt.Sprintf("validation failed: %v", err)), nil
 	}
 
-	jsonResult, _ := json.MarshalIndent(result, "", "  ")
-	return mcp.NewToolResultText(string(jsonResult)), nil
+	return s.jsonResult(result), nil
 }
 
 func (s *Server) handleGetConfig(ctx context.Context, req mcp.CallToolRequest) (*mcp.CallToolResult, error) {
@@ -1164,8 +1268,7 @@ func (s *Server) handleGetConfig(ctx context.Context, req mcp.CallToolRequest) (
 		"config": cfg,
 	}
 
-	jsonResult, _ := json.MarshalIndent(result, "", "  ")
-	return mcp.NewToolResultText(string(jsonResult)), nil
+	return s.jsonResult(result), nil
 }
 
 func (s *Server) handleApplyRecommendation(ctx context.Context, req mcp.CallToolRequest) (*mcp.CallToolResult, error) {
@@ -1253,7 +1356,8 @@ func (s *Server) handleApplyRecommendation(ctx context.Context, req mcp.CallTool
 			DefaultLimit: 10,
 		},
 		VectorStore: config.VectorStoreConfig{
-			Provider: "sqlitevec",
+			Provider:       "sqlitevec",
+			CompressChunks: true,
 		},
 		Limits: config.LimitsConfig{
 			MaxFileSize: "1MB",
@@ -1282,8 +1386,7 @@ func (s *Server) handleApplyRecommendation(ctx context.Context, req mcp.CallTool
 		"config":      cfg,
 	}
 
-	jsonResult, _ := json.MarshalIndent(result, "", "  ")
-	return mcp.NewToolResultText(string(jsonResult)), nil
+	return s.jsonResult(result), nil
 }
 
 func (s *Server) handleInitProject(ctx context.Context, req mcp.CallToolRequest) (*mcp.CallToolResult, error) {
@@ -1377,8 +1480,7 @@ func (s *Server) handleInitProject(ctx context.Context, req mcp.CallToolRequest)
 		state.Messages = append(state.Messages, wizard.FormatConfigSummary(cfg))
 	}
 
-	jsonResult, _ := json.MarshalIndent(state, "", "  ")
-	return mcp.NewToolResultText(string(jsonResult)), nil
+	return s.jsonResult(state), nil
 }
 
 // ServeStdio starts the MCP server using stdio transport.
@@ -1435,6 +1537,21 @@ func (s *Server) startWatcher() error {
 	return nil
 }
 
+// Close releases the resources the server opened itself. The vector store
+// and providers belong to the caller.
+func (s *Server) Close() error {
+	s.stopWatcher()
+
+	s.memoryMu.Lock()
+	defer s.memoryMu.Unlock()
+	if s.memoryStore == nil {
+		return nil
+	}
+	err := s.memoryStore.Close()
+	s.memoryStore = nil
+	return err
+}
+
 // stopWatcher stops the file watcher.
 func (s *Server) stopWatcher() {
 	if s.watcherCancel != nil {
@@ -1541,18 +1658,17 @@ func (s *Server) handleGetBlame(ctx context.Context, req mcp.CallToolRequest) (*
 
 	if startLine > 0 && endLine > 0 {
 		// Get range blame
-		result, err = blameAnalyzer.GetRangeBlame(absPath, startLine, endLine)
+		result, err = blameAnalyzer.GetRangeBlame(ctx, absPath, startLine, endLine)
 	} else {
 		// Get full file blame
-		result, err = blameAnalyzer.GetFileBlame(absPath)
+		result, err = blameAnalyzer.GetFileBlame(ctx, absPath)
 	}
 
 	if err != nil {
 		return mcp.NewToolResultError(fmt.Sprintf("git blame failed: %v", err)), nil
 	}
 
-	jsonResult, _ := json.MarshalIndent(result, "", "  ")
-	return mcp.NewToolResultText(string(jsonResult)), nil
+	return s.jsonResult(result), nil
 }
 
 func (s *Server) handleGetDeadCode(ctx context.Context, req mcp.CallToolRequest) (*mcp.CallToolResult, error) {
@@ -1566,13 +1682,13 @@ func (s *Server) handleGetDeadCode(ctx context.Context, req mcp.CallToolRequest)
 
 	switch typeStr {
 	case "functions":
-		results, err = deadCodeAnalyzer.FindDeadFunctions(limit)
+		results, err = deadCodeAnalyzer.FindDeadFunctions(ctx, limit)
 	case "types":
-		results, err = deadCodeAnalyzer.FindUnusedTypes(limit)
+		results, err = deadCodeAnalyzer.FindUnusedTypes(ctx, limit)
 	case "all":
-		results, err = deadCodeAnalyzer.FindDeadCode(limit)
+		results, err = deadCodeAnalyzer.FindDeadCode(ctx, limit)
 	default:
-		results, err = deadCodeAnalyzer.FindDeadFunctions(limit)
+		results, err = deadCodeAnalyzer.FindDeadFunctions(ctx, limit)
 	}
 
 	if err != nil {
@@ -1585,8 +1701,7 @@ func (s *Server) handleGetDeadCode(ctx context.Context, req mcp.CallToolRequest)
 		"results": results,
 	}
 
-	jsonResult, _ := json.MarshalIndent(response, "", "  ")
-	return mcp.NewToolResultText(string(jsonResult)), nil
+	return s.jsonResult(response), nil
 }
 
 func (s *Server) handleGetComplexity(ctx context.Context, req mcp.CallToolRequest) (*mcp.CallToolResult, error) {
@@ -1619,12 +1734,34 @@ func (s *Server) handleGetComplexity(ctx context.Context, req mcp.CallToolReques
 		return mcp.NewToolResultError(fmt.Sprintf("complexity analysis failed: %v", err)), nil
 	}
 
-	jsonResult, _ := json.MarshalIndent(result, "", "  ")
-	return mcp.NewToolResultText(string(jsonResult)), nil
+	return s.jsonResult(result), nil
 }
 
 // Git History handlers
 
+// historyResult is one result of search_history.
+type historyResult struct {
+	Score             float32          `json:"score"`
+	CommitHash        string           `json:"commit_hash"`
+	CommitDate        string           `json:"commit_date"`
+	Author            string           `json:"author"`
+	Message           string           `json:"message"`
+	File              string           `json:"file"`
+	ChangeType        types.ChangeType `json:"change_type"`
+	Additions         int              `json:"additions"`
+	Deletions         int              `json:"deletions"`
+	AffectedFunctions []string         `json:"affected_functions,omitempty"`
+	Diff              string           `json:"diff,omitempty"`
+	RelatedFiles      []string         `json:"related_files,omitempty"`
+}
+
+// historyResponse is the result of search_history.
+type historyResponse struct {
+	Query   string          `json:"query"`
+	Count   int             `json:"count"`
+	Results []historyResult `json:"results"`
+}
+
 func (s *Server) handleSearchHistory(ctx context.Context, req mcp.CallToolRequest) (*mcp.CallToolResult, error) {
 	query := req.GetString("query", "")
 	if query == "" {
@@ -1697,22 +1834,19 @@ func (s *Server) handleSearchHistory(ctx context.Context, req mcp.CallToolReques
 	}
 
 	// Format results
-	var formatted []map[string]any
+	var formatted []historyResult
 	for _, r := range results {
-		entry := map[string]any{
-			"score":       r.Score,
-			"commit_hash": r.Commit.ShortHash,
-			"commit_date": r.Commit.Date.Format("2006-01-02 15:04"),
-			"author":      r.Commit.Author,
-			"message":     r.Commit.Message,
-			"file":        r.Change.FilePath,
-			"change_type": r.Change.ChangeType,
-			"additions":   r.Change.Additions,
-			"deletions":   r.Change.Deletions,
-		}
-
-		if len(r.Change.AffectedFunctions) > 0 {
-			entry["affected_functions"] = r.Change.AffectedFunctions
+		entry := historyResult{
+			Score:             r.Score,
+			CommitHash:        r.Commit.ShortHash,
+			CommitDate:        r.Commit.Date.Format("2006-01-02 15:04"),
+			Author:            r.Commit.Author,
+			Message:           r.Commit.Message,
+			File:              r.Change.FilePath,
+			ChangeType:        r.Change.ChangeType,
+			Additions:         r.Change.Additions,
+			Deletions:         r.Change.Deletions,
+			AffectedFunctions: r.Change.AffectedFunctions,
 		}
 
 		if includeDiff && r.Change.DiffContent != "" {
@@ -1721,28 +1855,23 @@ func (s *Server) handleSearchHistory(ctx context.Context, req mcp.CallToolReques
 			if len(diff) > 2000 {
 				diff = diff[:2000] + "\n... (truncated)"
 			}
-			entry["diff"] = diff
+			entry.Diff = diff
 		}
 
-		if len(r.RelatedChanges) > 0 {
-			var related []string
-			for _, rc := range r.RelatedChanges {
-				related = append(related, rc.FilePath)
-			}
-			entry["related_files"] = related
+		for _, rc := range r.RelatedChanges {
+			entry.RelatedFiles = append(entry.RelatedFiles, rc.FilePath)
 		}
 
 		formatted = append(formatted, entry)
 	}
 
-	response := map[string]any{
-		"query":   query,
-		"count":   len(formatted),
-		"results": formatted,
+	response := historyResponse{
+		Query:   query,
+		Count:   len(formatted),
+		Results: formatted,
 	}
 
-	jsonResult, _ := json.MarshalIndent(response, "", "  ")
-	return mcp.NewToolResultText(string(jsonResult)), nil
+	return s.jsonResult(response), nil
 }
 
 func (s *Server) handleGetChunkHistory(ctx context.Context, req mcp.CallToolRequest) (*mcp.CallToolResult, error) {
@@ -1765,7 +1894,7 @@ func (s *Server) handleGetChunkHistory(ctx context.Context, req mcp.CallToolRequ
 
 	// If symbol provided, find the chunk ID first
 	if chunkID == "" && symbol != "" {
-		symbols, err := s.store.FindSymbols(symbol, "", 10)
+		symbols, err := s.store.FindSymbols(ctx, symbol, "", 10)
 		if err != nil {
 			return mcp.NewToolResultError(fmt.Sprintf("failed to find symbol: %v", err)), nil
 		}
@@ -1807,8 +1936,7 @@ func (s *Server) handleGetChunkHistory(ctx context.Context, req mcp.CallToolRequ
 		"history":  formatted,
 	}
 
-	jsonResult, _ := json.MarshalIndent(response, "", "  ")
-	return mcp.NewToolResultText(string(jsonResult)), nil
+	return s.jsonResult(response), nil
 }
 
 func (s *Server) handleGetCodeEvolution(ctx context.Context, req mcp.CallToolRequest) (*mcp.CallToolResult, error) {
@@ -1819,7 +1947,7 @@ func (s *Server) handleGetCodeEvolution(ctx context.Context, req mcp.CallToolReq
 	file := req.GetString("file", "")
 
 	// Find symbol first
-	symbols, err := s.store.FindSymbols(symbol, "", 10)
+	symbols, err := s.store.FindSymbols(ctx, symbol, "", 10)
 	if err != nil {
 		return mcp.NewToolResultError(fmt.Sprintf("failed to find symbol: %v", err)), nil
 	}
@@ -1877,8 +2005,7 @@ func (s *Server) handleGetCodeEvolution(ctx context.Context, req mcp.CallToolReq
 		result["history"] = history
 	}
 
-	jsonResult, _ := json.MarshalIndent(result, "", "  ")
-	return mcp.NewToolResultText(string(jsonResult)), nil
+	return s.jsonResult(result), nil
 }
 
 func (s *Server) handleFindRegression(ctx context.Context, req mcp.CallToolRequest) (*mcp.CallToolResult, error) {
@@ -1893,13 +2020,22 @@ func (s *Server) handleFindRegression(ctx context.Context, req mcp.CallToolReque
 
 	// Check if store supports git history
 	historyStore, ok := s.store.(interface {
-		FindRegressionCandidates(ctx context.Context, description string, knownGood, knownBad string, limit int) ([]*types.RegressionCandidate, error)
+		FindRegressionCandidates(ctx context.Context, description string, queryVec []float32, knownGood, knownBad string, limit int) ([]*types.RegressionCandidate, error)
 	})
 	if !ok {
 		return mcp.NewToolResultError("git history not supported by current store"), nil
 	}
 
-	candidates, err := historyStore.FindRegressionCandidates(ctx, description, knownGood, knownBad, limit)
+	// Generate description embedding
+	var queryVec []float32
+	if s.embedding != nil {
+		embeddings, err := s.embedding.Embed(ctx, []string{description})
+		if err == nil && len(embeddings) > 0 {
+			queryVec = embeddings[0]
+		}
+	}
+
+	candidates, err := historyStore.FindRegressionCandidates(ctx, description, queryVec, knownGood, knownBad, limit)
 	if err != nil {
 		return mcp.NewToolResultError(fmt.Sprintf("regression search failed: %v", err)), nil
 	}
@@ -1952,8 +2088,7 @@ func (s *Server) handleFindRegression(ctx context.Context, req mcp.CallToolReque
 			candidates[0].Commit.ShortHash, candidates[0].Commit.Message)
 	}
 
-	jsonResult, _ := json.MarshalIndent(response, "", "  ")
-	return mcp.NewToolResultText(string(jsonResult)), nil
+	return s.jsonResult(response), nil
 }
 
 func (s *Server) handleGetCommitContext(ctx context.Context, req mcp.CallToolRequest) (*mcp.CallToolResult, error) {
@@ -2029,8 +2164,7 @@ func (s *Server) handleGetCommitContext(ctx context.Context, req mcp.CallToolReq
 		result["tags"] = commit.Tags
 	}
 
-	jsonResult, _ := json.MarshalIndent(result, "", "  ")
-	return mcp.NewToolResultText(string(jsonResult)), nil
+	return s.jsonResult(result), nil
 }
 
 func (s *Server) handleGetContributorInsights(ctx context.Context, req mcp.CallToolRequest) (*mcp.CallToolResult, error) {
@@ -2076,8 +2210,7 @@ func (s *Server) handleGetContributorInsights(ctx context.Context, req mcp.CallT
 		response["top_expert"] = insights[0].Author
 	}
 
-	jsonResult, _ := json.MarshalIndent(response, "", "  ")
-	return mcp.NewToolResultText(string(jsonResult)), nil
+	return s.jsonResult(response), nil
 }
 
 func (s *Server) handleIndexGitHistory(ctx context.Context, req mcp.CallToolRequest) (*mcp.CallToolResult, error) {
@@ -2153,6 +2286,12 @@ func (s *Server) handleIndexGitHistory(ctx context.Context, req mcp.CallToolRequ
 	// Process changes for each commit
 	totalChanges := 0
 	for _, commit := range commits {
+		// The last indexed commit is not advanced, so a cancelled run is
+		// resumed by the next one
+		if ctx.Err() != nil {
+			return mcp.NewToolResultError("git history indexing cancelled"), nil
+		}
+
 		changes, err := gitAnalyzer.GetChangesForCommit(commit.Hash)
 		if err != nil {
 			continue
@@ -2184,8 +2323,7 @@ func (s *Server) handleIndexGitHistory(ctx context.Context, req mcp.CallToolRequ
 		"oldest_commit":  commits[len(commits)-1].ShortHash,
 	}
 
-	jsonResult, _ := json.MarshalIndent(result, "", "  ")
-	return mcp.NewToolResultText(string(jsonResult)), nil
+	return s.jsonResult(result), nil
 }
 
 func (s *Server) handleGetGitHistoryStatus(ctx context.Context, req mcp.CallToolRequest) (*mcp.CallToolResult, error) {
@@ -2224,8 +2362,19 @@ func (s *Server) handleGetGitHistoryStatus(ctx context.Context, req mcp.CallTool
 		result["last_indexed_at"] = stats.LastIndexed.Format("2006-01-02 15:04:05")
 	}
 
-	jsonResult, _ := json.MarshalIndent(result, "", "  ")
-	return mcp.NewToolResultText(string(jsonResult)), nil
+	// Database size as stored, and as it would be with uncompressed diffs
+	result["diff_storage"] = map[string]any{
+		"raw_bytes":         stats.DiffRawBytes,
+		"stored_bytes":      stats.DiffStoredBytes,
+		"compression_ratio": math.Round(stats.DiffCompressionRatio*100) / 100,
+	}
+	result["db_size_bytes"] = stats.DBSizeBytes
+	result["db_size_uncompressed_bytes"] = stats.DBSizeBytes - stats.DBFreeBytes - stats.DiffStoredBytes + stats.DiffRawBytes
+	if stats.DBFreeBytes > 0 {
+		result["db_free_bytes"] = stats.DBFreeBytes
+	}
+
+	return s.jsonResult(result), nil
 }
 
 // Memory handlers
@@ -2293,8 +2442,28 @@ func (s *Server) handleMemoryStore(ctx context.Context, req mcp.CallToolRequest)
 		"channel": memory.Channel,
 	}
 
-	jsonResult, _ := json.MarshalIndent(result, "", "  ")
-	return mcp.NewToolResultText(string(jsonResult)), nil
+	return s.jsonResult(result), nil
+}
+
+// recalledMemory is one result of memory_recall.
+type recalledMemory struct {
+	ID         string               `json:"id"`
+	Content    string               `json:"content"`
+	Category   types.MemoryCategory `json:"category"`
+	Importance float32              `json:"importance"`
+	Confidence float32              `json:"confidence"`
+	Score      float32              `json:"score"`
+	CreatedAt  string               `json:"created_at"`
+	Tags       []string             `json:"tags,omitempty"`
+	Summary    string               `json:"summary,omitempty"`
+}
+
+// memoryRecallResponse is the result of memory_recall.
+type memoryRecallResponse struct {
+	Query    string           `json:"query"`
+	Channel  string           `json:"channel"`
+	Count    int              `json:"count"`
+	Memories []recalledMemory `json:"memories"`
 }
 
 func (s *Server) handleMemoryRecall(ctx context.Context, req mcp.CallToolRequest) (*mcp.CallToolResult, error) {
@@ -2314,6 +2483,7 @@ func (s *Server) handleMemoryRecall(ctx context.Context, req mcp.CallToolRequest
 	categoriesStr := req.GetStringSlice("categories", nil)
 	tags := req.GetStringSlice("tags", nil)
 	minImportance := float32(req.GetFloat("min_importance", 0.0))
+	minConfidence := float32(req.GetFloat("min_confidence", 0.0))
 
 	// Convert categories
 	var categories []types.MemoryCategory
@@ -2337,6 +2507,7 @@ func (s *Server) handleMemoryRecall(ctx context.Context, req mcp.CallToolRequest
 		Categories:    categories,
 		Tags:          tags,
 		MinImportance: minImportance,
+		MinConfidence: minConfidence,
 		Limit:         limit,
 	}
 
@@ -2346,37 +2517,29 @@ func (s *Server) handleMemoryRecall(ctx context.Context, req mcp.CallToolRequest
 	}
 
 	// Format results
-	var formatted []map[string]any
+	var formatted []recalledMemory
 	for _, r := range results {
-		entry := map[string]any{
-			"id":         r.Memory.ID,
-			"content":    r.Memory.Content,
-			"category":   r.Memory.Category,
-			"importance": r.Memory.Importance,
-			"confidence": r.Memory.Confidence,
-			"score":      r.Score,
-			"created_at": r.Memory.CreatedAt.Format("2006-01-02 15:04"),
-		}
-
-		if len(r.Memory.Tags) > 0 {
-			entry["tags"] = r.Memory.Tags
-		}
-		if r.Memory.Summary != "" {
-			entry["summary"] = r.Memory.Summary
-		}
-
-		formatted = append(formatted, entry)
+		formatted = append(formatted, recalledMemory{
+			ID:         r.Memory.ID,
+			Content:    r.Memory.Content,
+			Category:   r.Memory.Category,
+			Importance: r.Memory.Importance,
+			Confidence: r.Memory.Confidence,
+			Score:      r.Score,
+			CreatedAt:  r.Memory.CreatedAt.Format("2006-01-02 15:04"),
+			Tags:       r.Memory.Tags,
+			Summary:    r.Memory.Summary,
+		})
 	}
 
-	response := map[string]any{
-		"query":    query,
-		"channel":  channel,
-		"count":    len(formatted),
-		"memories": formatted,
+	response := memoryRecallResponse{
+		Query:    query,
+		Channel:  channel,
+		Count:    len(formatted),
+		Memories: formatted,
 	}
 
-	jsonResult, _ := json.MarshalIndent(response, "", "  ")
-	return mcp.NewToolResultText(string(jsonResult)), nil
+	return s.jsonResult(response), nil
 }
 
 func (s *Server) handleMemoryForget(ctx context.Context, req mcp.CallToolRequest) (*mcp.CallToolResult, error) {
@@ -2400,8 +2563,7 @@ func (s *Server) handleMemoryForget(ctx context.Context, req mcp.CallToolRequest
 		"id":      id,
 	}
 
-	jsonResult, _ := json.MarshalIndent(result, "", "  ")
-	return mcp.NewToolResultText(string(jsonResult)), nil
+	return s.jsonResult(result), nil
 }
 
 func (s *Server) handleMemoryCheckpoint(ctx context.Context, req mcp.CallToolRequest) (*mcp.CallToolResult, error) {
@@ -2440,8 +2602,7 @@ func (s *Server) handleMemoryCheckpoint(ctx context.Context, req mcp.CallToolReq
 		"created_at": checkpoint.CreatedAt.Format("2006-01-02 15:04:05"),
 	}
 
-	jsonResult, _ := json.MarshalIndent(result, "", "  ")
-	return mcp.NewToolResultText(string(jsonResult)), nil
+	return s.jsonResult(result), nil
 }
 
 func (s *Server) handleMemoryRestore(ctx context.Context, req mcp.CallToolRequest) (*mcp.CallToolResult, error) {
@@ -2465,8 +2626,7 @@ func (s *Server) handleMemoryRestore(ctx context.Context, req mcp.CallToolReques
 		"checkpoint_id": checkpointID,
 	}
 
-	jsonResult, _ := json.MarshalIndent(result, "", "  ")
-	return mcp.NewToolResultText(string(jsonResult)), nil
+	return s.jsonResult(result), nil
 }
 
 func (s *Server) handleMemoryStats(ctx context.Context, req mcp.CallToolRequest) (*mcp.CallToolResult, error) {
@@ -2508,8 +2668,7 @@ func (s *Server) handleMemoryStats(ctx context.Context, req mcp.CallToolRequest)
 		result["newest_memory"] = stats.NewestMemory.Format("2006-01-02")
 	}
 
-	jsonResult, _ := json.MarshalIndent(result, "", "  ")
-	return mcp.NewToolResultText(string(jsonResult)), nil
+	return s.jsonResult(result), nil
 }
 
 // Todo handlers
@@ -2589,8 +2748,27 @@ func (s *Server) handleTodoCreate(ctx context.Context, req mcp.CallToolRequest)
 		"channel":  todo.Channel,
 	}
 
-	jsonResult, _ := json.MarshalIndent(result, "", "  ")
-	return mcp.NewToolResultText(string(jsonResult)), nil
+	return s.jsonResult(result), nil
+}
+
+// todoListItem is one result of todo_list.
+type todoListItem struct {
+	ID          string             `json:"id"`
+	Title       string             `json:"title"`
+	Status      types.TodoStatus   `json:"status"`
+	Priority    types.TodoPriority `json:"priority"`
+	Progress    int                `json:"progress"`
+	Description string             `json:"description,omitempty"`
+	Tags        []string           `json:"tags,omitempty"`
+	DueDate     string             `json:"due_date,omitempty"`
+	ParentID    string             `json:"parent_id,omitempty"`
+}
+
+// todoListResponse is the result of todo_list.
+type todoListResponse struct {
+	Channel string         `json:"channel"`
+	Count   int            `json:"count"`
+	Todos   []todoListItem `json:"todos"`
 }
 
 func (s *Server) handleTodoList(ctx context.Context, req mcp.CallToolRequest) (*mcp.CallToolResult, error) {
@@ -2626,40 +2804,32 @@ func (s *Server) handleTodoList(ctx context.Context, req mcp.CallToolRequest) (*
 	}
 
 	// Format results
-	var formatted []map[string]any
+	var formatted []todoListItem
 	for _, t := range todos {
-		entry := map[string]any{
-			"id":       t.ID,
-			"title":    t.Title,
-			"status":   t.Status,
-			"priority": t.Priority,
-			"progress": t.Progress,
-		}
-
-		if t.Description != "" {
-			entry["description"] = t.Description
-		}
-		if len(t.Tags) > 0 {
-			entry["tags"] = t.Tags
+		entry := todoListItem{
+			ID:          t.ID,
+			Title:       t.Title,
+			Status:      t.Status,
+			Priority:    t.Priority,
+			Progress:    t.Progress,
+			Description: t.Description,
+			Tags:        t.Tags,
+			ParentID:    t.ParentID,
 		}
 		if t.DueDate != nil {
-			entry["due_date"] = t.DueDate.Format("2006-01-02")
-		}
-		if t.ParentID != "" {
-			entry["parent_id"] = t.ParentID
+			entry.DueDate = t.DueDate.Format("2006-01-02")
 		}
 
 		formatted = append(formatted, entry)
 	}
 
-	response := map[string]any{
-		"channel": channel,
-		"count":   len(formatted),
-		"todos":   formatted,
+	response := todoListResponse{
+		Channel: channel,
+		Count:   len(formatted),
+		Todos:   formatted,
 	}
 
-	jsonResult, _ := json.MarshalIndent(response, "", "  ")
-	return mcp.NewToolResultText(string(jsonResult)), nil
+	return s.jsonResult(response), nil
 }
 
 func (s *Server) handleTodoSearch(ctx context.Context, req mcp.CallToolRequest) (*mcp.CallToolResult, error) {
@@ -2725,8 +2895,7 @@ func (s *Server) handleTodoSearch(ctx context.Context, req mcp.CallToolRequest)
 		"results": formatted,
 	}
 
-	jsonResult, _ := json.MarshalIndent(response, "", "  ")
-	return mcp.NewToolResultText(string(jsonResult)), nil
+	return s.jsonResult(response), nil
 }
 
 func (s *Server) handleTodoUpdate(ctx context.Context, req mcp.CallToolRequest) (*mcp.CallToolResult, error) {
@@ -2802,8 +2971,7 @@ func (s *Server) handleTodoUpdate(ctx context.Context, req mcp.CallToolRequest)
 		"progress": todo.Progress,
 	}
 
-	jsonResult, _ := json.MarshalIndent(result, "", "  ")
-	return mcp.NewToolResultText(string(jsonResult)), nil
+	return s.jsonResult(result), nil
 }
 
 func (s *Server) handleTodoComplete(ctx context.Context, req mcp.CallToolRequest) (*mcp.CallToolResult, error) {
@@ -2828,8 +2996,7 @@ func (s *Server) handleTodoComplete(ctx context.Context, req mcp.CallToolRequest
 		"status":  "completed",
 	}
 
-	jsonResult, _ := json.MarshalIndent(result, "", "  ")
-	return mcp.NewToolResultText(string(jsonResult)), nil
+	return s.jsonResult(result), nil
 }
 
 func (s *Server) handleTodoDelete(ctx context.Context, req mcp.CallToolRequest) (*mcp.CallToolResult, error) {
@@ -2853,8 +3020,7 @@ func (s *Server) handleTodoDelete(ctx context.Context, req mcp.CallToolRequest)
 		"id":      id,
 	}
 
-	jsonResult, _ := json.MarshalIndent(result, "", "  ")
-	return mcp.NewToolResultText(string(jsonResult)), nil
+	return s.jsonResult(result), nil
 }
 
 func (s *Server) handleTodoStats(ctx context.Context, req mcp.CallToolRequest) (*mcp.CallToolResult, error) {
@@ -2894,27 +3060,14 @@ func (s *Server) handleTodoStats(ctx context.Context, req mcp.CallToolRequest) (
 		result["by_channel"] = stats.TodosByChannel
 	}
 
-	jsonResult, _ := json.MarshalIndent(result, "", "  ")
-	return mcp.NewToolResultText(string(jsonResult)), nil
+	return s.jsonResult(result), nil
 }
 
 // getCurrentBranch returns the current git branch or "default" if not in a git repo.
 func (s *Server) getCurrentBranch() string {
-	// Try to read git HEAD
-	headPath := filepath.Join(s.projectDir, ".git", "HEAD")
-	data, err := os.ReadFile(headPath)
-	if err != nil {
-		return "default"
-	}
-
-	content := strings.TrimSpace(string(data))
-	if strings.HasPrefix(content, "ref: refs/heads/") {
-		return strings.TrimPrefix(content, "ref: refs/heads/")
-	}
-
-	// Detached HEAD or other state
-	if len(content) >= 8 {
-		return content[:8] // Short hash
+	// Detached HEAD yields the short hash
+	if branch := memory.CurrentBranch(s.projectDir); branch != "" {
+		return branch
 	}
 	return "default"
 }
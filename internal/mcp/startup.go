@@ -0,0 +1,113 @@
+package mcp
+
+import (
+	"context"
+	"log/slog"
+	"sync"
+	"time"
+)
+
+// Provider warmup (loading or pulling models) can take seconds to minutes,
+// so it runs in the background after the server starts answering. Tools
+// that embed or rerank wait for it; lookups do not.
+
+// warmupStatus tracks the background warmup of the providers.
+type warmupStatus struct {
+	done chan struct{}
+
+	mu      sync.Mutex
+	started time.Time
+	tasks   map[string]string // Provider -> "warming", "ready" or the error
+	elapsed time.Duration
+}
+
+// Warmup warms up the embedding provider and reranker in the background.
+// Search and indexing tools wait until it has finished.
+func (s *Server) Warmup(ctx context.Context) {
+	w := &warmupStatus{
+		done:    make(chan struct{}),
+		started: time.Now(),
+		tasks:   make(map[string]string),
+	}
+	s.warmup = w
+
+	type task struct {
+		name string
+		run  func(context.Context) error
+	}
+	var tasks []task
+	if s.embedding != nil {
+		tasks = append(tasks, task{"embedding", s.embedding.Warmup})
+	}
+	if s.reranker != nil {
+		tasks = append(tasks, task{"reranker", s.reranker.Warmup})
+	}
+	for _, t := range tasks {
+		w.tasks[t.name] = "warming"
+	}
+
+	go func() {
+		var wg sync.WaitGroup
+		for _, t := range tasks {
+			wg.Add(1)
+			go func(t task) {
+				defer wg.Done()
+				state := "ready"
+				if err := t.run(ctx); err != nil {
+					slog.Warn(t.name+" warmup failed", "error", err)
+					state = err.Error()
+				}
+				w.mu.Lock()
+				w.tasks[t.name] = state
+				w.mu.Unlock()
+			}(t)
+		}
+		wg.Wait()
+
+		w.mu.Lock()
+		w.elapsed = time.Since(w.started)
+		w.mu.Unlock()
+		close(w.done)
+		slog.Info("providers ready", "elapsed", w.elapsed)
+	}()
+}
+
+// awaitWarmup blocks until warmup has finished or ctx ends. It returns at
+// once if Warmup was never called.
+func (s *Server) awaitWarmup(ctx context.Context) error {
+	if s.warmup == nil {
+		return nil
+	}
+	select {
+	case <-s.warmup.done:
+		return nil
+	case <-ctx.Done():
+		return ctx.Err()
+	}
+}
+
+// warmupState reports the warmup progress for get_status.
+func (s *Server) warmupState() map[string]any {
+	w := s.warmup
+	if w == nil {
+		return nil
+	}
+
+	w.mu.Lock()
+	defer w.mu.Unlock()
+
+	providers := make(map[string]string, len(w.tasks))
+	for name, st := range w.tasks {
+		providers[name] = st
+	}
+	state := map[string]any{"providers": providers}
+	select {
+	case <-w.done:
+		state["ready"] = true
+		state["elapsed_ms"] = w.elapsed.Milliseconds()
+	default:
+		state["ready"] = false
+		state["elapsed_ms"] = time.Since(w.started).Milliseconds()
+	}
+	return state
+}
@@ -3,7 +3,6 @@ package mcp
 
 import (
 	"context"
-	"encoding/json"
 	"fmt"
 	"path/filepath"
 	"time"
@@ -207,8 +206,7 @@ func (s *Server) handleGetProjectContext(ctx context.Context, req mcp.CallToolRe
 		LastSession:      lastSession,
 	}
 
-	jsonResult, _ := json.MarshalIndent(initData, "", "  ")
-	return mcp.NewToolResultText(string(jsonResult)), nil
+	return s.jsonResult(initData), nil
 }
 
 func (s *Server) getIndexState() memory.IndexState {
@@ -331,8 +329,7 @@ func (s *Server) handleNoteAdd(ctx context.Context, req mcp.CallToolRequest) (*m
 		return mcp.NewToolResultError(fmt.Sprintf("failed to add note: %v", err)), nil
 	}
 
-	jsonResult, _ := json.MarshalIndent(note, "", "  ")
-	return mcp.NewToolResultText(string(jsonResult)), nil
+	return s.jsonResult(note), nil
 }
 
 func (s *Server) handleNoteList(ctx context.Context, req mcp.CallToolRequest) (*mcp.CallToolResult, error) {
@@ -356,8 +353,7 @@ func (s *Server) handleNoteList(ctx context.Context, req mcp.CallToolRequest) (*
 		"notes": notes,
 	}
 
-	jsonResult, _ := json.MarshalIndent(result, "", "  ")
-	return mcp.NewToolResultText(string(jsonResult)), nil
+	return s.jsonResult(result), nil
 }
 
 func (s *Server) handleNoteGet(ctx context.Context, req mcp.CallToolRequest) (*mcp.CallToolResult, error) {
@@ -376,8 +372,7 @@ func (s *Server) handleNoteGet(ctx context.Context, req mcp.CallToolRequest) (*m
 		return mcp.NewToolResultError(fmt.Sprintf("note not found: %v", err)), nil
 	}
 
-	jsonResult, _ := json.MarshalIndent(note, "", "  ")
-	return mcp.NewToolResultText(string(jsonResult)), nil
+	return s.jsonResult(note), nil
 }
 
 func (s *Server) handleNoteUpdate(ctx context.Context, req mcp.CallToolRequest) (*mcp.CallToolResult, error) {
@@ -408,8 +403,7 @@ func (s *Server) handleNoteUpdate(ctx context.Context, req mcp.CallToolRequest)
 		return mcp.NewToolResultError(fmt.Sprintf("failed to update note: %v", err)), nil
 	}
 
-	jsonResult, _ := json.MarshalIndent(note, "", "  ")
-	return mcp.NewToolResultText(string(jsonResult)), nil
+	return s.jsonResult(note), nil
 }
 
 func (s *Server) handleNoteDelete(ctx context.Context, req mcp.CallToolRequest) (*mcp.CallToolResult, error) {
@@ -453,8 +447,7 @@ func (s *Server) handleDecisionAdd(ctx context.Context, req mcp.CallToolRequest)
 		return mcp.NewToolResultError(fmt.Sprintf("failed to add decision: %v", err)), nil
 	}
 
-	jsonResult, _ := json.MarshalIndent(decision, "", "  ")
-	return mcp.NewToolResultText(string(jsonResult)), nil
+	return s.jsonResult(decision), nil
 }
 
 func (s *Server) handleDecisionList(ctx context.Context, req mcp.CallToolRequest) (*mcp.CallToolResult, error) {
@@ -476,8 +469,7 @@ func (s *Server) handleDecisionList(ctx context.Context, req mcp.CallToolRequest
 		"decisions": decisions,
 	}
 
-	jsonResult, _ := json.MarshalIndent(result, "", "  ")
-	return mcp.NewToolResultText(string(jsonResult)), nil
+	return s.jsonResult(result), nil
 }
 
 func (s *Server) handleDecisionGet(ctx context.Context, req mcp.CallToolRequest) (*mcp.CallToolResult, error) {
@@ -506,8 +498,7 @@ func (s *Server) handleDecisionGet(ctx context.Context, req mcp.CallToolRequest)
 		return mcp.NewToolResultError(fmt.Sprintf("decision not found: %v", err)), nil
 	}
 
-	jsonResult, _ := json.MarshalIndent(decision, "", "  ")
-	return mcp.NewToolResultText(string(jsonResult)), nil
+	return s.jsonResult(decision), nil
 }
 
 func (s *Server) handleDecisionUpdate(ctx context.Context, req mcp.CallToolRequest) (*mcp.CallToolResult, error) {
@@ -541,8 +532,7 @@ func (s *Server) handleDecisionUpdate(ctx context.Context, req mcp.CallToolReque
 		return mcp.NewToolResultError(fmt.Sprintf("failed to update decision: %v", err)), nil
 	}
 
-	jsonResult, _ := json.MarshalIndent(decision, "", "  ")
-	return mcp.NewToolResultText(string(jsonResult)), nil
+	return s.jsonResult(decision), nil
 }
 
 // === Issue handlers ===
@@ -567,8 +557,7 @@ func (s *Server) handleIssueAdd(ctx context.Context, req mcp.CallToolRequest) (*
 		return mcp.NewToolResultError(fmt.Sprintf("failed to add issue: %v", err)), nil
 	}
 
-	jsonResult, _ := json.MarshalIndent(issue, "", "  ")
-	return mcp.NewToolResultText(string(jsonResult)), nil
+	return s.jsonResult(issue), nil
 }
 
 func (s *Server) handleIssueList(ctx context.Context, req mcp.CallToolRequest) (*mcp.CallToolResult, error) {
@@ -592,8 +581,7 @@ func (s *Server) handleIssueList(ctx context.Context, req mcp.CallToolRequest) (
 		"issues": issues,
 	}
 
-	jsonResult, _ := json.MarshalIndent(result, "", "  ")
-	return mcp.NewToolResultText(string(jsonResult)), nil
+	return s.jsonResult(result), nil
 }
 
 func (s *Server) handleIssueResolve(ctx context.Context, req mcp.CallToolRequest) (*mcp.CallToolResult, error) {
@@ -617,8 +605,7 @@ func (s *Server) handleIssueResolve(ctx context.Context, req mcp.CallToolRequest
 		return mcp.NewToolResultError(fmt.Sprintf("failed to resolve issue: %v", err)), nil
 	}
 
-	jsonResult, _ := json.MarshalIndent(issue, "", "  ")
-	return mcp.NewToolResultText(string(jsonResult)), nil
+	return s.jsonResult(issue), nil
 }
 
 func (s *Server) handleIssueReopen(ctx context.Context, req mcp.CallToolRequest) (*mcp.CallToolResult, error) {
@@ -637,8 +624,7 @@ func (s *Server) handleIssueReopen(ctx context.Context, req mcp.CallToolRequest)
 		return mcp.NewToolResultError(fmt.Sprintf("failed to reopen issue: %v", err)), nil
 	}
 
-	jsonResult, _ := json.MarshalIndent(issue, "", "  ")
-	return mcp.NewToolResultText(string(jsonResult)), nil
+	return s.jsonResult(issue), nil
 }
 
 func (s *Server) handleGitHubSync(ctx context.Context, req mcp.CallToolRequest) (*mcp.CallToolResult, error) {
@@ -696,8 +682,7 @@ func (s *Server) handleGitHubSync(ctx context.Context, req mcp.CallToolRequest)
 		response["errors"] = errStrings
 	}
 
-	jsonResult, _ := json.MarshalIndent(response, "", "  ")
-	return mcp.NewToolResultText(string(jsonResult)), nil
+	return s.jsonResult(response), nil
 }
 
 // === Session handlers ===
@@ -759,8 +744,7 @@ func (s *Server) handleSessionGetHistory(ctx context.Context, req mcp.CallToolRe
 		"sessions": sessions,
 	}
 
-	jsonResult, _ := json.MarshalIndent(result, "", "  ")
-	return mcp.NewToolResultText(string(jsonResult)), nil
+	return s.jsonResult(result), nil
 }
 
 // === Memory Merge handler ===
@@ -793,16 +777,27 @@ func (s *Server) handleMemoryMerge(ctx context.Context, req mcp.CallToolRequest)
 		return mcp.NewToolResultError(fmt.Sprintf("merge failed: %v", err)), nil
 	}
 
-	jsonResult, _ := json.MarshalIndent(result, "", "  ")
-	return mcp.NewToolResultText(string(jsonResult)), nil
+	return s.jsonResult(result), nil
 }
 
 // Helper functions
 
+// getProjectMemoryStore returns the server's project memory store, opening
+// it on first use. It is closed with the server.
 func (s *Server) getProjectMemoryStore() (*memory.Store, error) {
-	return memory.NewStore(memory.StoreConfig{
-		ProjectDir: s.projectDir,
-	})
+	s.memoryMu.Lock()
+	defer s.memoryMu.Unlock()
+
+	if s.memoryStore == nil {
+		store, err := memory.NewStore(memory.StoreConfig{
+			ProjectDir: s.projectDir,
+		})
+		if err != nil {
+			return nil, err
+		}
+		s.memoryStore = store
+	}
+	return s.memoryStore, nil
 }
 
 func formatMemoryDuration(d time.Duration) string {
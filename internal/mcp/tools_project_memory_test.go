@@ -0,0 +1,46 @@
+package mcp
+
+import (
+	"os"
+	"path/filepath"
+	"testing"
+
+	"github.com/spetr/mcp-codewizard/internal/memory"
+)
+
+func TestProjectMemoryStoreReused(t *testing.T) {
+	tmpDir, err := os.MkdirTemp("", "mcp-memory-test-*")
+	if err != nil {
+		t.Fatal(err)
+	}
+	defer os.RemoveAll(tmpDir)
+
+	s := &Server{projectDir: tmpDir}
+	store, err := s.getProjectMemoryStore()
+	if err != nil {
+		t.Fatal(err)
+	}
+	again, err := s.getProjectMemoryStore()
+	if err != nil {
+		t.Fatal(err)
+	}
+	if store != again {
+		t.Error("memory store opened again on the second call")
+	}
+
+	if _, err := store.AddNote(memory.AddNoteRequest{Title: "Reused", Content: "one store"}); err != nil {
+		t.Fatal(err)
+	}
+
+	// Closing the server compacts the journal into the canonical file
+	if err := s.Close(); err != nil {
+		t.Fatalf("Close failed: %v", err)
+	}
+	notesPath := filepath.Join(tmpDir, ".mcp-codewizard", "memory", "notes.jsonl")
+	if _, err := os.Stat(notesPath); err != nil {
+		t.Errorf("notes not compacted on close: %v", err)
+	}
+	if s.memoryStore != nil {
+		t.Error("memory store kept after close")
+	}
+}
@@ -3,7 +3,6 @@ package mcp
 
 import (
 	"context"
-	"encoding/json"
 	"fmt"
 	"os"
 	"path/filepath"
@@ -84,11 +83,70 @@ func (s *Server) handleGetProjectTree(ctx context.Context, req mcp.CallToolReque
 		md := s.formatTreeAsMarkdown(root, 0)
 		return mcp.NewToolResultText(md), nil
 	default: // json
-		jsonResult, _ := json.MarshalIndent(result, "", "  ")
-		return mcp.NewToolResultText(string(jsonResult)), nil
+		return s.jsonResult(result), nil
 	}
 }
 
+// trimList lets an over-budget tree be cut to its first nodes in
+// breadth-first order, so the top levels survive and deep ones go first.
+func (r *TreeResult) trimList() *resultList {
+	nodes := countTreeNodes(r.Root) - 1 // The root is always kept
+	if nodes < 2 {
+		return nil
+	}
+	return &resultList{
+		name: "tree nodes",
+		size: nodes,
+		cut: func(n int) any {
+			cp := *r
+			cp.Root = pruneTree(r.Root, n)
+			cp.Truncated = true
+			return &cp
+		},
+	}
+}
+
+// countTreeNodes returns the number of nodes in a tree.
+func countTreeNodes(node *TreeNode) int {
+	if node == nil {
+		return 0
+	}
+	n := 1
+	for _, child := range node.Children {
+		n += countTreeNodes(child)
+	}
+	return n
+}
+
+// pruneTree returns a copy of a tree with the root and its first n
+// descendants in breadth-first order. Directory counts keep describing the
+// full tree.
+func pruneTree(root *TreeNode, n int) *TreeNode {
+	if root == nil {
+		return nil
+	}
+
+	type pair struct{ orig, cp *TreeNode }
+	rootCopy := *root
+	rootCopy.Children = nil
+	queue := []pair{{root, &rootCopy}}
+	for len(queue) > 0 && n > 0 {
+		p := queue[0]
+		queue = queue[1:]
+		for _, child := range p.orig.Children {
+			if n == 0 {
+				break
+			}
+			childCopy := *child
+			childCopy.Children = nil
+			p.cp.Children = append(p.cp.Children, &childCopy)
+			queue = append(queue, pair{child, &childCopy})
+			n--
+		}
+	}
+	return &rootCopy
+}
+
 type treeStats struct {
 	files     int
 	dirs      int
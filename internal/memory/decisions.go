@@ -59,9 +59,10 @@ func (s *Store) AddDecision(req AddDecisionRequest) (*Decision, error) {
 
 	s.mu.Lock()
 	s.decisions = append(s.decisions, decision)
+	s.decisionIdx.put(decision.ID, len(s.decisions)-1, decisionDoc(&decision))
 	s.mu.Unlock()
 
-	if err := s.Save(); err != nil {
+	if err := appendOp(s, decisionsFile, opPut, decision.ID, &decision); err != nil {
 		return nil, fmt.Errorf("failed to save decision: %w", err)
 	}
 
@@ -73,10 +74,8 @@ func (s *Store) GetDecision(id string) (*Decision, error) {
 	s.mu.RLock()
 	defer s.mu.RUnlock()
 
-	for i := range s.decisions {
-		if s.decisions[i].ID == id {
-			return &s.decisions[i], nil
-		}
+	if i, ok := s.decisionIdx.position(id); ok {
+		return &s.decisions[i], nil
 	}
 
 	return nil, fmt.Errorf("decision not found: %s", id)
@@ -99,17 +98,11 @@ func (s *Store) UpdateDecision(req UpdateDecisionRequest) (*Decision, error) {
 	s.mu.Lock()
 	defer s.mu.Unlock()
 
-	var decision *Decision
-	for i := range s.decisions {
-		if s.decisions[i].ID == req.ID {
-			decision = &s.decisions[i]
-			break
-		}
-	}
-
-	if decision == nil {
+	i, ok := s.decisionIdx.position(req.ID)
+	if !ok {
 		return nil, fmt.Errorf("decision not found: %s", req.ID)
 	}
+	decision := &s.decisions[i]
 
 	if req.Title != nil {
 		decision.Title = *req.Title
@@ -135,15 +128,12 @@ func (s *Store) UpdateDecision(req UpdateDecisionRequest) (*Decision, error) {
 	}
 
 	decision.UpdatedAt = time.Now()
+	s.decisionIdx.put(decision.ID, i, decisionDoc(decision))
 
-	// Save after releasing lock
-	s.mu.Unlock()
-	if err := s.Save(); err != nil {
-		s.mu.Lock()
+	if err := appendOp(s, decisionsFile, opPut, decision.ID, decision); err != nil {
 		return nil, fmt.Errorf("failed to save decision: %w", err)
 	}
 
-	s.mu.Lock()
 	return decision, nil
 }
 
@@ -177,13 +167,10 @@ func (s *Store) SupersedeDecision(id, supersededByID string) (*Decision, error)
 func (s *Store) DeleteDecision(id string) error {
 	s.mu.Lock()
 
-	found := false
-	for i := range s.decisions {
-		if s.decisions[i].ID == id {
-			s.decisions = append(s.decisions[:i], s.decisions[i+1:]...)
-			found = true
-			break
-		}
+	i, found := s.decisionIdx.position(id)
+	if found {
+		s.decisions = append(s.decisions[:i], s.decisions[i+1:]...)
+		s.decisionIdx.remove(id)
 	}
 	s.mu.Unlock()
 
@@ -191,7 +178,7 @@ func (s *Store) DeleteDecision(id string) error {
 		return fmt.Errorf("decision not found: %s", id)
 	}
 
-	return s.Save()
+	return appendOp[Decision](s, decisionsFile, opDel, id, nil)
 }
 
 // ListDecisionsRequest contains parameters for listing decisions.
@@ -208,55 +195,30 @@ func (s *Store) ListDecisions(req ListDecisionsRequest) []Decision {
 	s.mu.RLock()
 	defer s.mu.RUnlock()
 
-	var result []Decision
-
-	for _, decision := range s.decisions {
-		// Filter by status
-		if len(req.Status) > 0 {
-			hasStatus := false
-			for _, status := range req.Status {
-				if string(decision.Status) == status {
-					hasStatus = true
-					break
-				}
-			}
-			if !hasStatus {
-				continue
-			}
-		}
+	idx := s.decisionIdx
+	var sets []idSet
 
-		// Filter by author
-		if req.Author != "" && !strings.EqualFold(decision.Author, req.Author) {
-			continue
-		}
-
-		// Search in title, context, decision
-		if req.Search != "" {
-			searchLower := strings.ToLower(req.Search)
-			if !strings.Contains(strings.ToLower(decision.Title), searchLower) &&
-				!strings.Contains(strings.ToLower(decision.Context), searchLower) &&
-				!strings.Contains(strings.ToLower(decision.Decision), searchLower) {
-				continue
-			}
-		}
-
-		result = append(result, decision)
+	// Filter by status
+	if len(req.Status) > 0 {
+		sets = append(sets, idx.lookup(fieldStatus, req.Status...))
 	}
 
-	// Apply offset
-	if req.Offset > 0 {
-		if req.Offset >= len(result) {
-			return nil
-		}
-		result = result[req.Offset:]
+	// Filter by author
+	if req.Author != "" {
+		sets = append(sets, idx.lookup(fieldAuthor, strings.ToLower(req.Author)))
 	}
 
-	// Apply limit
-	if req.Limit > 0 && req.Limit < len(result) {
-		result = result[:req.Limit]
+	// Search in title, context, decision
+	var match func(id string) bool
+	if req.Search != "" {
+		if candidates, ok := idx.search(req.Search); ok {
+			sets = append(sets, candidates)
+		}
+		searchLower := strings.ToLower(req.Search)
+		match = func(id string) bool { return idx.matchText(id, searchLower) }
 	}
 
-	return result
+	return collect(s.decisions, idx.query(len(s.decisions), sets, match, req.Offset, req.Limit))
 }
 
 // GetActiveDecisions returns all non-deprecated, non-superseded decisions.
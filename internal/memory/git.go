@@ -6,7 +6,6 @@ import (
 	"os"
 	"os/exec"
 	"path/filepath"
-	"strconv"
 	"strings"
 )
 
@@ -26,175 +25,134 @@ func NewGitIntegration(store *Store) *GitIntegration {
 
 // IsGitRepo checks if the project is a git repository.
 func (g *GitIntegration) IsGitRepo() bool {
-	gitDir := filepath.Join(g.projectDir, ".git")
-	info, err := os.Stat(gitDir)
-	if err != nil {
-		return false
-	}
-	return info.IsDir()
+	return gitStateFor(g.projectDir) != nil
 }
 
-// GetCurrentBranch returns the current git branch.
+// GetCurrentBranch returns the current git branch, or "HEAD" when detached.
 func (g *GitIntegration) GetCurrentBranch() string {
-	cmd := exec.Command("git", "rev-parse", "--abbrev-ref", "HEAD")
-	cmd.Dir = g.projectDir
-	output, err := cmd.Output()
-	if err != nil {
+	p := gitStateFor(g.projectDir)
+	if p == nil {
 		return ""
 	}
-	return strings.TrimSpace(string(output))
+	branch, commit := p.head()
+	if branch == "" && commit != "" {
+		return "HEAD"
+	}
+	return branch
 }
 
 // GetCurrentCommit returns the current commit hash.
 func (g *GitIntegration) GetCurrentCommit() string {
-	cmd := exec.Command("git", "rev-parse", "HEAD")
-	cmd.Dir = g.projectDir
-	output, err := cmd.Output()
-	if err != nil {
+	p := gitStateFor(g.projectDir)
+	if p == nil {
 		return ""
 	}
-	return strings.TrimSpace(string(output))[:7]
+	_, commit := p.head()
+	if len(commit) < 7 {
+		return commit
+	}
+	return commit[:7]
 }
 
 // GetCommitMessage returns the current commit message.
 func (g *GitIntegration) GetCommitMessage() string {
-	cmd := exec.Command("git", "log", "-1", "--format=%s")
-	cmd.Dir = g.projectDir
-	output, err := cmd.Output()
-	if err != nil {
+	p := gitStateFor(g.projectDir)
+	if p == nil {
 		return ""
 	}
-	return strings.TrimSpace(string(output))
+	return p.commitMessage(g.projectDir)
 }
 
 // GetRemoteURL returns the remote origin URL.
 func (g *GitIntegration) GetRemoteURL() string {
-	cmd := exec.Command("git", "remote", "get-url", "origin")
-	cmd.Dir = g.projectDir
-	output, err := cmd.Output()
-	if err != nil {
+	p := gitStateFor(g.projectDir)
+	if p == nil {
 		return ""
 	}
-	return strings.TrimSpace(string(output))
+	return p.remoteURL(g.projectDir)
 }
 
 // IsDirty returns true if there are uncommitted changes.
 func (g *GitIntegration) IsDirty() bool {
-	cmd := exec.Command("git", "status", "--porcelain")
-	cmd.Dir = g.projectDir
-	output, err := cmd.Output()
-	if err != nil {
-		return false
-	}
-	return len(strings.TrimSpace(string(output))) > 0
+	return len(g.GetDirtyFiles()) > 0
 }
 
 // GetDirtyFiles returns list of modified files.
 func (g *GitIntegration) GetDirtyFiles() []string {
-	cmd := exec.Command("git", "status", "--porcelain")
-	cmd.Dir = g.projectDir
-	output, err := cmd.Output()
-	if err != nil {
+	p := gitStateFor(g.projectDir)
+	if p == nil {
 		return nil
 	}
-
-	var files []string
-	scanner := bufio.NewScanner(strings.NewReader(string(output)))
-	for scanner.Scan() {
-		line := scanner.Text()
-		if len(line) > 3 {
-			files = append(files, strings.TrimSpace(line[3:]))
-		}
-	}
-	return files
+	return p.workingStatus(g.projectDir).dirtyFiles
 }
 
 // GetAheadBehind returns how many commits ahead/behind the remote.
 func (g *GitIntegration) GetAheadBehind() (ahead, behind int) {
-	cmd := exec.Command("git", "rev-list", "--left-right", "--count", "HEAD...@{upstream}")
-	cmd.Dir = g.projectDir
-	output, err := cmd.Output()
-	if err != nil {
+	p := gitStateFor(g.projectDir)
+	if p == nil {
 		return 0, 0
 	}
-
-	parts := strings.Fields(string(output))
-	if len(parts) >= 2 {
-		ahead, _ = strconv.Atoi(parts[0])
-		behind, _ = strconv.Atoi(parts[1])
-	}
-	return
+	st := p.workingStatus(g.projectDir)
+	return st.ahead, st.behind
 }
 
 // IsMergeInProgress returns true if a merge is in progress.
 func (g *GitIntegration) IsMergeInProgress() bool {
-	mergePath := filepath.Join(g.projectDir, ".git", "MERGE_HEAD")
-	_, err := os.Stat(mergePath)
-	return err == nil
+	p := gitStateFor(g.projectDir)
+	return p != nil && p.mergeInProgress()
 }
 
 // IsRebaseInProgress returns true if a rebase is in progress.
 func (g *GitIntegration) IsRebaseInProgress() bool {
-	rebasePaths := []string{
-		filepath.Join(g.projectDir, ".git", "rebase-merge"),
-		filepath.Join(g.projectDir, ".git", "rebase-apply"),
-	}
-	for _, path := range rebasePaths {
-		if _, err := os.Stat(path); err == nil {
-			return true
-		}
-	}
-	return false
+	p := gitStateFor(g.projectDir)
+	return p != nil && p.rebaseInProgress()
 }
 
 // GetConflictFiles returns list of files with merge conflicts.
 func (g *GitIntegration) GetConflictFiles() []string {
-	cmd := exec.Command("git", "diff", "--name-only", "--diff-filter=U")
-	cmd.Dir = g.projectDir
-	output, err := cmd.Output()
-	if err != nil {
+	p := gitStateFor(g.projectDir)
+	if p == nil {
 		return nil
 	}
-
-	var files []string
-	scanner := bufio.NewScanner(strings.NewReader(string(output)))
-	for scanner.Scan() {
-		files = append(files, scanner.Text())
-	}
-	return files
+	return p.workingStatus(g.projectDir).conflictFiles
 }
 
-// GetGitState returns the complete git state.
+// GetGitState returns the complete git state. Working tree status comes
+// from a single cached `git status` call.
 func (g *GitIntegration) GetGitState() GitState {
-	ahead, behind := g.GetAheadBehind()
+	p := gitStateFor(g.projectDir)
+	if p == nil {
+		return GitState{}
+	}
+	st := p.workingStatus(g.projectDir)
 
 	return GitState{
 		Branch:           g.GetCurrentBranch(),
 		Commit:           g.GetCurrentCommit(),
-		CommitMessage:    g.GetCommitMessage(),
-		IsDirty:          g.IsDirty(),
-		DirtyFiles:       g.GetDirtyFiles(),
-		Remote:           g.GetRemoteURL(),
-		Ahead:            ahead,
-		Behind:           behind,
-		MergeInProgress:  g.IsMergeInProgress(),
-		RebaseInProgress: g.IsRebaseInProgress(),
-		ConflictFiles:    g.GetConflictFiles(),
+		CommitMessage:    p.commitMessage(g.projectDir),
+		IsDirty:          len(st.dirtyFiles) > 0,
+		DirtyFiles:       st.dirtyFiles,
+		Remote:           p.remoteURL(g.projectDir),
+		Ahead:            st.ahead,
+		Behind:           st.behind,
+		MergeInProgress:  p.mergeInProgress(),
+		RebaseInProgress: p.rebaseInProgress(),
+		ConflictFiles:    st.conflictFiles,
 	}
 }
 
 // GetProjectID returns a unique project ID based on git.
 func (g *GitIntegration) GetProjectID() string {
 	// Use the hash of the first commit as project ID
-	cmd := exec.Command("git", "rev-list", "--max-parents=0", "HEAD")
-	cmd.Dir = g.projectDir
-	output, err := cmd.Output()
-	if err != nil {
+	var commit string
+	if p := gitStateFor(g.projectDir); p != nil {
+		commit = p.rootCommitHash(g.projectDir)
+	}
+	if commit == "" {
 		// Fallback to directory name
 		return filepath.Base(g.projectDir)
 	}
 
-	commit := strings.TrimSpace(string(output))
 	if len(commit) > 8 {
 		return commit[:8]
 	}
@@ -361,6 +319,13 @@ func (g *GitIntegration) GetChangedFilesSinceCommit(commit string) []string {
 
 // StageMemoryFiles stages all memory files for commit.
 func (g *GitIntegration) StageMemoryFiles() error {
+	// Journaled changes only reach git once compacted
+	if g.store != nil {
+		if err := g.store.Compact(); err != nil {
+			return err
+		}
+	}
+
 	memoryDir := filepath.Join(g.projectDir, ".mcp-codewizard", "memory")
 
 	cmd := exec.Command("git", "add", memoryDir)
@@ -0,0 +1,348 @@
+package memory
+
+import (
+	"bufio"
+	"bytes"
+	"os"
+	"os/exec"
+	"path/filepath"
+	"strconv"
+	"strings"
+	"sync"
+	"time"
+)
+
+// gitStateProvider answers git state queries from the files under .git
+// where possible and caches everything else. Cached values are keyed by a
+// fingerprint (mtime and size) of the files they derive from, so a stat is
+// all a repeated query costs. Providers are shared per repository so the
+// cache survives the short-lived Store instances the server creates.
+type gitStateProvider struct {
+	gitDir    string // Per-worktree git dir (HEAD, index, MERGE_HEAD)
+	commonDir string // Shared git dir (refs, packed-refs, config)
+
+	mu sync.Mutex
+
+	headKey string
+	branch  string // Empty when HEAD is detached
+	commit  string
+
+	statusKey  string
+	statusTime time.Time
+	status     *gitStatus
+
+	messageCommit string
+	message       string
+
+	remoteKey string
+	remote    string
+
+	rootCommit string
+}
+
+// gitStatus is the parsed output of `git status --porcelain=v2 --branch`.
+type gitStatus struct {
+	dirtyFiles    []string
+	conflictFiles []string
+	ahead, behind int
+}
+
+// statusTTL bounds how stale working tree status may be. Edits to tracked
+// files do not touch anything under .git, so fingerprints alone cannot
+// detect them.
+var statusTTL = 2 * time.Second
+
+var gitProviders sync.Map // projectDir -> *gitStateProvider
+
+// gitStateFor returns the shared provider for a project, or nil if the
+// project is not a git repository.
+func gitStateFor(projectDir string) *gitStateProvider {
+	if p, ok := gitProviders.Load(projectDir); ok {
+		return p.(*gitStateProvider)
+	}
+
+	gitDir := resolveGitDir(projectDir)
+	if gitDir == "" {
+		return nil
+	}
+	commonDir := gitDir
+	if data, err := os.ReadFile(filepath.Join(gitDir, "commondir")); err == nil {
+		commonDir = strings.TrimSpace(string(data))
+		if !filepath.IsAbs(commonDir) {
+			commonDir = filepath.Join(gitDir, commonDir)
+		}
+	}
+
+	p, _ := gitProviders.LoadOrStore(projectDir, &gitStateProvider{gitDir: gitDir, commonDir: commonDir})
+	return p.(*gitStateProvider)
+}
+
+// resolveGitDir finds the git dir of a working tree, following the
+// "gitdir:" file used by worktrees and submodules.
+func resolveGitDir(projectDir string) string {
+	dotGit := filepath.Join(projectDir, ".git")
+	info, err := os.Stat(dotGit)
+	if err != nil {
+		return ""
+	}
+	if info.IsDir() {
+		return dotGit
+	}
+
+	data, err := os.ReadFile(dotGit)
+	if err != nil {
+		return ""
+	}
+	dir, ok := strings.CutPrefix(strings.TrimSpace(string(data)), "gitdir:")
+	if !ok {
+		return ""
+	}
+	dir = strings.TrimSpace(dir)
+	if !filepath.IsAbs(dir) {
+		dir = filepath.Join(projectDir, dir)
+	}
+	return dir
+}
+
+// fingerprint summarizes the mtime and size of files; missing files count.
+func fingerprint(paths ...string) string {
+	var b strings.Builder
+	for _, p := range paths {
+		if info, err := os.Stat(p); err == nil {
+			b.WriteString(strconv.FormatInt(info.ModTime().UnixNano(), 36))
+			b.WriteByte('.')
+			b.WriteString(strconv.FormatInt(info.Size(), 36))
+		}
+		b.WriteByte('|')
+	}
+	return b.String()
+}
+
+// head returns the current branch ("" when detached) and commit hash.
+func (p *gitStateProvider) head() (branch, commit string) {
+	p.mu.Lock()
+	defer p.mu.Unlock()
+
+	if p.commit != "" && p.headFingerprint() == p.headKey {
+		return p.branch, p.commit
+	}
+
+	data, err := os.ReadFile(filepath.Join(p.gitDir, "HEAD"))
+	if err != nil {
+		return "", ""
+	}
+	content := strings.TrimSpace(string(data))
+
+	p.branch, p.commit = "", content
+	if ref, ok := strings.CutPrefix(content, "ref: "); ok {
+		p.branch = strings.TrimPrefix(ref, "refs/heads/")
+		p.commit = p.resolveRef(ref)
+	}
+	p.headKey = p.headFingerprint()
+
+	return p.branch, p.commit
+}
+
+// headFingerprint covers HEAD, packed-refs and the loose ref of the cached
+// branch.
+func (p *gitStateProvider) headFingerprint() string {
+	paths := []string{filepath.Join(p.gitDir, "HEAD"), filepath.Join(p.commonDir, "packed-refs")}
+	if p.branch != "" {
+		paths = append(paths, filepath.Join(p.commonDir, "refs", "heads", filepath.FromSlash(p.branch)))
+	}
+	return fingerprint(paths...)
+}
+
+// resolveRef resolves a ref from its loose file or packed-refs. Returns ""
+// for an unborn branch.
+func (p *gitStateProvider) resolveRef(ref string) string {
+	if data, err := os.ReadFile(filepath.Join(p.commonDir, filepath.FromSlash(ref))); err == nil {
+		return strings.TrimSpace(string(data))
+	}
+
+	data, err := os.ReadFile(filepath.Join(p.commonDir, "packed-refs"))
+	if err != nil {
+		return ""
+	}
+	scanner := bufio.NewScanner(bytes.NewReader(data))
+	for scanner.Scan() {
+		hash, name, ok := strings.Cut(scanner.Text(), " ")
+		if ok && name == ref {
+			return hash
+		}
+	}
+	return ""
+}
+
+// mergeInProgress reports whether MERGE_HEAD exists.
+func (p *gitStateProvider) mergeInProgress() bool {
+	_, err := os.Stat(filepath.Join(p.gitDir, "MERGE_HEAD"))
+	return err == nil
+}
+
+// rebaseInProgress reports whether a rebase state directory exists.
+func (p *gitStateProvider) rebaseInProgress() bool {
+	for _, dir := range []string{"rebase-merge", "rebase-apply"} {
+		if _, err := os.Stat(filepath.Join(p.gitDir, dir)); err == nil {
+			return true
+		}
+	}
+	return false
+}
+
+// workingStatus returns dirty files, conflicts and ahead/behind counts from
+// a single `git status --porcelain=v2 --branch` call, cached for statusTTL
+// or until HEAD, the index or MERGE_HEAD change.
+func (p *gitStateProvider) workingStatus(projectDir string) *gitStatus {
+	p.mu.Lock()
+	defer p.mu.Unlock()
+
+	key := fingerprint(
+		filepath.Join(p.gitDir, "HEAD"),
+		filepath.Join(p.gitDir, "index"),
+		filepath.Join(p.gitDir, "MERGE_HEAD"),
+		filepath.Join(p.commonDir, "packed-refs"),
+	)
+	if p.status != nil && key == p.statusKey && time.Since(p.statusTime) < statusTTL {
+		return p.status
+	}
+
+	cmd := exec.Command("git", "status", "--porcelain=v2", "--branch", "-z")
+	cmd.Dir = projectDir
+	output, err := cmd.Output()
+	if err != nil {
+		return &gitStatus{}
+	}
+
+	p.status = parsePorcelainV2(output)
+	p.statusKey = key
+	p.statusTime = time.Now()
+	return p.status
+}
+
+// parsePorcelainV2 parses NUL-separated `git status --porcelain=v2
+// --branch -z` output.
+func parsePorcelainV2(output []byte) *gitStatus {
+	st := &gitStatus{}
+	entries := strings.Split(string(output), "\x00")
+
+	for i := 0; i < len(entries); i++ {
+		entry := entries[i]
+		if entry == "" {
+			continue
+		}
+
+		switch entry[0] {
+		case '#':
+			// # branch.ab +<ahead> -<behind>
+			if ab, ok := strings.CutPrefix(entry, "# branch.ab "); ok {
+				fields := strings.Fields(ab)
+				if len(fields) == 2 {
+					st.ahead, _ = strconv.Atoi(strings.TrimPrefix(fields[0], "+"))
+					st.behind, _ = strconv.Atoi(strings.TrimPrefix(fields[1], "-"))
+				}
+			}
+		case '1':
+			// 1 XY sub mH mI mW hH hI path
+			if fields := strings.SplitN(entry, " ", 9); len(fields) == 9 {
+				st.dirtyFiles = append(st.dirtyFiles, fields[8])
+			}
+		case '2':
+			// 2 XY sub mH mI mW hH hI Xscore path, then origPath
+			if fields := strings.SplitN(entry, " ", 10); len(fields) == 10 {
+				st.dirtyFiles = append(st.dirtyFiles, fields[9])
+			}
+			i++
+		case 'u':
+			// u XY sub m1 m2 m3 mW h1 h2 h3 path
+			if fields := strings.SplitN(entry, " ", 11); len(fields) == 11 {
+				st.dirtyFiles = append(st.dirtyFiles, fields[10])
+				st.conflictFiles = append(st.conflictFiles, fields[10])
+			}
+		case '?':
+			st.dirtyFiles = append(st.dirtyFiles, entry[2:])
+		}
+	}
+
+	return st
+}
+
+// commitMessage returns the subject of the HEAD commit, cached per commit.
+func (p *gitStateProvider) commitMessage(projectDir string) string {
+	_, commit := p.head()
+
+	p.mu.Lock()
+	defer p.mu.Unlock()
+
+	if commit != "" && commit == p.messageCommit {
+		return p.message
+	}
+
+	cmd := exec.Command("git", "log", "-1", "--format=%s")
+	cmd.Dir = projectDir
+	output, err := cmd.Output()
+	if err != nil {
+		return ""
+	}
+
+	p.messageCommit = commit
+	p.message = strings.TrimSpace(string(output))
+	return p.message
+}
+
+// remoteURL returns the origin URL, cached until the git config changes.
+func (p *gitStateProvider) remoteURL(projectDir string) string {
+	p.mu.Lock()
+	defer p.mu.Unlock()
+
+	key := fingerprint(filepath.Join(p.commonDir, "config"))
+	if key == p.remoteKey {
+		return p.remote
+	}
+
+	cmd := exec.Command("git", "remote", "get-url", "origin")
+	cmd.Dir = projectDir
+	output, _ := cmd.Output()
+
+	p.remoteKey = key
+	p.remote = strings.TrimSpace(string(output))
+	return p.remote
+}
+
+// rootCommitHash returns the first root commit; history roots do not change.
+func (p *gitStateProvider) rootCommitHash(projectDir string) string {
+	p.mu.Lock()
+	defer p.mu.Unlock()
+
+	if p.rootCommit != "" {
+		return p.rootCommit
+	}
+
+	cmd := exec.Command("git", "rev-list", "--max-parents=0", "HEAD")
+	cmd.Dir = projectDir
+	output, err := cmd.Output()
+	if err != nil {
+		return ""
+	}
+
+	roots := strings.Fields(string(output))
+	if len(roots) > 0 {
+		p.rootCommit = roots[0]
+	}
+	return p.rootCommit
+}
+
+// CurrentBranch returns the checked-out branch of a project without running
+// git, the short commit hash when HEAD is detached, or "" outside a
+// repository.
+func CurrentBranch(projectDir string) string {
+	p := gitStateFor(projectDir)
+	if p == nil {
+		return ""
+	}
+	branch, commit := p.head()
+	if branch == "" && len(commit) >= 8 {
+		return commit[:8]
+	}
+	return branch
+}
@@ -0,0 +1,95 @@
+package memory
+
+import (
+	"os"
+	"os/exec"
+	"path/filepath"
+	"strings"
+	"testing"
+)
+
+func TestParsePorcelainV2(t *testing.T) {
+	output := strings.Join([]string{
+		"# branch.oid 1234567890abcdef1234567890abcdef12345678",
+		"# branch.head main",
+		"# branch.upstream origin/main",
+		"# branch.ab +2 -1",
+		"1 .M N... 100644 100644 100644 aaaa bbbb file with space.go",
+		"2 R. N... 100644 100644 100644 aaaa aaaa R100 new.go",
+		"old.go",
+		"u UU N... 100644 100644 100644 100644 aaaa bbbb cccc conflict.go",
+		"? untracked.txt",
+		"",
+	}, "\x00")
+
+	st := parsePorcelainV2([]byte(output))
+
+	if st.ahead != 2 || st.behind != 1 {
+		t.Errorf("ahead/behind = %d/%d, want 2/1", st.ahead, st.behind)
+	}
+	want := []string{"file with space.go", "new.go", "conflict.go", "untracked.txt"}
+	if strings.Join(st.dirtyFiles, ",") != strings.Join(want, ",") {
+		t.Errorf("dirtyFiles = %v, want %v", st.dirtyFiles, want)
+	}
+	if len(st.conflictFiles) != 1 || st.conflictFiles[0] != "conflict.go" {
+		t.Errorf("conflictFiles = %v, want [conflict.go]", st.conflictFiles)
+	}
+}
+
+func TestGitStateProviderHead(t *testing.T) {
+	if _, err := exec.LookPath("git"); err != nil {
+		t.Skip("git not available")
+	}
+
+	tmpDir, err := os.MkdirTemp("", "memory-git-test-*")
+	if err != nil {
+		t.Fatal(err)
+	}
+	defer os.RemoveAll(tmpDir)
+
+	git := func(args ...string) string {
+		cmd := exec.Command("git", args...)
+		cmd.Dir = tmpDir
+		cmd.Env = append(os.Environ(),
+			"GIT_AUTHOR_NAME=Test", "GIT_AUTHOR_EMAIL=test@test.com",
+			"GIT_COMMITTER_NAME=Test", "GIT_COMMITTER_EMAIL=test@test.com")
+		out, err := cmd.Output()
+		if err != nil {
+			t.Fatalf("git %v failed: %v", args, err)
+		}
+		return strings.TrimSpace(string(out))
+	}
+
+	git("init", "-q", "-b", "main")
+	os.WriteFile(filepath.Join(tmpDir, "a.txt"), []byte("a"), 0644)
+	git("add", "a.txt")
+	git("commit", "-q", "-m", "first")
+
+	store, err := NewStore(StoreConfig{ProjectDir: tmpDir})
+	if err != nil {
+		t.Fatal(err)
+	}
+	gi := NewGitIntegration(store)
+
+	if b := gi.GetCurrentBranch(); b != "main" {
+		t.Errorf("GetCurrentBranch = %q, want main", b)
+	}
+	if c := gi.GetCurrentCommit(); c != git("rev-parse", "--short=7", "HEAD") {
+		t.Errorf("GetCurrentCommit = %q", c)
+	}
+
+	// Branch switch and packed refs are picked up
+	git("checkout", "-q", "-b", "feature")
+	git("pack-refs", "--all")
+	if b := gi.GetCurrentBranch(); b != "feature" {
+		t.Errorf("GetCurrentBranch after checkout = %q, want feature", b)
+	}
+
+	git("checkout", "-q", "--detach")
+	if b := gi.GetCurrentBranch(); b != "HEAD" {
+		t.Errorf("GetCurrentBranch when detached = %q, want HEAD", b)
+	}
+	if b := CurrentBranch(tmpDir); b != git("rev-parse", "--short=8", "HEAD") {
+		t.Errorf("CurrentBranch when detached = %q", b)
+	}
+}
@@ -0,0 +1,463 @@
+package memory
+
+import (
+	"slices"
+	"strings"
+	"unicode"
+)
+
+// itemIndex maintains secondary indexes over one collection (notes,
+// decisions, todos or issues) so that lookups by ID, list filters and
+// searches only touch candidate items instead of scanning the whole slice.
+// It is guarded by Store.mu like the collection it indexes.
+type itemIndex struct {
+	pos    map[string]int              // ID -> position in the collection slice
+	fields map[string]map[string]idSet // field -> value -> IDs
+	tokens map[string]idSet            // lowercased word -> IDs
+	vocab  []string                    // Sorted keys of tokens
+	docs   map[string]indexDoc         // ID -> indexed values
+}
+
+type idSet map[string]struct{}
+
+// indexDoc holds the values an item is indexed under.
+type indexDoc struct {
+	keys []indexKey
+	text []string // Lowercased searchable fields
+}
+
+type indexKey struct {
+	field, value string
+}
+
+// Indexed fields.
+const (
+	fieldTag      = "tag"
+	fieldFile     = "file"
+	fieldAuthor   = "author"
+	fieldBranch   = "branch"
+	fieldStatus   = "status"
+	fieldPriority = "priority"
+	fieldSeverity = "severity"
+	fieldAssigned = "assigned"
+)
+
+func newItemIndex() *itemIndex {
+	return &itemIndex{
+		pos:    make(map[string]int),
+		fields: make(map[string]map[string]idSet),
+		tokens: make(map[string]idSet),
+		vocab:  []string{},
+		docs:   make(map[string]indexDoc),
+	}
+}
+
+// buildIndex indexes a whole collection.
+func buildIndex[T any](items []T, id func(*T) string, doc func(*T) indexDoc) *itemIndex {
+	idx := newItemIndex()
+	idx.vocab = nil // Sorted once below instead of on every insert
+	for i := range items {
+		idx.put(id(&items[i]), i, doc(&items[i]))
+	}
+
+	idx.vocab = make([]string, 0, len(idx.tokens))
+	for tok := range idx.tokens {
+		idx.vocab = append(idx.vocab, tok)
+	}
+	slices.Sort(idx.vocab)
+	return idx
+}
+
+// put indexes an item at position i, replacing any previous entry.
+func (idx *itemIndex) put(id string, i int, doc indexDoc) {
+	idx.unindex(id)
+	idx.pos[id] = i
+	idx.docs[id] = doc
+
+	for _, k := range doc.keys {
+		values := idx.fields[k.field]
+		if values == nil {
+			values = make(map[string]idSet)
+			idx.fields[k.field] = values
+		}
+		addID(values, k.value, id)
+	}
+	for _, text := range doc.text {
+		for _, tok := range tokenize(text) {
+			if _, ok := idx.tokens[tok]; !ok && idx.vocab != nil {
+				i, _ := slices.BinarySearch(idx.vocab, tok)
+				idx.vocab = slices.Insert(idx.vocab, i, tok)
+			}
+			addID(idx.tokens, tok, id)
+		}
+	}
+}
+
+// remove drops an item that was removed from the collection and shifts the
+// positions of the items after it.
+func (idx *itemIndex) remove(id string) {
+	i, ok := idx.pos[id]
+	if !ok {
+		return
+	}
+	idx.unindex(id)
+	delete(idx.pos, id)
+
+	for other, p := range idx.pos {
+		if p > i {
+			idx.pos[other] = p - 1
+		}
+	}
+}
+
+func (idx *itemIndex) unindex(id string) {
+	doc, ok := idx.docs[id]
+	if !ok {
+		return
+	}
+	delete(idx.docs, id)
+
+	for _, k := range doc.keys {
+		removeID(idx.fields[k.field], k.value, id)
+	}
+	for _, text := range doc.text {
+		for _, tok := range tokenize(text) {
+			removeID(idx.tokens, tok, id)
+			if _, ok := idx.tokens[tok]; !ok {
+				if i, found := slices.BinarySearch(idx.vocab, tok); found {
+					idx.vocab = slices.Delete(idx.vocab, i, i+1)
+				}
+			}
+		}
+	}
+}
+
+// position returns the slice position of an item.
+func (idx *itemIndex) position(id string) (int, bool) {
+	i, ok := idx.pos[id]
+	return i, ok
+}
+
+// lookup returns the IDs indexed under any of values of a field.
+func (idx *itemIndex) lookup(field string, values ...string) idSet {
+	byValue := idx.fields[field]
+	if len(values) == 1 {
+		return byValue[values[0]]
+	}
+	result := make(idSet)
+	for _, v := range values {
+		for id := range byValue[v] {
+			result[id] = struct{}{}
+		}
+	}
+	return result
+}
+
+// lookupContains returns the IDs whose field value contains substr. Only the
+// distinct values are scanned, not the items.
+func (idx *itemIndex) lookupContains(field, substr string) idSet {
+	result := make(idSet)
+	for v, ids := range idx.fields[field] {
+		if strings.Contains(v, substr) {
+			for id := range ids {
+				result[id] = struct{}{}
+			}
+		}
+	}
+	return result
+}
+
+// search returns candidate IDs for a case-insensitive substring query, or
+// false when the query has no words to narrow by. A query word bounded by
+// non-word characters on a side must line up with the start or end of an
+// item word on that side. Exact words are posting list lookups and
+// prefix-bounded words a range of the sorted vocabulary; the vocabulary is
+// only scanned when no word is bounded on its left. The most selective word
+// is used and callers still verify candidates with matchText.
+func (idx *itemIndex) search(query string) (idSet, bool) {
+	words := queryWords(strings.ToLower(query))
+	if len(words) == 0 {
+		return nil, false
+	}
+
+	// Candidate vocabulary words for each query word, cheapest kind first
+	var best []string
+	bestSize := -1
+	consider := func(toks []string) {
+		size := 0
+		for _, tok := range toks {
+			size += len(idx.tokens[tok])
+		}
+		if bestSize < 0 || size < bestSize {
+			best, bestSize = toks, size
+		}
+	}
+	for _, w := range words {
+		if w.exact() {
+			consider([]string{w.text})
+		}
+	}
+	if bestSize < 0 {
+		for _, w := range words {
+			if w.left {
+				consider(idx.vocabPrefix(w.text))
+			}
+		}
+	}
+	if bestSize < 0 {
+		for _, w := range words {
+			var toks []string
+			for _, tok := range idx.vocab {
+				if w.matches(tok) {
+					toks = append(toks, tok)
+				}
+			}
+			consider(toks)
+		}
+	}
+
+	if len(best) == 1 {
+		return idx.tokens[best[0]], true
+	}
+	result := make(idSet, bestSize)
+	for _, tok := range best {
+		for id := range idx.tokens[tok] {
+			result[id] = struct{}{}
+		}
+	}
+	return result, true
+}
+
+// vocabPrefix returns the vocabulary words starting with prefix.
+func (idx *itemIndex) vocabPrefix(prefix string) []string {
+	i, _ := slices.BinarySearch(idx.vocab, prefix)
+	j := i
+	for j < len(idx.vocab) && strings.HasPrefix(idx.vocab[j], prefix) {
+		j++
+	}
+	return idx.vocab[i:j]
+}
+
+// queryWord is a word of a search query and whether it is bounded by a
+// non-word character on its left and right.
+type queryWord struct {
+	text        string
+	left, right bool
+}
+
+func (w *queryWord) exact() bool { return w.left && w.right }
+
+// matches reports whether an item word can contain this part of the query.
+func (w *queryWord) matches(tok string) bool {
+	switch {
+	case w.left && w.right:
+		return tok == w.text
+	case w.left:
+		return strings.HasPrefix(tok, w.text)
+	case w.right:
+		return strings.HasSuffix(tok, w.text)
+	default:
+		return strings.Contains(tok, w.text)
+	}
+}
+
+// queryWords splits a lowercased query into words with their boundaries.
+func queryWords(query string) []queryWord {
+	var words []queryWord
+	start := -1
+	for i, r := range query {
+		if isWordRune(r) {
+			if start < 0 {
+				start = i
+			}
+			continue
+		}
+		if start >= 0 {
+			words = append(words, queryWord{text: query[start:i], left: start > 0, right: true})
+			start = -1
+		}
+	}
+	if start >= 0 {
+		words = append(words, queryWord{text: query[start:], left: start > 0})
+	}
+	return words
+}
+
+// matchText reports whether any searchable field of an item contains the
+// lowercased query.
+func (idx *itemIndex) matchText(id, lowerQuery string) bool {
+	for _, text := range idx.docs[id].text {
+		if strings.Contains(text, lowerQuery) {
+			return true
+		}
+	}
+	return false
+}
+
+// query intersects candidate sets (no sets means every item), keeps the IDs
+// accepted by match and returns their positions in collection order with
+// offset and limit applied. total is the collection size.
+func (idx *itemIndex) query(total int, sets []idSet, match func(id string) bool, offset, limit int) []int {
+	var positions []int
+
+	if len(sets) == 0 && match == nil {
+		// Unfiltered: the page is a plain slice range
+		first, last := min(max(offset, 0), total), total
+		if limit > 0 {
+			last = min(first+limit, total)
+		}
+		positions = make([]int, 0, last-first)
+		for i := first; i < last; i++ {
+			positions = append(positions, i)
+		}
+		return positions
+	}
+
+	if len(sets) == 0 {
+		for id, i := range idx.pos {
+			if match(id) {
+				positions = append(positions, i)
+			}
+		}
+	} else {
+		// Iterate the smallest set and probe the others
+		smallest := 0
+		for i, set := range sets {
+			if len(set) < len(sets[smallest]) {
+				smallest = i
+			}
+		}
+	next:
+		for id := range sets[smallest] {
+			for i, set := range sets {
+				if i == smallest {
+					continue
+				}
+				if _, ok := set[id]; !ok {
+					continue next
+				}
+			}
+			if match != nil && !match(id) {
+				continue
+			}
+			positions = append(positions, idx.pos[id])
+		}
+	}
+
+	slices.Sort(positions)
+
+	if offset > 0 {
+		if offset >= len(positions) {
+			return nil
+		}
+		positions = positions[offset:]
+	}
+	if limit > 0 && limit < len(positions) {
+		positions = positions[:limit]
+	}
+	return positions
+}
+
+// tokenize splits lowercased text into its words (runs of letters and
+// digits), deduplicated.
+func tokenize(text string) []string {
+	var words []string
+	seen := make(map[string]struct{})
+	for _, w := range strings.FieldsFunc(text, func(r rune) bool { return !isWordRune(r) }) {
+		if _, ok := seen[w]; !ok {
+			seen[w] = struct{}{}
+			words = append(words, w)
+		}
+	}
+	return words
+}
+
+func isWordRune(r rune) bool {
+	return unicode.IsLetter(r) || unicode.IsDigit(r)
+}
+
+func addID(m map[string]idSet, key, id string) {
+	ids := m[key]
+	if ids == nil {
+		ids = make(idSet)
+		m[key] = ids
+	}
+	ids[id] = struct{}{}
+}
+
+func removeID(m map[string]idSet, key, id string) {
+	ids := m[key]
+	delete(ids, id)
+	if len(ids) == 0 {
+		delete(m, key)
+	}
+}
+
+// collect returns the items at positions.
+func collect[T any](items []T, positions []int) []T {
+	if len(positions) == 0 {
+		return nil
+	}
+	result := make([]T, len(positions))
+	for i, p := range positions {
+		result[i] = items[p]
+	}
+	return result
+}
+
+func noteDoc(n *Note) indexDoc {
+	doc := indexDoc{
+		keys: []indexKey{
+			{fieldFile, n.FilePath},
+			{fieldAuthor, strings.ToLower(n.Author)},
+			{fieldBranch, n.Branch},
+		},
+		text: []string{strings.ToLower(n.Title), strings.ToLower(n.Content)},
+	}
+	for _, tag := range n.Tags {
+		doc.keys = append(doc.keys, indexKey{fieldTag, strings.ToLower(tag)})
+	}
+	return doc
+}
+
+func decisionDoc(d *Decision) indexDoc {
+	return indexDoc{
+		keys: []indexKey{
+			{fieldStatus, string(d.Status)},
+			{fieldAuthor, strings.ToLower(d.Author)},
+		},
+		text: []string{strings.ToLower(d.Title), strings.ToLower(d.Context), strings.ToLower(d.Decision)},
+	}
+}
+
+func todoDoc(t *Todo) indexDoc {
+	return indexDoc{
+		keys: []indexKey{
+			{fieldStatus, string(t.Status)},
+			{fieldPriority, string(t.Priority)},
+			{fieldFile, t.FilePath},
+			{fieldAssigned, strings.ToLower(t.AssignedTo)},
+		},
+		text: []string{strings.ToLower(t.Title), strings.ToLower(t.Description)},
+	}
+}
+
+func issueDoc(i *Issue) indexDoc {
+	return indexDoc{
+		keys: []indexKey{
+			{fieldStatus, i.Status},
+			{fieldSeverity, i.Severity},
+			{fieldFile, i.FilePath},
+		},
+		text: []string{strings.ToLower(i.Title), strings.ToLower(i.Description)},
+	}
+}
+
+// reindexLocked rebuilds all indexes after the collections were replaced.
+// Must be called with s.mu held.
+func (s *Store) reindexLocked() {
+	s.noteIdx = buildIndex(s.notes, noteID, noteDoc)
+	s.decisionIdx = buildIndex(s.decisions, decisionID, decisionDoc)
+	s.todoIdx = buildIndex(s.todos, todoID, todoDoc)
+	s.issueIdx = buildIndex(s.issues, issueID, issueDoc)
+}
@@ -55,9 +55,10 @@ func (s *Store) AddIssue(req AddIssueRequest) (*Issue, error) {
 
 	s.mu.Lock()
 	s.issues = append(s.issues, issue)
+	s.issueIdx.put(issue.ID, len(s.issues)-1, issueDoc(&issue))
 	s.mu.Unlock()
 
-	if err := s.Save(); err != nil {
+	if err := appendOp(s, issuesFile, opPut, issue.ID, &issue); err != nil {
 		return nil, fmt.Errorf("failed to save issue: %w", err)
 	}
 
@@ -69,10 +70,8 @@ func (s *Store) GetIssue(id string) (*Issue, error) {
 	s.mu.RLock()
 	defer s.mu.RUnlock()
 
-	for i := range s.issues {
-		if s.issues[i].ID == id {
-			return &s.issues[i], nil
-		}
+	if i, ok := s.issueIdx.position(id); ok {
+		return &s.issues[i], nil
 	}
 
 	return nil, fmt.Errorf("issue not found: %s", id)
@@ -95,17 +94,11 @@ func (s *Store) UpdateIssue(req UpdateIssueRequest) (*Issue, error) {
 	s.mu.Lock()
 	defer s.mu.Unlock()
 
-	var issue *Issue
-	for i := range s.issues {
-		if s.issues[i].ID == req.ID {
-			issue = &s.issues[i]
-			break
-		}
-	}
-
-	if issue == nil {
+	i, ok := s.issueIdx.position(req.ID)
+	if !ok {
 		return nil, fmt.Errorf("issue not found: %s", req.ID)
 	}
+	issue := &s.issues[i]
 
 	if req.Title != nil {
 		issue.Title = *req.Title
@@ -139,15 +132,12 @@ func (s *Store) UpdateIssue(req UpdateIssueRequest) (*Issue, error) {
 	}
 
 	issue.UpdatedAt = time.Now()
+	s.issueIdx.put(issue.ID, i, issueDoc(issue))
 
-	// Save after releasing lock
-	s.mu.Unlock()
-	if err := s.Save(); err != nil {
-		s.mu.Lock()
+	if err := appendOp(s, issuesFile, opPut, issue.ID, issue); err != nil {
 		return nil, fmt.Errorf("failed to save issue: %w", err)
 	}
 
-	s.mu.Lock()
 	return issue, nil
 }
 
@@ -174,13 +164,10 @@ func (s *Store) ReopenIssue(id string) (*Issue, error) {
 func (s *Store) DeleteIssue(id string) error {
 	s.mu.Lock()
 
-	found := false
-	for i := range s.issues {
-		if s.issues[i].ID == id {
-			s.issues = append(s.issues[:i], s.issues[i+1:]...)
-			found = true
-			break
-		}
+	i, found := s.issueIdx.position(id)
+	if found {
+		s.issues = append(s.issues[:i], s.issues[i+1:]...)
+		s.issueIdx.remove(id)
 	}
 	s.mu.Unlock()
 
@@ -188,7 +175,7 @@ func (s *Store) DeleteIssue(id string) error {
 		return fmt.Errorf("issue not found: %s", id)
 	}
 
-	return s.Save()
+	return appendOp[Issue](s, issuesFile, opDel, id, nil)
 }
 
 // ListIssuesRequest contains parameters for listing issues.
@@ -206,68 +193,35 @@ func (s *Store) ListIssues(req ListIssuesRequest) []Issue {
 	s.mu.RLock()
 	defer s.mu.RUnlock()
 
-	var result []Issue
-
-	for _, issue := range s.issues {
-		// Filter by status
-		if len(req.Status) > 0 {
-			hasStatus := false
-			for _, status := range req.Status {
-				if issue.Status == status {
-					hasStatus = true
-					break
-				}
-			}
-			if !hasStatus {
-				continue
-			}
-		}
+	idx := s.issueIdx
+	var sets []idSet
 
-		// Filter by severity
-		if len(req.Severity) > 0 {
-			hasSeverity := false
-			for _, severity := range req.Severity {
-				if issue.Severity == severity {
-					hasSeverity = true
-					break
-				}
-			}
-			if !hasSeverity {
-				continue
-			}
-		}
-
-		// Filter by file path
-		if req.FilePath != "" && !strings.Contains(issue.FilePath, req.FilePath) {
-			continue
-		}
-
-		// Search in title and description
-		if req.Search != "" {
-			searchLower := strings.ToLower(req.Search)
-			if !strings.Contains(strings.ToLower(issue.Title), searchLower) &&
-				!strings.Contains(strings.ToLower(issue.Description), searchLower) {
-				continue
-			}
-		}
+	// Filter by status
+	if len(req.Status) > 0 {
+		sets = append(sets, idx.lookup(fieldStatus, req.Status...))
+	}
 
-		result = append(result, issue)
+	// Filter by severity
+	if len(req.Severity) > 0 {
+		sets = append(sets, idx.lookup(fieldSeverity, req.Severity...))
 	}
 
-	// Apply offset
-	if req.Offset > 0 {
-		if req.Offset >= len(result) {
-			return nil
-		}
-		result = result[req.Offset:]
+	// Filter by file path
+	if req.FilePath != "" {
+		sets = append(sets, idx.lookupContains(fieldFile, req.FilePath))
 	}
 
-	// Apply limit
-	if req.Limit > 0 && req.Limit < len(result) {
-		result = result[:req.Limit]
+	// Search in title and description
+	var match func(id string) bool
+	if req.Search != "" {
+		if candidates, ok := idx.search(req.Search); ok {
+			sets = append(sets, candidates)
+		}
+		searchLower := strings.ToLower(req.Search)
+		match = func(id string) bool { return idx.matchText(id, searchLower) }
 	}
 
-	return result
+	return collect(s.issues, idx.query(len(s.issues), sets, match, req.Offset, req.Limit))
 }
 
 // GetOpenIssues returns all open and investigating issues.
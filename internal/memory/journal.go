@@ -0,0 +1,291 @@
+package memory
+
+import (
+	"bytes"
+	"fmt"
+	"log/slog"
+	"os"
+	"path/filepath"
+	"strings"
+	"sync"
+	"time"
+)
+
+// Mutations are appended to a per-collection operation journal in the local
+// (gitignored) directory instead of rewriting the canonical JSONL files.
+// Compaction replays the journal onto the canonical file and truncates it,
+// so git and the merge tooling only ever see compacted files.
+
+// Canonical collection files in the memory directory.
+const (
+	notesFile     = "notes.jsonl"
+	decisionsFile = "decisions.jsonl"
+	todosFile     = "todos.jsonl"
+	issuesFile    = "issues.jsonl"
+)
+
+// Journal operations.
+const (
+	opPut = "put"
+	opDel = "del"
+)
+
+// compactDelay is how long journaled writes wait before being compacted into
+// the canonical files. Writes within the window share one compaction.
+var compactDelay = 2 * time.Second
+
+// journalOp is one record of a collection journal. Put records carry the
+// full item; del records only the ID.
+type journalOp[T any] struct {
+	Op     string `json:"op"`
+	ID     string `json:"id"`
+	Record *T     `json:"record,omitempty"`
+}
+
+// lockFileName is the lock file in the local directory that serializes
+// journal appends and rewrites of the memory files across processes.
+const lockFileName = "memory.lock"
+
+// dirLocks serializes the same across Store instances of the same project
+// within a process; the file lock is per open file description.
+var dirLocks sync.Map // memoryDir -> *sync.Mutex
+
+// lockDir takes the memory directory lock for journal appends and for every
+// rewrite of the canonical files. The returned function releases it.
+func (s *Store) lockDir() (func(), error) {
+	l, _ := dirLocks.LoadOrStore(s.memoryDir, &sync.Mutex{})
+	mu := l.(*sync.Mutex)
+	mu.Lock()
+
+	unlock, err := lockFile(filepath.Join(s.localDir, lockFileName))
+	if err != nil {
+		mu.Unlock()
+		return nil, fmt.Errorf("failed to lock memory directory: %w", err)
+	}
+	return func() {
+		unlock()
+		mu.Unlock()
+	}, nil
+}
+
+func (s *Store) journalPath(file string) string {
+	return filepath.Join(s.localDir, strings.TrimSuffix(file, ".jsonl")+".journal.jsonl")
+}
+
+func noteID(n *Note) string         { return n.ID }
+func decisionID(d *Decision) string { return d.ID }
+func todoID(t *Todo) string         { return t.ID }
+func issueID(i *Issue) string       { return i.ID }
+
+// appendOp journals a mutation of one collection item and schedules a
+// compaction.
+func appendOp[T any](s *Store, file, op, id string, record *T) error {
+	unlock, err := s.lockDir()
+	if err != nil {
+		return err
+	}
+	path := s.journalPath(file)
+	err = trimTornRecord(path)
+	if err == nil {
+		err = appendJSONL(path, journalOp[T]{Op: op, ID: id, Record: record})
+	}
+	unlock()
+	if err != nil {
+		return err
+	}
+
+	s.scheduleCompaction()
+	return nil
+}
+
+// loadCollection loads a canonical collection file and replays its journal.
+// Returns the number of journal records applied.
+func loadCollection[T any](s *Store, file string, id func(*T) string) ([]T, int, error) {
+	items, err := loadJSONL[T](filepath.Join(s.memoryDir, file))
+	if err != nil && !os.IsNotExist(err) {
+		return nil, 0, err
+	}
+
+	ops, err := loadJournal[T](s.journalPath(file))
+	if err != nil {
+		if os.IsNotExist(err) {
+			return items, 0, nil
+		}
+		return nil, 0, fmt.Errorf("journal: %w", err)
+	}
+
+	return replayJournal(items, ops, id), len(ops), nil
+}
+
+// loadJournal loads the records of a collection journal. Every record ends
+// with a newline, so text after the last one is the torn tail of an append
+// interrupted by a crash; it is dropped, like the record was never written.
+func loadJournal[T any](path string) ([]journalOp[T], error) {
+	data, err := os.ReadFile(path)
+	if err != nil {
+		return nil, err
+	}
+	if end := bytes.LastIndexByte(data, '\n') + 1; end < len(data) {
+		slog.Warn("dropping torn journal record", "path", path, "bytes", len(data)-end)
+		data = data[:end]
+	}
+	return decodeJSONL[journalOp[T]](bytes.NewReader(data))
+}
+
+// trimTornRecord truncates a journal after its last complete record, so the
+// next record does not continue a torn one. Must be called with the
+// directory lock held.
+func trimTornRecord(path string) error {
+	f, err := os.OpenFile(path, os.O_RDWR, 0)
+	if os.IsNotExist(err) {
+		return nil
+	}
+	if err != nil {
+		return err
+	}
+	defer f.Close()
+
+	info, err := f.Stat()
+	if err != nil || info.Size() == 0 {
+		return err
+	}
+	last := make([]byte, 1)
+	if _, err := f.ReadAt(last, info.Size()-1); err != nil {
+		return err
+	}
+	if last[0] == '\n' {
+		return nil
+	}
+
+	data, err := os.ReadFile(path)
+	if err != nil {
+		return err
+	}
+	end := bytes.LastIndexByte(data, '\n') + 1
+	slog.Warn("truncating torn journal record", "path", path, "bytes", len(data)-end)
+	return f.Truncate(int64(end))
+}
+
+// replayJournal applies journal operations in order. Updated items keep
+// their position; new items are appended.
+func replayJournal[T any](items []T, ops []journalOp[T], id func(*T) string) []T {
+	if len(ops) == 0 {
+		return items
+	}
+
+	index := make(map[string]int, len(items))
+	for i := range items {
+		index[id(&items[i])] = i
+	}
+	deleted := make(map[string]bool)
+
+	for _, op := range ops {
+		switch op.Op {
+		case opPut:
+			if op.Record == nil {
+				continue
+			}
+			delete(deleted, op.ID)
+			if i, ok := index[op.ID]; ok {
+				items[i] = *op.Record
+			} else {
+				index[op.ID] = len(items)
+				items = append(items, *op.Record)
+			}
+		case opDel:
+			if _, ok := index[op.ID]; ok {
+				deleted[op.ID] = true
+			}
+		}
+	}
+
+	if len(deleted) == 0 {
+		return items
+	}
+	kept := items[:0]
+	for _, item := range items {
+		if !deleted[id(&item)] {
+			kept = append(kept, item)
+		}
+	}
+	return kept
+}
+
+// compactCollection rewrites a canonical file from itself plus its journal
+// and removes the journal. Must be called with the directory lock held.
+func compactCollection[T any](s *Store, file string, id func(*T) string) error {
+	items, applied, err := loadCollection(s, file, id)
+	if err != nil {
+		return err
+	}
+	if applied == 0 {
+		return nil
+	}
+
+	if err := saveJSONL(filepath.Join(s.memoryDir, file), items); err != nil {
+		return err
+	}
+	if err := os.Remove(s.journalPath(file)); err != nil && !os.IsNotExist(err) {
+		return err
+	}
+	return nil
+}
+
+// Compact folds all pending journal records into the canonical JSONL files.
+// Compaction reads from disk, so records journaled by other Store instances
+// are kept.
+func (s *Store) Compact() error {
+	unlock, err := s.lockDir()
+	if err != nil {
+		return err
+	}
+	defer unlock()
+
+	if err = compactCollection(s, notesFile, noteID); err != nil {
+		return fmt.Errorf("failed to compact notes: %w", err)
+	}
+	if err := compactCollection(s, decisionsFile, decisionID); err != nil {
+		return fmt.Errorf("failed to compact decisions: %w", err)
+	}
+	if err := compactCollection(s, todosFile, todoID); err != nil {
+		return fmt.Errorf("failed to compact todos: %w", err)
+	}
+	if err := compactCollection(s, issuesFile, issueID); err != nil {
+		return fmt.Errorf("failed to compact issues: %w", err)
+	}
+
+	return nil
+}
+
+// scheduleCompaction runs Compact in the background after compactDelay
+// unless one is already pending.
+func (s *Store) scheduleCompaction() {
+	s.compactMu.Lock()
+	defer s.compactMu.Unlock()
+
+	if s.compactTimer != nil {
+		return
+	}
+	s.compactTimer = time.AfterFunc(compactDelay, func() {
+		s.compactMu.Lock()
+		s.compactTimer = nil
+		s.compactMu.Unlock()
+
+		if err := s.Compact(); err != nil {
+			slog.Warn("memory compaction failed", "error", err)
+		}
+	})
+}
+
+// Close compacts any pending journal records. Short-lived users of the
+// store should call it so the canonical files are up to date on exit.
+func (s *Store) Close() error {
+	s.compactMu.Lock()
+	if s.compactTimer != nil {
+		s.compactTimer.Stop()
+		s.compactTimer = nil
+	}
+	s.compactMu.Unlock()
+
+	return s.Compact()
+}
@@ -0,0 +1,66 @@
+//go:build !windows
+
+package memory
+
+import (
+	"os"
+	"path/filepath"
+	"testing"
+	"time"
+)
+
+func TestLockDirExcludesOtherProcesses(t *testing.T) {
+	tmpDir, err := os.MkdirTemp("", "memory-test-*")
+	if err != nil {
+		t.Fatal(err)
+	}
+	defer os.RemoveAll(tmpDir)
+
+	store, err := NewStore(StoreConfig{ProjectDir: tmpDir})
+	if err != nil {
+		t.Fatal(err)
+	}
+	if _, err := store.AddNote(AddNoteRequest{Title: "Held", Content: "journaled"}); err != nil {
+		t.Fatal(err)
+	}
+
+	// Another process opens the lock file on its own; a separate open file
+	// description conflicts with the store's lock like one would
+	unlock, err := store.lockDir()
+	if err != nil {
+		t.Fatal(err)
+	}
+	acquired := make(chan func())
+	go func() {
+		other, err := lockFile(filepath.Join(store.localDir, lockFileName))
+		if err != nil {
+			t.Error(err)
+			other = func() {}
+		}
+		acquired <- other
+	}()
+
+	select {
+	case <-acquired:
+		t.Fatal("lock taken while the store holds it")
+	case <-time.After(100 * time.Millisecond):
+	}
+	unlock()
+
+	other := <-acquired
+	// Compaction waits for the other holder too
+	compacted := make(chan error)
+	go func() { compacted <- store.Close() }()
+	select {
+	case <-compacted:
+		t.Fatal("compaction ran while another process held the lock")
+	case <-time.After(100 * time.Millisecond):
+	}
+	other()
+	if err := <-compacted; err != nil {
+		t.Fatalf("Close failed: %v", err)
+	}
+	if _, err := os.Stat(store.journalPath(notesFile)); !os.IsNotExist(err) {
+		t.Errorf("journal not removed after compaction")
+	}
+}
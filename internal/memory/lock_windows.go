@@ -0,0 +1,9 @@
+//go:build windows
+
+package memory
+
+// lockFile is a no-op on Windows; the memory directory is only serialized
+// within a process there.
+func lockFile(path string) (func(), error) {
+	return func() {}, nil
+}
@@ -123,10 +123,17 @@ func (m *Merger) MergeAll() (*MergeResult, error) {
 	return result, nil
 }
 
-// mergeFile merges a specific memory file.
+// mergeFile merges a specific memory file. The rewrite holds the memory
+// directory lock so it does not race journal appends and compaction.
 func (m *Merger) mergeFile(relativePath string) (*MergeResult, error) {
 	fullPath := filepath.Join(m.store.projectDir, relativePath)
 
+	unlock, err := m.store.lockDir()
+	if err != nil {
+		return nil, err
+	}
+	defer unlock()
+
 	switch {
 	case strings.HasSuffix(relativePath, "notes.jsonl"):
 		return m.mergeNotes(fullPath)
@@ -51,9 +51,10 @@ func (s *Store) AddNote(req AddNoteRequest) (*Note, error) {
 
 	s.mu.Lock()
 	s.notes = append(s.notes, note)
+	s.noteIdx.put(note.ID, len(s.notes)-1, noteDoc(&note))
 	s.mu.Unlock()
 
-	if err := s.Save(); err != nil {
+	if err := appendOp(s, notesFile, opPut, note.ID, &note); err != nil {
 		return nil, fmt.Errorf("failed to save note: %w", err)
 	}
 
@@ -65,10 +66,8 @@ func (s *Store) GetNote(id string) (*Note, error) {
 	s.mu.RLock()
 	defer s.mu.RUnlock()
 
-	for i := range s.notes {
-		if s.notes[i].ID == id {
-			return &s.notes[i], nil
-		}
+	if i, ok := s.noteIdx.position(id); ok {
+		return &s.notes[i], nil
 	}
 
 	return nil, fmt.Errorf("note not found: %s", id)
@@ -90,17 +89,11 @@ func (s *Store) UpdateNote(req UpdateNoteRequest) (*Note, error) {
 	s.mu.Lock()
 	defer s.mu.Unlock()
 
-	var note *Note
-	for i := range s.notes {
-		if s.notes[i].ID == req.ID {
-			note = &s.notes[i]
-			break
-		}
-	}
-
-	if note == nil {
+	i, ok := s.noteIdx.position(req.ID)
+	if !ok {
 		return nil, fmt.Errorf("note not found: %s", req.ID)
 	}
+	note := &s.notes[i]
 
 	if req.Title != nil {
 		note.Title = *req.Title
@@ -122,18 +115,12 @@ func (s *Store) UpdateNote(req UpdateNoteRequest) (*Note, error) {
 	}
 
 	note.UpdatedAt = time.Now()
+	s.noteIdx.put(note.ID, i, noteDoc(note))
 
-	// Save after releasing lock
-	notesCopy := make([]Note, len(s.notes))
-	copy(notesCopy, s.notes)
-	s.mu.Unlock()
-
-	if err := s.Save(); err != nil {
-		s.mu.Lock()
+	if err := appendOp(s, notesFile, opPut, note.ID, note); err != nil {
 		return nil, fmt.Errorf("failed to save note: %w", err)
 	}
 
-	s.mu.Lock()
 	return note, nil
 }
 
@@ -141,13 +128,10 @@ func (s *Store) UpdateNote(req UpdateNoteRequest) (*Note, error) {
 func (s *Store) DeleteNote(id string) error {
 	s.mu.Lock()
 
-	found := false
-	for i := range s.notes {
-		if s.notes[i].ID == id {
-			s.notes = append(s.notes[:i], s.notes[i+1:]...)
-			found = true
-			break
-		}
+	i, found := s.noteIdx.position(id)
+	if found {
+		s.notes = append(s.notes[:i], s.notes[i+1:]...)
+		s.noteIdx.remove(id)
 	}
 	s.mu.Unlock()
 
@@ -155,7 +139,7 @@ func (s *Store) DeleteNote(id string) error {
 		return fmt.Errorf("note not found: %s", id)
 	}
 
-	return s.Save()
+	return appendOp[Note](s, notesFile, opDel, id, nil)
 }
 
 // ListNotesRequest contains parameters for listing notes.
@@ -169,74 +153,50 @@ type ListNotesRequest struct {
 	Offset   int      `json:"offset,omitempty"`
 }
 
-// ListNotes lists notes with optional filters.
+// ListNotes lists notes with optional filters. Filters are answered from
+// the secondary indexes, so the cost follows the number of matches.
 func (s *Store) ListNotes(req ListNotesRequest) []Note {
 	s.mu.RLock()
 	defer s.mu.RUnlock()
 
-	var result []Note
-
-	for _, note := range s.notes {
-		// Filter by tags
-		if len(req.Tags) > 0 {
-			hasTag := false
-			for _, reqTag := range req.Tags {
-				for _, noteTag := range note.Tags {
-					if strings.EqualFold(noteTag, reqTag) {
-						hasTag = true
-						break
-					}
-				}
-				if hasTag {
-					break
-				}
-			}
-			if !hasTag {
-				continue
-			}
-		}
-
-		// Filter by file path
-		if req.FilePath != "" && !strings.Contains(note.FilePath, req.FilePath) {
-			continue
-		}
-
-		// Filter by author
-		if req.Author != "" && !strings.EqualFold(note.Author, req.Author) {
-			continue
-		}
+	idx := s.noteIdx
+	var sets []idSet
 
-		// Filter by branch
-		if req.Branch != "" && note.Branch != req.Branch {
-			continue
+	// Filter by tags
+	if len(req.Tags) > 0 {
+		tags := make([]string, len(req.Tags))
+		for i, tag := range req.Tags {
+			tags[i] = strings.ToLower(tag)
 		}
+		sets = append(sets, idx.lookup(fieldTag, tags...))
+	}
 
-		// Search in title and content
-		if req.Search != "" {
-			searchLower := strings.ToLower(req.Search)
-			if !strings.Contains(strings.ToLower(note.Title), searchLower) &&
-				!strings.Contains(strings.ToLower(note.Content), searchLower) {
-				continue
-			}
-		}
+	// Filter by file path
+	if req.FilePath != "" {
+		sets = append(sets, idx.lookupContains(fieldFile, req.FilePath))
+	}
 
-		result = append(result, note)
+	// Filter by author
+	if req.Author != "" {
+		sets = append(sets, idx.lookup(fieldAuthor, strings.ToLower(req.Author)))
 	}
 
-	// Apply offset
-	if req.Offset > 0 {
-		if req.Offset >= len(result) {
-			return nil
-		}
-		result = result[req.Offset:]
+	// Filter by branch
+	if req.Branch != "" {
+		sets = append(sets, idx.lookup(fieldBranch, req.Branch))
 	}
 
-	// Apply limit
-	if req.Limit > 0 && req.Limit < len(result) {
-		result = result[:req.Limit]
+	// Search in title and content
+	var match func(id string) bool
+	if req.Search != "" {
+		if candidates, ok := idx.search(req.Search); ok {
+			sets = append(sets, candidates)
+		}
+		searchLower := strings.ToLower(req.Search)
+		match = func(id string) bool { return idx.matchText(id, searchLower) }
 	}
 
-	return result
+	return collect(s.notes, idx.query(len(s.notes), sets, match, req.Offset, req.Limit))
 }
 
 // GetNotesByFile returns all notes associated with a file.
@@ -266,11 +226,8 @@ func (s *Store) CountNotes() int {
 	return len(s.notes)
 }
 
-// getCurrentBranch gets the current git branch (helper).
+// getCurrentBranch gets the current git branch (helper). Reads .git
+// directly through the cached git state provider.
 func (s *Store) getCurrentBranch() string {
-	git := NewGitIntegration(s)
-	if git.IsGitRepo() {
-		return git.GetCurrentBranch()
-	}
-	return ""
+	return NewGitIntegration(s).GetCurrentBranch()
 }
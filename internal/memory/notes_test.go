@@ -1,8 +1,10 @@
 package memory
 
 import (
+	"fmt"
 	"os"
 	"testing"
+	"time"
 )
 
 func TestAddNote(t *testing.T) {
@@ -250,6 +252,113 @@ func TestListNotes(t *testing.T) {
 	}
 }
 
+func TestListNotesIndexUpdates(t *testing.T) {
+	tmpDir, err := os.MkdirTemp("", "memory-test-*")
+	if err != nil {
+		t.Fatal(err)
+	}
+	defer os.RemoveAll(tmpDir)
+
+	store, err := NewStore(StoreConfig{ProjectDir: tmpDir})
+	if err != nil {
+		t.Fatal(err)
+	}
+
+	n1, _ := store.AddNote(AddNoteRequest{Title: "Cache layer", Content: "LRU eviction for embeddings", Tags: []string{"Perf"}})
+	n2, _ := store.AddNote(AddNoteRequest{Title: "Parser", Content: "tree-sitter grammar loading", Tags: []string{"parsing"}})
+	n3, _ := store.AddNote(AddNoteRequest{Title: "Indexer", Content: "Chunks are embedded in batches", Tags: []string{"perf"}, Author: "human"})
+
+	tests := []struct {
+		name string
+		req  ListNotesRequest
+		want []string
+	}{
+		{"tag is case-insensitive", ListNotesRequest{Tags: []string{"PERF"}}, []string{n1.ID, n3.ID}},
+		{"partial word", ListNotesRequest{Search: "mbed"}, []string{n1.ID, n3.ID}},
+		{"phrase across words", ListNotesRequest{Search: "sitter gram"}, []string{n2.ID}},
+		{"interior word must match exactly", ListNotesRequest{Search: "are embedded in"}, []string{n3.ID}},
+		{"punctuation only", ListNotesRequest{Search: "-"}, []string{n2.ID}},
+		{"combined filters", ListNotesRequest{Tags: []string{"perf"}, Author: "HUMAN"}, []string{n3.ID}},
+		{"offset keeps order", ListNotesRequest{Offset: 1, Limit: 1}, []string{n2.ID}},
+	}
+	for _, tt := range tests {
+		t.Run(tt.name, func(t *testing.T) {
+			assertNoteIDs(t, store.ListNotes(tt.req), tt.want)
+		})
+	}
+
+	// Updates and deletes keep the indexes in sync
+	content := "No longer about speed"
+	if _, err := store.UpdateNote(UpdateNoteRequest{ID: n1.ID, Content: &content, Tags: []string{"docs"}}); err != nil {
+		t.Fatal(err)
+	}
+	assertNoteIDs(t, store.ListNotes(ListNotesRequest{Tags: []string{"perf"}}), []string{n3.ID})
+	assertNoteIDs(t, store.ListNotes(ListNotesRequest{Search: "speed"}), []string{n1.ID})
+
+	if err := store.DeleteNote(n2.ID); err != nil {
+		t.Fatal(err)
+	}
+	assertNoteIDs(t, store.ListNotes(ListNotesRequest{}), []string{n1.ID, n3.ID})
+	if note, err := store.GetNote(n3.ID); err != nil || note.Title != "Indexer" {
+		t.Errorf("GetNote after delete = %v, %v", note, err)
+	}
+}
+
+func assertNoteIDs(t *testing.T, notes []Note, want []string) {
+	t.Helper()
+	got := make([]string, len(notes))
+	for i, n := range notes {
+		got[i] = n.ID
+	}
+	if fmt.Sprint(got) != fmt.Sprint(want) {
+		t.Errorf("got notes %v, want %v", got, want)
+	}
+}
+
+func BenchmarkListNotes50k(b *testing.B) {
+	tmpDir := b.TempDir()
+	store, err := NewStore(StoreConfig{ProjectDir: tmpDir})
+	if err != nil {
+		b.Fatal(err)
+	}
+
+	words := []string{"cache", "parser", "index", "embedding", "vector", "chunk", "query", "merge", "branch", "session"}
+	notes := make([]Note, 50000)
+	for i := range notes {
+		notes[i] = Note{
+			ID:        fmt.Sprintf("n%07d", i),
+			Title:     fmt.Sprintf("Note %d about %s", i, words[i%len(words)]),
+			Content:   fmt.Sprintf("Details on the %s and %s paths, item %d.", words[i%7], words[i%3], i),
+			Tags:      []string{words[i%len(words)], fmt.Sprintf("t%d", i%100)},
+			FilePath:  fmt.Sprintf("pkg/%s/file%d.go", words[i%len(words)], i%500),
+			Author:    []string{"human", "ai"}[i%2],
+			CreatedAt: time.Now(),
+		}
+	}
+	store.mu.Lock()
+	store.notes = notes
+	store.reindexLocked()
+	store.mu.Unlock()
+
+	benchmarks := []struct {
+		name string
+		req  ListNotesRequest
+	}{
+		{"tag", ListNotesRequest{Tags: []string{"t42"}}},
+		{"file", ListNotesRequest{FilePath: "file123.go"}},
+		{"author+tag", ListNotesRequest{Author: "human", Tags: []string{"t42"}}},
+		{"search", ListNotesRequest{Search: "item 4242"}},
+		{"page", ListNotesRequest{Limit: 20, Offset: 100}},
+	}
+	for _, bm := range benchmarks {
+		b.Run(bm.name, func(b *testing.B) {
+			for i := 0; i < b.N; i++ {
+				store.ListNotes(bm.req)
+			}
+		})
+	}
+}
+
 func TestCountNotes(t *testing.T) {
 	tmpDir, err := os.MkdirTemp("", "memory-test-*")
 	if err != nil {
@@ -4,6 +4,7 @@ import (
 	"bufio"
 	"encoding/json"
 	"fmt"
+	"io"
 	"os"
 	"path/filepath"
 	"sync"
@@ -23,6 +24,16 @@ type Store struct {
 	issues  []Issue
 	context WorkingContext
 
+	// Secondary indexes over the collections, guarded by mu
+	noteIdx     *itemIndex
+	decisionIdx *itemIndex
+	todoIdx     *itemIndex
+	issueIdx    *itemIndex
+
+	// Pending background compaction of the journals
+	compactMu    sync.Mutex
+	compactTimer *time.Timer
+
 	// Project metadata
 	projectID   string
 	projectName string
@@ -70,38 +81,53 @@ func NewStore(cfg StoreConfig) (*Store, error) {
 	return s, nil
 }
 
-// Load loads all memory data from disk.
+// Load loads all memory data from disk, replaying any journaled changes
+// that have not been compacted yet.
 func (s *Store) Load() error {
 	s.mu.Lock()
 	defer s.mu.Unlock()
 
+	unlock, err := s.lockDir()
+	if err != nil {
+		return err
+	}
+	defer unlock()
+
+	pending := 0
+
 	// Load notes
-	notes, err := loadJSONL[Note](filepath.Join(s.memoryDir, "notes.jsonl"))
-	if err != nil && !os.IsNotExist(err) {
+	notes, n, err := loadCollection(s, notesFile, noteID)
+	if err != nil {
 		return fmt.Errorf("failed to load notes: %w", err)
 	}
 	s.notes = notes
+	pending += n
 
 	// Load decisions
-	decisions, err := loadJSONL[Decision](filepath.Join(s.memoryDir, "decisions.jsonl"))
-	if err != nil && !os.IsNotExist(err) {
+	decisions, n, err := loadCollection(s, decisionsFile, decisionID)
+	if err != nil {
 		return fmt.Errorf("failed to load decisions: %w", err)
 	}
 	s.decisions = decisions
+	pending += n
 
 	// Load todos
-	todos, err := loadJSONL[Todo](filepath.Join(s.memoryDir, "todos.jsonl"))
-	if err != nil && !os.IsNotExist(err) {
+	todos, n, err := loadCollection(s, todosFile, todoID)
+	if err != nil {
 		return fmt.Errorf("failed to load todos: %w", err)
 	}
 	s.todos = todos
+	pending += n
 
 	// Load issues
-	issues, err := loadJSONL[Issue](filepath.Join(s.memoryDir, "issues.jsonl"))
-	if err != nil && !os.IsNotExist(err) {
+	issues, n, err := loadCollection(s, issuesFile, issueID)
+	if err != nil {
 		return fmt.Errorf("failed to load issues: %w", err)
 	}
 	s.issues = issues
+	pending += n
+
+	s.reindexLocked()
 
 	// Load context
 	contextPath := filepath.Join(s.localDir, "context.json")
@@ -111,45 +137,54 @@ func (s *Store) Load() error {
 		}
 	}
 
+	// Journals left over from a process that exited before compacting
+	if pending > 0 {
+		s.scheduleCompaction()
+	}
+
 	return nil
 }
 
-// Save saves all memory data to disk.
+// Save writes all memory data to the canonical files and discards the
+// journals. Single-item mutations journal their change instead.
 func (s *Store) Save() error {
 	s.mu.RLock()
 	defer s.mu.RUnlock()
 
+	unlock, err := s.lockDir()
+	if err != nil {
+		return err
+	}
+	defer unlock()
+
 	// Save notes
-	if err := saveJSONL(filepath.Join(s.memoryDir, "notes.jsonl"), s.notes); err != nil {
+	if err := saveJSONL(filepath.Join(s.memoryDir, notesFile), s.notes); err != nil {
 		return fmt.Errorf("failed to save notes: %w", err)
 	}
 
 	// Save decisions
-	if err := saveJSONL(filepath.Join(s.memoryDir, "decisions.jsonl"), s.decisions); err != nil {
+	if err := saveJSONL(filepath.Join(s.memoryDir, decisionsFile), s.decisions); err != nil {
 		return fmt.Errorf("failed to save decisions: %w", err)
 	}
 
 	// Save todos
-	if err := saveJSONL(filepath.Join(s.memoryDir, "todos.jsonl"), s.todos); err != nil {
+	if err := saveJSONL(filepath.Join(s.memoryDir, todosFile), s.todos); err != nil {
 		return fmt.Errorf("failed to save todos: %w", err)
 	}
 
 	// Save issues
-	if err := saveJSONL(filepath.Join(s.memoryDir, "issues.jsonl"), s.issues); err != nil {
+	if err := saveJSONL(filepath.Join(s.memoryDir, issuesFile), s.issues); err != nil {
 		return fmt.Errorf("failed to save issues: %w", err)
 	}
 
-	// Save context (local only)
-	contextPath := filepath.Join(s.localDir, "context.json")
-	data, err := json.MarshalIndent(s.context, "", "  ")
-	if err != nil {
-		return fmt.Errorf("failed to marshal context: %w", err)
-	}
-	if err := os.WriteFile(contextPath, data, 0644); err != nil {
-		return fmt.Errorf("failed to save context: %w", err)
+	for _, file := range []string{notesFile, decisionsFile, todosFile, issuesFile} {
+		if err := os.Remove(s.journalPath(file)); err != nil && !os.IsNotExist(err) {
+			return fmt.Errorf("failed to remove journal: %w", err)
+		}
 	}
 
-	return nil
+	// Save context (local only)
+	return s.saveContextLocked()
 }
 
 // loadJSONL loads items from a JSONL file.
@@ -160,8 +195,13 @@ func loadJSONL[T any](path string) ([]T, error) {
 	}
 	defer file.Close()
 
+	return decodeJSONL[T](file)
+}
+
+// decodeJSONL decodes items from JSONL data.
+func decodeJSONL[T any](r io.Reader) ([]T, error) {
 	var items []T
-	scanner := bufio.NewScanner(file)
+	scanner := bufio.NewScanner(r)
 	// Increase buffer size for long lines
 	buf := make([]byte, 0, 64*1024)
 	scanner.Buffer(buf, 1024*1024)
@@ -245,14 +285,11 @@ func appendJSONL[T any](path string, item T) error {
 		return err
 	}
 
-	if _, err := file.Write(data); err != nil {
-		return err
-	}
-	if _, err := file.WriteString("\n"); err != nil {
+	// One write per line, so a crash tears at most the last line
+	if _, err := file.Write(append(data, '\n')); err != nil {
 		return err
 	}
-
-	return nil
+	return file.Sync()
 }
 
 // GetProjectDir returns the project directory.
@@ -336,11 +373,11 @@ func (s *Store) GetContext() WorkingContext {
 // SetContext sets the working context.
 func (s *Store) SetContext(ctx WorkingContext) error {
 	s.mu.Lock()
+	defer s.mu.Unlock()
 	s.context = ctx
 	s.context.UpdatedAt = time.Now()
-	s.mu.Unlock()
 
-	return s.Save()
+	return s.saveContextLocked()
 }
 
 // GetLastSession returns the last session summary.
@@ -353,12 +390,12 @@ func (s *Store) GetLastSession() *SessionSummary {
 // SaveSession saves a session summary.
 func (s *Store) SaveSession(session SessionSummary) error {
 	s.mu.Lock()
+	defer s.mu.Unlock()
 	session.EndedAt = time.Now()
 	s.context.LastSession = &session
 	s.context.UpdatedAt = time.Now()
-	s.mu.Unlock()
 
-	return s.Save()
+	return s.saveContextLocked()
 }
 
 // Clear removes all memory data.
@@ -369,14 +406,19 @@ func (s *Store) Clear() error {
 	s.todos = nil
 	s.issues = nil
 	s.context = WorkingContext{}
+	s.reindexLocked()
 	s.mu.Unlock()
 
 	// Remove files
 	files := []string{
-		filepath.Join(s.memoryDir, "notes.jsonl"),
-		filepath.Join(s.memoryDir, "decisions.jsonl"),
-		filepath.Join(s.memoryDir, "todos.jsonl"),
-		filepath.Join(s.memoryDir, "issues.jsonl"),
+		filepath.Join(s.memoryDir, notesFile),
+		filepath.Join(s.memoryDir, decisionsFile),
+		filepath.Join(s.memoryDir, todosFile),
+		filepath.Join(s.memoryDir, issuesFile),
+		s.journalPath(notesFile),
+		s.journalPath(decisionsFile),
+		s.journalPath(todosFile),
+		s.journalPath(issuesFile),
 		filepath.Join(s.localDir, "context.json"),
 	}
 
@@ -414,6 +456,7 @@ func (s *Store) Import(pm *ProjectMemory) error {
 	s.todos = pm.Todos
 	s.issues = pm.Issues
 	s.context = pm.Context
+	s.reindexLocked()
 	s.mu.Unlock()
 
 	return s.Save()
@@ -211,3 +211,115 @@ func TestStoreSearchHistory(t *testing.T) {
 		t.Errorf("First search = %q, want %q", searches[0], "third search")
 	}
 }
+
+func TestStoreJournalCompaction(t *testing.T) {
+	tmpDir, err := os.MkdirTemp("", "memory-test-*")
+	if err != nil {
+		t.Fatal(err)
+	}
+	defer os.RemoveAll(tmpDir)
+
+	store, err := NewStore(StoreConfig{ProjectDir: tmpDir})
+	if err != nil {
+		t.Fatal(err)
+	}
+
+	keep, err := store.AddNote(AddNoteRequest{Title: "Keep", Content: "kept"})
+	if err != nil {
+		t.Fatalf("AddNote failed: %v", err)
+	}
+	drop, err := store.AddNote(AddNoteRequest{Title: "Drop", Content: "dropped"})
+	if err != nil {
+		t.Fatalf("AddNote failed: %v", err)
+	}
+	title := "Kept and updated"
+	if _, err := store.UpdateNote(UpdateNoteRequest{ID: keep.ID, Title: &title}); err != nil {
+		t.Fatalf("UpdateNote failed: %v", err)
+	}
+	if err := store.DeleteNote(drop.ID); err != nil {
+		t.Fatalf("DeleteNote failed: %v", err)
+	}
+
+	// Writes go to the journal, not the canonical file
+	notesPath := filepath.Join(tmpDir, ".mcp-codewizard", "memory", notesFile)
+	if _, err := os.Stat(notesPath); !os.IsNotExist(err) {
+		t.Errorf("canonical notes file written before compaction")
+	}
+
+	// A second store sees journaled changes
+	store2, err := NewStore(StoreConfig{ProjectDir: tmpDir})
+	if err != nil {
+		t.Fatal(err)
+	}
+	if n := store2.CountNotes(); n != 1 {
+		t.Fatalf("CountNotes = %d, want 1", n)
+	}
+
+	if err := store.Close(); err != nil {
+		t.Fatalf("Close failed: %v", err)
+	}
+	if _, err := os.Stat(store.journalPath(notesFile)); !os.IsNotExist(err) {
+		t.Errorf("journal not removed after compaction")
+	}
+
+	notes, err := loadJSONL[Note](notesPath)
+	if err != nil {
+		t.Fatalf("failed to read compacted notes: %v", err)
+	}
+	if len(notes) != 1 || notes[0].Title != title {
+		t.Errorf("compacted notes = %+v, want one note titled %q", notes, title)
+	}
+}
+
+func TestStoreJournalTornRecord(t *testing.T) {
+	tmpDir, err := os.MkdirTemp("", "memory-test-*")
+	if err != nil {
+		t.Fatal(err)
+	}
+	defer os.RemoveAll(tmpDir)
+
+	store, err := NewStore(StoreConfig{ProjectDir: tmpDir})
+	if err != nil {
+		t.Fatal(err)
+	}
+	if _, err := store.AddNote(AddNoteRequest{Title: "Before", Content: "complete"}); err != nil {
+		t.Fatalf("AddNote failed: %v", err)
+	}
+
+	// A crash in the middle of an append leaves a truncated last line
+	journal, err := os.OpenFile(store.journalPath(notesFile), os.O_APPEND|os.O_WRONLY, 0644)
+	if err != nil {
+		t.Fatal(err)
+	}
+	if _, err := journal.WriteString(`{"op":"put","id":"note_torn","record":{"id":"note_`); err != nil {
+		t.Fatal(err)
+	}
+	journal.Close()
+
+	store2, err := NewStore(StoreConfig{ProjectDir: tmpDir})
+	if err != nil {
+		t.Fatalf("NewStore with a torn journal failed: %v", err)
+	}
+	if n := store2.CountNotes(); n != 1 {
+		t.Fatalf("CountNotes = %d, want 1", n)
+	}
+
+	// The next append starts on a line of its own
+	if _, err := store2.AddNote(AddNoteRequest{Title: "After", Content: "complete"}); err != nil {
+		t.Fatalf("AddNote after a torn record failed: %v", err)
+	}
+	ops, err := loadJSONL[journalOp[Note]](store2.journalPath(notesFile))
+	if err != nil || len(ops) != 2 {
+		t.Errorf("journal after the next append = %d records, %v; want 2", len(ops), err)
+	}
+
+	if err := store2.Compact(); err != nil {
+		t.Fatalf("Compact failed: %v", err)
+	}
+	notes, err := loadJSONL[Note](filepath.Join(tmpDir, ".mcp-codewizard", "memory", notesFile))
+	if err != nil || len(notes) != 2 {
+		t.Errorf("compacted notes = %+v, %v; want 2", notes, err)
+	}
+	store.Close()
+	store2.Close()
+}
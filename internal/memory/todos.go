@@ -56,9 +56,10 @@ func (s *Store) AddTodo(req AddTodoRequest) (*Todo, error) {
 
 	s.mu.Lock()
 	s.todos = append(s.todos, todo)
+	s.todoIdx.put(todo.ID, len(s.todos)-1, todoDoc(&todo))
 	s.mu.Unlock()
 
-	if err := s.Save(); err != nil {
+	if err := appendOp(s, todosFile, opPut, todo.ID, &todo); err != nil {
 		return nil, fmt.Errorf("failed to save todo: %w", err)
 	}
 
@@ -70,10 +71,8 @@ func (s *Store) GetTodo(id string) (*Todo, error) {
 	s.mu.RLock()
 	defer s.mu.RUnlock()
 
-	for i := range s.todos {
-		if s.todos[i].ID == id {
-			return &s.todos[i], nil
-		}
+	if i, ok := s.todoIdx.position(id); ok {
+		return &s.todos[i], nil
 	}
 
 	return nil, fmt.Errorf("todo not found: %s", id)
@@ -97,17 +96,11 @@ func (s *Store) UpdateTodo(req UpdateTodoRequest) (*Todo, error) {
 	s.mu.Lock()
 	defer s.mu.Unlock()
 
-	var todo *Todo
-	for i := range s.todos {
-		if s.todos[i].ID == req.ID {
-			todo = &s.todos[i]
-			break
-		}
-	}
-
-	if todo == nil {
+	i, ok := s.todoIdx.position(req.ID)
+	if !ok {
 		return nil, fmt.Errorf("todo not found: %s", req.ID)
 	}
+	todo := &s.todos[i]
 
 	if req.Title != nil {
 		todo.Title = *req.Title
@@ -145,15 +138,12 @@ func (s *Store) UpdateTodo(req UpdateTodoRequest) (*Todo, error) {
 	}
 
 	todo.UpdatedAt = time.Now()
+	s.todoIdx.put(todo.ID, i, todoDoc(todo))
 
-	// Save after releasing lock
-	s.mu.Unlock()
-	if err := s.Save(); err != nil {
-		s.mu.Lock()
+	if err := appendOp(s, todosFile, opPut, todo.ID, todo); err != nil {
 		return nil, fmt.Errorf("failed to save todo: %w", err)
 	}
 
-	s.mu.Lock()
 	return todo, nil
 }
 
@@ -185,13 +175,10 @@ func (s *Store) StartTodo(id string) (*Todo, error) {
 func (s *Store) DeleteTodo(id string) error {
 	s.mu.Lock()
 
-	found := false
-	for i := range s.todos {
-		if s.todos[i].ID == id {
-			s.todos = append(s.todos[:i], s.todos[i+1:]...)
-			found = true
-			break
-		}
+	i, found := s.todoIdx.position(id)
+	if found {
+		s.todos = append(s.todos[:i], s.todos[i+1:]...)
+		s.todoIdx.remove(id)
 	}
 	s.mu.Unlock()
 
@@ -199,7 +186,7 @@ func (s *Store) DeleteTodo(id string) error {
 		return fmt.Errorf("todo not found: %s", id)
 	}
 
-	return s.Save()
+	return appendOp[Todo](s, todosFile, opDel, id, nil)
 }
 
 // ListTodosRequest contains parameters for listing todos.
@@ -218,73 +205,40 @@ func (s *Store) ListTodos(req ListTodosRequest) []Todo {
 	s.mu.RLock()
 	defer s.mu.RUnlock()
 
-	var result []Todo
-
-	for _, todo := range s.todos {
-		// Filter by status
-		if len(req.Status) > 0 {
-			hasStatus := false
-			for _, status := range req.Status {
-				if string(todo.Status) == status {
-					hasStatus = true
-					break
-				}
-			}
-			if !hasStatus {
-				continue
-			}
-		}
-
-		// Filter by priority
-		if len(req.Priority) > 0 {
-			hasPriority := false
-			for _, priority := range req.Priority {
-				if string(todo.Priority) == priority {
-					hasPriority = true
-					break
-				}
-			}
-			if !hasPriority {
-				continue
-			}
-		}
-
-		// Filter by file path
-		if req.FilePath != "" && !strings.Contains(todo.FilePath, req.FilePath) {
-			continue
-		}
+	idx := s.todoIdx
+	var sets []idSet
 
-		// Filter by assigned to
-		if req.AssignedTo != "" && !strings.EqualFold(todo.AssignedTo, req.AssignedTo) {
-			continue
-		}
+	// Filter by status
+	if len(req.Status) > 0 {
+		sets = append(sets, idx.lookup(fieldStatus, req.Status...))
+	}
 
-		// Search in title and description
-		if req.Search != "" {
-			searchLower := strings.ToLower(req.Search)
-			if !strings.Contains(strings.ToLower(todo.Title), searchLower) &&
-				!strings.Contains(strings.ToLower(todo.Description), searchLower) {
-				continue
-			}
-		}
+	// Filter by priority
+	if len(req.Priority) > 0 {
+		sets = append(sets, idx.lookup(fieldPriority, req.Priority...))
+	}
 
-		result = append(result, todo)
+	// Filter by file path
+	if req.FilePath != "" {
+		sets = append(sets, idx.lookupContains(fieldFile, req.FilePath))
 	}
 
-	// Apply offset
-	if req.Offset > 0 {
-		if req.Offset >= len(result) {
-			return nil
-		}
-		result = result[req.Offset:]
+	// Filter by assigned to
+	if req.AssignedTo != "" {
+		sets = append(sets, idx.lookup(fieldAssigned, strings.ToLower(req.AssignedTo)))
 	}
 
-	// Apply limit
-	if req.Limit > 0 && req.Limit < len(result) {
-		result = result[:req.Limit]
+	// Search in title and description
+	var match func(id string) bool
+	if req.Search != "" {
+		if candidates, ok := idx.search(req.Search); ok {
+			sets = append(sets, candidates)
+		}
+		searchLower := strings.ToLower(req.Search)
+		match = func(id string) bool { return idx.matchText(id, searchLower) }
 	}
 
-	return result
+	return collect(s.todos, idx.query(len(s.todos), sets, match, req.Offset, req.Limit))
 }
 
 // GetPendingTodos returns all pending and in-progress todos.
@@ -180,8 +180,8 @@ func (e *Engine) addContext(result *types.SearchResult, contextLines int) {
 }
 
 // SearchSymbols searches for symbols by name and kind.
-func (e *Engine) SearchSymbols(query string, kind types.SymbolKind, limit int) ([]*types.Symbol, error) {
-	return e.store.FindSymbols(query, kind, limit)
+func (e *Engine) SearchSymbols(ctx context.Context, query string, kind types.SymbolKind, limit int) ([]*types.Symbol, error) {
+	return e.store.FindSymbols(ctx, query, kind, limit)
 }
 
 // SearchSymbolsAdvanced searches for symbols with additional filtering options.
@@ -276,11 +276,11 @@ type EntryPoint struct {
 }
 
 // GetEntryPoints finds entry points in the codebase (main functions, handlers, tests, etc).
-func (e *Engine) GetEntryPoints(limit int) ([]*EntryPoint, error) {
+func (e *Engine) GetEntryPoints(ctx context.Context, limit int) ([]*EntryPoint, error) {
 	var entryPoints []*EntryPoint
 
 	// Find main functions (highest confidence)
-	mainSymbols, err := e.store.FindSymbols("main", types.SymbolKindFunction, 100)
+	mainSymbols, err := e.store.FindSymbols(ctx, "main", types.SymbolKindFunction, 100)
 	if err != nil {
 		return nil, err
 	}
@@ -297,7 +297,7 @@ func (e *Engine) GetEntryPoints(limit int) ([]*EntryPoint, error) {
 	// Find HTTP handlers (look for common patterns)
 	handlerPatterns := []string{"Handle", "ServeHTTP", "Handler"}
 	for _, pattern := range handlerPatterns {
-		symbols, err := e.store.FindSymbols(pattern, types.SymbolKindFunction, 100)
+		symbols, err := e.store.FindSymbols(ctx, pattern, types.SymbolKindFunction, 100)
 		if err != nil {
 			continue
 		}
@@ -314,7 +314,7 @@ func (e *Engine) GetEntryPoints(limit int) ([]*EntryPoint, error) {
 	}
 
 	// Find test functions
-	testSymbols, err := e.store.FindSymbols("Test", types.SymbolKindFunction, 100)
+	testSymbols, err := e.store.FindSymbols(ctx, "Test", types.SymbolKindFunction, 100)
 	if err == nil {
 		for _, sym := range testSymbols {
 			if strings.HasPrefix(sym.Name, "Test") {
@@ -328,7 +328,7 @@ func (e *Engine) GetEntryPoints(limit int) ([]*EntryPoint, error) {
 	}
 
 	// Find init functions
-	initSymbols, err := e.store.FindSymbols("init", types.SymbolKindFunction, 100)
+	initSymbols, err := e.store.FindSymbols(ctx, "init", types.SymbolKindFunction, 100)
 	if err == nil {
 		for _, sym := range initSymbols {
 			if sym.Name == "init" {
@@ -344,7 +344,7 @@ func (e *Engine) GetEntryPoints(limit int) ([]*EntryPoint, error) {
 	// Find CLI entry points (Execute, Run, Cmd)
 	cliPatterns := []string{"Execute", "Run", "Cmd"}
 	for _, pattern := range cliPatterns {
-		symbols, err := e.store.FindSymbols(pattern, types.SymbolKindFunction, 50)
+		symbols, err := e.store.FindSymbols(ctx, pattern, types.SymbolKindFunction, 50)
 		if err != nil {
 			continue
 		}
@@ -388,9 +388,9 @@ type ImportGraph struct {
 }
 
 // GetImportGraph builds the import graph from import references.
-func (e *Engine) GetImportGraph(limit int) (*ImportGraph, error) {
+func (e *Engine) GetImportGraph(ctx context.Context, limit int) (*ImportGraph, error) {
 	// Get all import references
-	refs, err := e.store.FindReferencesByKind(types.RefKindImport, limit)
+	refs, err := e.store.FindReferencesByKind(ctx, types.RefKindImport, limit)
 	if err != nil {
 		return nil, err
 	}
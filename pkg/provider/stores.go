@@ -18,6 +18,9 @@ type ChunkStore interface {
 
 	// DeleteChunksByFile removes all chunks for a file.
 	DeleteChunksByFile(filePath string) error
+
+	// DeleteChunksByFiles removes all chunks for many files at once.
+	DeleteChunksByFiles(filePaths []string) error
 }
 
 // SymbolStore handles symbol storage operations.
@@ -29,7 +32,7 @@ type SymbolStore interface {
 	GetSymbol(id string) (*types.Symbol, error)
 
 	// FindSymbols searches symbols by name pattern and kind.
-	FindSymbols(query string, kind types.SymbolKind, limit int) ([]*types.Symbol, error)
+	FindSymbols(ctx context.Context, query string, kind types.SymbolKind, limit int) ([]*types.Symbol, error)
 
 	// FindSymbolsAdvanced searches symbols with additional filtering options.
 	// minLines: minimum line count (0 = no filter)
@@ -52,11 +55,11 @@ type ReferenceStore interface {
 	GetCallees(symbolID string, limit int) ([]*types.Reference, error)
 
 	// FindReferencesByKind returns all references of a specific kind.
-	FindReferencesByKind(kind types.RefKind, limit int) ([]*types.Reference, error)
+	FindReferencesByKind(ctx context.Context, kind types.RefKind, limit int) ([]*types.Reference, error)
 
 	// GetAllReferences returns all references for building call graphs.
 	// Used by dead code analysis for efficient graph construction.
-	GetAllReferences(limit int) ([]*types.Reference, error)
+	GetAllReferences(ctx context.Context, limit int) ([]*types.Reference, error)
 }
 
 // Searcher handles search operations.
@@ -116,6 +119,14 @@ type Maintainer interface {
 	CheckFTSHealth() error
 }
 
+// BulkLoader loads a whole index at once, faster than storing chunks,
+// symbols and references separately.
+type BulkLoader interface {
+	// BulkLoad replaces all chunks, symbols and references of the store and
+	// clears its file hashes, which the caller sets again afterwards.
+	BulkLoad(chunks []*types.ChunkWithEmbedding, symbols []*types.Symbol, refs []*types.Reference) error
+}
+
 // GitHistoryStore handles git history storage and search operations.
 type GitHistoryStore interface {
 	// Commit operations
@@ -143,7 +154,9 @@ type GitHistoryStore interface {
 	SearchDiffs(ctx context.Context, queryVec []float32, limit int) ([]*types.Change, error)
 
 	// Analysis operations
-	FindRegressionCandidates(ctx context.Context, description string, knownGood, knownBad string, limit int) ([]*types.RegressionCandidate, error)
+	// FindRegressionCandidates ranks commits in knownGood..knownBad; queryVec is the
+	// embedded description and may be nil.
+	FindRegressionCandidates(ctx context.Context, description string, queryVec []float32, knownGood, knownBad string, limit int) ([]*types.RegressionCandidate, error)
 	GetContributorInsights(ctx context.Context, paths []string, symbol string) ([]*types.ContributorInsight, error)
 
 	// Statistics
@@ -162,12 +175,13 @@ func (v *vectorStoreValidator) Close() error
 func (v *vectorStoreValidator) StoreChunks(chunks []*types.ChunkWithEmbedding) error { return nil }
 func (v *vectorStoreValidator) GetChunk(id string) (*types.Chunk, error)         { return nil, nil }
 func (v *vectorStoreValidator) DeleteChunksByFile(filePath string) error         { return nil }
+func (v *vectorStoreValidator) DeleteChunksByFiles(filePaths []string) error         { return nil }
 func (v *vectorStoreValidator) Search(ctx context.Context, req *types.SearchRequest) ([]*types.SearchResult, error) {
 	return nil, nil
 }
 func (v *vectorStoreValidator) StoreSymbols(symbols []*types.Symbol) error           { return nil }
 func (v *vectorStoreValidator) GetSymbol(id string) (*types.Symbol, error)           { return nil, nil }
-func (v *vectorStoreValidator) FindSymbols(query string, kind types.SymbolKind, limit int) ([]*types.Symbol, error) {
+func (v *vectorStoreValidator) FindSymbols(ctx context.Context, query string, kind types.SymbolKind, limit int) ([]*types.Symbol, error) {
 	return nil, nil
 }
 func (v *vectorStoreValidator) FindSymbolsAdvanced(query string, kind types.SymbolKind, minLines int, sortBy string, limit int) ([]*types.Symbol, error) {
@@ -183,10 +197,10 @@ func (v *vectorStoreValidator) GetCallers(symbolID string, limit int) ([]*types.
 func (v *vectorStoreValidator) GetCallees(symbolID string, limit int) ([]*types.Reference, error) {
 	return nil, nil
 }
-func (v *vectorStoreValidator) FindReferencesByKind(kind types.RefKind, limit int) ([]*types.Reference, error) {
+func (v *vectorStoreValidator) FindReferencesByKind(ctx context.Context, kind types.RefKind, limit int) ([]*types.Reference, error) {
 	return nil, nil
 }
-func (v *vectorStoreValidator) GetAllReferences(limit int) ([]*types.Reference, error) {
+func (v *vectorStoreValidator) GetAllReferences(ctx context.Context, limit int) ([]*types.Reference, error) {
 	return nil, nil
 }
 func (v *vectorStoreValidator) GetMetadata() (*types.IndexMetadata, error)       { return nil, nil }
@@ -232,7 +246,7 @@ type MemoryStore interface {
 	// Maintenance
 	PruneExpired() (int, error)
 	Consolidate(channel string) error // Merge similar memories
-	DecayConfidence(halfLifeDays int) error // Apply time-based confidence decay
+	DecayConfidence(halfLifeDays int) error // Set the confidence half-life (decay is applied on read)
 
 	// Statistics
 	GetMemoryStats(channel string) (*types.MemoryStats, error)
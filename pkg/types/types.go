@@ -182,6 +182,13 @@ type StoreStats struct {
 	IndexedFiles    int
 	LastIndexed     time.Time
 	DBSizeBytes     int64
+
+	// Storage health, see the store's idle maintenance
+	PageSize        int64
+	PageCount       int64
+	FreePages       int64 // Pages not yet returned to the file system
+	WALSizeBytes    int64
+	LastMaintenance time.Time // Zero if no pass ran since opening
 }
 
 // IndexMetadata contains metadata about the index.
@@ -263,6 +270,8 @@ type Commit struct {
 	Message          string    `json:"message"`
 	MessageEmbedding []float32 `json:"-"` // Embedding of commit message
 	ParentHash       string    `json:"parent_hash"`
+	ParentHashes     []string  `json:"parent_hashes,omitempty"` // All parents, first parent first
+	Generation       int       `json:"generation,omitempty"`    // 1 + max parent generation in the indexed graph
 
 	// Statistics
 	FilesChanged int `json:"files_changed"`
@@ -443,6 +452,13 @@ type GitHistoryStats struct {
 	NewestCommit          time.Time `json:"newest_commit"`
 	UniqueAuthors         int       `json:"unique_authors"`
 	LastIndexed           time.Time `json:"last_indexed"`
+
+	// Diff storage
+	DiffRawBytes         int64   `json:"diff_raw_bytes"`         // Uncompressed diff and hunk bytes
+	DiffStoredBytes      int64   `json:"diff_stored_bytes"`      // Bytes actually stored
+	DiffCompressionRatio float64 `json:"diff_compression_ratio"` // DiffRawBytes / DiffStoredBytes
+	DBSizeBytes          int64   `json:"db_size_bytes"`
+	DBFreeBytes          int64   `json:"db_free_bytes"` // Free pages reclaimable by VACUUM
 }
 
 // =============================================================================
@@ -503,6 +519,7 @@ type MemorySearchRequest struct {
 	Tags       []string         `json:"tags,omitempty"`
 	Channel    string           `json:"channel,omitempty"` // Empty = all channels
 	MinImportance float32       `json:"min_importance,omitempty"`
+	MinConfidence float32       `json:"min_confidence,omitempty"` // Effective (decayed) confidence
 
 	// Time filters
 	CreatedAfter  *time.Time `json:"created_after,omitempty"`